@@ -71,6 +71,14 @@ extern "C" {
 #define MIN_FHBFSK_DWELL_TIME       1
 #define MAX_FHBFSK_DWELL_TIME       4
 
+#define DEFAULT_MFSK_BITS_PER_SYMBOL 2
+#define MIN_MFSK_BITS_PER_SYMBOL    2
+#define MAX_MFSK_BITS_PER_SYMBOL    (MFSK_MAX_BITS_PER_SYMBOL)
+
+#define DEFAULT_OFDM_NUM_SUBCARRIERS 32
+#define MIN_OFDM_NUM_SUBCARRIERS    8
+#define MAX_OFDM_NUM_SUBCARRIERS    (OFDM_MAX_SUBCARRIERS)
+
 #define DEFAULT_PRINT_ENABLED       (true)
 #define MIN_PRINT_ENABLED           (false)
 #define MAX_PRINT_ENABLED           (true)
@@ -173,10 +181,60 @@ extern "C" {
 #define MIN_ECC_METHOD              0
 #define MAX_ECC_METHOD              (NUM_ECC_METHODS - 1)
 
+#define DEFAULT_RS_BLOCK_LENGTH     64
+#define MIN_RS_BLOCK_LENGTH         8
+#define MAX_RS_BLOCK_LENGTH         255
+
+#define DEFAULT_RS_PARITY_SYMBOLS   8
+#define MIN_RS_PARITY_SYMBOLS       2
+#define MAX_RS_PARITY_SYMBOLS       32
+
+#define DEFAULT_LDPC_RATE           (LDPC_RATE_1_2)
+#define MIN_LDPC_RATE               0
+#define MAX_LDPC_RATE               (NUM_LDPC_RATES - 1)
+
+#define DEFAULT_LDPC_ITERATIONS     20
+#define MIN_LDPC_ITERATIONS         1
+#define MAX_LDPC_ITERATIONS         50
+
 #define DEFAULT_INTERLEAVER_STATE   (false)
 #define MIN_INTERLEAVER_STATE       (false)
 #define MAX_INTERLEAVER_STATE       (true)
 
+#define DEFAULT_ARQ_STATE           (false)
+#define MIN_ARQ_STATE               (false)
+#define MAX_ARQ_STATE               (true)
+
+// The 8 bit sequence numbers allow windows of up to 128 frames but every
+// frame in the window is buffered by both the sender and the receiver. The
+// maximum must be a power of 2 since the buffers are indexed by sequence number
+#define DEFAULT_ARQ_WINDOW          4
+#define MIN_ARQ_WINDOW              1
+#define MAX_ARQ_WINDOW              8
+
+// Seconds since the latest fragment of a transfer before the incomplete
+// transfer is reported and its reassembly buffer is freed
+#define DEFAULT_FRAGMENT_TIMEOUT    120
+#define MIN_FRAGMENT_TIMEOUT        1
+#define MAX_FRAGMENT_TIMEOUT        3600
+
+#define DEFAULT_LINK_ADAPT_STATE    (false)
+#define MIN_LINK_ADAPT_STATE        (false)
+#define MAX_LINK_ADAPT_STATE        (true)
+
+// Largest predicted packet error rate in percent that link adaptation accepts
+// when picking the fastest cargo ECC
+#define DEFAULT_LINK_ADAPT_PER      10
+#define MIN_LINK_ADAPT_PER          1
+#define MAX_LINK_ADAPT_PER          50
+
+// Milliseconds without further parameter changes before the changes are
+// written to flash. Changes are saved at most FLASH_MAX_DEFER_MS after the
+// first one even if they keep coming
+#define DEFAULT_FLASH_SAVE_DELAY    2000
+#define MIN_FLASH_SAVE_DELAY        100
+#define MAX_FLASH_SAVE_DELAY        30000
+
 #define DEFAULT_FHBFSK_HOPPER       (HOPPER_GALOIS)
 #define MIN_FHBFSK_HOPPER           0
 #define MAX_FHBFSK_HOPPER           (NUM_HOPPERS - 1)
@@ -28,6 +28,15 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 
+#define CFG_IMAGE_MAGIC       0x55434647  // UCFG in hex
+#define CFG_IMAGE_VERSION     1
+
+// Sent as hex on a single line so the image must fit in half of a buffer
+// with room for the line ending
+#define CFG_IMAGE_MAX_SIZE    ((MAX_COMM_IN_BUFFER_SIZE - 3) / 2)
+
+// Tag of an entry that starts from a stored profile. Its value is the slot
+#define CFG_IMAGE_TAG_PROFILE 0xF0
 
 
 /* Exported macro ------------------------------------------------------------*/
@@ -67,6 +76,66 @@ bool ImportExport_ExportConfiguration(FunctionContext_t* context);
  */
 bool ImportExport_ImportConfiguration(FunctionContext_t* context);
 
+/**
+ * @brief Builds a binary configuration image of the exported parameters
+ *
+ * The image is a header (magic, version, entry count, entry bytes) followed
+ * by one tag-type-length-value entry per parameter and a CRC-32 over
+ * everything before it. All fields are little endian.
+ *
+ * @param image Buffer for the image (modified)
+ * @param max_size Size of the buffer in bytes
+ * @param size Size of the image in bytes (modified)
+ *
+ * @return true if the image was built, false if it does not fit
+ */
+bool ImportExport_BuildImage(uint8_t* image, uint16_t max_size, uint16_t* size);
+
+/**
+ * @brief Validates a binary configuration image and applies it in one step
+ *
+ * The header, length and CRC are checked and every entry must name a
+ * registered parameter of the same type before anything is applied. An
+ * optional CFG_IMAGE_TAG_PROFILE entry starts from a stored profile that the
+ * parameter entries then override. Values are applied all-or-nothing under a
+ * single configuration version increment.
+ *
+ * @param image Image to apply
+ * @param size Size of the image in bytes
+ * @param num_applied Number of parameters applied (modified)
+ *
+ * @return true if the image was applied, false if it was rejected
+ *
+ * @see Param_SetValues
+ */
+bool ImportExport_ApplyImage(const uint8_t* image, uint16_t size, uint16_t* num_applied);
+
+/**
+ * @brief Exports the configuration as one hex encoded binary image
+ *
+ * @param context Gives a buffer and interface context
+ *
+ * @return true if successful, false otherwise
+ *
+ * @see ImportExport_BuildImage
+ */
+bool ImportExport_ExportBinary(FunctionContext_t* context);
+
+/**
+ * @brief Imports a hex encoded binary image exported from another device
+ *
+ * 2 stages: The first stage prompts for the image. The second stage decodes
+ * the line, validates the whole image and applies it.
+ *
+ * @param context Gives an output buffer, the line to decode and the
+ *        interface context. Changes the context's state
+ *
+ * @return true if the image was applied, false otherwise
+ *
+ * @see ImportExport_ApplyImage
+ */
+bool ImportExport_ImportBinary(FunctionContext_t* context);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
@@ -31,6 +31,9 @@ extern "C" {
 #define EVENT_PARAMS_LOADED         0x02
 #define EVENT_SAVE_REQUESTED        0x04
 
+// Longest wait for pending parameters to be written before a reset or sleep
+#define CFG_FLUSH_TIMEOUT_MS        5000
+
 /* Exported macro ------------------------------------------------------------*/
 
 extern osEventFlagsId_t param_events;
@@ -83,6 +86,12 @@ bool CFG_CreateFlags(void);
  */
 void CFG_WaitLoadComplete(void);
 
+/**
+ * @brief Marks the parameters as changed so the CFG task saves them
+ *
+ * The save is deferred until no parameter changed for the flash save delay
+ * and MESS is idle, so bursts of changes are written in one batch
+ */
 void CFG_SetFlashSaveFlag(void);
 
 /**
@@ -98,6 +107,28 @@ void CFG_IncrementVersionNumber(void);
  */
 uint32_t CFG_GetVersionNumber(void);
 
+/**
+ * @brief Writes all changed parameters to flash now instead of after the
+ * save delay
+ *
+ * Still waits for MESS to be idle before programming flash
+ *
+ * @param timeout_ms Longest time to wait for the write to complete
+ *
+ * @return true if the parameters were saved, false on a flash error or timeout
+ *
+ * @warning Blocks the calling task. Do not call from the CFG task
+ */
+bool CFG_FlushParameters(uint32_t timeout_ms);
+
+/**
+ * @brief Checks whether the CFG task is about to program or is programming
+ * flash
+ *
+ * @return true if MESS should hold off transmitting and packet detection
+ */
+bool CFG_IsFlashBusy(void);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
@@ -82,6 +82,18 @@ typedef enum {
   PARAM_JANUS_DESTINATION,
   PARAM_CODING,
   PARAM_ENCRYPTION,
+  PARAM_MFSK_BITS_PER_SYMBOL,
+  PARAM_OFDM_NUM_SUBCARRIERS,
+  PARAM_RS_BLOCK_LENGTH,
+  PARAM_RS_PARITY_SYMBOLS,
+  PARAM_LDPC_RATE,
+  PARAM_LDPC_MAX_ITERATIONS,
+  PARAM_ARQ_ENABLED,
+  PARAM_ARQ_WINDOW,
+  PARAM_FRAGMENT_TIMEOUT,
+  PARAM_LINK_ADAPT,
+  PARAM_LINK_ADAPT_PER_TARGET,
+  PARAM_FLASH_SAVE_DELAY,
   // Add new parameters just above here and nowhere else
   NUM_PARAM
 } ParamIds_t;
@@ -163,20 +175,54 @@ bool Param_Register(ParamIds_t id, const char* name, ParamType_t type,
  * @brief Retrieves a parameter value by ID
  *
  * Core function that retrieves a parameter value from the parameter store.
- * This function provides thread-safe access to parameters by using mutex protection.
+ * Wait-free for the caller: the value is copied under the parameter seqlock
+ * and the copy is retried if Param_SetValue wrote it at the same time.
  *
  * @param id The parameter identifier
  * @param value Pointer to memory where the parameter value will be stored
  *
  * @return true if parameter was successfully retrieved, false otherwise
- *         (parameter not initialized or mutex acquisition failed)
+ *         (parameter not initialized)
  *
- * @note This function blocks indefinitely while waiting for mutex acquisition
+ * @note Never takes the parameter mutex so it does not contend with the CFG
+ *       task writing flash
  * @warning The caller must ensure that value points to sufficient memory to
  *          store the parameter's full size
  */
 bool Param_GetValue(ParamIds_t id, void* value);
 
+/**
+ * @brief Refreshes a task's private copy of a block of parameters
+ *
+ * Copies the block only when a parameter changed since the last refresh.
+ * The copy is consistent: it never holds half of a parameter update. Tasks
+ * read their snapshot without any locking and call this once per loop.
+ *
+ * @param snapshot Task's copy of the block (modified)
+ * @param block Block holding registered parameter values
+ * @param size Size of the block in bytes
+ * @param version Version of the snapshot, 0 before the first refresh
+ *                (modified)
+ *
+ * @return true if the snapshot changed, false otherwise
+ */
+bool Param_RefreshSnapshot(void* snapshot, const void* block, size_t size,
+                           uint32_t* version);
+
+/**
+ * @brief Reads several parameters as one consistent set
+ *
+ * Each value is returned in the low bytes of a 32-bit container, the same
+ * layout used for parameters saved to flash.
+ *
+ * @param ids Identifiers of the parameters to read
+ * @param values Values of the parameters (modified)
+ * @param count Number of parameters
+ *
+ * @return true if every parameter was read, false if one is not registered
+ */
+bool Param_GetValues(const ParamIds_t* ids, uint32_t* values, uint16_t count);
+
 /**
  * @brief Retrieves an 8-bit unsigned parameter value
  *
@@ -265,14 +311,13 @@ bool Param_GetFloat(ParamIds_t id, float* value);
  * @brief Retrieves the name of a parameter by its ID
  *
  * Looks up a parameter in the parameter database and returns its name.
- * The function is thread-safe through mutex protection of the parameter database.
+ * Names never change after registration so no locking is needed.
  *
  * @param id The parameter identifier to look up
  *
  * @return Pointer to the parameter name if parameter exists and is initialized,
- *         NULL if parameter is not initialized or mutex cannot be acquired
+ *         NULL if parameter is not initialized
  *
- * @note This function blocks indefinitely while waiting for the mutex
  * @see findParamById, isParamInitialized
  */
 char* Param_GetName(ParamIds_t id);
@@ -281,7 +326,7 @@ char* Param_GetName(ParamIds_t id);
  * @brief Retrieves the minimum and maximum limits for a specified parameter
  *
  * This is the base function that all type-specific limit retrieval functions use.
- * Acquires a parameter mutex to ensure thread safety while accessing the parameter.
+ * Limits never change after registration so no locking is needed.
  *
  * @param id The parameter identifier
  * @param min Pointer to receive the minimum limit value (must accommodate sizeof(uint32_t) bytes)
@@ -290,7 +335,6 @@ char* Param_GetName(ParamIds_t id);
  * @return true if limits were successfully retrieved, false otherwise
  *
  * @note This function always copies sizeof(uint32_t) bytes regardless of the actual parameter type
- * @note Blocks indefinitely until the parameter mutex can be acquired
  */
 bool Param_GetLimits(ParamIds_t id, void* min, void* max);
 
@@ -417,6 +461,24 @@ bool Param_GetFloatLimits (ParamIds_t id, float* min, float* max);
  */
 bool Param_SetValue(ParamIds_t id, const void* value);
 
+/**
+ * @brief Sets several parameters in one step
+ *
+ * All values are validated before any is written. They are then published
+ * together so readers never see part of the set, each distinct callback runs
+ * once and the configuration version is incremented once.
+ *
+ * @param ids Identifiers of the parameters to set
+ * @param values Values in the low bytes of 32-bit containers
+ * @param count Number of parameters
+ *
+ * @return true if the set was applied, false if any parameter is not
+ *         registered or any value is outside its limits
+ *
+ * @see Param_GetValues
+ */
+bool Param_SetValues(const ParamIds_t* ids, const uint32_t* values, uint16_t count);
+
 /**
  * @brief Sets an 8-bit unsigned integer parameter
  *
@@ -523,7 +585,6 @@ bool Param_SetFloat(ParamIds_t id, float* value);
  *
  * @return true if parameter exists, false otherwise
  *
- * @note Blocks indefinitely while waiting for mutex acquisition
  * @note The parameter must be set
  */
 bool Param_GetParamType(ParamIds_t id, ParamType_t* param_type);
@@ -537,9 +598,34 @@ bool Param_GetParamType(ParamIds_t id, ParamType_t* param_type);
  *
  * @return true if all modified parameters saved
  *         false if error saving parameter
+ *
+ * @note Holds the parameter mutex so values cannot change while being saved.
+ * Only called from the CFG task, which batches changes
  */
 bool Param_SaveToFlash(void);
 
+/**
+ * @brief Number of parameters changed since they were last saved to flash
+ *
+ * @return Number of parameters waiting to be saved
+ */
+uint16_t Param_NumModified(void);
+
+/**
+ * @brief Appends a record of another type to the parameter flash sector
+ *
+ * The sector is compacted first if the record does not fit. Compaction
+ * rewrites every parameter and every profile.
+ *
+ * @param record Record starting with its signature
+ * @param num_words Length of the record in flash words
+ *
+ * @return true if the record was written, false otherwise
+ *
+ * @see Profile_RewriteToFlash
+ */
+bool Param_WriteFlashRecord(const void* record, uint16_t num_words);
+
 /**
  * @brief Registers a task in the parameter management system
  *
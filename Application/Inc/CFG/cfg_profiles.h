@@ -0,0 +1,172 @@
+/*
+ * cfg_profiles.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef CFG_CFG_PROFILES_H_
+#define CFG_CFG_PROFILES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "cfg_parameters.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+#define PROFILE_SIGNATURE     0x50524F46  // PROF in hex
+
+#define PROFILE_NUM_SLOTS     4
+
+// Including the null terminator
+#define PROFILE_NAME_LEN      16
+
+#define PROFILE_MAX_PARAMS    48
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Creates the mutex guarding the profiles kept in RAM
+ *
+ * @return true if successful, false otherwise
+ *
+ * @note Must be called before Param_LoadInit
+ */
+bool Profile_Init(void);
+
+/**
+ * @brief Stores the current waveform configuration as a named profile
+ *
+ * Captures every profile parameter as one consistent set. The profile is
+ * written to flash by the CFG task together with the next parameter save.
+ *
+ * @param slot Profile slot from 0 to PROFILE_NUM_SLOTS - 1
+ * @param name Name of the profile. Truncated to PROFILE_NAME_LEN - 1
+ *
+ * @return true if the profile was stored, false otherwise
+ */
+bool Profile_Save(uint8_t slot, const char* name);
+
+/**
+ * @brief Switches to a stored profile in one step
+ *
+ * The profile's CRC is checked and then all of its values are applied under
+ * a single configuration version increment.
+ *
+ * @param slot Profile slot
+ *
+ * @return true if the profile was applied, false if the slot is empty, the
+ *         CRC does not match or a value is outside its limits
+ *
+ * @see Param_SetValues
+ */
+bool Profile_Apply(uint8_t slot);
+
+/**
+ * @brief Copies the parameters stored in a profile
+ *
+ * @param slot Profile slot
+ * @param ids Buffer of PROFILE_MAX_PARAMS parameter identifiers (modified)
+ * @param values Buffer of PROFILE_MAX_PARAMS values (modified)
+ * @param count Number of parameters in the profile (modified)
+ *
+ * @return true if the slot holds a profile with a valid CRC, false otherwise
+ *
+ * @see Param_SetValues
+ */
+bool Profile_GetValues(uint8_t slot, ParamIds_t* ids, uint32_t* values, uint8_t* count);
+
+/**
+ * @brief Empties a profile slot
+ *
+ * @param slot Profile slot
+ *
+ * @return true if the slot was emptied, false otherwise
+ */
+bool Profile_Delete(uint8_t slot);
+
+/**
+ * @brief Whether a slot holds a profile
+ *
+ * @param slot Profile slot
+ *
+ * @return true if the slot holds a profile, false otherwise
+ */
+bool Profile_IsValid(uint8_t slot);
+
+/**
+ * @brief Copies the name of a stored profile
+ *
+ * @param slot Profile slot
+ * @param name Buffer of at least PROFILE_NAME_LEN characters (modified)
+ *
+ * @return true if the slot holds a profile, false otherwise
+ */
+bool Profile_GetName(uint8_t slot, char* name);
+
+/**
+ * @brief Finds a stored profile by name
+ *
+ * @param name Name of the profile
+ * @param slot Slot holding the profile (modified)
+ *
+ * @return true if a profile with the name exists, false otherwise
+ */
+bool Profile_FindByName(const char* name, uint8_t* slot);
+
+/**
+ * @brief Writes profiles changed since the last save to flash. Only called
+ * from the CFG task
+ *
+ * @return true if successful, false otherwise
+ */
+bool Profile_SaveToFlash(void);
+
+/**
+ * @brief Writes every stored profile to flash after the parameter sector was
+ * erased
+ *
+ * @return true if successful, false otherwise
+ *
+ * @see Param_WriteFlashRecord
+ */
+bool Profile_RewriteToFlash(void);
+
+/**
+ * @brief Loads a profile record found while loading parameters from flash
+ *
+ * A record with a bad CRC is skipped but still consumed so the records after
+ * it are loaded.
+ *
+ * @param record Start of the record in flash
+ * @param max_words Flash words left in the sector
+ *
+ * @return Number of flash words in the record, 0 if the record is malformed
+ */
+uint16_t Profile_LoadFromFlash(const void* record, uint32_t max_words);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CFG_CFG_PROFILES_H_ */
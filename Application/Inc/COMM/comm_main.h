@@ -26,6 +26,8 @@ extern "C" {
 
 #define CALC_LEN                  0 // A length of 0 makes the function call strlen
 
+#define COMM_INPUT_FLAG           (1 << 0)
+
 typedef enum {
   NEW_CONTENT,
   DATA_READY,
@@ -82,6 +84,13 @@ void COMM_StartTask(void *argument);
  */
 void COMM_TransmitData(const void *data, uint32_t data_len, CommInterface_t interface);
 
+/**
+ * @brief Wakes the communication task to handle new input
+ *
+ * @note Callable from interrupts
+ */
+void COMM_SignalInput(void);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
@@ -40,6 +40,19 @@ typedef enum {
   MENU_ID_CFG_UNIV_ERR_CARGOERR,// What to do when the cargo has an error
   MENU_ID_CFG_UNIV_ECCPREAMBLE, // ECC to use on the preamble
   MENU_ID_CFG_UNIV_ECCMESSAGE,  // ECC to use on the data 
+  MENU_ID_CFG_UNIV_RS,          // Reed-Solomon code parameters
+  MENU_ID_CFG_UNIV_RS_N,        // Reed-Solomon block length in symbols
+  MENU_ID_CFG_UNIV_RS_PARITY,   // Reed-Solomon parity symbols per block
+  MENU_ID_CFG_UNIV_LDPC,        // LDPC code parameters
+  MENU_ID_CFG_UNIV_LDPC_RATE,   // LDPC code rate
+  MENU_ID_CFG_UNIV_LDPC_ITER,   // Maximum LDPC decoder iterations
+  MENU_ID_CFG_UNIV_ARQ,         // Selective-repeat ARQ link layer parameters
+  MENU_ID_CFG_UNIV_ARQ_EN,      // Send messages through the ARQ link layer
+  MENU_ID_CFG_UNIV_ARQ_WINDOW,  // ARQ send window size in frames
+  MENU_ID_CFG_UNIV_FRAG_TIMEOUT,// Time to wait for the missing fragments of a transfer
+  MENU_ID_CFG_UNIV_LINK,        // SNR driven cargo ECC selection parameters
+  MENU_ID_CFG_UNIV_LINK_EN,     // Pick the cargo ECC of each message from the link quality
+  MENU_ID_CFG_UNIV_LINK_PER,    // Largest predicted packet error rate to accept
   MENU_ID_CFG_UNIV_MOD,         // Modulation scheme used for both reception and transmission
   MENU_ID_CFG_UNIV_FSK,         // FSK based waveform processing parameters
   MENU_ID_CFG_UNIV_FSK_F0,      // FSK frequency corresponding to bit 0
@@ -49,6 +62,10 @@ typedef enum {
   MENU_ID_CFG_UNIV_FHBFSK_DWELL,// Number of bit periods to dwell on a tone in FHBFSK
   MENU_ID_CFG_UNIV_FHBFSK_TONES,// Number of tones to use in the FHBFSK modulations scheme
   MENU_ID_CFG_UNIV_FHBFSK_HOPP, // Frequency hopping method to use
+  MENU_ID_CFG_UNIV_MFSK,        // MFSK based waveform processing parameters
+  MENU_ID_CFG_UNIV_MFSK_BITS,   // Number of bits carried by each MFSK symbol
+  MENU_ID_CFG_UNIV_OFDM,        // OFDM based waveform processing parameters
+  MENU_ID_CFG_UNIV_OFDM_SUBCARRIERS, // Number of OFDM subcarriers including pilots
   MENU_ID_CFG_UNIV_BAUD,        // Raw baud rate used for transmission
   MENU_ID_CFG_UNIV_FC,          // Center frequency used 
   MENU_ID_CFG_UNIV_BP,          // Bit period used in the baud rate. Currently the inverse of ^^
@@ -57,6 +74,8 @@ typedef enum {
   MENU_ID_CFG_UNIV_SYNC,        // Synchronization sequence to use
   MENU_ID_CFG_UNIV_EXP,         // Export the configuration options used
   MENU_ID_CFG_UNIV_IMP,         // Import configuration options
+  MENU_ID_CFG_UNIV_EXP_BIN,     // Export the configuration as a binary image
+  MENU_ID_CFG_UNIV_IMP_BIN,     // Import a binary configuration image
   MENU_ID_CFG_UNIV_WAKEUP,      // Wakeup tones options
   MENU_ID_CFG_UNIV_WAKEUP_EN,   // Toggle sending wakeup tones
   MENU_ID_CFG_UNIV_WAKEUP_F1,   // First wakeup tone frequency
@@ -104,6 +123,14 @@ typedef enum {
   MENU_ID_CFG_LED_EN,           // Enable/disable the onboard LED
   MENU_ID_CFG_SETID,            // Set the ID to be used for transmission
   MENU_ID_CFG_STATIONARY,       // Whether the modem is stationary or not
+  MENU_ID_CFG_FLASH,            // Saving parameters to flash
+  MENU_ID_CFG_FLASH_DELAY,      // Time without changes before parameters are saved
+  MENU_ID_CFG_FLASH_FLUSH,      // Save changed parameters now
+  MENU_ID_CFG_PROFILE,          // Named configuration profiles
+  MENU_ID_CFG_PROFILE_LIST,     // List the stored profiles
+  MENU_ID_CFG_PROFILE_SAVE,     // Store the current configuration as a profile
+  MENU_ID_CFG_PROFILE_APPLY,    // Switch to a stored profile
+  MENU_ID_CFG_PROFILE_DELETE,   // Delete a stored profile
   MENU_ID_DBG_GPIO,             // Dump the state of all used GPIO inputs and outputs
   MENU_ID_DBG_SETLED,           // Set the colour of the onboard LED
   MENU_ID_DBG_PRINT,            // Print the next received waveform when it is received
@@ -116,11 +143,19 @@ typedef enum {
   MENU_ID_DBG_DFU,              // Enter DFU mode to flash new firmware over USB
   MENU_ID_DBG_RESETCONFIG,      // Reset saved configuration 
   MENU_ID_DBG_DEEPSLEEP,        // Enter deep sleep mode
+  MENU_ID_DBG_REPLAY,           // Replay a recorded ADC capture streamed over USB
+  MENU_ID_DBG_LINK,             // Print the link adaptation rate table
+  MENU_ID_DBG_CPU,              // Print the CPU load of each task and MESS state
+  MENU_ID_DBG_CPU_RECORD,       // Send the CPU load statistics as a binary record
+  MENU_ID_DBG_TRACE,            // Dump the event trace and restart it
+  MENU_ID_DBG_MEMORY,           // Print the stack, heap, and static RAM usage
+  MENU_ID_DBG_UART,             // Print the daughter card UART statistics
   MENU_ID_HIST_PWR,             // History of power
   MENU_ID_HIST_PWR_PEAK,        // Peak power consumption since boot
   MENU_ID_HIST_PWR_BOOT,        // Total power consumption since boot
   MENU_ID_HIST_PWR_AVG,         // Average power consumption since boot
   MENU_ID_HIST_PWR_CURR,        // Current power consumption
+  MENU_ID_HIST_PWR_ENERGY,      // Energy per MESS state and per bit
   MENU_ID_HIST_RECV,            // Print the last 5 received messages
   MENU_ID_HIST_SENT,            // Print the last 5 sent messages
   MENU_ID_HIST_ERR,             // Error log since boot
@@ -136,6 +171,8 @@ typedef enum {
   MENU_ID_TXRX_INTFB,           // Transmit an integer through feedback network
   MENU_ID_TXRX_FLOATOUT,        // Transmit a float through transducer
   MENU_ID_TXRX_FLOATFB,         // Transmit a float through feedback
+  MENU_ID_TXRX_LARGEOUT,        // Transmit a fragmented buffer through transducer
+  MENU_ID_TXRX_LARGEFB,         // Transmit a fragmented buffer through feedback
   MENU_ID_TXRX_ENPNT,           // Enable/disable printing of waveforms as they are received
   MENU_ID_JANUS_PROTOCOL,         // Toggle JANUS mode
   MENU_ID_JANUS_SEND,           // Send JANUS message
@@ -152,6 +189,9 @@ typedef enum {
   MENU_ID_EVAL_FEEDBACK,        // Send evaluation message through feedback network
   MENU_ID_EVAL_TRANSDUCER,      // Send evaluation message through transducer
   MENU_ID_EVAL_FEEDBACKTESTS,   // Performs the feedback network tests
+  MENU_ID_EVAL_SNRSWEEP,        // Performs the BER/PER versus SNR sweep
+  MENU_ID_EVAL_GOLDEN,          // Checks the transmit chain against golden vectors
+  MENU_ID_EVAL_ARQ,             // ARQ loopback test with frame erasures
   // ... other menu IDs can be added freely at any location
   MENU_ID_COUNT
 } MenuID_t;
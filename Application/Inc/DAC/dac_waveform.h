@@ -27,6 +27,8 @@ typedef struct {
   uint32_t freq_hz;
   float relative_amplitude;
   uint32_t duration_us;
+  uint32_t phase_shift; // Added to the carrier phase at the start of the step. 2^32 is one full cycle
+  const float* samples; // Replaces the tone when set. Peak normalized and sampled at the ADC rate
 } WaveformStep_t;
 
 typedef enum {
@@ -36,7 +38,7 @@ typedef enum {
 
 /* Exported constants --------------------------------------------------------*/
 
-#define DAC_BUFFER_SIZE     500
+#define DAC_BUFFER_SIZE     500       // Halfword samples, refilled one half at a time
 #define DAC_SAMPLE_RATE     1000000
 
 /* Exported macro ------------------------------------------------------------*/
@@ -124,6 +126,27 @@ void Waveform_Flush(void);
  */
 void Waveform_FillBuffer(FillType_t type);
 
+/**
+ * @brief Renders the registered message offline through the DAC fill routine
+ *
+ * Runs the same fill routine as the DMA callbacks without starting the DAC
+ * and computes a CRC-32 over the generated samples (16-bit little-endian).
+ * A fixed amplitude and transition length are used so the result does not
+ * depend on saved parameters.
+ *
+ * @param num_steps The number of steps in the bit message sequence
+ * @param amplitude Relative amplitude used for all steps
+ * @param transition Amplitude transition length in samples
+ * @param crc CRC-32 of the rendered samples (modified)
+ * @param num_samples Number of rendered samples (modified)
+ *
+ * @return false if the DAC is currently running, true otherwise
+ *
+ * @pre MessDacResource_RegisterMessageConfiguration must be called first
+ */
+bool Waveform_Render(uint16_t num_steps, float amplitude, uint16_t transition,
+                     uint32_t* crc, uint32_t* num_samples);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
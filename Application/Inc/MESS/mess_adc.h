@@ -75,11 +75,10 @@ bool ADC_StartInput();
  * @brief Starts ADC conversions on the feedback channel using DMA
  *
  * Resets the feedback buffer index and initiates DMA-based ADC conversions
- * for the feedback channel. Requires a feedback buffer to be registered first.
+ * for the feedback channel. The feedback channel has its own DMA and
+ * processing buffers so it can run alongside the input channel.
  *
- * @return true if operation starts successfully, false if feedback buffer is NULL or DMA fails
- *
- * @pre Feedback buffer must be registered with ADC_RegisterFeedbackBuffer()
+ * @return true if operation starts successfully, false if DMA fails
  */
 bool ADC_StartFeedback();
 
@@ -120,11 +119,12 @@ void ADC_InputClear();
 void ADC_FeedbackClear();
 
 /**
- * @brief Number of times the ADC head has reset (both buffers)
+ * @brief Number of times the ADC head has reset
  * 
- * @return uint16_t Number of rollovers for the tail
+ * @param feedback Whether the feedback or the input ADC is being used
+ * @return uint16_t Number of rollovers for the head
  */
-uint16_t ADC_HeadRolloverCount();
+uint16_t ADC_HeadRolloverCount(bool feedback);
 
 /**
  * @brief Number of buffer rollovers at the buffer tail position
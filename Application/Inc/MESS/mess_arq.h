@@ -0,0 +1,127 @@
+/*
+ * mess_arq.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_ARQ_H_
+#define MESS_MESS_ARQ_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_main.h"
+#include "mess_dsp_config.h"
+#include "FreeRTOS.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+// Link header at the start of every ARQ data frame's cargo: [session]
+// [sequence][sender window base][attempt][data type][length bits (2 bytes)]
+#define ARQ_DATA_HEADER_BYTES       7
+// ARQ acknowledgement cargo: [session][next expected sequence][SACK bitmap]
+// [echoed sequence][echoed attempt]
+#define ARQ_ACK_BYTES               5
+
+#define ARQ_MAX_PAYLOAD_BYTES       (PACKET_DATA_MAX_LENGTH_BYTES - ARQ_DATA_HEADER_BYTES)
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Creates the queue of messages waiting to enter the ARQ send window
+ *
+ * @note Called from MESS_InitializeQueues before the scheduler starts
+ */
+void Arq_InitializeQueue(void);
+
+/**
+ * @brief Registers the ARQ parameters
+ *
+ * @return true if registration was successful, false otherwise
+ */
+bool Arq_RegisterParams(void);
+
+/**
+ * @brief Hands a message to the selective-repeat ARQ layer for reliable delivery
+ *
+ * The message is sent as soon as there is space in the send window and is
+ * retransmitted until it is acknowledged by the receiver
+ *
+ * @param msg Custom protocol message to send. The type selects the transducer
+ * or the feedback network
+ *
+ * @return pdPASS if the message was queued, pdFAIL if the queue is full or the
+ * message is too long to carry the link header
+ *
+ * @note Safe to call from any task
+ */
+BaseType_t Arq_Send(Message_t* msg);
+
+/**
+ * @brief Checks whether Arq_Send would accept a message without blocking
+ *
+ * @return true if there is space in the ARQ send queue, false otherwise
+ */
+bool Arq_CanSend(void);
+
+/**
+ * @brief Sends the next ARQ frame if one is due
+ *
+ * Sends a pending acknowledgement first and otherwise at most one data frame
+ * per call: timed out or fast retransmitted frames before new frames.
+ * Called from the MESS task while listening
+ *
+ * @param cfg Current DSP configuration used to estimate frame airtimes
+ */
+void Arq_Process(const DspConfig_t* cfg);
+
+/**
+ * @brief Consumes received ARQ data and acknowledgement frames
+ *
+ * Data frames are reordered and delivered to the reception queue in sequence
+ * with the link header removed. Duplicates are acknowledged but not delivered
+ *
+ * @param received_msg Received and decoded message
+ *
+ * @return true if the message was an ARQ frame (message consumed), false
+ * otherwise
+ */
+bool Arq_Check(Message_t* received_msg);
+
+/**
+ * @brief Starts the ARQ loopback test through the feedback network
+ *
+ * Sends a fixed number of test messages through a fresh ARQ session while
+ * frames are randomly erased on reception. Prints the in-order delivery
+ * results and link statistics over USB. Messages still waiting for the send
+ * window are discarded
+ *
+ * @note Must not be run at the same time as the feedback tests or SNR sweep
+ */
+void Arq_StartLoopbackTest(void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_ARQ_H_ */
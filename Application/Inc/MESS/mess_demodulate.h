@@ -29,8 +29,12 @@ typedef struct {
   uint16_t data_len;         // Length of the relevant part of data_buf
   uint16_t data_start_index;
   uint16_t chip_index;       // includes synchronization sequence (if applicable)
-  uint16_t bit_index;
+  uint16_t bit_index;        // Symbol index for multi-bit and DPSK methods
   bool decoded_bit;
+  uint8_t num_bits;          // Bits carried by the symbol
+  uint8_t decoded_symbol;    // Symbols of 2 to 8 bits. Bits are MSB first
+  uint8_t symbol_bits[OFDM_MAX_BITS_PER_SYMBOL / 8]; // Symbols wider than 8 bits (OFDM). Bits are MSB first
+  float soft_bits[MFSK_MAX_BITS_PER_SYMBOL]; // [-1, 1] with positive favouring 1
   bool analysis_done;
   uint32_t f0;
   uint32_t f1;
@@ -54,7 +58,9 @@ typedef enum {
 
 /* Exported constants --------------------------------------------------------*/
 
+// Must be a power of 2
 #define MAX_ANALYSIS_BUFFER_SIZE    64
+#define ANALYSIS_BUFFER_MASK        (MAX_ANALYSIS_BUFFER_SIZE - 1)
 
 /* Exported macro ------------------------------------------------------------*/
 
@@ -71,8 +77,14 @@ void Demodulate_Init();
  * @brief Performs demodulation on the provided data
  *
  * Executes the appropriate demodulation algorithm based on the currently set
- * modulation method (FSK or FHBFSK). Then applies the selected decision method
- * to determine the decoded bit value.
+ * modulation method (FSK, FHBFSK, MFSK, DBPSK, DQPSK or OFDM). For the binary
+ * frequency methods the selected decision method is then applied to determine
+ * the decoded bit value. MFSK picks the strongest of the M tones and produces
+ * one soft value per bit from the difference between the strongest tones with
+ * that bit set and cleared. DBPSK and DQPSK compare the complex carrier bin
+ * against the previous symbol; the first symbol is only a phase reference
+ * and yields no bits. OFDM equalizes every subcarrier from the pilots and
+ * returns all of the symbol's bits packed in symbol_bits.
  *
  * @param data Pointer to demodulation data structure containing input samples
  *             and which will be updated with demodulation results
@@ -85,6 +97,15 @@ void Demodulate_Init();
  */
 bool Demodulate_Perform(DemodulationInfo_t* data, const DspConfig_t* cfg);
 
+/**
+ * @brief Number of ADC samples in one data symbol
+ *
+ * @param cfg Configuration information
+ *
+ * @return Samples per analysis block
+ */
+uint16_t Demodulate_SymbolLength(const DspConfig_t* cfg);
+
 /**
  * @brief Power normalization factor for current windowing function
  * 
@@ -42,6 +42,7 @@ typedef struct preamble_content {
   PreambleValue_t class_user_id;
   PreambleValue_t application_type;
   PreambleValue_t schedule_flag;
+  PreambleValue_t rate_profile;
   // others as needed
 } PreambleContent_t;
 
@@ -49,6 +50,10 @@ typedef struct preamble_content {
 typedef enum {
   MOD_DEMOD_FSK,
   MOD_DEMOD_FHBFSK,
+  MOD_DEMOD_MFSK,
+  MOD_DEMOD_DBPSK,
+  MOD_DEMOD_DQPSK,
+  MOD_DEMOD_OFDM,
   // Place others as needed here
   NUM_MOD_DEMOD_METHODS
 } ModDemodMethod_t;
@@ -69,6 +74,8 @@ typedef enum {
   NO_ECC,
   HAMMING_CODE,
   JANUS_CONVOLUTIONAL,
+  REED_SOLOMON,
+  QC_LDPC,
   // Place others as needed here
   NUM_ECC_METHODS
 } ErrorCorrectionMethod_t;
@@ -107,6 +114,8 @@ typedef struct {
   uint8_t fhbfsk_freq_spacing;                  // Integer spacing between adjacent frequencies in FH-BFSK
   uint8_t fhbfsk_num_tones;                     // Number of FH-BFSK tone pairs
   uint8_t fhbfsk_dwell_time;                    // Number of symbols to remain on a FH-bFSK tone pair
+  uint8_t mfsk_bits_per_symbol;                 // log2 of the number of MFSK tones (M = 4, 8, 16)
+  uint8_t ofdm_num_subcarriers;                 // Number of OFDM subcarriers including pilots, centered on fc
   ErrorDetectionMethod_t preamble_validation;   // Error detection method to use on the message preamble
   ErrorDetectionMethod_t cargo_validation;      // Error detection method to use on the message cargo
   ErrorCorrectionMethod_t preamble_ecc_method;  // Error correction method to use on the message preamble
@@ -119,11 +128,17 @@ typedef struct {
   uint32_t wakeup_tone2;                        // Second of three wakeup tones
   uint32_t wakeup_tone3;                        // Third of three wakeup tones
   MessagingProtocol_t protocol;                 // Messaging protocol defining preambles and cargo contents
+  bool link_adaptation;                         // Whether the cargo ECC is chosen per message from the link quality
 } DspConfig_t;
 
 
 /* Exported constants --------------------------------------------------------*/
 
+#define MFSK_MAX_BITS_PER_SYMBOL    4
+#define MFSK_MAX_TONES              (1 << MFSK_MAX_BITS_PER_SYMBOL)
+
+#define OFDM_MAX_SUBCARRIERS        64
+#define OFDM_MAX_BITS_PER_SYMBOL    (2 * OFDM_MAX_SUBCARRIERS) // QPSK on every subcarrier
 
 
 /* Exported macro ------------------------------------------------------------*/
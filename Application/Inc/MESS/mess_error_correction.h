@@ -24,11 +24,19 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 
-
+typedef enum {
+  LDPC_RATE_1_2,
+  LDPC_RATE_2_3,
+  LDPC_RATE_3_4,
+  NUM_LDPC_RATES
+} LdpcRate_t;
 
 /* Exported constants --------------------------------------------------------*/
 
-
+// QC-LDPC base matrix width and largest lifting, giving the largest codeword
+#define LDPC_BASE_COLUMNS       24
+#define LDPC_MAX_LIFTING        96
+#define LDPC_MAX_CODEWORD_BITS  (LDPC_BASE_COLUMNS * LDPC_MAX_LIFTING)
 
 /* Exported macro ------------------------------------------------------------*/
 
@@ -67,6 +75,8 @@ bool ErrorCorrection_AddCorrection(BitMessage_t* bit_msg,
  * 
  * @note Not all ECC methods can detect errors so error_detected cannot be
  * uninitialized
+ * @note Convolutional, Reed-Solomon and LDPC sections resume from any bits
+ * already consumed by ErrorCorrection_StreamCargo so only the tail is decoded
  */
 bool ErrorCorrection_CheckCorrection(BitMessage_t* bit_msg, 
                                      const DspConfig_t* cfg, 
@@ -74,6 +84,31 @@ bool ErrorCorrection_CheckCorrection(BitMessage_t* bit_msg,
                                      bool* error_detected, 
                                      bool* error_corrected);
 
+/**
+ * @brief Decodes as much of the cargo as the received bits allow
+ *
+ * Called while the cargo is still being received so the decoding work is
+ * spread across reception. Whole Reed-Solomon and LDPC blocks are decoded as
+ * soon as their last bit arrives and the Vitrebi decoder decides bits once
+ * they fall out of the traceback window. Decoded bits are held internally
+ * until ErrorCorrection_CheckCorrection finishes the section so the coded
+ * bits remain available for BER evaluation.
+ *
+ * @param bit_msg Bit message being received. The preamble must be decoded
+ * @param cfg Configuration
+ *
+ * @return true if successful, false otherwise
+ *
+ * @note Does nothing when the interleaver is enabled since the interleaver
+ * spans the entire section, or for Hamming codes
+ */
+bool ErrorCorrection_StreamCargo(BitMessage_t* bit_msg, const DspConfig_t* cfg);
+
+/**
+ * @brief Discards any partially decoded section
+ */
+void ErrorCorrection_ResetStream(void);
+
 /**
  * @brief Returns length of a sequence with ECC
  * 
@@ -96,6 +131,13 @@ uint16_t ErrorCorrection_CodedLength(const uint16_t length,
 uint16_t ErrorCorrection_UncodedLength(const uint16_t length,
                                        const ErrorCorrectionMethod_t method);
 
+/**
+ * @brief Registers the Reed-Solomon and LDPC code parameters
+ *
+ * @return true if registration was successful, false otherwise
+ */
+bool ErrorCorrection_RegisterParams(void);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
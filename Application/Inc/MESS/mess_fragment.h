@@ -0,0 +1,154 @@
+/*
+ * mess_fragment.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_FRAGMENT_H_
+#define MESS_MESS_FRAGMENT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_main.h"
+#include "mess_arq.h"
+#include "mess_dsp_config.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+// Fragment header at the start of every fragment's cargo: [transfer id]
+// [fragment index][fragment count][data type][transfer length bytes (2 bytes)]
+#define FRAGMENT_HEADER_BYTES         6
+
+// Sized so a fragment still fits a packet when it also carries the ARQ header
+#define FRAGMENT_MAX_PAYLOAD_BYTES    (ARQ_MAX_PAYLOAD_BYTES - FRAGMENT_HEADER_BYTES)
+
+// Largest buffer that can be sent or reassembled
+#define FRAGMENT_MAX_TRANSFER_BYTES   4096
+#define FRAGMENT_MAX_FRAGMENTS        ((FRAGMENT_MAX_TRANSFER_BYTES + \
+                                        FRAGMENT_MAX_PAYLOAD_BYTES - 1) / \
+                                        FRAGMENT_MAX_PAYLOAD_BYTES)
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+  const uint8_t* data;          // Reassembled buffer. Only valid until released
+  uint16_t length_bytes;
+  uint8_t sender_id;
+  uint8_t transfer_id;
+  uint8_t fragment_count;
+  uint8_t fragments_received;
+  CustomMessageData_t data_type;
+  bool complete;                // false if the reassembly timed out
+} FragmentTransfer_t;
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Registers the fragmentation parameters
+ *
+ * @return true if registration was successful, false otherwise
+ */
+bool Fragment_RegisterParams(void);
+
+/**
+ * @brief Splits a buffer into fragments that are sent back to back
+ *
+ * The buffer is copied so the caller can reuse it immediately. The fragments
+ * go through the ARQ layer if it is enabled and straight to the transmission
+ * queue otherwise
+ *
+ * @param data Buffer to send
+ * @param length_bytes Number of bytes in the buffer
+ * @param data_type Type of the reassembled data on the receiving side
+ * @param type Selects the transducer or the feedback network
+ * @param fragment_count Number of fragments the buffer was split into
+ * (modified)
+ *
+ * @return true if the transfer was started, false if another transfer is
+ * still being sent or the buffer is empty or too long
+ *
+ * @note Called from the COMM task
+ */
+bool Fragment_Send(const uint8_t* data, uint16_t length_bytes,
+                   CustomMessageData_t data_type, MessageType_t type,
+                   uint8_t* fragment_count);
+
+/**
+ * @brief Feeds the next fragment to the link and expires stale reassemblies
+ *
+ * At most one fragment is handed off per call once the previous one has left
+ * the DAC. Reassembly reports that could not be queued are retried. Called from
+ * the MESS task while listening
+ *
+ * @param cfg Current DSP configuration
+ */
+void Fragment_Process(const DspConfig_t* cfg);
+
+/**
+ * @brief Consumes received fragments and reassembles them
+ *
+ * Once every fragment of a transfer has arrived a report message is added to
+ * the reception queue. The reassembled data stays in the pool until COMM
+ * releases it
+ *
+ * @param received_msg Received and decoded message with any link header
+ * already removed
+ *
+ * @return true if the message was a fragment (message consumed), false
+ * otherwise
+ */
+bool Fragment_Check(Message_t* received_msg);
+
+/**
+ * @brief Gets the transfer that a reassembly report refers to
+ *
+ * @param report Report message taken from the reception queue
+ * @param transfer Reassembled transfer (modified)
+ *
+ * @return true if the report refers to a reassembled or timed out transfer,
+ * false otherwise
+ */
+bool Fragment_GetTransfer(const Message_t* report, FragmentTransfer_t* transfer);
+
+/**
+ * @brief Checks whether a fragment of a reported transfer was received
+ *
+ * @param report Report message taken from the reception queue
+ * @param index Fragment index
+ *
+ * @return true if the fragment was received, false otherwise
+ */
+bool Fragment_WasReceived(const Message_t* report, uint8_t index);
+
+/**
+ * @brief Returns the reassembly buffer of a reported transfer to the pool
+ *
+ * Does nothing if the message is not a reassembly report so every received
+ * message can be passed in once it has been handled
+ *
+ * @param report Message taken from the reception queue
+ */
+void Fragment_Release(const Message_t* report);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_FRAGMENT_H_ */
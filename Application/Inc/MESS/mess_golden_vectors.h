@@ -0,0 +1,67 @@
+/*
+ * mess_golden_vectors.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_GOLDEN_VECTORS_H_
+#define MESS_MESS_GOLDEN_VECTORS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Selects whether the next run verifies or regenerates the vectors
+ *
+ * @param record true to print a regenerated table instead of verifying
+ */
+void GoldenVectors_SetRecordMode(bool record);
+
+/**
+ * @brief Runs every golden vector through the transmit chain
+ *
+ * For each protocol/configuration combination the bit stream after packet
+ * preparation, error correction and interleaving, the waveform step schedule
+ * (wakeup, sync and hop frequencies) and the rendered DAC samples are reduced
+ * to CRC-32s and compared against the committed reference values. Results are
+ * printed over USB.
+ *
+ * @return false if the transmit chain failed, true otherwise (even if a
+ *         vector did not match)
+ *
+ * @note Must be called from the MESS task while nothing is being transmitted
+ */
+bool GoldenVectors_Run(void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_GOLDEN_VECTORS_H_ */
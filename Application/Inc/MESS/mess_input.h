@@ -72,19 +72,24 @@ bool Input_DetectMessageStart(const DspConfig_t* cfg);
  * @brief Segments input buffer into analysis blocks for demodulation
  *
  * Creates analysis blocks from the input data stream based on the current baud rate.
- * Each block contains data needed to demodulate one bit of the message.
+ * Each block contains data needed to demodulate one symbol of the message.
+ * Blocks are added to a fixed size ring that Input_ProcessBlocks drains. When
+ * the ring is full segmentation stops and the remaining samples are left in
+ * the ADC buffer for the next call.
  * 
  * @param cfg DSP configuration defining how to segment blocks
  *
- * @return true if segmentation succeeds, false if analysis buffer capacity is exceeded
+ * @return true if segmentation succeeds, false otherwise
  */
 bool Input_SegmentBlocks(const DspConfig_t* cfg);
 
 /**
  * @brief Processes analysis blocks to extract bits from the received signal
  *
- * Demodulates each pending analysis block, extracting the bit value and
- * storing demodulation metrics for evaluation purposes.
+ * Demodulates each pending analysis block, extracting the bit values and
+ * storing demodulation metrics for evaluation purposes. The bits are appended
+ * to the message as they are decoded. Blocks past the end of the message are
+ * left unprocessed.
  *
  * @param bit_msg Pointer to the bit message structure where decoded bits are stored
  * @param eval_info Pointer to evaluation metrics structure to record signal quality data
@@ -99,7 +104,8 @@ bool Input_ProcessBlocks(BitMessage_t* bit_msg, const DspConfig_t* cfg);
  * @brief Decodes header information from accumulated bits
  *
  * Attempts to extract message header fields (sender ID, data type, length, etc.)
- * once sufficient bits have been received.
+ * once sufficient bits have been received. After that the cargo error
+ * correction is advanced over the newly received bits.
  *
  * @param bit_msg Pointer to the bit message structure containing received bits
  * @param cfg Pointer to configuration data
@@ -0,0 +1,148 @@
+/*
+ * mess_link_adapt.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_LINK_ADAPT_H_
+#define MESS_MESS_LINK_ADAPT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_main.h"
+#include "mess_packet.h"
+#include "mess_demodulate.h"
+#include "mess_dsp_config.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+  float snr_db;             // Smoothed SNR estimate of the packets from the peer
+  float offset_db;          // Outer loop correction learned from cargo failures
+  uint32_t last_tick;       // Time the peer was last heard
+  uint16_t packets;
+  uint16_t failures;        // Packets whose cargo failed validation
+  uint8_t last_profile;     // Rate profile the peer last sent with
+  bool valid;
+} LinkPeer_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+// Rate profile 0 keeps the configured cargo ECC
+#define RATE_PROFILE_CONFIGURED     0
+
+#define LINK_ADAPT_MAX_PEERS        (1 << PACKET_SENDER_ID_BITS)
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Registers the link adaptation parameters
+ *
+ * @return true if registration was successful, false otherwise
+ */
+bool LinkAdapt_RegisterParams(void);
+
+/**
+ * @brief Clears the link quality measurements of the previous message
+ *
+ * @note Called when a new message starts being received
+ */
+void LinkAdapt_StartPacket(void);
+
+/**
+ * @brief Adds the soft decisions of a demodulated symbol to the link quality
+ * measurement of the message being received
+ *
+ * @param block Demodulated symbol
+ */
+void LinkAdapt_AddSymbol(const DemodulationInfo_t* block);
+
+/**
+ * @brief Updates the rate table entry of the sender of a received message
+ *
+ * The SNR estimate of the message is folded into the sender's average and the
+ * cargo validation result steers the outer loop offset. Messages with a
+ * corrupted preamble are ignored since the sender is unknown
+ *
+ * @param msg Received and decoded message
+ * @param bit_msg Received bits with the error flags set
+ * @param cfg Configuration the message was received with
+ */
+void LinkAdapt_Observe(const Message_t* msg, const BitMessage_t* bit_msg,
+                       const DspConfig_t* cfg);
+
+/**
+ * @brief Picks the rate profile of a message about to be sent
+ *
+ * The profile with the highest expected goodput whose predicted packet error
+ * rate is below the target is chosen for the weakest recently heard peer.
+ * The choice is stored in the message preamble
+ *
+ * @param msg Message about to be sent (modified)
+ * @param cfg Current DSP configuration
+ *
+ * @return Configuration to code the message with
+ */
+const DspConfig_t* LinkAdapt_PrepareTx(Message_t* msg, const DspConfig_t* cfg);
+
+/**
+ * @brief Gets the configuration used for the cargo of a message
+ *
+ * @param cfg Current DSP configuration
+ * @param preamble Preamble of the message
+ *
+ * @return cfg if link adaptation is off or the message uses the configured
+ * profile, otherwise a copy of cfg with the profile's cargo ECC. The copy is
+ * only valid until the next call
+ */
+const DspConfig_t* LinkAdapt_CargoConfig(const DspConfig_t* cfg,
+                                         const PreambleContent_t* preamble);
+
+/**
+ * @brief Gets the rate table entry of a peer
+ *
+ * @param modem_id Identifier of the peer
+ * @param peer Copy of the entry (modified)
+ *
+ * @return true if the peer has been heard, false otherwise
+ */
+bool LinkAdapt_GetPeer(uint8_t modem_id, LinkPeer_t* peer);
+
+/**
+ * @brief Gets the rate profile of the last message sent
+ *
+ * @return Rate profile index
+ */
+uint8_t LinkAdapt_LastTxProfile(void);
+
+/**
+ * @brief Gets a short description of a rate profile
+ *
+ * @param profile Rate profile index
+ *
+ * @return Description or "invalid" if the profile does not exist
+ */
+const char* LinkAdapt_ProfileName(uint8_t profile);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_LINK_ADAPT_H_ */
@@ -32,6 +32,8 @@ extern "C" {
 #define PACKET_MESSAGE_TYPE_BITS          4
 #define PACKET_LENGTH_BITS                7
 #define PACKET_STATIONARY_BITS            1
+// Appended to the custom preamble when link adaptation is enabled
+#define PACKET_RATE_PROFILE_BITS          3
 
 #define PACKET_PREAMBLE_LENGTH_BITS       (PACKET_SENDER_ID_BITS + \
                                            PACKET_MESSAGE_TYPE_BITS + \
@@ -46,6 +48,7 @@ extern "C" {
 // This is the number of bits in the *raw* message and is not to be used for
 // any ecc operation
 #define PACKET_MAX_LENGTH_BITS            (PACKET_PREAMBLE_LENGTH_BITS + \
+                                           PACKET_RATE_PROFILE_BITS + \
                                            PACKET_DATA_MAX_LENGTH_BITS + \
                                            PACKET_MAX_ERROR_DETECTION_BITS)
 
@@ -59,11 +62,15 @@ extern "C" {
 #define FACTOR_FOR_ECC                    2
 // At most 8 bits are added to flush the encoder in the janus convolutional encoder
 #define ADDED_ECC_BITS                    8
+// Rate 1/2 LDPC rounds each section up to a whole lift which adds at most 47
+// bits beyond the factor
+#define ADDED_BLOCK_ECC_BITS              48
 
 // TODO: Add a check to see if the number of bytes is sufficient
 #define PACKET_MAX_LENGTH_BYTES           (((PACKET_MAX_LENGTH_BITS + \
                                           ADDED_ECC_BITS * 2 + 7) / 8) * \
-                                          FACTOR_FOR_ECC)
+                                          FACTOR_FOR_ECC + \
+                                          (ADDED_BLOCK_ECC_BITS * 2 + 7) / 8)
 // The data max length does not have ECC applied and is sanitized for a user
 #define PACKET_DATA_MAX_LENGTH_BYTES      (PACKET_DATA_MAX_LENGTH_BITS / 8)
 
@@ -82,7 +89,13 @@ typedef enum {
   BITS,
   // Add new message data types here
   UNKNOWN,
-  EVAL
+  EVAL,
+  // Selective-repeat ARQ link layer frames. Placed last to keep the values
+  // of the types above on the air
+  ARQ_DATA,
+  ARQ_ACK,
+  // Part of a buffer larger than one packet
+  FRAGMENT
 } CustomMessageData_t;
 
 typedef enum {
@@ -167,7 +180,10 @@ typedef enum {
   MESS_PRINT_WAVEFORM = 1 << 3,
   MESS_FEEDBACK_TESTS = 1 << 4,
   MESS_DAC_READY = 1 << 5,
-  MESS_INPUT_FFT = 1 << 6
+  MESS_INPUT_FFT = 1 << 6,
+  MESS_SNR_SWEEP = 1 << 7,
+  MESS_GOLDEN_VECTORS = 1 << 8,
+  MESS_ARQ_TEST = 1 << 9
 } MessageFlags_t;
 
 /* Exported macro ------------------------------------------------------------*/
@@ -198,7 +214,7 @@ void MESS_StartTask(void* argument);
  * @brief Initialize message transmission and reception queues
  *
  * Creates fixed-size FreeRTOS queues for handling message transfer between
- * the messaging system and other components.
+ * the messaging system and other components, including the ARQ send queue.
  *
  * @warning Must be called before any queue operations are performed
  * @note Does not currently implement robust error handling for failed queue creation
@@ -34,6 +34,8 @@ typedef enum {
 
 /* Exported constants --------------------------------------------------------*/
 
+#define DPSK_REFERENCE_SYMBOLS      1
+
 
 
 /* Exported macro ------------------------------------------------------------*/
@@ -119,6 +121,53 @@ uint32_t Modulate_GetFhbfskFrequency(bool bit,
  */
 uint32_t Modulate_GetFskFrequency(bool bit, const DspConfig_t* cfg);
 
+/**
+ * @brief Calculates the frequency for a given symbol using MFSK modulation
+ *
+ * The M = 2^mfsk_bits_per_symbol tones are centered on fc and separated by
+ * the frequency spacing times the baud rate. Symbols are Gray coded onto the
+ * tones so adjacent tones differ by a single bit.
+ *
+ * @param symbol The symbol value in [0, M)
+ * @param cfg Configuration information
+ *
+ * @return The calculated frequency in Hertz
+ */
+uint32_t Modulate_GetMfskFrequency(uint8_t symbol, const DspConfig_t* cfg);
+
+/**
+ * @brief Returns the number of bits carried by each data symbol
+ *
+ * @param cfg Configuration information
+ *
+ * @return 1 for the binary methods, log2(M) for MFSK
+ */
+uint8_t Modulate_BitsPerSymbol(const DspConfig_t* cfg);
+
+/**
+ * @brief Calculates the number of data symbols needed to send a message
+ *
+ * @param num_bits Number of bits in the message including error correction
+ * @param cfg Configuration information
+ *
+ * @return The number of data waveform steps including any DPSK phase
+ *         reference symbol
+ */
+uint16_t Modulate_NumDataSteps(uint16_t num_bits, const DspConfig_t* cfg);
+
+/**
+ * @brief Returns whether the method encodes data in the phase change between
+ * symbols (DBPSK or DQPSK)
+ *
+ * Differential methods transmit an unmodulated reference symbol on fc before
+ * the first data symbol.
+ *
+ * @param cfg Configuration information
+ *
+ * @return true for the differential phase methods
+ */
+bool Modulate_IsDifferential(const DspConfig_t* cfg);
+
 /**
  * @brief Populates the waveform step for data symbols
  * 
@@ -126,6 +175,7 @@ uint32_t Modulate_GetFskFrequency(bool bit, const DspConfig_t* cfg);
  * @param bit_msg Bit message to take the bits from
  * @param waveform_step Waveform step to populate with symbol information
  * @param transmission_step Step in transmission, corresponds to bit index
+ *                          (symbol index for MFSK)
  * @return true if successful, false otherwise
  */
 bool Modulate_DataStep(const DspConfig_t* cfg, BitMessage_t* bit_msg, WaveformStep_t* waveform_step, uint16_t bit_index, uint16_t symbol_index);
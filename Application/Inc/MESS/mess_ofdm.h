@@ -0,0 +1,119 @@
+/*
+ * mess_ofdm.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_OFDM_H_
+#define MESS_MESS_OFDM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "mess_dsp_config.h"
+#include "mess_packet.h"
+#include "mess_demodulate.h"
+#include "mess_adc.h"
+#include <stdbool.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+// Symbols are generated and analyzed at the ADC rate so the transmit
+// subcarriers land exactly on the receive FFT bins
+#define OFDM_FFT_SIZE               512
+#define OFDM_CP_SAMPLES             88
+#define OFDM_SYMBOL_SAMPLES         (OFDM_FFT_SIZE + OFDM_CP_SAMPLES) // 5 ms. Must be a multiple of 250 us
+#define OFDM_SAMPLE_RATE            (ADC_SAMPLING_RATE)
+
+// Every fourth subcarrier (and the last) is a pilot
+#define OFDM_PILOT_SPACING          4
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Initializes the FFT used for both symbol generation and analysis
+ *
+ * @return true if successful, false otherwise
+ */
+bool Ofdm_Init(void);
+
+/**
+ * @brief Calculates the number of data bits carried by each OFDM symbol
+ *
+ * Each data subcarrier carries one Gray coded QPSK symbol.
+ *
+ * @param cfg Configuration information
+ *
+ * @return Bits per OFDM symbol
+ */
+uint8_t Ofdm_BitsPerSymbol(const DspConfig_t* cfg);
+
+/**
+ * @brief Returns the frequencies of the outermost subcarriers
+ *
+ * @param cfg Configuration information
+ * @param lower_freq Lowest subcarrier frequency in Hz
+ * @param upper_freq Highest subcarrier frequency in Hz
+ *
+ * @return true if the subcarriers fit below the Nyquist frequency
+ */
+bool Ofdm_GetBand(const DspConfig_t* cfg, uint32_t* lower_freq, uint32_t* upper_freq);
+
+/**
+ * @brief Generates the time domain samples for one OFDM symbol
+ *
+ * Data bits are mapped MSB first onto the data subcarriers, pilots are
+ * inserted, the inverse real FFT is taken and the cyclic prefix is prepended.
+ * The result is normalized to a peak of 1.
+ *
+ * @param cfg Configuration information
+ * @param bit_msg Message to modulate
+ * @param symbol_index Index of the OFDM symbol within the data section
+ * @param samples Set to OFDM_SYMBOL_SAMPLES samples at OFDM_SAMPLE_RATE
+ *
+ * @return true if successful, false otherwise
+ *
+ * @note The samples are valid until the next call
+ */
+bool Ofdm_ModulateSymbol(const DspConfig_t* cfg, BitMessage_t* bit_msg,
+                         uint16_t symbol_index, const float** samples);
+
+/**
+ * @brief Demodulates one OFDM symbol from the input buffer
+ *
+ * The FFT window starts halfway into the cyclic prefix and is rotated back
+ * so synchronization errors in either direction stay inside the prefix. The
+ * residual timing error is removed using the phase slope across the pilots
+ * and each data subcarrier is then equalized with the channel linearly
+ * interpolated between the neighbouring pilots.
+ *
+ * @param data Analysis block. symbol_bits and num_bits are populated
+ * @param cfg Configuration information
+ *
+ * @return true if successful, false otherwise
+ */
+bool Ofdm_DemodulateSymbol(DemodulationInfo_t* data, const DspConfig_t* cfg);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_OFDM_H_ */
@@ -55,6 +55,10 @@ typedef struct {
 
 /* Exported constants --------------------------------------------------------*/
 
+// Confidence levels of a received bit. 0 means the demodulator had no soft
+// decision for it
+#define PACKET_MAX_CONFIDENCE   15
+
 
 
 /* Exported macro ------------------------------------------------------------*/
@@ -276,6 +280,40 @@ bool Packet_CargoBytes(uint8_t length_index, uint16_t* cargo_bytes);
  */
 bool Packet_Copy(const BitMessage_t* src_msg, BitMessage_t* dest_msg, const uint16_t start_index, const uint16_t length);
 
+/**
+ * @brief Records how confident the demodulator was in a received bit
+ *
+ * Only the message being received keeps confidences. They are cleared by
+ * Packet_PrepareRx and stored in received order.
+ *
+ * @param bit_msg Message being received
+ * @param position Position of the bit
+ * @param soft_bit Soft decision from -1 to 1
+ */
+void Packet_SetConfidence(const BitMessage_t* bit_msg, uint16_t position, float soft_bit);
+
+/**
+ * @brief Confidence of a received bit after deinterleaving
+ *
+ * @param bit_msg Message being decoded
+ * @param position Position of the bit
+ *
+ * @return 1 to PACKET_MAX_CONFIDENCE, or 0 if unknown or bit_msg is not the
+ *         message being received
+ */
+uint8_t Packet_GetConfidence(const BitMessage_t* bit_msg, uint16_t position);
+
+/**
+ * @brief Makes Packet_GetConfidence follow a deinterleaved section
+ *
+ * @param bit_msg Message being received
+ * @param start_index First bit of the section
+ * @param length Number of bits in the section
+ * @param depth Interleaver depth used on the section
+ */
+void Packet_DeinterleaveConfidence(const BitMessage_t* bit_msg, uint16_t start_index,
+                                   uint16_t length, uint16_t depth);
+
 /**
  * @brief Registers modem parameters with the parameter subsystem for HMI access
  *
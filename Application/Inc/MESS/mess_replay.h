@@ -0,0 +1,127 @@
+/*
+ * mess_replay.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_REPLAY_H_
+#define MESS_MESS_REPLAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_adc.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+  uint32_t samples_requested;
+  uint32_t samples_replayed;
+  uint32_t underruns;           // ADC blocks where USB data was not available
+  uint32_t overruns;            // ADC blocks that overwrote unprocessed samples
+  uint16_t max_unprocessed;     // Worst case input ring occupancy in samples
+  bool timed_out;
+} ReplayStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+#define REPLAY_MAX_SAMPLES        (ADC_SAMPLING_RATE * 600) // 10 minutes
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Starts replaying a recorded capture into the input processing ring
+ *
+ * After this call all USB data is treated as raw little-endian 16-bit ADC
+ * samples. Samples are consumed at the ADC rate in place of the input ADC
+ * DMA data so detection, synchronization and decoding run in real time.
+ *
+ * @param num_samples Number of samples the host will stream
+ */
+void Replay_Start(uint32_t num_samples);
+
+/**
+ * @brief Aborts an ongoing replay
+ *
+ * @param timed_out Set if the host stopped streaming
+ */
+void Replay_Stop(bool timed_out);
+
+/**
+ * @brief Returns whether a replay is ongoing
+ *
+ * @return true if USB data should be routed to the replay buffer
+ */
+bool Replay_IsActive(void);
+
+/**
+ * @brief Checks for a stalled host and resumes USB reception once the
+ * replay buffer has drained
+ *
+ * Must be called periodically from task context while a replay is active.
+ *
+ * @return true while the replay is still active
+ */
+bool Replay_Service(void);
+
+/**
+ * @brief Adds raw sample bytes received over USB to the replay buffer
+ *
+ * @param data Received bytes
+ * @param len Number of received bytes
+ *
+ * @note Called from the USB receive interrupt
+ */
+void Replay_AddData(const uint8_t* data, uint32_t len);
+
+/**
+ * @brief Returns the free space in the replay buffer
+ *
+ * @return Free space in bytes
+ */
+uint32_t Replay_FreeSpace(void);
+
+/**
+ * @brief Replaces a block of ADC samples with replayed samples
+ *
+ * Also records the input ring occupancy to measure the decode margin.
+ *
+ * @param block Destination for the replayed samples
+ * @param num_samples Number of samples in the block
+ * @param unprocessed_samples Current number of unprocessed samples in the
+ *                            input ring
+ *
+ * @return true if the block was filled with replayed samples
+ *
+ * @note Called from the ADC DMA callbacks
+ */
+bool Replay_GetBlock(uint16_t* block, uint16_t num_samples, uint16_t unprocessed_samples);
+
+/**
+ * @brief Copies the statistics of the current or most recent replay
+ *
+ * @param stats Destination for the statistics
+ */
+void Replay_GetStats(ReplayStats_t* stats);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_REPLAY_H_ */
@@ -0,0 +1,97 @@
+/*
+ * mess_snr_sweep.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef MESS_MESS_SNR_SWEEP_H_
+#define MESS_MESS_SNR_SWEEP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_main.h"
+#include "mess_packet.h"
+#include "mess_dsp_config.h"
+#include <stdbool.h>
+
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Starts a BER/PER versus SNR sweep through the feedback network
+ *
+ * Resets all statistics and prints the sweep configuration table over USB.
+ * Evaluation messages are then sent for every configuration and SNR point
+ * while white gaussian noise is added to the input ADC samples
+ *
+ * @note Must not be run at the same time as the feedback tests
+ */
+void SnrSweep_Start(void);
+
+/**
+ * @brief If performing a sweep, sends the next message or times out the
+ * previous one if it was never decoded
+ */
+void SnrSweep_GetNext(void);
+
+/**
+ * @brief Returns the current configuration if currently running a sweep
+ *
+ * @param cfg Current sweep point's configuration
+ *
+ * @return true if doing a sweep and false otherwise
+ */
+bool SnrSweep_GetConfig(DspConfig_t** cfg);
+
+/**
+ * @brief Records the received message against the current sweep point
+ *
+ * This function returns immediately if a sweep is not ongoing
+ *
+ * @param received_msg Received and decoded evaluation message
+ * @param received_bit_msg Received bits
+ * @return true if performing a sweep (message consumed), false otherwise
+ */
+bool SnrSweep_Check(Message_t* received_msg, BitMessage_t* received_bit_msg);
+
+/**
+ * @brief Adds noise to newly received input samples for the current SNR point
+ *
+ * Also measures the clean signal power of the block which is used as the
+ * reference for the noise level. Called from the ADC DMA callbacks.
+ *
+ * @param buffer Input processing ring buffer
+ * @param start_index Index of the first new sample in the ring
+ * @param num_samples Number of new samples
+ * @param mask Mask used to wrap the ring index
+ */
+void SnrSweep_AddNoise(float* buffer, uint16_t start_index, uint16_t num_samples, uint16_t mask);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESS_MESS_SNR_SWEEP_H_ */
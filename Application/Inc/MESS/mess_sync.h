@@ -65,6 +65,14 @@ uint16_t Sync_NumSteps(const DspConfig_t* cfg);
  */
 bool Sync_Synchronize(const DspConfig_t* cfg);
 
+/**
+ * @brief Returns the SNR measured while synchronizing to the last message
+ *
+ * @return Average signal to background noise energy ratio over the PN
+ * sequence, 0 if the synchronization method does not measure it
+ */
+float Sync_LastSnr();
+
 /**
  * @brief Resets the synchronization process
  * 
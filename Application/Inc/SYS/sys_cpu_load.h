@@ -0,0 +1,139 @@
+/*
+ * sys_cpu_load.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef SYS_SYS_CPU_LOAD_H_
+#define SYS_SYS_CPU_LOAD_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_main.h"
+#include <stdbool.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum {
+  CPU_LOAD_WINDOW_1S,
+  CPU_LOAD_WINDOW_10S,
+  CPU_LOAD_WINDOW_60S,
+  NUM_CPU_LOAD_WINDOWS
+} CpuLoadWindow_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+#define CPU_LOAD_MAX_TASKS          10
+// One entry per ProcessingState_t
+#define CPU_LOAD_NUM_MESS_STATES    (CHANGING + 1)
+
+#define CPU_LOAD_RECORD_VERSION     1
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Samples the run time counters of all tasks once per second
+ *
+ * Called from the SYS task loop
+ */
+void CpuLoad_Process(void);
+
+/**
+ * @brief Attributes the CPU time of the MESS task to the state it is leaving
+ *
+ * Must be called from the MESS task every time its state changes. The time
+ * is resolved to the last context switch of the MESS task
+ *
+ * @param state State the MESS task is entering
+ */
+void CpuLoad_SetMessState(ProcessingState_t state);
+
+/**
+ * @brief Number of tasks seen by the sampler
+ *
+ * @return Number of tasks with load statistics
+ */
+uint8_t CpuLoad_NumTasks(void);
+
+/**
+ * @brief Name of a task seen by the sampler
+ *
+ * @param task Index of the task
+ *
+ * @return Task name or an empty string if the index is invalid
+ */
+const char* CpuLoad_TaskName(uint8_t task);
+
+/**
+ * @brief CPU load of a task over a window
+ *
+ * @param task Index of the task
+ * @param window Averaging window
+ *
+ * @return Load in permille of the CPU
+ */
+uint16_t CpuLoad_TaskPermille(uint8_t task, CpuLoadWindow_t window);
+
+/**
+ * @brief CPU load of the MESS task while in a state over a window
+ *
+ * @param state MESS task state
+ * @param window Averaging window
+ *
+ * @return Load in permille of the CPU
+ */
+uint16_t CpuLoad_MessStatePermille(ProcessingState_t state, CpuLoadWindow_t window);
+
+/**
+ * @brief CPU load of all tasks except the idle task over a window
+ *
+ * @param window Averaging window
+ *
+ * @return Load in permille of the CPU
+ */
+uint16_t CpuLoad_BusyPermille(CpuLoadWindow_t window);
+
+/**
+ * @brief Length of a window in seconds
+ *
+ * @param window Averaging window
+ *
+ * @return Window length or 0 if the window is invalid
+ */
+uint8_t CpuLoad_WindowSeconds(CpuLoadWindow_t window);
+
+/**
+ * @brief Packs the load statistics into a little endian binary record
+ *
+ * Layout: [version][number of tasks N][run time counter frequency (4 bytes)]
+ * [uptime in seconds (4 bytes)] then for each window: [busy][N task loads]
+ * [one load per MESS state] as 2 byte permille values, followed by the N task
+ * names as [length][characters]
+ *
+ * @param buffer Destination of the record (modified)
+ * @param max_len Size of the destination
+ *
+ * @return Length of the record or 0 if it does not fit
+ */
+uint16_t CpuLoad_PackRecord(uint8_t* buffer, uint16_t max_len);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYS_SYS_CPU_LOAD_H_ */
@@ -0,0 +1,86 @@
+/*
+ * sys_memory.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef SYS_SYS_MEMORY_H_
+#define SYS_SYS_MEMORY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include <stdbool.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+  const char* name;
+  uint32_t stack_bytes;       // 0 if the stack size is not known
+  uint32_t min_free_bytes;    // Stack high-water mark
+} MemoryTaskUsage_t;
+
+typedef struct {
+  const char* name;
+  uint32_t used_bytes;
+  uint32_t size_bytes;
+} MemoryRegionUsage_t;
+
+typedef struct {
+  uint32_t size_bytes;
+  uint32_t free_bytes;
+  uint32_t min_free_bytes;    // Lowest free heap since boot
+} MemoryHeapUsage_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+#define MEMORY_MAX_TASKS    12
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Gets the stack usage of every task
+ *
+ * @param usage Stack usage of each task (modified)
+ * @param max_tasks Number of entries in usage
+ *
+ * @return Number of entries filled
+ */
+uint8_t Memory_GetTaskUsage(MemoryTaskUsage_t* usage, uint8_t max_tasks);
+
+/**
+ * @brief Gets the statically allocated size of each RAM region
+ *
+ * @param usage Usage of each region (modified)
+ * @param max_regions Number of entries in usage
+ *
+ * @return Number of entries filled
+ */
+uint8_t Memory_GetRegionUsage(MemoryRegionUsage_t* usage, uint8_t max_regions);
+
+/**
+ * @brief Gets the usage of the FreeRTOS heap
+ *
+ * @param usage Heap usage (modified)
+ */
+void Memory_GetHeapUsage(MemoryHeapUsage_t* usage);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYS_SYS_MEMORY_H_ */
@@ -0,0 +1,176 @@
+/*
+ * sys_power.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef SYS_SYS_POWER_H_
+#define SYS_SYS_POWER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32h7xx_hal.h"
+#include "mess_main.h"
+#include <stdbool.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum {
+  POWER_PACKET_TX,
+  POWER_PACKET_RX,
+  NUM_POWER_PACKET_TYPES
+} PowerPacket_t;
+
+typedef struct {
+  uint32_t packets;           // Packets sent or decoded
+  uint32_t bits;              // Message bits in those packets
+  uint32_t delivered_bits;    // Bits in packets without detected errors
+  float energy_j;             // Energy spent in the packet state since boot
+  float last_packet_energy_j; // Energy of the most recent packet
+} PowerPacketStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+// One entry per ProcessingState_t
+#define POWER_NUM_MESS_STATES     (CHANGING + 1)
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Configures the INA219 power monitor
+ *
+ * @return true if the power monitor responded, false otherwise
+ */
+bool Power_Init(void);
+
+/**
+ * @brief Starts a non-blocking read of the power monitor. Only call from
+ * sys_sensor_timer
+ *
+ * @return true if the read was started, false if the previous one is still in
+ * progress or the monitor is not initialized
+ *
+ * @see SensorTimer_Tick
+ */
+bool Power_TriggerConversion(void);
+
+/**
+ * @brief Adds a power monitor reading to the ring buffer together with the
+ * current MESS state
+ *
+ * @param shunt_raw Shunt voltage register
+ * @param bus_raw Bus voltage register
+ *
+ * @see INA219_StartRead
+ */
+void Power_AddValue(int16_t shunt_raw, uint16_t bus_raw);
+
+/**
+ * @brief Processes unprocessed readings in the ring buffer
+ *
+ * Updates the running power statistics and integrates the energy spent in
+ * each MESS state. Constant time per reading
+ *
+ * @return true
+ */
+bool Power_Process(void);
+
+/**
+ * @brief Records a packet so energy can be reported per bit
+ *
+ * @param type Sent or received packet
+ * @param bits Number of message bits in the packet
+ * @param delivered false if an error was detected in a received packet
+ */
+void Power_AddPacket(PowerPacket_t type, uint16_t bits, bool delivered);
+
+/**
+ * @brief Latest power reading
+ *
+ * @return Power in W
+ */
+float Power_GetCurrent(void);
+
+/**
+ * @brief Peak power since reset
+ *
+ * @return Power in W
+ */
+float Power_GetPeak(void);
+
+/**
+ * @brief Average power since reset
+ *
+ * @return Power in W
+ */
+float Power_GetAverage(void);
+
+/**
+ * @brief Standard deviation of the power readings since reset
+ *
+ * @return Standard deviation in W
+ */
+float Power_GetStdDev(void);
+
+/**
+ * @brief Energy used since reset
+ *
+ * @return Energy in J
+ */
+float Power_GetEnergy(void);
+
+/**
+ * @brief Latest bus voltage and current
+ *
+ * @param voltage_v Bus voltage in V (modified)
+ * @param current_a Current in A (modified)
+ */
+void Power_GetLatestReading(float* voltage_v, float* current_a);
+
+/**
+ * @brief Energy used while the MESS task was in a state
+ *
+ * @param state MESS state
+ * @param time_s Time spent in the state in s (modified)
+ *
+ * @return Energy in J
+ */
+float Power_GetStateEnergy(ProcessingState_t state, float* time_s);
+
+/**
+ * @brief Energy accounting for sent or received packets
+ *
+ * @param type Sent or received packets
+ * @param stats Packet statistics (modified)
+ */
+void Power_GetPacketStats(PowerPacket_t type, PowerPacketStats_t* stats);
+
+/**
+ * @brief Number of readings since reset including the ones dropped because
+ * the I2C bus was busy
+ *
+ * @param dropped Readings that could not be started or failed (modified)
+ *
+ * @return Number of readings processed
+ */
+uint32_t Power_GetSampleCount(uint32_t* dropped);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYS_SYS_POWER_H_ */
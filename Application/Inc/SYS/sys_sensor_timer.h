@@ -32,6 +32,8 @@ extern "C" {
 #define SENSOR_TIMER_TICK_RATE_HZ       1000
 // Trigger a temeprature sensor reading every 200ms
 #define TEMPERATURE_SENSOR_PERIOD_MS    200
+// Read the power monitor every 5ms. Shunt and bus conversions take 532us each
+#define POWER_SENSOR_PERIOD_MS          5
 
 extern TIM_HandleTypeDef SENSOR_TIMER_SOURCE;
 
@@ -0,0 +1,141 @@
+/*
+ * sys_trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef SYS_SYS_TRACE_H_
+#define SYS_SYS_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+// Kept free of HAL and FreeRTOS includes since FreeRTOSConfig.h includes it
+// for the kernel trace hooks
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum {
+  TRACE_EVENT_TASK_SWITCHED_IN,     // arg: task number
+  TRACE_EVENT_TASK_SWITCHED_OUT,    // arg: task number
+  TRACE_EVENT_QUEUE_SEND,           // arg: queue address (mutexes included)
+  TRACE_EVENT_QUEUE_SEND_FAILED,    // arg: queue address
+  TRACE_EVENT_QUEUE_RECEIVE,        // arg: queue address
+  TRACE_EVENT_QUEUE_RECEIVE_FAILED, // arg: queue address
+  TRACE_EVENT_QUEUE_BLOCK_SEND,     // arg: queue address
+  TRACE_EVENT_QUEUE_BLOCK_RECEIVE,  // arg: queue address
+  TRACE_EVENT_PRIORITY_INHERIT,     // arg: holder task number << 16 | inherited priority
+  TRACE_EVENT_ADC_HALF,             // arg: TraceAdc_t
+  TRACE_EVENT_ADC_FULL,             // arg: TraceAdc_t
+  TRACE_EVENT_DAC_HALF,             // arg: DAC channel
+  TRACE_EVENT_DAC_FULL,             // arg: DAC channel
+  TRACE_EVENT_DAC_UNDERRUN,         // arg: pending fill flags
+  TRACE_EVENT_GPIO_EXTI,            // arg: pin mask
+  TRACE_EVENT_MESS_STATE,           // arg: ProcessingState_t entered
+  TRACE_EVENT_PARAM_SET,            // arg: parameter ID
+  TRACE_EVENT_PACKET_RECEIVED,      // arg: message length in bits
+  TRACE_EVENT_PACKET_FAILED,        // arg: message length in bits
+  TRACE_EVENT_MARK,                 // arg: user defined
+  NUM_TRACE_EVENTS
+} TraceEvent_t;
+
+typedef enum {
+  TRACE_ADC_INPUT,
+  TRACE_ADC_FEEDBACK,
+  TRACE_ADC_TEMPERATURE
+} TraceAdc_t;
+
+typedef struct {
+  uint32_t timestamp;     // DWT cycle counter
+  uint32_t arg;
+  uint16_t event;         // TraceEvent_t
+  uint16_t source;        // Active exception number, 0 in thread mode
+} TraceRecord_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+// Must be a power of 2
+#define TRACE_BUFFER_SIZE       1024
+// Records kept after a fault before the trace stops
+#define TRACE_POST_FAULT        (TRACE_BUFFER_SIZE / 4)
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Starts the DWT cycle counter and the trace
+ *
+ * @note Called from main before the scheduler starts
+ */
+void Trace_Init(void);
+
+/**
+ * @brief Adds a record to the trace
+ *
+ * Lock free. Safe to call from any task, interrupt, or kernel trace hook
+ *
+ * @param event Event identifier
+ * @param arg Event argument
+ */
+void Trace_Record(TraceEvent_t event, uint32_t arg);
+
+/**
+ * @brief Adds a record to the trace and stops the trace TRACE_POST_FAULT
+ * records later so the events leading up to the fault are kept
+ *
+ * Only the first fault since the trace was started stops it
+ *
+ * @param event Event identifier
+ * @param arg Event argument
+ */
+void Trace_Fault(TraceEvent_t event, uint32_t arg);
+
+/**
+ * @brief Stops adding records to the trace
+ *
+ * @return Number of records held in the buffer
+ */
+uint32_t Trace_Freeze(void);
+
+/**
+ * @brief Clears the buffer and restarts the trace
+ */
+void Trace_Restart(void);
+
+/**
+ * @brief Checks whether a fault has stopped the trace
+ *
+ * @return true if the trace was stopped by Trace_Fault, false otherwise
+ */
+bool Trace_IsFaulted(void);
+
+/**
+ * @brief Copies records out of a frozen trace
+ *
+ * @param first Index of the first record to copy, 0 being the oldest held
+ * @param dest Destination of the records (modified)
+ * @param max_records Maximum number of records to copy
+ *
+ * @return Number of records copied
+ */
+uint32_t Trace_CopyRecords(uint32_t first, TraceRecord_t* dest, uint32_t max_records);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYS_SYS_TRACE_H_ */
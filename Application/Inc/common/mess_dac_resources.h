@@ -37,7 +37,7 @@ extern "C" {
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
- * @brief Initializes mutex for shared DAC and MESS resources
+ * @brief Initializes the seqlock guarding the shared DAC and MESS resources
  */
 void MessDacResource_Init(void);
 
@@ -58,6 +58,9 @@ void MessDacResource_RegisterMessageConfiguration(const DspConfig_t* new_cfg,
  * @param current_step Current step in the bit message
  *
  * @return structure with the frequency, duration, and amplitude to transmit
+ *
+ * @note Lock free. Raises ERROR_MESS_DAC_RESOURCE if a message is registered
+ * while the step is being computed
  */
 WaveformStep_t MessDacResource_GetStep(uint16_t current_step);
 
@@ -0,0 +1,66 @@
+/*
+ * crc32.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef COMMON_UTILS_CRC32_H_
+#define COMMON_UTILS_CRC32_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+#define CRC32_INIT          0xFFFFFFFFu
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Updates a running CRC-32 (IEEE 802.3, reflected) with new bytes
+ *
+ * Start with CRC32_INIT and pass the result through Crc32_Final once all
+ * data has been added. Matches zlib's crc32().
+ *
+ * @param crc Running CRC value
+ * @param data Bytes to add
+ * @param len Number of bytes
+ *
+ * @return Updated running CRC value
+ */
+uint32_t Crc32_Update(uint32_t crc, const void* data, uint32_t len);
+
+/**
+ * @brief Finalizes a running CRC-32
+ *
+ * @param crc Running CRC value
+ *
+ * @return Final CRC-32
+ */
+uint32_t Crc32_Final(uint32_t crc);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_UTILS_CRC32_H_ */
@@ -50,6 +50,16 @@ typedef struct {
  */
 void goertzel_1(GoertzelInfo_t* goertzel_info);
 
+/**
+ * @brief Calculates goertzel on a single frequency and also returns the
+ * complex bin for phase detection
+ *
+ * @param goertzel_info Contains input and output info for goertzel calculation
+ * @param real Real part of the unnormalized bin
+ * @param imag Imaginary part of the unnormalized bin
+ */
+void goertzel_1_iq(GoertzelInfo_t* goertzel_info, float* real, float* imag);
+
 /**
  * @brief Calculates goertzel on 2 frequencies together
  * 
@@ -57,6 +67,13 @@ void goertzel_1(GoertzelInfo_t* goertzel_info);
  */
 void goertzel_2(GoertzelInfo_t* goertzel_info);
 
+/**
+ * @brief Calculates goertzel on 4 frequencies together
+ * 
+ * @param goertzel_info Contains input and output info for goertzel calculation
+ */
+void goertzel_4(GoertzelInfo_t* goertzel_info);
+
 /**
  * @brief Calculates goertzel on 6 frequencies at once
  * 
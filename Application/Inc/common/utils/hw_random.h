@@ -0,0 +1,55 @@
+/*
+ * hw_random.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef COMMON_UTILS_HW_RANDOM_H_
+#define COMMON_UTILS_HW_RANDOM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+
+
+/* Exported constants --------------------------------------------------------*/
+
+
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Reads a byte from the hardware random number generator
+ *
+ * Starts HSI48 and the RNG on first use. Falls back to the unique device ID
+ * mixed with the tick count if the generator does not start
+ *
+ * @return Random byte that differs between resets
+ *
+ * @note Busy waits up to a few ms. Must be called from a task
+ */
+uint8_t Random_Byte(void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_UTILS_HW_RANDOM_H_ */
@@ -0,0 +1,111 @@
+/*
+ * seqlock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+#ifndef COMMON_UTILS_SEQLOCK_H_
+#define COMMON_UTILS_SEQLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Private includes ----------------------------------------------------------*/
+
+
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * Sequence counter guarding data with a single writer at a time. The
+ * sequence is odd while a write is in progress. Readers copy the data
+ * without locking and retry if the sequence moved while they were copying
+ */
+typedef struct {
+  volatile uint32_t sequence;
+} Seqlock_t;
+
+/* Exported constants --------------------------------------------------------*/
+
+
+
+/* Exported macro ------------------------------------------------------------*/
+
+
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+ * @brief Marks the start of a write to the guarded data
+ *
+ * Writers must be serialized by the caller. A reader that can preempt the
+ * writer spins in Seqlock_Copy until the write ends, so writes read by
+ * higher priority tasks belong in a critical section
+ *
+ * @param lock Seqlock guarding the data
+ */
+void Seqlock_WriteBegin(Seqlock_t* lock);
+
+/**
+ * @brief Marks the end of a write and publishes the data to readers
+ *
+ * @param lock Seqlock guarding the data
+ */
+void Seqlock_WriteEnd(Seqlock_t* lock);
+
+/**
+ * @brief Starts a read of the guarded data
+ *
+ * @param lock Seqlock guarding the data
+ * @param sequence Sequence to pass to Seqlock_ReadValid (modified)
+ *
+ * @return false if a write is in progress, true otherwise
+ */
+bool Seqlock_ReadBegin(const Seqlock_t* lock, uint32_t* sequence);
+
+/**
+ * @brief Checks that no write happened since Seqlock_ReadBegin
+ *
+ * @param lock Seqlock guarding the data
+ * @param sequence Sequence returned by Seqlock_ReadBegin
+ *
+ * @return true if the data read is consistent, false otherwise
+ */
+bool Seqlock_ReadValid(const Seqlock_t* lock, uint32_t sequence);
+
+/**
+ * @brief Copies guarded data, retrying until the copy is consistent
+ *
+ * @param lock Seqlock guarding the data
+ * @param dest Destination of the copy (modified)
+ * @param src Guarded data
+ * @param size Number of bytes to copy
+ *
+ * @return Sequence the copy corresponds to
+ */
+uint32_t Seqlock_Copy(const Seqlock_t* lock, void* dest, const volatile void* src, size_t size);
+
+/**
+ * @brief Current sequence. Changes every time the guarded data is written
+ *
+ * @param lock Seqlock guarding the data
+ *
+ * @return Sequence
+ */
+uint32_t Seqlock_GetSequence(const Seqlock_t* lock);
+
+/* Private defines -----------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_UTILS_SEQLOCK_H_ */
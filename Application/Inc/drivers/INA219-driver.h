@@ -14,7 +14,8 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32h7xx_hal.h"
-
+#include <stdbool.h>
+#include <stdint.h>
 
 /* Private includes ----------------------------------------------------------*/
 
@@ -26,7 +27,11 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 
+// A0 and A1 tied to ground
+#define INA219_I2C_ADDRESS      0x40
 
+#define INA219_SHUNT_LSB_UV     10    // Shunt voltage register resolution
+#define INA219_BUS_LSB_MV       4     // Bus voltage register resolution
 
 /* Exported macro ------------------------------------------------------------*/
 
@@ -34,7 +39,35 @@ extern "C" {
 
 /* Exported functions prototypes ---------------------------------------------*/
 
+/**
+ * @brief Configures the INA219 for continuous 12 bit shunt and bus voltage
+ * conversions with a 32 V bus range and a 320 mV shunt range
+ *
+ * @return true if the configuration was written, false otherwise
+ *
+ * @note Blocking. Call from a task before sampling starts
+ */
+bool INA219_Init(void);
 
+/**
+ * @brief Starts a non-blocking read of the latest shunt and bus voltages
+ *
+ * The two registers are read back to back in interrupt mode and passed to
+ * Power_AddValue when both have arrived
+ *
+ * @return true if the read was started, false if the bus is busy or the I2C
+ * peripheral is not initialized
+ *
+ * @note Safe to call from interrupts
+ */
+bool INA219_StartRead(void);
+
+/**
+ * @brief Number of reads that failed on the I2C bus after they were started
+ *
+ * @return Failed read count
+ */
+uint32_t INA219_GetErrorCount(void);
 
 /* Private defines -----------------------------------------------------------*/
 
@@ -24,6 +24,21 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 
+typedef struct {
+  uint32_t queued_bytes;      // Bytes accepted for transmission
+  uint32_t sent_bytes;        // Bytes the UART finished sending
+  uint32_t back_pressure;     // Writes that had to wait for space
+  uint32_t dropped_messages;  // Writes dropped because the ring stayed full
+  uint32_t dropped_bytes;     // Bytes dropped by full ring or errors
+  uint32_t errors;            // Transfers aborted by a UART or DMA error
+  uint32_t max_used;          // Most bytes waiting to be sent at once
+} DauTxStats_t;
+
+typedef struct {
+  uint32_t received_bytes;    // Bytes written by the receive DMA
+  uint32_t overruns;          // Times unread bytes were overwritten
+  uint32_t errors;            // Receptions restarted after a UART or DMA error
+} DauRxStats_t;
 
 
 /* Exported constants --------------------------------------------------------*/
@@ -39,35 +54,52 @@ extern "C" {
 /**
  * @brief Initializes the Data Acquisition Unit (DAU) communication interface
  *
- * Configures the DAU buffer parameters, enables UART IDLE line detection
- * interrupt, and initiates DMA-based UART reception.
+ * Configures the DAU buffer parameters and starts circular DMA reception that
+ * also ends at every UART idle line. Each reception event wakes the COMM task.
  *
  * @note This function must be called before any other DAU functions
  */
 void DAU_Init(void);
 
 /**
- * @brief Transmits data over the DAU UART interface using DMA
+ * @brief Queues data for transmission over the DAU UART interface
  *
- * Acquires a mutex to ensure thread-safe access to the UART, waits if there's
- * an ongoing transmission, copies data to the transmit buffer, and initiates
- * DMA transfer.
+ * Copies the data into a transmit ring and returns without waiting for the
+ * UART. DMA transfers are chained from the transfer complete callback until
+ * the ring is empty. Only waits when the ring is full, for at most
+ * DAU_TX_TIMEOUT_MS, after which the data is dropped and counted.
  *
  * @param data Pointer to the data to be transmitted
  * @param len Length of data in bytes
  *
- * @note Thread-safe implementation using RTOS mutex
- * @warning Function silently returns if data length exceeds buffer size
+ * @note Thread-safe implementation using RTOS mutex. Not callable from
+ * interrupts
+ * @see DAU_GetTxStats
  */
 void DAU_TransmitData(uint8_t* data, uint16_t len);
 
 /**
- * @brief Processes newly received data from the DMA circular buffer
+ * @brief Transmit statistics since reset
  *
- * Calculates the current DMA position, updates the circular buffer pointers,
- * and processes all newly received bytes between the head and tail pointers.
+ * @param stats Statistics (modified)
+ */
+void DAU_GetTxStats(DauTxStats_t* stats);
+
+/**
+ * @brief Receive statistics since reset
  *
- * @note Should be called regularly to process incoming data
+ * @param stats Statistics (modified)
+ */
+void DAU_GetRxStats(DauRxStats_t* stats);
+
+/**
+ * @brief Processes data received since the last call from the DMA ring
+ *
+ * Stops after a complete message so the rest stays in the ring until the
+ * message is taken by DAU_GetMessage. Unread data overwritten by the DMA is
+ * discarded and counted.
+ *
+ * @note Only called from the COMM task
  */
 void DAU_GetNewData(void);
 
@@ -78,19 +110,22 @@ void DAU_GetNewData(void);
  * - Escape ('\e'): Immediately marks data as ready with escape code
  * - Backspace ('\b'): Removes last character if possible
  * - CR/LF ('\r' or '\n'): Marks current buffer as ready if not empty
+ * - Null ('\0'): Ignored
  * - Other characters: Added to buffer if space available
  *
  * @param data Pointer to received data bytes
  * @param len Number of bytes to process
  *
+ * @return Number of bytes processed. Less than len if a message is complete
+ *
  * @note Buffer overflow protection is implemented
  */
-void DAU_ProcessRxData(uint8_t* data, uint32_t len);
+uint32_t DAU_ProcessRxData(uint8_t* data, uint32_t len);
 
 /**
  * @brief Retrieves processed message from the DAU buffer
  *
- * Checks if new content is available, copies data to the provided buffer,
+ * Processes newly received data, checks if new content is available, copies data to the provided buffer,
  * and updates buffer state flags. The buffer is reset if a complete message was read.
  *
  * @param buffer Destination buffer to copy message into
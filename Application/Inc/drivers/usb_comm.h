@@ -98,6 +98,24 @@ RxState_t USB_GetMessage(uint8_t* buffer, uint16_t* len);
 
 void USB_TransferComplete(void);
 
+/**
+ * @brief Determines whether the next USB packet can be received
+ *
+ * Called from the receive callback before re-arming the endpoint. While a
+ * capture is being replayed, reception is paused until the replay buffer
+ * has room for another packet.
+ *
+ * @return true if the endpoint should be re-armed immediately
+ */
+bool USB_ContinueRx(void);
+
+/**
+ * @brief Re-arms USB reception if it was paused and there is now room
+ *
+ * @note Must be called from task context
+ */
+void USB_ResumeRx(void);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
@@ -9,6 +9,8 @@
 
 #include "cfg_import_export.h"
 #include "cfg_parameters.h"
+#include "cfg_profiles.h"
+#include "crc32.h"
 
 #include "comm_menu_system.h"
 #include "comm_main.h"
@@ -20,6 +22,19 @@
 
 /* Private typedef -----------------------------------------------------------*/
 
+typedef struct {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t count;      // Number of entries
+  uint16_t length;    // Bytes of entries following the header
+} __attribute__((packed)) ImageHeader_t;
+
+// Followed by length bytes of value
+typedef struct {
+  uint8_t tag;        // Parameter ID or CFG_IMAGE_TAG_PROFILE
+  uint8_t type;       // ParamType_t
+  uint8_t length;
+} __attribute__((packed)) ImageEntry_t;
 
 
 /* Private define ------------------------------------------------------------*/
@@ -52,13 +67,29 @@ static ParamIds_t imp_exp_parameters[] = {
     PARAM_ECC_PREAMBLE,
     PARAM_ECC_MESSAGE,
     PARAM_USE_INTERLEAVER,
-    PARAM_FHBFSK_HOPPER
+    PARAM_FHBFSK_HOPPER,
+    PARAM_MFSK_BITS_PER_SYMBOL,
+    PARAM_OFDM_NUM_SUBCARRIERS,
+    PARAM_RS_BLOCK_LENGTH,
+    PARAM_RS_PARITY_SYMBOLS,
+    PARAM_LDPC_RATE,
+    PARAM_LDPC_MAX_ITERATIONS,
+    PARAM_ARQ_ENABLED,
+    PARAM_ARQ_WINDOW,
+    PARAM_FRAGMENT_TIMEOUT,
+    PARAM_LINK_ADAPT,
+    PARAM_LINK_ADAPT_PER_TARGET
 };
 
 static const uint16_t num_param = sizeof(imp_exp_parameters) / sizeof(imp_exp_parameters[0]);
 
+// Shared by export and import, which both run in the COMM task
+static uint8_t image_buffer[CFG_IMAGE_MAX_SIZE];
+
 /* Private function prototypes -----------------------------------------------*/
 
+static uint8_t paramTypeSize(ParamType_t type);
+static int8_t hexValue(char c);
 
 
 /* Exported function definitions ---------------------------------------------*/
@@ -287,4 +318,228 @@ bool ImportExport_ImportConfiguration(FunctionContext_t* context)
   }
 }
 
+bool ImportExport_BuildImage(uint8_t* image, uint16_t max_size, uint16_t* size)
+{
+  ImageHeader_t header = {
+      .magic = CFG_IMAGE_MAGIC,
+      .version = CFG_IMAGE_VERSION,
+      .count = 0,
+      .length = 0
+  };
+  uint16_t index = sizeof(ImageHeader_t);
+
+  for (uint16_t i = 0; i < num_param; i++) {
+    ParamIds_t id = imp_exp_parameters[i];
+    ParamType_t param_type;
+    uint32_t value;
+    if (Param_GetParamType(id, &param_type) == false ||
+        Param_GetValues(&id, &value, 1) == false) {
+      return false;
+    }
+
+    ImageEntry_t entry = {
+        .tag = (uint8_t) id,
+        .type = (uint8_t) param_type,
+        .length = paramTypeSize(param_type)
+    };
+    if (index + sizeof(entry) + entry.length + sizeof(uint32_t) > max_size) {
+      return false;
+    }
+    memcpy(&image[index], &entry, sizeof(entry));
+    index += sizeof(entry);
+    memcpy(&image[index], &value, entry.length);
+    index += entry.length;
+    header.count++;
+  }
+
+  header.length = index - sizeof(ImageHeader_t);
+  memcpy(image, &header, sizeof(header));
+
+  uint32_t crc = Crc32_Final(Crc32_Update(CRC32_INIT, image, index));
+  memcpy(&image[index], &crc, sizeof(crc));
+  *size = index + sizeof(crc);
+  return true;
+}
+
+bool ImportExport_ApplyImage(const uint8_t* image, uint16_t size, uint16_t* num_applied)
+{
+  static ParamIds_t ids[NUM_PARAM + PROFILE_MAX_PARAMS];
+  static uint32_t values[NUM_PARAM + PROFILE_MAX_PARAMS];
+  uint16_t count = 0;
+
+  *num_applied = 0;
+
+  ImageHeader_t header;
+  if (size < sizeof(header) + sizeof(uint32_t)) {
+    return false;
+  }
+  memcpy(&header, image, sizeof(header));
+  if (header.magic != CFG_IMAGE_MAGIC || header.version != CFG_IMAGE_VERSION ||
+      sizeof(header) + header.length + sizeof(uint32_t) != size) {
+    return false;
+  }
+
+  uint32_t crc;
+  memcpy(&crc, &image[size - sizeof(crc)], sizeof(crc));
+  if (Crc32_Final(Crc32_Update(CRC32_INIT, image, size - sizeof(crc))) != crc) {
+    return false;
+  }
+
+  // The whole image is checked and merged before anything is applied
+  const uint8_t* curr = &image[sizeof(header)];
+  const uint8_t* end = curr + header.length;
+  bool profile_loaded = false;
+  for (uint8_t i = 0; i < header.count; i++) {
+    ImageEntry_t entry;
+    if (curr + sizeof(entry) > end) {
+      return false;
+    }
+    memcpy(&entry, curr, sizeof(entry));
+    curr += sizeof(entry);
+    if (curr + entry.length > end) {
+      return false;
+    }
+
+    if (entry.tag == CFG_IMAGE_TAG_PROFILE) {
+      // Only as the first entry so the parameters after it override it
+      uint8_t profile_count;
+      if (i != 0 || entry.length != 1 ||
+          Profile_GetValues(*curr, ids, values, &profile_count) == false) {
+        return false;
+      }
+      count = profile_count;
+      profile_loaded = true;
+    }
+    else {
+      ParamType_t param_type;
+      if (entry.tag >= NUM_PARAM ||
+          Param_GetParamType((ParamIds_t) entry.tag, &param_type) == false ||
+          entry.type != param_type || entry.length != paramTypeSize(param_type)) {
+        return false;
+      }
+
+      uint32_t value = 0;
+      memcpy(&value, curr, entry.length);
+      uint16_t j = 0;
+      while (j < count && ids[j] != (ParamIds_t) entry.tag) {
+        j++;
+      }
+      if (j == count) {
+        if (count >= NUM_PARAM + PROFILE_MAX_PARAMS) {
+          return false;
+        }
+        ids[count++] = (ParamIds_t) entry.tag;
+      }
+      values[j] = value;
+    }
+    curr += entry.length;
+  }
+  if (curr != end || (count == 0 && profile_loaded == false)) {
+    return false;
+  }
+
+  if (Param_SetValues(ids, values, count) == false) {
+    return false;
+  }
+  *num_applied = count;
+  return true;
+}
+
+bool ImportExport_ExportBinary(FunctionContext_t* context)
+{
+  uint16_t size;
+  if (ImportExport_BuildImage(image_buffer, sizeof(image_buffer), &size) == false) {
+    context->state->state = PARAM_STATE_COMPLETE;
+    return false;
+  }
+
+  COMM_TransmitData("\r\nPlease copy the next line\r\n\r\n", CALC_LEN,
+                    context->comm_interface);
+  uint16_t buffer_index = 0;
+  for (uint16_t i = 0; i < size; i++) {
+    buffer_index += sprintf((char*) &context->output_buffer[buffer_index], "%02X",
+                            image_buffer[i]);
+  }
+  buffer_index += sprintf((char*) &context->output_buffer[buffer_index], "\r\n");
+  COMM_TransmitData(context->output_buffer, buffer_index, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
+  return true;
+}
+
+bool ImportExport_ImportBinary(FunctionContext_t* context)
+{
+  switch (context->state->state) {
+    case PARAM_STATE_0:
+      COMM_TransmitData("\r\nPlease paste the configuration image:\r\n", CALC_LEN,
+                        context->comm_interface);
+      context->state->state = PARAM_STATE_1;
+      return true;
+    case PARAM_STATE_1: {
+      context->state->state = PARAM_STATE_COMPLETE;
+
+      uint16_t size = context->input_len / 2;
+      if ((context->input_len % 2) != 0 || size > sizeof(image_buffer)) {
+        COMM_TransmitData("\r\nError: image has an invalid length\r\n", CALC_LEN,
+                          context->comm_interface);
+        return false;
+      }
+      for (uint16_t i = 0; i < size; i++) {
+        int8_t high = hexValue(context->input[2 * i]);
+        int8_t low = hexValue(context->input[2 * i + 1]);
+        if (high < 0 || low < 0) {
+          COMM_TransmitData("\r\nError: image is not hex encoded\r\n", CALC_LEN,
+                            context->comm_interface);
+          return false;
+        }
+        image_buffer[i] = (uint8_t) ((high << 4) | low);
+      }
+
+      uint16_t num_applied;
+      if (ImportExport_ApplyImage(image_buffer, size, &num_applied) == false) {
+        COMM_TransmitData("\r\nError: image rejected, no parameters were changed\r\n",
+                          CALC_LEN, context->comm_interface);
+        return false;
+      }
+      sprintf((char*) context->output_buffer, "\r\nSuccessfully imported %u parameters\r\n",
+              num_applied);
+      COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      return true;
+    }
+    default:
+      context->state->state = PARAM_STATE_COMPLETE;
+      return false;
+  }
+}
+
 /* Private function definitions ----------------------------------------------*/
+
+static uint8_t paramTypeSize(ParamType_t type)
+{
+  switch (type) {
+    case PARAM_TYPE_UINT8:
+    case PARAM_TYPE_INT8:
+      return sizeof(uint8_t);
+    case PARAM_TYPE_UINT16:
+    case PARAM_TYPE_INT16:
+      return sizeof(uint16_t);
+    case PARAM_TYPE_UINT32:
+    case PARAM_TYPE_INT32:
+    case PARAM_TYPE_FLOAT:
+    default:
+      return sizeof(uint32_t);
+  }
+}
+
+static int8_t hexValue(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
@@ -10,17 +10,30 @@
 #include "cfg_main.h"
 #include "cmsis_os.h"
 #include "cfg_parameters.h"
+#include "cfg_profiles.h"
+#include "cfg_defaults.h"
+#include "mess_main.h"
 #include "sys_error.h"
 #include "main.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
 typedef enum {
-  FLASH_SAVE_REQUESTED = 0x00000001,
+  FLASH_SAVE_REQUESTED  = 0x00000001,
+  FLASH_FLUSH_REQUESTED = 0x00000002,
+  FLASH_FLUSH_DONE      = 0x00000004,
+  FLASH_FLUSH_FAILED    = 0x00000008
 } FlashEvents_t;
 
 /* Private define ------------------------------------------------------------*/
 
+#define FLASH_REQUEST_EVENTS    (FLASH_SAVE_REQUESTED | FLASH_FLUSH_REQUESTED)
+
+// Upper bound on how long a stream of changes can postpone saving
+#define FLASH_MAX_DEFER_MS      60000
+
+// How often the MESS state is checked while waiting for it to be idle
+#define FLASH_IDLE_POLL_MS      10
 
 
 /* Private macro -------------------------------------------------------------*/
@@ -33,11 +46,18 @@ osEventFlagsId_t param_events = NULL;
 static osEventFlagsId_t flash_events;
 static volatile uint32_t cfg_number = 1;
 
+static uint16_t flash_save_delay_ms = DEFAULT_FLASH_SAVE_DELAY;
+// Set while parameters are being written. MESS does not start a
+// transmission while it is set
+static volatile bool flash_busy = false;
+
 /* Private function prototypes -----------------------------------------------*/
 
 static void waitAllTasksRegistered(void);
 static bool registerCfgParams(void);
-static bool waitForFlashSave(void);
+static bool waitForFlashSave(bool* flush);
+static bool waitSaveDelay(void);
+static void waitMessIdle(void);
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -67,25 +87,40 @@ void CFG_StartTask(void* argument)
   // then indicate to tasks that all parameters have been updated from flash memory
   osEventFlagsSet(param_events, EVENT_PARAMS_LOADED);
   for (;;) {
-    if (waitForFlashSave() == true) {
-      osDelay(100); // Small wait for multiple successive saves
-      if (Param_SaveToFlash() == false) {
-        Error_Routine(ERROR_FLASH);
-      }
+    bool flush = false;
+    if (waitForFlashSave(&flush) == false) {
+      Error_Routine(ERROR_FLASH);
+      continue;
+    }
+    // Let successive changes (imports, sweeps, menu edits) coalesce into one
+    // batch unless a flush was asked for
+    if (flush == false) {
+      flush = waitSaveDelay();
     }
-    else {
+
+    // Programming stalls code fetch from the single flash bank so it is done
+    // while MESS is only listening
+    waitMessIdle();
+    bool success = Param_SaveToFlash() && Profile_SaveToFlash();
+    flash_busy = false;
+
+    if (success == false) {
       Error_Routine(ERROR_FLASH);
     }
+    if (flush == true) {
+      osEventFlagsSet(flash_events, success ? FLASH_FLUSH_DONE : FLASH_FLUSH_FAILED);
+    }
   }
 }
 
 bool CFG_CreateFlags()
 {
+  static StaticEventGroup_t event_control_block;
   static const osEventFlagsAttr_t event_attr = {
       .name = "ParamEvents",
       .attr_bits = 0,
-      .cb_mem = NULL,
-      .cb_size = 0
+      .cb_mem = &event_control_block,
+      .cb_size = sizeof(event_control_block)
   };
 
   param_events = osEventFlagsNew(&event_attr);
@@ -94,11 +129,12 @@ bool CFG_CreateFlags()
     return false;
   }
 
+  static StaticEventGroup_t flash_control_block;
   static const osEventFlagsAttr_t flash_attr = {
       .name = "FlashEvents",
       .attr_bits = 0,
-      .cb_mem = NULL,
-      .cb_size = 0
+      .cb_mem = &flash_control_block,
+      .cb_size = sizeof(flash_control_block)
   };
 
   flash_events = osEventFlagsNew(&flash_attr);
@@ -129,6 +165,27 @@ uint32_t CFG_GetVersionNumber()
   return cfg_number;
 }
 
+bool CFG_FlushParameters(uint32_t timeout_ms)
+{
+  if (flash_events == NULL) {
+    return false;
+  }
+
+  osEventFlagsClear(flash_events, FLASH_FLUSH_DONE | FLASH_FLUSH_FAILED);
+  osEventFlagsSet(flash_events, FLASH_FLUSH_REQUESTED);
+  uint32_t flags = osEventFlagsWait(flash_events,
+      FLASH_FLUSH_DONE | FLASH_FLUSH_FAILED, osFlagsWaitAny, timeout_ms);
+  if (flags & osFlagsError) {
+    return false;
+  }
+  return (flags & FLASH_FLUSH_DONE) != 0;
+}
+
+bool CFG_IsFlashBusy()
+{
+  return flash_busy;
+}
+
 /* Private function definitions ----------------------------------------------*/
 
 void waitAllTasksRegistered()
@@ -138,14 +195,60 @@ void waitAllTasksRegistered()
 
 bool registerCfgParams()
 {
+  uint32_t min_u32 = MIN_FLASH_SAVE_DELAY;
+  uint32_t max_u32 = MAX_FLASH_SAVE_DELAY;
+  if (Param_Register(PARAM_FLASH_SAVE_DELAY, "the flash save delay",
+                     PARAM_TYPE_UINT16, &flash_save_delay_ms, sizeof(uint16_t),
+                     &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
   return true;
 }
 
-bool waitForFlashSave()
+bool waitForFlashSave(bool* flush)
 {
-  uint32_t flags = osEventFlagsWait(flash_events, FLASH_SAVE_REQUESTED, osFlagsWaitAny, osWaitForever);
+  uint32_t flags = osEventFlagsWait(flash_events, FLASH_REQUEST_EVENTS, osFlagsWaitAny, osWaitForever);
   if (flags & osFlagsError) {
     return false;
   }
+  *flush = (flags & FLASH_FLUSH_REQUESTED) != 0;
   return true;
 }
+
+// Waits until no parameter changed for the save delay. Returns true if a
+// flush was requested in the meantime
+bool waitSaveDelay()
+{
+  uint32_t start = osKernelGetTickCount();
+  for (;;) {
+    uint32_t flags = osEventFlagsWait(flash_events, FLASH_REQUEST_EVENTS,
+                                      osFlagsWaitAny, flash_save_delay_ms);
+    if (flags & osFlagsError) {
+      return false; // Timeout: the changes have settled
+    }
+    if (flags & FLASH_FLUSH_REQUESTED) {
+      return true;
+    }
+    if (osKernelGetTickCount() - start >= FLASH_MAX_DEFER_MS) {
+      return false;
+    }
+  }
+}
+
+// Returns with flash_busy set and MESS listening. MESS runs at a higher
+// priority and checks flash_busy before transmitting or searching the input
+// for a packet, so once it is seen listening with the flag set it stays
+// listening. A sector erase during compaction stalls code fetch, including the
+// ADC interrupt, for far longer than a DMA half buffer so MESS discards the
+// input until the batch is done
+void waitMessIdle()
+{
+  for (;;) {
+    flash_busy = true;
+    if (MESS_GetState() == LISTENING) {
+      return;
+    }
+    flash_busy = false;
+    osDelay(FLASH_IDLE_POLL_MS);
+  }
+}
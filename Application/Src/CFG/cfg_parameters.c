@@ -9,11 +9,16 @@
 
 #include "cfg_parameters.h"
 #include "cfg_main.h"
+#include "cfg_profiles.h"
+#include "sys_trace.h"
+#include "seqlock.h"
 
 #include "stm32h7xx.h"
 #include "stm32h7xx_hal.h"
 
 #include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include "cmsis_os.h"
 
 #include <stdbool.h>
@@ -75,33 +80,46 @@ static uint8_t complete_registrations_count = 0;
 
 static Parameter_t parameters[NUM_PARAM] = {0};
 
+// Serializes writers. Readers only use the seqlock
 static osMutexId_t param_mutex = NULL;
 
+// Guards every registered parameter value. Starts at 2 so a snapshot version
+// of 0 always refreshes
+static Seqlock_t param_seqlock = {.sequence = 2};
+
 static uint32_t num_erases;
 static uint32_t next_write_addr = FLASH_PARAM_ADDR;
 
 static bool flash_load_complete = false;
 
+// Set while the sector is being rewritten so a full sector cannot trigger
+// another compaction
+static bool flash_compacting = false;
+
 // static uint32_t param_crc = 0; TODO
 
 /* Private function prototypes -----------------------------------------------*/
 
 static Parameter_t* findParamById(ParamIds_t id);
 static bool isParamInitialized(ParamIds_t id);
+static bool isValueInLimits(const Parameter_t* param, const void* value);
 
 static bool getNumErases();
 static bool updateNumErases();
 static bool writeParameterToFlash(uint16_t id);
+static bool programFlashWords(const void* data, uint16_t num_words);
+static bool compactFlash(void);
 
 /* Exported function definitions ---------------------------------------------*/
 
 bool Param_Init(void)
 {
+  static StaticSemaphore_t mutex_control_block;
   static const osMutexAttr_t mutex_attr = {
       .name = "ParamMutex",
       .attr_bits = osMutexRecursive,
-      .cb_mem = NULL,
-      .cb_size = 0
+      .cb_mem = &mutex_control_block,
+      .cb_size = sizeof(mutex_control_block)
   };
 
   param_mutex = osMutexNew(&mutex_attr);
@@ -132,11 +150,8 @@ bool Param_Init(void)
 bool Param_LoadInit(void)
 {
   // Load parameters from flash to overwrite defaults set by registration
-  for (; next_write_addr < FLASH_PARAM_ADDR_END; next_write_addr += FLASH_WORD_SIZE) {
+  while (next_write_addr < FLASH_PARAM_ADDR_END) {
     ConfigEntry_t* entry = (ConfigEntry_t*) next_write_addr;
-    if (entry->signature != PARAM_SIGNATURE) { // add other signatures as needed
-      break;
-    }
     if (entry->signature == PARAM_SIGNATURE) {
       if (entry->version != 1) {
         return false;
@@ -144,6 +159,18 @@ bool Param_LoadInit(void)
       if (Param_SetValue(entry->param_id, (void*) &entry->value) == false) {
         return false;
       }
+      next_write_addr += FLASH_WORD_SIZE;
+    }
+    else if (entry->signature == PROFILE_SIGNATURE) {
+      uint16_t num_words = Profile_LoadFromFlash((const void*) next_write_addr,
+          (FLASH_PARAM_ADDR_END - next_write_addr) / FLASH_WORD_SIZE);
+      if (num_words == 0) {
+        return false;
+      }
+      next_write_addr += num_words * FLASH_WORD_SIZE;
+    }
+    else { // add other signatures as needed
+      break;
     }
   }
 
@@ -176,7 +203,6 @@ bool Param_Register(ParamIds_t id, const char* name, ParamType_t type,
     param->id = id;
     strncpy(param->name, name, sizeof(param->name) - 1);
     param->type = type;
-    param->value_ptr = value_ptr;
     param->value_size = value_size;
     param->callback = callback;
     param->is_modified = false;
@@ -199,9 +225,15 @@ bool Param_Register(ParamIds_t id, const char* name, ParamType_t type,
         param->limits.f.max = *(float*) max;
         break;
       default:
+        osMutexRelease(param_mutex);
         return false;
     }
 
+    // Lock-free readers treat the parameter as registered once value_ptr is
+    // set so it is published last
+    __DMB();
+    param->value_ptr = value_ptr;
+
     osMutexRelease(param_mutex);
     return true;
   }
@@ -212,16 +244,45 @@ bool Param_Register(ParamIds_t id, const char* name, ParamType_t type,
 
 bool Param_GetValue(ParamIds_t id, void* value)
 {
-  bool success = false;
+  if (isParamInitialized(id) == false) {
+    return false;
+  }
 
-  if (osMutexAcquire(param_mutex, osWaitForever) == osOK) {
-    Parameter_t* param = findParamById(id);
-    if (isParamInitialized(id) == true) {
-      memcpy(value, param->value_ptr, param->value_size);
-      success = true;
+  Parameter_t* param = findParamById(id);
+  Seqlock_Copy(&param_seqlock, value, param->value_ptr, param->value_size);
+  return true;
+}
+
+bool Param_RefreshSnapshot(void* snapshot, const void* block, size_t size,
+                           uint32_t* version)
+{
+  if (*version == Seqlock_GetSequence(&param_seqlock)) {
+    return false;
+  }
+
+  *version = Seqlock_Copy(&param_seqlock, snapshot, block, size);
+  return true;
+}
+
+bool Param_GetValues(const ParamIds_t* ids, uint32_t* values, uint16_t count)
+{
+  // Holding off writers makes the values one consistent set
+  if (osMutexAcquire(param_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+
+  bool success = true;
+  for (uint16_t i = 0; i < count; i++) {
+    if (ids[i] >= NUM_PARAM || isParamInitialized(ids[i]) == false) {
+      success = false;
+      break;
     }
-    osMutexRelease(param_mutex);
+    Parameter_t* param = findParamById(ids[i]);
+    values[i] = 0;
+    memcpy(&values[i], param->value_ptr, param->value_size);
   }
+
+  osMutexRelease(param_mutex);
   return success;
 }
 
@@ -259,34 +320,28 @@ bool Param_GetFloat(ParamIds_t id, float* value)
   return Param_GetValue(id, value);
 }
 
+// Names, limits, and types never change after registration so they are read
+// without the mutex
+
 char* Param_GetName(ParamIds_t id)
 {
-  char* param_name = NULL;
-  if (osMutexAcquire(param_mutex, osWaitForever) == osOK) {
-    Parameter_t* param = findParamById(id);
-    if (isParamInitialized(id) == true) {
-      param_name = param->name;
-    }
-    osMutexRelease(param_mutex);
+  if (isParamInitialized(id) == false) {
+    return NULL;
   }
-  return param_name;
+  return findParamById(id)->name;
 }
 
 bool Param_GetLimits(ParamIds_t id, void* min, void* max)
 {
-  bool success = false;
-
-  if (osMutexAcquire(param_mutex, osWaitForever) == osOK) {
-    Parameter_t* param = findParamById(id);
-    if (isParamInitialized(id) == true) {
-      // Always copies fixed-size data regardless of actual parameter type
-      memcpy(min, &param->limits.u32.min, sizeof(uint32_t));
-      memcpy(max, &param->limits.u32.max, sizeof(uint32_t));
-      success = true;
-    }
-    osMutexRelease(param_mutex);
+  if (isParamInitialized(id) == false) {
+    return false;
   }
-  return success;
+
+  Parameter_t* param = findParamById(id);
+  // Always copies fixed-size data regardless of actual parameter type
+  memcpy(min, &param->limits.u32.min, sizeof(uint32_t));
+  memcpy(max, &param->limits.u32.max, sizeof(uint32_t));
+  return true;
 }
 
 bool Param_GetUint8Limits (ParamIds_t id, uint8_t* min, uint8_t* max)
@@ -351,59 +406,22 @@ bool Param_GetFloatLimits (ParamIds_t id, float* min, float* max)
 bool Param_SetValue(ParamIds_t id, const void* value)
 {
   bool success = false;
+  Trace_Record(TRACE_EVENT_PARAM_SET, id);
 
   if (osMutexAcquire(param_mutex, osWaitForever) == osOK) {
     Parameter_t* param = findParamById(id);
     if (isParamInitialized(id) == true) {
-      bool valid = false;
-      switch (param->type) {
-        case PARAM_TYPE_UINT8:
-        case PARAM_TYPE_UINT16:
-        case PARAM_TYPE_UINT32: {
-          uint32_t val = 0;
-          if (param->type == PARAM_TYPE_UINT8) {
-            val = (uint32_t) (*(uint8_t*) value);
-          }
-          else if (param->type == PARAM_TYPE_UINT16) {
-            val = (uint32_t) (*(uint16_t*) value);
-          }
-          else {
-            val = *(uint32_t*) value;
-          }
-          valid = (val >= param->limits.u32.min &&
-                   val <= param->limits.u32.max);
-          break;
-        }
-        case PARAM_TYPE_INT8:
-        case PARAM_TYPE_INT16:
-        case PARAM_TYPE_INT32: {
-          int32_t val = 0;
-          if (param->type == PARAM_TYPE_INT8) {
-            val = (int32_t) (*(uint8_t*) value);
-          }
-          else if (param->type == PARAM_TYPE_INT16) {
-            val = (int32_t) (*(uint16_t*) value);
-          }
-          else {
-            val = *(int32_t*) value;
-          }
-          valid = (val >= param->limits.i32.min &&
-                   val <= param->limits.i32.max);
-          break;
-        }
-        case PARAM_TYPE_FLOAT: {
-          float val = *(float*) value;
-          valid = (val >= param->limits.f.min &&
-                   val <= param->limits.f.max);
-          break;
-        }
-        default:
-          break;
-      }
+      bool valid = isValueInLimits(param, value);
 
       if (valid) {
         if (memcmp(param->value_ptr, value, param->value_size) != 0) {
+          // Short enough to keep out of the way of readers in higher
+          // priority tasks, which would otherwise spin on the seqlock
+          taskENTER_CRITICAL();
+          Seqlock_WriteBegin(&param_seqlock);
           memcpy(param->value_ptr, value, param->value_size);
+          Seqlock_WriteEnd(&param_seqlock);
+          taskEXIT_CRITICAL();
           param->is_modified = true;
           if ((param->callback != NULL) && (flash_load_complete == true)) {
             (*param->callback)();
@@ -419,6 +437,71 @@ bool Param_SetValue(ParamIds_t id, const void* value)
   return success;
 }
 
+bool Param_SetValues(const ParamIds_t* ids, const uint32_t* values, uint16_t count)
+{
+  // Callbacks shared by several of the parameters only need to run once
+  void (*callbacks[NUM_PARAM])(void);
+  uint16_t num_callbacks = 0;
+  bool changed = false;
+
+  if (osMutexAcquire(param_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+
+  // Nothing is written unless every value is valid
+  for (uint16_t i = 0; i < count; i++) {
+    Trace_Record(TRACE_EVENT_PARAM_SET, ids[i]);
+    if (ids[i] >= NUM_PARAM || isParamInitialized(ids[i]) == false ||
+        isValueInLimits(findParamById(ids[i]), &values[i]) == false) {
+      osMutexRelease(param_mutex);
+      return false;
+    }
+  }
+
+  // One write section so readers and snapshots see either the old or the new
+  // set and never a mix
+  taskENTER_CRITICAL();
+  Seqlock_WriteBegin(&param_seqlock);
+  for (uint16_t i = 0; i < count; i++) {
+    Parameter_t* param = findParamById(ids[i]);
+    if (memcmp(param->value_ptr, &values[i], param->value_size) == 0) {
+      continue;
+    }
+    memcpy(param->value_ptr, &values[i], param->value_size);
+    param->is_modified = true;
+    changed = true;
+
+    if (param->callback == NULL) {
+      continue;
+    }
+    bool listed = false;
+    for (uint16_t j = 0; j < num_callbacks; j++) {
+      if (callbacks[j] == param->callback) {
+        listed = true;
+        break;
+      }
+    }
+    if (listed == false) {
+      callbacks[num_callbacks++] = param->callback;
+    }
+  }
+  Seqlock_WriteEnd(&param_seqlock);
+  taskEXIT_CRITICAL();
+
+  if (changed == true) {
+    if (flash_load_complete == true) {
+      for (uint16_t i = 0; i < num_callbacks; i++) {
+        (*callbacks[i])();
+      }
+    }
+    CFG_SetFlashSaveFlag();
+    CFG_IncrementVersionNumber();
+  }
+
+  osMutexRelease(param_mutex);
+  return true;
+}
+
 bool Param_SetUint8(ParamIds_t id, uint8_t* value)
 {
   return Param_SetValue(id, value);
@@ -456,42 +539,67 @@ bool Param_SetFloat(ParamIds_t id, float* value)
 
 bool Param_GetParamType(ParamIds_t id, ParamType_t* param_type)
 {
-  if (osMutexAcquire(param_mutex, osWaitForever) == osOK) {
-    Parameter_t* param = findParamById(id);
-    if (isParamInitialized(id) == true) {
-      *param_type = param->type;
-      return true;
-    }
+  if (isParamInitialized(id) == false) {
+    return false;
   }
-  return false;
+  *param_type = findParamById(id)->type;
+  return true;
 }
 
 bool Param_SaveToFlash(void)
 {
-  for (uint16_t i = 0; i < NUM_PARAM; i++) {
+  if (osMutexAcquire(param_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+
+  bool success = true;
+  for (uint16_t i = 0; i < NUM_PARAM && success == true; i++) {
     if (parameters[i].is_modified == true) {
       // save the parameter
       if (writeParameterToFlash(i) == false) {
-        return false;
+        success = false;
+        break;
       }
       if (next_write_addr >= FLASH_PARAM_ADDR_END) {
-        // clear flash, update num erases, add parameters back to flash
-        if (Param_FlashReset() == false) {
-          return false;
-        }
-        if (updateNumErases() == false) {
-          return false;
-        }
-
-        for (uint16_t i = 0; i < NUM_PARAM; i++) {
-          if (writeParameterToFlash(i) == false) {
-            return false;
-          }
+        if (compactFlash() == false) {
+          success = false;
+          break;
         }
       }
     }
   }
-  return true;
+
+  osMutexRelease(param_mutex);
+  return success;
+}
+
+bool Param_WriteFlashRecord(const void* record, uint16_t num_words)
+{
+  if (osMutexAcquire(param_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+
+  bool success = true;
+  if (next_write_addr + num_words * FLASH_WORD_SIZE > FLASH_PARAM_ADDR_END) {
+    success = (flash_compacting == false) && (compactFlash() == true);
+  }
+  if (success == true) {
+    success = programFlashWords(record, num_words);
+  }
+
+  osMutexRelease(param_mutex);
+  return success;
+}
+
+uint16_t Param_NumModified(void)
+{
+  uint16_t count = 0;
+  for (uint16_t i = 0; i < NUM_PARAM; i++) {
+    if (parameters[i].is_modified == true) {
+      count++;
+    }
+  }
+  return count;
 }
 
 bool Param_RegisterTask(TaskIds_t task_id, const char* task_name)
@@ -596,6 +704,56 @@ bool isParamInitialized(ParamIds_t id)
   return true;
 }
 
+static bool isValueInLimits(const Parameter_t* param, const void* value)
+{
+  bool valid = false;
+  switch (param->type) {
+    case PARAM_TYPE_UINT8:
+    case PARAM_TYPE_UINT16:
+    case PARAM_TYPE_UINT32: {
+      uint32_t val = 0;
+      if (param->type == PARAM_TYPE_UINT8) {
+        val = (uint32_t) (*(uint8_t*) value);
+      }
+      else if (param->type == PARAM_TYPE_UINT16) {
+        val = (uint32_t) (*(uint16_t*) value);
+      }
+      else {
+        val = *(uint32_t*) value;
+      }
+      valid = (val >= param->limits.u32.min &&
+               val <= param->limits.u32.max);
+      break;
+    }
+    case PARAM_TYPE_INT8:
+    case PARAM_TYPE_INT16:
+    case PARAM_TYPE_INT32: {
+      int32_t val = 0;
+      if (param->type == PARAM_TYPE_INT8) {
+        val = (int32_t) (*(uint8_t*) value);
+      }
+      else if (param->type == PARAM_TYPE_INT16) {
+        val = (int32_t) (*(uint16_t*) value);
+      }
+      else {
+        val = *(int32_t*) value;
+      }
+      valid = (val >= param->limits.i32.min &&
+               val <= param->limits.i32.max);
+      break;
+    }
+    case PARAM_TYPE_FLOAT: {
+      float val = *(float*) value;
+      valid = (val >= param->limits.f.min &&
+               val <= param->limits.f.max);
+      break;
+    }
+    default:
+      break;
+  }
+  return valid;
+}
+
 static bool getNumErases()
 {
   uint32_t* num_erases_addr = (uint32_t*) FLASH_PARAM_ADDR;
@@ -639,19 +797,52 @@ static bool writeParameterToFlash(uint16_t id)
   entry.param_id = id;
   entry.value = *((uint32_t*) parameters[id].value_ptr);
 
-  if (HAL_FLASH_Unlock() != HAL_OK) {
+  if (programFlashWords(&entry, 1) == false) {
     return false;
   }
-  HAL_StatusTypeDef status = HAL_FLASH_Program(
-      FLASH_TYPEPROGRAM_FLASHWORD, next_write_addr, (uint32_t) &entry);
-  if (status != HAL_OK) {
+  parameters[id].is_modified = false;
+
+  return true;
+}
+
+static bool programFlashWords(const void* data, uint16_t num_words)
+{
+  if (HAL_FLASH_Unlock() != HAL_OK) {
     return false;
   }
+  for (uint16_t i = 0; i < num_words; i++) {
+    HAL_StatusTypeDef status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD,
+        next_write_addr, (uint32_t) data + i * FLASH_WORD_SIZE);
+    if (status != HAL_OK) {
+      HAL_FLASH_Lock();
+      return false;
+    }
+    next_write_addr += FLASH_WORD_SIZE;
+  }
   if (HAL_FLASH_Lock() != HAL_OK) {
     return false;
   }
-  parameters[id].is_modified = false;
-  next_write_addr += FLASH_WORD_SIZE;
-
   return true;
 }
+
+static bool compactFlash()
+{
+  // clear flash (also updates num erases), add parameters and profiles back
+  if (Param_FlashReset() == false) {
+    return false;
+  }
+
+  for (uint16_t i = 0; i < NUM_PARAM; i++) {
+    if (isParamInitialized(i) == false) {
+      continue;
+    }
+    if (writeParameterToFlash(i) == false) {
+      return false;
+    }
+  }
+
+  flash_compacting = true;
+  bool success = Profile_RewriteToFlash();
+  flash_compacting = false;
+  return success;
+}
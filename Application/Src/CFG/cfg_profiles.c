@@ -0,0 +1,429 @@
+/*
+ * cfg_profiles.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "cfg_profiles.h"
+#include "cfg_parameters.h"
+#include "cfg_main.h"
+#include "crc32.h"
+
+#include "FreeRTOS.h"
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+#define PROFILE_ENTRIES_PER_WORD  5
+// Header and parameters
+#define PROFILE_MAX_WORDS         (1 + (PROFILE_MAX_PARAMS + PROFILE_ENTRIES_PER_WORD - 1) / PROFILE_ENTRIES_PER_WORD)
+
+typedef struct {
+  char name[PROFILE_NAME_LEN];
+  uint8_t count;        // 0 when the slot is empty
+  ParamIds_t ids[PROFILE_MAX_PARAMS];
+  uint32_t values[PROFILE_MAX_PARAMS];
+  uint32_t crc;
+  bool pending;         // Changed since it was last written to flash
+} Profile_t;
+
+// First flash word of a profile record. The parameters follow in
+// ProfileWord_t words
+typedef struct {
+  uint32_t signature;
+  uint16_t version;
+  uint8_t slot;
+  uint8_t count;
+  uint32_t crc;
+  char name[PROFILE_NAME_LEN];
+  uint8_t padding[4];
+} __attribute__((packed)) ProfileHeader_t;
+
+typedef struct {
+  uint16_t param_id;
+  uint32_t value;
+} __attribute__((packed)) ProfileEntry_t;
+
+typedef struct {
+  ProfileEntry_t entries[PROFILE_ENTRIES_PER_WORD];
+  uint8_t padding[2];
+} __attribute__((packed)) ProfileWord_t;
+
+typedef struct {
+  ProfileHeader_t header;
+  ProfileWord_t words[PROFILE_MAX_WORDS - 1];
+} __attribute__((packed, aligned(4))) ProfileRecord_t;
+
+/* Private define ------------------------------------------------------------*/
+
+#define PROFILE_VERSION           1
+
+#define PROFILE_FLASH_WORD_SIZE   (FLASH_NB_32BITWORD_IN_FLASHWORD * sizeof(uint32_t))
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+// Parameters that make up a waveform configuration. Calibration, identity and
+// board settings are left out so switching profiles never changes them. New
+// parameters can be added anywhere in the list up to PROFILE_MAX_PARAMS
+static const ParamIds_t profile_parameters[] = {
+    PARAM_PROTOCOL,
+    PARAM_MOD_DEMOD_METHOD,
+    PARAM_BAUD,
+    PARAM_FC,
+    PARAM_FSK_F0,
+    PARAM_FSK_F1,
+    PARAM_FHBFSK_FREQ_SPACING,
+    PARAM_FHBFSK_DWELL_TIME,
+    PARAM_FHBFSK_NUM_TONES,
+    PARAM_FHBFSK_HOPPER,
+    PARAM_MFSK_BITS_PER_SYMBOL,
+    PARAM_OFDM_NUM_SUBCARRIERS,
+    PARAM_PREAMBLE_ERROR_DETECTION,
+    PARAM_CARGO_ERROR_DETECTION,
+    PARAM_ECC_PREAMBLE,
+    PARAM_ECC_MESSAGE,
+    PARAM_RS_BLOCK_LENGTH,
+    PARAM_RS_PARITY_SYMBOLS,
+    PARAM_LDPC_RATE,
+    PARAM_LDPC_MAX_ITERATIONS,
+    PARAM_USE_INTERLEAVER,
+    PARAM_SYNC_METHOD,
+    PARAM_WINDOW_FUNCTION,
+    PARAM_DEMODULATION_DECISION,
+    PARAM_WAKEUP_TONES_STATE,
+    PARAM_WAKEUP_TONE1,
+    PARAM_WAKEUP_TONE2,
+    PARAM_WAKEUP_TONE3,
+    PARAM_CODING,
+    PARAM_ENCRYPTION,
+    PARAM_OUTPUT_AMPLITUDE,
+    PARAM_DAC_TRANSITION_LEN,
+    PARAM_MODULATION_OUTPUT_METHOD,
+    PARAM_MODULATION_TARGET_POWER,
+    PARAM_ARQ_ENABLED,
+    PARAM_ARQ_WINDOW,
+    PARAM_FRAGMENT_TIMEOUT,
+    PARAM_LINK_ADAPT,
+    PARAM_LINK_ADAPT_PER_TARGET
+};
+
+static const uint16_t num_profile_param = sizeof(profile_parameters) / sizeof(profile_parameters[0]);
+
+static Profile_t profiles[PROFILE_NUM_SLOTS];
+
+static osMutexId_t profile_mutex = NULL;
+
+// Separate buffers since compacting the sector while a profile is being saved
+// rewrites every profile
+static ProfileRecord_t save_record;
+static ProfileRecord_t rewrite_record;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t calculateCrc(const Profile_t* profile);
+static uint16_t buildRecord(uint8_t slot, ProfileRecord_t* record);
+static uint16_t recordWords(uint8_t count);
+
+/* Exported function definitions ---------------------------------------------*/
+
+bool Profile_Init()
+{
+  static StaticSemaphore_t mutex_control_block;
+  static const osMutexAttr_t mutex_attr = {
+      .name = "ProfileMutex",
+      .attr_bits = 0,
+      .cb_mem = &mutex_control_block,
+      .cb_size = sizeof(mutex_control_block)
+  };
+
+  if (sizeof(ProfileHeader_t) != PROFILE_FLASH_WORD_SIZE ||
+      sizeof(ProfileWord_t) != PROFILE_FLASH_WORD_SIZE ||
+      num_profile_param > PROFILE_MAX_PARAMS) {
+    return false;
+  }
+
+  profile_mutex = osMutexNew(&mutex_attr);
+  if (profile_mutex == NULL) {
+    return false;
+  }
+
+  memset(profiles, 0, sizeof(profiles));
+  return true;
+}
+
+bool Profile_Save(uint8_t slot, const char* name)
+{
+  if (slot >= PROFILE_NUM_SLOTS || name == NULL || name[0] == '\0') {
+    return false;
+  }
+
+  // Read before taking the profile mutex so it is never held while waiting
+  // for the parameter mutex
+  uint32_t values[PROFILE_MAX_PARAMS];
+  if (Param_GetValues(profile_parameters, values, num_profile_param) == false) {
+    return false;
+  }
+
+  if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+  Profile_t* profile = &profiles[slot];
+  memset(profile->name, 0, sizeof(profile->name));
+  strncpy(profile->name, name, PROFILE_NAME_LEN - 1);
+  profile->count = num_profile_param;
+  memcpy(profile->ids, profile_parameters, sizeof(profile_parameters));
+  memcpy(profile->values, values, num_profile_param * sizeof(uint32_t));
+  profile->crc = calculateCrc(profile);
+  profile->pending = true;
+  osMutexRelease(profile_mutex);
+
+  CFG_SetFlashSaveFlag();
+  return true;
+}
+
+bool Profile_Apply(uint8_t slot)
+{
+  if (slot >= PROFILE_NUM_SLOTS) {
+    return false;
+  }
+
+  ParamIds_t ids[PROFILE_MAX_PARAMS];
+  uint32_t values[PROFILE_MAX_PARAMS];
+  uint8_t count;
+
+  // Copied out so the profile mutex is never held while waiting for the
+  // parameter mutex
+  if (Profile_GetValues(slot, ids, values, &count) == false) {
+    return false;
+  }
+  return Param_SetValues(ids, values, count);
+}
+
+bool Profile_GetValues(uint8_t slot, ParamIds_t* ids, uint32_t* values, uint8_t* count)
+{
+  if (slot >= PROFILE_NUM_SLOTS) {
+    return false;
+  }
+
+  if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+  Profile_t* profile = &profiles[slot];
+  if (profile->count == 0 || profile->crc != calculateCrc(profile)) {
+    osMutexRelease(profile_mutex);
+    return false;
+  }
+  *count = profile->count;
+  memcpy(ids, profile->ids, profile->count * sizeof(ParamIds_t));
+  memcpy(values, profile->values, profile->count * sizeof(uint32_t));
+  osMutexRelease(profile_mutex);
+  return true;
+}
+
+bool Profile_Delete(uint8_t slot)
+{
+  if (slot >= PROFILE_NUM_SLOTS) {
+    return false;
+  }
+
+  if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+  Profile_t* profile = &profiles[slot];
+  memset(profile->name, 0, sizeof(profile->name));
+  profile->count = 0;
+  profile->crc = calculateCrc(profile);
+  profile->pending = true;
+  osMutexRelease(profile_mutex);
+
+  CFG_SetFlashSaveFlag();
+  return true;
+}
+
+bool Profile_IsValid(uint8_t slot)
+{
+  if (slot >= PROFILE_NUM_SLOTS) {
+    return false;
+  }
+  return profiles[slot].count != 0;
+}
+
+bool Profile_GetName(uint8_t slot, char* name)
+{
+  if (slot >= PROFILE_NUM_SLOTS) {
+    return false;
+  }
+
+  if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+  bool valid = profiles[slot].count != 0;
+  if (valid == true) {
+    memcpy(name, profiles[slot].name, PROFILE_NAME_LEN);
+  }
+  osMutexRelease(profile_mutex);
+  return valid;
+}
+
+bool Profile_FindByName(const char* name, uint8_t* slot)
+{
+  if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+    return false;
+  }
+  bool found = false;
+  for (uint8_t i = 0; i < PROFILE_NUM_SLOTS; i++) {
+    if (profiles[i].count != 0 &&
+        strncmp(profiles[i].name, name, PROFILE_NAME_LEN) == 0) {
+      *slot = i;
+      found = true;
+      break;
+    }
+  }
+  osMutexRelease(profile_mutex);
+  return found;
+}
+
+bool Profile_SaveToFlash()
+{
+  bool success = true;
+  for (uint8_t i = 0; i < PROFILE_NUM_SLOTS; i++) {
+    if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+      return false;
+    }
+    uint16_t num_words = 0;
+    if (profiles[i].pending == true) {
+      num_words = buildRecord(i, &save_record);
+      profiles[i].pending = false;
+    }
+    osMutexRelease(profile_mutex);
+
+    if (num_words == 0) {
+      continue;
+    }
+    if (Param_WriteFlashRecord(&save_record, num_words) == false) {
+      // Left pending so the next save retries it
+      osMutexAcquire(profile_mutex, osWaitForever);
+      profiles[i].pending = true;
+      osMutexRelease(profile_mutex);
+      success = false;
+    }
+  }
+  return success;
+}
+
+bool Profile_RewriteToFlash()
+{
+  for (uint8_t i = 0; i < PROFILE_NUM_SLOTS; i++) {
+    if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+      return false;
+    }
+    // An empty slot needs no record once the sector is erased
+    uint16_t num_words = 0;
+    if (profiles[i].count != 0) {
+      num_words = buildRecord(i, &rewrite_record);
+    }
+    osMutexRelease(profile_mutex);
+
+    if (num_words == 0) {
+      continue;
+    }
+    if (Param_WriteFlashRecord(&rewrite_record, num_words) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint16_t Profile_LoadFromFlash(const void* record, uint32_t max_words)
+{
+  const ProfileRecord_t* flash_record = (const ProfileRecord_t*) record;
+  const ProfileHeader_t* header = &flash_record->header;
+
+  if (header->version != PROFILE_VERSION || header->slot >= PROFILE_NUM_SLOTS ||
+      header->count > PROFILE_MAX_PARAMS) {
+    return 0;
+  }
+  uint16_t num_words = recordWords(header->count);
+  if (num_words > max_words) {
+    return 0;
+  }
+
+  Profile_t profile = {0};
+  memcpy(profile.name, header->name, PROFILE_NAME_LEN);
+  profile.name[PROFILE_NAME_LEN - 1] = '\0';
+  profile.count = header->count;
+  for (uint8_t i = 0; i < header->count; i++) {
+    const ProfileEntry_t* entry =
+        &flash_record->words[i / PROFILE_ENTRIES_PER_WORD].entries[i % PROFILE_ENTRIES_PER_WORD];
+    profile.ids[i] = (ParamIds_t) entry->param_id;
+    profile.values[i] = entry->value;
+  }
+  profile.crc = calculateCrc(&profile);
+
+  // A record cut short by a reset has unprogrammed entries and fails the CRC.
+  // The slot keeps the profile from the previous record
+  if (profile.crc != header->crc) {
+    return num_words;
+  }
+
+  if (osMutexAcquire(profile_mutex, osWaitForever) != osOK) {
+    return 0;
+  }
+  profiles[header->slot] = profile;
+  osMutexRelease(profile_mutex);
+  return num_words;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+static uint32_t calculateCrc(const Profile_t* profile)
+{
+  uint32_t crc = CRC32_INIT;
+  crc = Crc32_Update(crc, profile->name, PROFILE_NAME_LEN);
+  crc = Crc32_Update(crc, &profile->count, sizeof(profile->count));
+  for (uint8_t i = 0; i < profile->count; i++) {
+    ProfileEntry_t entry = {
+        .param_id = (uint16_t) profile->ids[i],
+        .value = profile->values[i]
+    };
+    crc = Crc32_Update(crc, &entry, sizeof(entry));
+  }
+  return Crc32_Final(crc);
+}
+
+static uint16_t buildRecord(uint8_t slot, ProfileRecord_t* record)
+{
+  const Profile_t* profile = &profiles[slot];
+
+  // Unused bytes are left erased
+  memset(record, 0xFF, sizeof(ProfileRecord_t));
+  record->header.signature = PROFILE_SIGNATURE;
+  record->header.version = PROFILE_VERSION;
+  record->header.slot = slot;
+  record->header.count = profile->count;
+  record->header.crc = profile->crc;
+  memcpy(record->header.name, profile->name, PROFILE_NAME_LEN);
+
+  for (uint8_t i = 0; i < profile->count; i++) {
+    ProfileEntry_t* entry =
+        &record->words[i / PROFILE_ENTRIES_PER_WORD].entries[i % PROFILE_ENTRIES_PER_WORD];
+    entry->param_id = (uint16_t) profile->ids[i];
+    entry->value = profile->values[i];
+  }
+  return recordWords(profile->count);
+}
+
+static uint16_t recordWords(uint8_t count)
+{
+  return 1 + (count + PROFILE_ENTRIES_PER_WORD - 1) / PROFILE_ENTRIES_PER_WORD;
+}
@@ -11,8 +11,10 @@
 #include "comm_menu_system.h"
 #include "comm_main.h"
 #include "cfg_parameters.h"
+#include "cfg_main.h"
 #include "comm_function_loops.h"
 #include "cfg_import_export.h"
+#include "cfg_profiles.h"
 #include "main.h"
 #include "mess_main.h"
 #include "mess_modulate.h"
@@ -41,6 +43,15 @@ void preambleErrorBehavior(void* argument);
 void cargoErrorBehavior(void* argument);
 void setPremableEcc(void* argument);
 void setMessageEcc(void* argument);
+void setRsBlockLength(void* argument);
+void setRsParitySymbols(void* argument);
+void setLdpcRate(void* argument);
+void setLdpcIterations(void* argument);
+void toggleArq(void* argument);
+void setArqWindow(void* argument);
+void setFragmentTimeout(void* argument);
+void toggleLinkAdaptation(void* argument);
+void setLinkAdaptationPer(void* argument);
 void setModulationMethod(void* argument);
 void setFskF0(void* argument);
 void setFskF1(void* argument);
@@ -48,6 +59,8 @@ void setFhbfskFreqSpacing(void* argument);
 void setFhbfskDwell(void* argument);
 void setFhbfskTones(void* argument);
 void setFhbfskHopper(void* argument);
+void setMfskBitsPerSymbol(void* argument);
+void setOfdmNumSubcarriers(void* argument);
 void toggleWakeupTones(void* argument);
 void setWakeupTone1(void* argument);
 void setWakeupTone2(void* argument);
@@ -60,6 +73,8 @@ void toggleInterleaver(void* argument);
 void setSynchronizer(void* argument);
 void printConfigOptions(void* argument);
 void importConfiOptions(void* argument);
+void exportConfigImage(void* argument);
+void importConfigImage(void* argument);
 void setDacTransitionDuration(void* argument);
 void setModPowerControlMethod(void* argument);
 void setModFixedOutput(void* argument);
@@ -94,6 +109,15 @@ void setDemodCalUpperFreq(void* argument);
 void exportDemodCal(void* argument);
 void setID(void* argument);
 void setStationaryFlag(void* argument);
+void setFlashSaveDelay(void* argument);
+void flushParameters(void* argument);
+void listProfiles(void* argument);
+void saveProfile(void* argument);
+void applyProfile(void* argument);
+void deleteProfile(void* argument);
+
+static void printProfiles(FunctionContext_t* context);
+static bool parseProfileSlot(FunctionContext_t* context, uint8_t* slot);
 
 /* Private variables ---------------------------------------------------------*/
 
@@ -101,7 +125,8 @@ void setStationaryFlag(void* argument);
 
 static MenuID_t configMenuChildren[] = {
   MENU_ID_CFG_UNIV, MENU_ID_CFG_MOD,    MENU_ID_CFG_DEMOD,      MENU_ID_CFG_DAU, 
-  MENU_ID_CFG_LED,  MENU_ID_CFG_SETID,  MENU_ID_CFG_STATIONARY
+  MENU_ID_CFG_LED,  MENU_ID_CFG_SETID,  MENU_ID_CFG_STATIONARY, MENU_ID_CFG_FLASH,
+  MENU_ID_CFG_PROFILE
 };
 static const MenuNode_t configMenu = {
   .id = MENU_ID_CFG,
@@ -118,13 +143,17 @@ static const MenuNode_t configMenu = {
 
 static MenuID_t univConfigMenuChildren[] = {
   MENU_ID_CFG_UNIV_ERR,         MENU_ID_CFG_UNIV_ECCPREAMBLE, 
-  MENU_ID_CFG_UNIV_ECCMESSAGE,  MENU_ID_CFG_UNIV_MOD,      
-  MENU_ID_CFG_UNIV_FSK,         MENU_ID_CFG_UNIV_FHBFSK,  
-  MENU_ID_CFG_UNIV_BAUD,        MENU_ID_CFG_UNIV_FC,    
-  MENU_ID_CFG_UNIV_BP,          MENU_ID_CFG_UNIV_BANDWIDTH, 
+  MENU_ID_CFG_UNIV_ECCMESSAGE,  MENU_ID_CFG_UNIV_RS,
+  MENU_ID_CFG_UNIV_LDPC,        MENU_ID_CFG_UNIV_MOD,
+  MENU_ID_CFG_UNIV_FSK,         MENU_ID_CFG_UNIV_FHBFSK,
+  MENU_ID_CFG_UNIV_MFSK,        MENU_ID_CFG_UNIV_OFDM,
+  MENU_ID_CFG_UNIV_BAUD,        MENU_ID_CFG_UNIV_FC,
+  MENU_ID_CFG_UNIV_BP,          MENU_ID_CFG_UNIV_BANDWIDTH,
   MENU_ID_CFG_UNIV_INTERLEAVER, MENU_ID_CFG_UNIV_SYNC,
-  MENU_ID_CFG_UNIV_WAKEUP,      MENU_ID_CFG_UNIV_EXP,
-  MENU_ID_CFG_UNIV_IMP
+  MENU_ID_CFG_UNIV_WAKEUP,      MENU_ID_CFG_UNIV_ARQ,
+  MENU_ID_CFG_UNIV_FRAG_TIMEOUT, MENU_ID_CFG_UNIV_LINK,
+  MENU_ID_CFG_UNIV_EXP,         MENU_ID_CFG_UNIV_IMP,
+  MENU_ID_CFG_UNIV_EXP_BIN,     MENU_ID_CFG_UNIV_IMP_BIN
 };
 static const MenuNode_t univConfigMenu = {
   .id = MENU_ID_CFG_UNIV,
@@ -184,6 +213,35 @@ static const MenuNode_t dauConfigMenu = {
   .parameters = NULL
 };
 
+static MenuID_t flashConfigMenuChildren[] = {
+  MENU_ID_CFG_FLASH_DELAY, MENU_ID_CFG_FLASH_FLUSH
+};
+static const MenuNode_t flashConfigMenu = {
+  .id = MENU_ID_CFG_FLASH,
+  .description = "Parameter Saving",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG,
+  .children_ids = flashConfigMenuChildren,
+  .num_children = sizeof(flashConfigMenuChildren) / sizeof(flashConfigMenuChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
+static MenuID_t profileConfigMenuChildren[] = {
+  MENU_ID_CFG_PROFILE_LIST,  MENU_ID_CFG_PROFILE_SAVE,
+  MENU_ID_CFG_PROFILE_APPLY, MENU_ID_CFG_PROFILE_DELETE
+};
+static const MenuNode_t profileConfigMenu = {
+  .id = MENU_ID_CFG_PROFILE,
+  .description = "Configuration Profiles",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG,
+  .children_ids = profileConfigMenuChildren,
+  .num_children = sizeof(profileConfigMenuChildren) / sizeof(profileConfigMenuChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
 static MenuID_t ledConfigMenuChildren[] = {
   MENU_ID_CFG_LED_BRIGHTNESS, MENU_ID_CFG_LED_EN
 };
@@ -230,6 +288,96 @@ static const MenuNode_t setStationary = {
 
 /* Sub sub menus -------------------------------------------------------------*/
 
+static ParamContext_t flashConfigDelayParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_FLASH_DELAY
+};
+static const MenuNode_t flashConfigDelay = {
+  .id = MENU_ID_CFG_FLASH_DELAY,
+  .description = "Set Save Delay After the Last Change (ms)",
+  .handler = setFlashSaveDelay,
+  .parent_id = MENU_ID_CFG_FLASH,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &flashConfigDelayParam
+};
+
+static ParamContext_t flashConfigFlushParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_FLASH_FLUSH
+};
+static const MenuNode_t flashConfigFlush = {
+  .id = MENU_ID_CFG_FLASH_FLUSH,
+  .description = "Save Changed Parameters Now",
+  .handler = flushParameters,
+  .parent_id = MENU_ID_CFG_FLASH,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &flashConfigFlushParam
+};
+
+static ParamContext_t profileConfigListParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_PROFILE_LIST
+};
+static const MenuNode_t profileConfigList = {
+  .id = MENU_ID_CFG_PROFILE_LIST,
+  .description = "List Profiles",
+  .handler = listProfiles,
+  .parent_id = MENU_ID_CFG_PROFILE,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &profileConfigListParam
+};
+
+static ParamContext_t profileConfigSaveParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_PROFILE_SAVE
+};
+static const MenuNode_t profileConfigSave = {
+  .id = MENU_ID_CFG_PROFILE_SAVE,
+  .description = "Save Current Configuration as a Profile",
+  .handler = saveProfile,
+  .parent_id = MENU_ID_CFG_PROFILE,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &profileConfigSaveParam
+};
+
+static ParamContext_t profileConfigApplyParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_PROFILE_APPLY
+};
+static const MenuNode_t profileConfigApply = {
+  .id = MENU_ID_CFG_PROFILE_APPLY,
+  .description = "Apply a Profile",
+  .handler = applyProfile,
+  .parent_id = MENU_ID_CFG_PROFILE,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &profileConfigApplyParam
+};
+
+static ParamContext_t profileConfigDeleteParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_PROFILE_DELETE
+};
+static const MenuNode_t profileConfigDelete = {
+  .id = MENU_ID_CFG_PROFILE_DELETE,
+  .description = "Delete a Profile",
+  .handler = deleteProfile,
+  .parent_id = MENU_ID_CFG_PROFILE,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &profileConfigDeleteParam
+};
+
 static MenuID_t univConfigErrChildren[] = {
   MENU_ID_CFG_UNIV_ERR_PREAMBLE, MENU_ID_CFG_UNIV_ERR_CARGO,
   MENU_ID_CFG_UNIV_ERR_PREERR,   MENU_ID_CFG_UNIV_ERR_CARGOERR
@@ -275,6 +423,66 @@ static const MenuNode_t univConfigEccMessage = {
   .parameters = &univConfigEccMessageParam
 };
 
+// Applies to both the preamble and the message when they use Reed-Solomon
+static MenuID_t univConfigRsChildren[] = {
+  MENU_ID_CFG_UNIV_RS_N, MENU_ID_CFG_UNIV_RS_PARITY
+};
+static const MenuNode_t univConfigRsMenu = {
+  .id = MENU_ID_CFG_UNIV_RS,
+  .description = "Reed-Solomon Options",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = univConfigRsChildren,
+  .num_children = sizeof(univConfigRsChildren) / sizeof(univConfigRsChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
+// Applies to both the preamble and the message when they use LDPC
+static MenuID_t univConfigLdpcChildren[] = {
+  MENU_ID_CFG_UNIV_LDPC_RATE, MENU_ID_CFG_UNIV_LDPC_ITER
+};
+static const MenuNode_t univConfigLdpcMenu = {
+  .id = MENU_ID_CFG_UNIV_LDPC,
+  .description = "LDPC Options",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = univConfigLdpcChildren,
+  .num_children = sizeof(univConfigLdpcChildren) / sizeof(univConfigLdpcChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
+// Only applies to messages sent from the transmission/reception menu
+static MenuID_t univConfigArqChildren[] = {
+  MENU_ID_CFG_UNIV_ARQ_EN, MENU_ID_CFG_UNIV_ARQ_WINDOW
+};
+static const MenuNode_t univConfigArqMenu = {
+  .id = MENU_ID_CFG_UNIV_ARQ,
+  .description = "ARQ Link Layer Options",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = univConfigArqChildren,
+  .num_children = sizeof(univConfigArqChildren) / sizeof(univConfigArqChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
+// Only applies to the custom protocol. Both ends must have it enabled
+static MenuID_t univConfigLinkChildren[] = {
+  MENU_ID_CFG_UNIV_LINK_EN, MENU_ID_CFG_UNIV_LINK_PER
+};
+static const MenuNode_t univConfigLinkMenu = {
+  .id = MENU_ID_CFG_UNIV_LINK,
+  .description = "Link Adaptation Options",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = univConfigLinkChildren,
+  .num_children = sizeof(univConfigLinkChildren) / sizeof(univConfigLinkChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
 static ParamContext_t univConfigModParam = {
   .state = PARAM_STATE_0,
   .param_id = MENU_ID_CFG_UNIV_MOD,
@@ -319,6 +527,36 @@ static const MenuNode_t univConfigFhbskMenu = {
   .parameters = NULL
 };
 
+// Tones are placed around the center frequency using the FHBFSK frequency spacing
+static MenuID_t univConfigMfskChildren[] = {
+  MENU_ID_CFG_UNIV_MFSK_BITS
+};
+static const MenuNode_t univConfigMfskMenu = {
+  .id = MENU_ID_CFG_UNIV_MFSK,
+  .description = "MFSK Options",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = univConfigMfskChildren,
+  .num_children = sizeof(univConfigMfskChildren) / sizeof(univConfigMfskChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
+// Subcarriers are centered on fc with a fixed 234 Hz spacing
+static MenuID_t univConfigOfdmChildren[] = {
+  MENU_ID_CFG_UNIV_OFDM_SUBCARRIERS
+};
+static const MenuNode_t univConfigOfdmMenu = {
+  .id = MENU_ID_CFG_UNIV_OFDM,
+  .description = "OFDM Options",
+  .handler = NULL,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = univConfigOfdmChildren,
+  .num_children = sizeof(univConfigOfdmChildren) / sizeof(univConfigOfdmChildren[0]),
+  .access_level = 0,
+  .parameters = NULL
+};
+
 static ParamContext_t univConfigBaudParam = {
   .state = PARAM_STATE_0,
   .param_id = MENU_ID_CFG_UNIV_BAUD
@@ -454,6 +692,36 @@ static const MenuNode_t univConfigImport = {
   .parameters = &univConfigImportParam
 };
 
+static ParamContext_t univConfigExportBinParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_EXP_BIN
+};
+static const MenuNode_t univConfigExportBin = {
+  .id = MENU_ID_CFG_UNIV_EXP_BIN,
+  .description = "Export Configuration Image",
+  .handler = exportConfigImage,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univConfigExportBinParam
+};
+
+static ParamContext_t univConfigImportBinParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_IMP_BIN
+};
+static const MenuNode_t univConfigImportBin = {
+  .id = MENU_ID_CFG_UNIV_IMP_BIN,
+  .description = "Import Configuration Image",
+  .handler = importConfigImage,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univConfigImportBinParam
+};
+
 static ParamContext_t modConfigDacTransitionParam = {
   .state = PARAM_STATE_0,
   .param_id = MENU_ID_CFG_MOD_TLEN
@@ -849,6 +1117,171 @@ static const MenuNode_t univFhbfskConfigHopper = {
   .parameters = &univFhbfskConfigHopperParam
 };
 
+static ParamContext_t univMfskConfigBitsParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_MFSK_BITS
+};
+static const MenuNode_t univMfskConfigBits = {
+  .id = MENU_ID_CFG_UNIV_MFSK_BITS,
+  .description = "Set Bits per Symbol (M = 2^bits tones)",
+  .handler = setMfskBitsPerSymbol,
+  .parent_id = MENU_ID_CFG_UNIV_MFSK,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univMfskConfigBitsParam
+};
+
+static ParamContext_t univOfdmConfigSubcarriersParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_OFDM_SUBCARRIERS
+};
+static const MenuNode_t univOfdmConfigSubcarriers = {
+  .id = MENU_ID_CFG_UNIV_OFDM_SUBCARRIERS,
+  .description = "Set Number of Subcarriers (every 4th is a pilot)",
+  .handler = setOfdmNumSubcarriers,
+  .parent_id = MENU_ID_CFG_UNIV_OFDM,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univOfdmConfigSubcarriersParam
+};
+
+static ParamContext_t univRsConfigBlockLengthParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_RS_N
+};
+static const MenuNode_t univRsConfigBlockLength = {
+  .id = MENU_ID_CFG_UNIV_RS_N,
+  .description = "Set Block Length n (symbols)",
+  .handler = setRsBlockLength,
+  .parent_id = MENU_ID_CFG_UNIV_RS,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univRsConfigBlockLengthParam
+};
+
+static ParamContext_t univRsConfigParityParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_RS_PARITY
+};
+static const MenuNode_t univRsConfigParity = {
+  .id = MENU_ID_CFG_UNIV_RS_PARITY,
+  .description = "Set Parity Symbols n - k (corrects half as many)",
+  .handler = setRsParitySymbols,
+  .parent_id = MENU_ID_CFG_UNIV_RS,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univRsConfigParityParam
+};
+
+static ParamContext_t univLdpcConfigRateParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_LDPC_RATE
+};
+static const MenuNode_t univLdpcConfigRate = {
+  .id = MENU_ID_CFG_UNIV_LDPC_RATE,
+  .description = "Set Code Rate",
+  .handler = setLdpcRate,
+  .parent_id = MENU_ID_CFG_UNIV_LDPC,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univLdpcConfigRateParam
+};
+
+static ParamContext_t univLdpcConfigIterParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_LDPC_ITER
+};
+static const MenuNode_t univLdpcConfigIter = {
+  .id = MENU_ID_CFG_UNIV_LDPC_ITER,
+  .description = "Set Maximum Decoder Iterations",
+  .handler = setLdpcIterations,
+  .parent_id = MENU_ID_CFG_UNIV_LDPC,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univLdpcConfigIterParam
+};
+
+static ParamContext_t univArqConfigEnParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_ARQ_EN
+};
+static const MenuNode_t univArqConfigEn = {
+  .id = MENU_ID_CFG_UNIV_ARQ_EN,
+  .description = "Toggle ARQ",
+  .handler = toggleArq,
+  .parent_id = MENU_ID_CFG_UNIV_ARQ,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univArqConfigEnParam
+};
+
+static ParamContext_t univArqConfigWindowParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_ARQ_WINDOW
+};
+static const MenuNode_t univArqConfigWindow = {
+  .id = MENU_ID_CFG_UNIV_ARQ_WINDOW,
+  .description = "Set Window Size",
+  .handler = setArqWindow,
+  .parent_id = MENU_ID_CFG_UNIV_ARQ,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univArqConfigWindowParam
+};
+
+static ParamContext_t univLinkConfigEnParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_LINK_EN
+};
+static const MenuNode_t univLinkConfigEn = {
+  .id = MENU_ID_CFG_UNIV_LINK_EN,
+  .description = "Toggle Link Adaptation",
+  .handler = toggleLinkAdaptation,
+  .parent_id = MENU_ID_CFG_UNIV_LINK,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univLinkConfigEnParam
+};
+
+static ParamContext_t univLinkConfigPerParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_LINK_PER
+};
+static const MenuNode_t univLinkConfigPer = {
+  .id = MENU_ID_CFG_UNIV_LINK_PER,
+  .description = "Set Target Packet Error Rate (%)",
+  .handler = setLinkAdaptationPer,
+  .parent_id = MENU_ID_CFG_UNIV_LINK,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univLinkConfigPerParam
+};
+
+static ParamContext_t univConfigFragTimeoutParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_CFG_UNIV_FRAG_TIMEOUT
+};
+static const MenuNode_t univConfigFragTimeout = {
+  .id = MENU_ID_CFG_UNIV_FRAG_TIMEOUT,
+  .description = "Set Fragment Reassembly Timeout (s)",
+  .handler = setFragmentTimeout,
+  .parent_id = MENU_ID_CFG_UNIV,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &univConfigFragTimeoutParam
+};
+
 static ParamContext_t univWakeupConfigEnParam = {
   .state = PARAM_STATE_0,
   .param_id = MENU_ID_CFG_UNIV_WAKEUP_EN
@@ -1221,10 +1654,24 @@ bool COMM_RegisterConfigurationMenu()
              registerMenu(&univConfigFhbskMenu) && registerMenu(&univConfigBaud) && 
              registerMenu(&univConfigFc) && registerMenu(&univConfigBitPeriod) && 
              registerMenu(&univConfigExport) && registerMenu(&univConfigImport) && 
+             registerMenu(&univConfigExportBin) && registerMenu(&univConfigImportBin) &&
              registerMenu(&setStationary) && registerMenu(&modConfigDacTransition) &&
              registerMenu(&modConfigCalMenu) && registerMenu(&modConfigFeedbackMenu) && 
              registerMenu(&modConfigMethod) && registerMenu(&univConfigInterleaver) &&
              registerMenu(&demodConfigCalMenu) && registerMenu(&univFhbfskConfigHopper) &&
+             registerMenu(&univConfigMfskMenu) && registerMenu(&univMfskConfigBits) &&
+             registerMenu(&univConfigOfdmMenu) && registerMenu(&univOfdmConfigSubcarriers) &&
+             registerMenu(&univConfigRsMenu) && registerMenu(&univRsConfigBlockLength) &&
+             registerMenu(&univRsConfigParity) && registerMenu(&univConfigLdpcMenu) &&
+             registerMenu(&univLdpcConfigRate) && registerMenu(&univLdpcConfigIter) &&
+             registerMenu(&univConfigArqMenu) && registerMenu(&univArqConfigEn) &&
+             registerMenu(&univArqConfigWindow) && registerMenu(&univConfigFragTimeout) &&
+             registerMenu(&univConfigLinkMenu) && registerMenu(&univLinkConfigEn) &&
+             registerMenu(&univLinkConfigPer) && registerMenu(&flashConfigMenu) &&
+             registerMenu(&flashConfigDelay) && registerMenu(&flashConfigFlush) &&
+             registerMenu(&profileConfigMenu) && registerMenu(&profileConfigList) &&
+             registerMenu(&profileConfigSave) && registerMenu(&profileConfigApply) &&
+             registerMenu(&profileConfigDelete) &&
              registerMenu(&dauConfigSleep) && registerMenu(&ledConfigBrightness) &&
              registerMenu(&ledConfigToggle) && registerMenu(&modCalConfigLowFreq) &&
              registerMenu(&modCalConfigUpperFreq) && registerMenu(&modCalConfigTvr) && 
@@ -1295,7 +1742,8 @@ void cargoErrorBehavior(void* argument)
 void setPremableEcc(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
-  char* descriptors[] = {"None", "1-bit Hamming Code", "1:2 Convolutional Code (JANUS)"};
+  char* descriptors[] = {"None", "1-bit Hamming Code", "1:2 Convolutional Code (JANUS)",
+                         "Reed-Solomon", "QC-LDPC"};
 
   COMMLoops_LoopEnum(context, PARAM_ECC_PREAMBLE, descriptors,
     sizeof(descriptors) / sizeof(descriptors[0]));
@@ -1304,17 +1752,83 @@ void setPremableEcc(void* argument)
 void setMessageEcc(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
-  char* descriptors[] = {"None", "1-bit Hamming Code", "1:2 Convolutional Code (JANUS)"};
+  char* descriptors[] = {"None", "1-bit Hamming Code", "1:2 Convolutional Code (JANUS)",
+                         "Reed-Solomon", "QC-LDPC"};
 
   COMMLoops_LoopEnum(context, PARAM_ECC_MESSAGE, descriptors,
     sizeof(descriptors) / sizeof(descriptors[0]));
 }
 
+void setRsBlockLength(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_RS_BLOCK_LENGTH);
+}
+
+void setRsParitySymbols(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_RS_PARITY_SYMBOLS);
+}
+
+void setLdpcRate(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+  char* descriptors[] = {"1/2", "2/3", "3/4"};
+
+  COMMLoops_LoopEnum(context, PARAM_LDPC_RATE, descriptors,
+    sizeof(descriptors) / sizeof(descriptors[0]));
+}
+
+void setLdpcIterations(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_LDPC_MAX_ITERATIONS);
+}
+
+void toggleArq(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopToggle(context, PARAM_ARQ_ENABLED);
+}
+
+void setArqWindow(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_ARQ_WINDOW);
+}
+
+void setFragmentTimeout(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint16(context, PARAM_FRAGMENT_TIMEOUT);
+}
+
+void toggleLinkAdaptation(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopToggle(context, PARAM_LINK_ADAPT);
+}
+
+void setLinkAdaptationPer(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_LINK_ADAPT_PER_TARGET);
+}
+
 void setModulationMethod(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
 
-  char* descriptors[] = {"FSK", "FHBFSK"};
+  char* descriptors[] = {"FSK", "FHBFSK", "MFSK", "DBPSK", "DQPSK", "OFDM"};
   
   COMMLoops_LoopEnum(context, PARAM_MOD_DEMOD_METHOD, descriptors, 
     sizeof(descriptors) / sizeof(descriptors[0]));
@@ -1366,6 +1880,20 @@ void setFhbfskHopper(void* argument)
       sizeof(descriptors) / sizeof(descriptors[0]));
 }
 
+void setMfskBitsPerSymbol(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_MFSK_BITS_PER_SYMBOL);
+}
+
+void setOfdmNumSubcarriers(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint8(context, PARAM_OFDM_NUM_SUBCARRIERS);
+}
+
 void toggleWakeupTones(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
@@ -1567,6 +2095,22 @@ void importConfiOptions(void* argument)
   ImportExport_ImportConfiguration(context);
 }
 
+void exportConfigImage(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  if (ImportExport_ExportBinary(context) == false) {
+    COMM_TransmitData("\r\nInternal Error!\r\n", CALC_LEN, context->comm_interface);
+  }
+}
+
+void importConfigImage(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  ImportExport_ImportBinary(context);
+}
+
 void setDacTransitionDuration(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
@@ -1833,3 +2377,176 @@ void setStationaryFlag(void* argument)
 
   COMMLoops_LoopToggle(context, PARAM_STATIONARY_FLAG);
 }
+
+void setFlashSaveDelay(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  COMMLoops_LoopUint16(context, PARAM_FLASH_SAVE_DELAY);
+}
+
+void flushParameters(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  uint16_t pending = Param_NumModified();
+  if (CFG_FlushParameters(CFG_FLUSH_TIMEOUT_MS) == true) {
+    sprintf((char*) context->output_buffer, "\r\n%u changed parameter(s) saved\r\n",
+            pending);
+  }
+  else {
+    sprintf((char*) context->output_buffer, "\r\nFailed to save %u changed "
+            "parameter(s)\r\n", pending);
+  }
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void listProfiles(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  printProfiles(context);
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void saveProfile(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  switch (context->state->state) {
+    case PARAM_STATE_0:
+      printProfiles(context);
+      sprintf((char*) context->output_buffer, "\r\nEnter the slot (1-%u) and a name "
+              "of up to %u characters, e.g. \"1 janus\": ", PROFILE_NUM_SLOTS,
+              PROFILE_NAME_LEN - 1);
+      COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      context->state->state = PARAM_STATE_1;
+      break;
+    case PARAM_STATE_1: {
+      context->input[context->input_len] = '\0';
+      char* name = strchr(context->input, ' ');
+      uint8_t slot;
+      if (name == NULL ||
+          checkUint8(context->input, name - context->input, &slot, 1, PROFILE_NUM_SLOTS) == false) {
+        COMM_TransmitData("\r\nInvalid Input: Expected a slot number and a name\r\n",
+                          CALC_LEN, context->comm_interface);
+        context->state->state = PARAM_STATE_COMPLETE;
+        break;
+      }
+      while (*name == ' ') {
+        name++;
+      }
+      if (Profile_Save(slot - 1, name) == true &&
+          CFG_FlushParameters(CFG_FLUSH_TIMEOUT_MS) == true) {
+        sprintf((char*) context->output_buffer, "\r\nProfile %u saved\r\n", slot);
+      }
+      else {
+        sprintf((char*) context->output_buffer, "\r\nFailed to save profile %u\r\n", slot);
+      }
+      COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      context->state->state = PARAM_STATE_COMPLETE;
+      break;
+    }
+    default:
+      context->state->state = PARAM_STATE_COMPLETE;
+      break;
+  }
+}
+
+void applyProfile(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  switch (context->state->state) {
+    case PARAM_STATE_0:
+      printProfiles(context);
+      COMM_TransmitData("\r\nEnter the slot or name of the profile to apply: ",
+                        CALC_LEN, context->comm_interface);
+      context->state->state = PARAM_STATE_1;
+      break;
+    case PARAM_STATE_1: {
+      uint8_t slot;
+      if (parseProfileSlot(context, &slot) == false) {
+        COMM_TransmitData("\r\nInvalid Input: No such profile\r\n", CALC_LEN,
+                          context->comm_interface);
+      }
+      else if (Profile_Apply(slot) == true) {
+        sprintf((char*) context->output_buffer, "\r\nProfile %u applied\r\n", slot + 1);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      }
+      else {
+        sprintf((char*) context->output_buffer, "\r\nFailed to apply profile %u. "
+                "The configuration was not changed\r\n", slot + 1);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      }
+      context->state->state = PARAM_STATE_COMPLETE;
+      break;
+    }
+    default:
+      context->state->state = PARAM_STATE_COMPLETE;
+      break;
+  }
+}
+
+void deleteProfile(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  switch (context->state->state) {
+    case PARAM_STATE_0:
+      printProfiles(context);
+      COMM_TransmitData("\r\nEnter the slot or name of the profile to delete: ",
+                        CALC_LEN, context->comm_interface);
+      context->state->state = PARAM_STATE_1;
+      break;
+    case PARAM_STATE_1: {
+      uint8_t slot;
+      if (parseProfileSlot(context, &slot) == false) {
+        COMM_TransmitData("\r\nInvalid Input: No such profile\r\n", CALC_LEN,
+                          context->comm_interface);
+      }
+      else if (Profile_Delete(slot) == true &&
+               CFG_FlushParameters(CFG_FLUSH_TIMEOUT_MS) == true) {
+        sprintf((char*) context->output_buffer, "\r\nProfile %u deleted\r\n", slot + 1);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      }
+      else {
+        sprintf((char*) context->output_buffer, "\r\nFailed to delete profile %u\r\n",
+                slot + 1);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+      }
+      context->state->state = PARAM_STATE_COMPLETE;
+      break;
+    }
+    default:
+      context->state->state = PARAM_STATE_COMPLETE;
+      break;
+  }
+}
+
+static void printProfiles(FunctionContext_t* context)
+{
+  COMM_TransmitData("\r\nStored profiles:", CALC_LEN, context->comm_interface);
+  for (uint8_t i = 0; i < PROFILE_NUM_SLOTS; i++) {
+    char name[PROFILE_NAME_LEN];
+    if (Profile_GetName(i, name) == true) {
+      sprintf((char*) context->output_buffer, "\r\n\t%u: %s", i + 1, name);
+    }
+    else {
+      sprintf((char*) context->output_buffer, "\r\n\t%u: (empty)", i + 1);
+    }
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+  COMM_TransmitData("\r\n", CALC_LEN, context->comm_interface);
+}
+
+static bool parseProfileSlot(FunctionContext_t* context, uint8_t* slot)
+{
+  context->input[context->input_len] = '\0';
+  if (checkUint8(context->input, context->input_len, slot, 1, PROFILE_NUM_SLOTS) == true) {
+    *slot -= 1;
+    return Profile_IsValid(*slot);
+  }
+  return Profile_FindByName(context->input, slot);
+}
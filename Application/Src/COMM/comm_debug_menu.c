@@ -13,17 +13,26 @@
 #include "comm_main.h"
 
 #include "cfg_parameters.h"
+#include "cfg_main.h"
 
 #include "sys_temperature.h"
+#include "sys_power.h"
 #include "sys_led.h"
 #include "sys_main.h"
+#include "sys_cpu_load.h"
+#include "sys_trace.h"
+#include "sys_memory.h"
 
 #include "check_inputs.h"
 
+#include "dau_card-driver.h"
+
 #include "mess_main.h"
 #include "mess_modulate.h"
 #include "mess_packet.h"
 #include "mess_background_noise.h"
+#include "mess_replay.h"
+#include "mess_link_adapt.h"
 
 #include "cmsis_os.h"
 #include "main.h"
@@ -60,6 +69,13 @@ void printBackgroundNoise(void* argument);
 void enterDfuMode(void* argument);
 void resetSavedValues(void* argument);
 void deepSleep(void* argument);
+void replayCapture(void* argument);
+void printLinkTable(void* argument);
+void printCpuLoad(void* argument);
+void sendCpuLoadRecord(void* argument);
+void dumpEventTrace(void* argument);
+void printMemoryUsage(void* argument);
+void printUartStats(void* argument);
 
 /* Private variables ---------------------------------------------------------*/
 
@@ -70,7 +86,11 @@ static MenuID_t debugMenuChildren[] = {MENU_ID_DBG_GPIO, MENU_ID_DBG_SETLED,
                                        MENU_ID_DBG_BGFREQ, MENU_ID_DBG_TEMP, 
                                        MENU_ID_DBG_ERR, MENU_ID_DBG_PWR, 
                                        MENU_ID_DBG_NOISE, MENU_ID_DBG_DFU, 
-                                       MENU_ID_DBG_RESETCONFIG, MENU_ID_DBG_DEEPSLEEP};
+                                       MENU_ID_DBG_RESETCONFIG, MENU_ID_DBG_DEEPSLEEP,
+                                       MENU_ID_DBG_REPLAY, MENU_ID_DBG_LINK,
+                                       MENU_ID_DBG_CPU, MENU_ID_DBG_CPU_RECORD,
+                                       MENU_ID_DBG_TRACE, MENU_ID_DBG_MEMORY,
+                                       MENU_ID_DBG_UART};
 static const MenuNode_t debugMenu = {
   .id = MENU_ID_DBG,
   .description = "Debug Menu",
@@ -262,6 +282,111 @@ static const MenuNode_t debugMenuDeepSleep = {
   .parameters = &debugMenuDeepSleepParam
 };
 
+static ParamContext_t debugMenuReplayParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_REPLAY
+};
+static const MenuNode_t debugMenuReplay = {
+  .id = MENU_ID_DBG_REPLAY,
+  .description = "Replay a recorded ADC capture streamed over USB",
+  .handler = replayCapture,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuReplayParam
+};
+
+static ParamContext_t debugMenuLinkParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_LINK
+};
+static const MenuNode_t debugMenuLink = {
+  .id = MENU_ID_DBG_LINK,
+  .description = "Print the link adaptation rate table",
+  .handler = printLinkTable,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuLinkParam
+};
+
+static ParamContext_t debugMenuCpuParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_CPU
+};
+static const MenuNode_t debugMenuCpu = {
+  .id = MENU_ID_DBG_CPU,
+  .description = "Print the CPU load of each task and MESS state",
+  .handler = printCpuLoad,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuCpuParam
+};
+
+static ParamContext_t debugMenuCpuRecordParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_CPU_RECORD
+};
+static const MenuNode_t debugMenuCpuRecord = {
+  .id = MENU_ID_DBG_CPU_RECORD,
+  .description = "Send the CPU load statistics as a binary record",
+  .handler = sendCpuLoadRecord,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuCpuRecordParam
+};
+
+static ParamContext_t debugMenuTraceParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_TRACE
+};
+static const MenuNode_t debugMenuTrace = {
+  .id = MENU_ID_DBG_TRACE,
+  .description = "Dump the event trace and restart it",
+  .handler = dumpEventTrace,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuTraceParam
+};
+
+static ParamContext_t debugMenuMemoryParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_MEMORY
+};
+static const MenuNode_t debugMenuMemory = {
+  .id = MENU_ID_DBG_MEMORY,
+  .description = "Print the stack, heap, and static RAM usage",
+  .handler = printMemoryUsage,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuMemoryParam
+};
+
+static ParamContext_t debugMenuUartParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_DBG_UART
+};
+static const MenuNode_t debugMenuUart = {
+  .id = MENU_ID_DBG_UART,
+  .description = "Print the daughter card UART statistics",
+  .handler = printUartStats,
+  .parent_id = MENU_ID_DBG,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &debugMenuUartParam
+};
+
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -273,7 +398,10 @@ bool COMM_RegisterDebugMenu(void)
              registerMenu(&debugMenuErr) && registerMenu(&debugMenuPwr) &&
              registerMenu(&debugMenuDfu) && registerMenu(&debugMenuReset) &&
              registerMenu(&debugMenuNoiseF) && registerMenu(&debugMenuNoiseLevel) &&
-             registerMenu(&debugMenuDeepSleep);
+             registerMenu(&debugMenuDeepSleep) && registerMenu(&debugMenuReplay) &&
+             registerMenu(&debugMenuLink) && registerMenu(&debugMenuCpu) &&
+             registerMenu(&debugMenuCpuRecord) && registerMenu(&debugMenuTrace) &&
+             registerMenu(&debugMenuMemory) && registerMenu(&debugMenuUart);
   return ret;
 }
 
@@ -435,12 +563,21 @@ void printCurrentErrors(void* argument)
   COMMLoops_NotImplemented(context);
 }
 
-// TODO: implement
 void printCurrentPowerConsumption(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
   
-  COMMLoops_NotImplemented(context);
+  float voltage_v;
+  float current_a;
+  uint32_t dropped;
+  Power_GetLatestReading(&voltage_v, &current_a);
+  uint32_t samples = Power_GetSampleCount(&dropped);
+
+  sprintf((char*) context->output_buffer, "\r\nCurrent power: %.3f W "
+          "(%.3f V, %.1f mA)\r\nReadings: %lu, dropped: %lu\r\n",
+          Power_GetCurrent(), voltage_v, current_a * 1000.0f, samples, dropped);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
 }
 
 void printBackgroundNoise(void* argument)
@@ -507,6 +644,8 @@ void enterDfuMode(void* argument)
 {
   (void)(argument);
 
+  CFG_FlushParameters(CFG_FLUSH_TIMEOUT_MS);
+
   // write magic number to magic address. See startup code for corresponding check
   *((uint32_t*) 0x38000000) = 0xABCDABCD;
 
@@ -524,3 +663,229 @@ void deepSleep(void* argument)
 
   context->state->state = PARAM_STATE_COMPLETE;
 }
+
+void replayCapture(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  ParamState_t old_state = context->state->state;
+
+  do {
+    switch (context->state->state) {
+      case PARAM_STATE_0:
+        sprintf((char*) context->output_buffer, "\r\nEnter the number of "
+            "samples to replay (1-%lu)\r\n", (uint32_t) REPLAY_MAX_SAMPLES);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+        context->state->state = PARAM_STATE_1;
+        break;
+      case PARAM_STATE_1:
+        uint32_t num_samples;
+        if (checkUint32(context->input, context->input_len, &num_samples, 1,
+            REPLAY_MAX_SAMPLES) == false) {
+          COMM_TransmitData("\r\nInvalid input!\r\n", CALC_LEN, context->comm_interface);
+          context->state->state = PARAM_STATE_0;
+          break;
+        }
+
+        if (context->comm_interface != COMM_USB) {
+          COMM_TransmitData("\r\nReplay is only supported over USB\r\n",
+              CALC_LEN, context->comm_interface);
+          context->state->state = PARAM_STATE_COMPLETE;
+          break;
+        }
+
+        // Flow control, the host timeout and the final report are handled by
+        // the COMM task loop so received messages keep being printed
+        Replay_Start(num_samples);
+        COMM_TransmitData("\r\nREPLAY_READY\r\n", CALC_LEN, context->comm_interface);
+
+        context->state->state = PARAM_STATE_COMPLETE;
+        break;
+      default:
+        context->state->state = PARAM_STATE_COMPLETE;
+        break;
+    }
+  } while (old_state > context->state->state);
+}
+
+void printLinkTable(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  sprintf((char*) context->output_buffer, "\r\nLast message sent with the %s "
+      "cargo ECC\r\nID  SNR (dB)  Offset (dB)  Packets  Failures  Last profile  "
+      "Age (s)\r\n", LinkAdapt_ProfileName(LinkAdapt_LastTxProfile()));
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+
+  uint32_t now = osKernelGetTickCount();
+  bool any_peer = false;
+  for (uint8_t i = 0; i < LINK_ADAPT_MAX_PEERS; i++) {
+    LinkPeer_t peer;
+    if (LinkAdapt_GetPeer(i, &peer) == false) {
+      continue;
+    }
+    any_peer = true;
+    sprintf((char*) context->output_buffer, "%2u  %8.1f  %11.1f  %7u  %8u  %12s  %7lu\r\n",
+        i, peer.snr_db, peer.offset_db, peer.packets, peer.failures,
+        LinkAdapt_ProfileName(peer.last_profile), (now - peer.last_tick) / 1000);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+  if (any_peer == false) {
+    COMM_TransmitData("No peers heard with link adaptation enabled\r\n",
+        CALC_LEN, context->comm_interface);
+  }
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void printCpuLoad(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  static const char* state_names[CPU_LOAD_NUM_MESS_STATES] = {
+      "MESS driving", "MESS listening", "MESS processing", "MESS changing"};
+
+  sprintf((char*) context->output_buffer, "\r\nCPU load (%%)    %5us  %5us  %5us\r\n"
+      "Busy            %6.1f  %6.1f  %6.1f\r\n",
+      CpuLoad_WindowSeconds(CPU_LOAD_WINDOW_1S), CpuLoad_WindowSeconds(CPU_LOAD_WINDOW_10S),
+      CpuLoad_WindowSeconds(CPU_LOAD_WINDOW_60S),
+      CpuLoad_BusyPermille(CPU_LOAD_WINDOW_1S) / 10.0f,
+      CpuLoad_BusyPermille(CPU_LOAD_WINDOW_10S) / 10.0f,
+      CpuLoad_BusyPermille(CPU_LOAD_WINDOW_60S) / 10.0f);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+
+  for (uint8_t i = 0; i < CpuLoad_NumTasks(); i++) {
+    sprintf((char*) context->output_buffer, "%-15s %6.1f  %6.1f  %6.1f\r\n",
+        CpuLoad_TaskName(i),
+        CpuLoad_TaskPermille(i, CPU_LOAD_WINDOW_1S) / 10.0f,
+        CpuLoad_TaskPermille(i, CPU_LOAD_WINDOW_10S) / 10.0f,
+        CpuLoad_TaskPermille(i, CPU_LOAD_WINDOW_60S) / 10.0f);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+  for (uint8_t i = 0; i < CPU_LOAD_NUM_MESS_STATES; i++) {
+    sprintf((char*) context->output_buffer, "%-15s %6.1f  %6.1f  %6.1f\r\n",
+        state_names[i],
+        CpuLoad_MessStatePermille(i, CPU_LOAD_WINDOW_1S) / 10.0f,
+        CpuLoad_MessStatePermille(i, CPU_LOAD_WINDOW_10S) / 10.0f,
+        CpuLoad_MessStatePermille(i, CPU_LOAD_WINDOW_60S) / 10.0f);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void sendCpuLoadRecord(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  static uint8_t record[MAX_COMM_OUT_BUFFER_SIZE];
+  uint16_t length = CpuLoad_PackRecord(record, sizeof(record));
+
+  // Text header so the host knows how many binary bytes follow
+  sprintf((char*) context->output_buffer, "CPU_RECORD,%u\r\n", length);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  if (length > 0) {
+    COMM_TransmitData(record, length, context->comm_interface);
+  }
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void dumpEventTrace(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  static TaskStatus_t tasks[CPU_LOAD_MAX_TASKS + 2];
+  static TraceRecord_t records[MAX_COMM_OUT_BUFFER_SIZE / sizeof(TraceRecord_t)];
+
+  bool faulted = Trace_IsFaulted();
+  uint32_t num_records = Trace_Freeze();
+
+  // Task numbers of the context switch records
+  UBaseType_t num_tasks = uxTaskGetSystemState(tasks, sizeof(tasks) / sizeof(tasks[0]), NULL);
+  for (UBaseType_t i = 0; i < num_tasks; i++) {
+    sprintf((char*) context->output_buffer, "TRACE_TASK,%lu,%s,%lu\r\n",
+        tasks[i].xTaskNumber, tasks[i].pcTaskName, tasks[i].uxCurrentPriority);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+
+  // Text header so the host knows how many binary records follow
+  sprintf((char*) context->output_buffer, "TRACE_DUMP,%lu,%u,%lu,%u\r\n", num_records,
+      sizeof(TraceRecord_t), SystemCoreClock, faulted);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+
+  uint32_t sent = 0;
+  while (sent < num_records) {
+    uint32_t count = Trace_CopyRecords(sent, records, sizeof(records) / sizeof(records[0]));
+    if (count == 0) {
+      break;
+    }
+    COMM_TransmitData(records, count * sizeof(TraceRecord_t), context->comm_interface);
+    sent += count;
+  }
+  COMM_TransmitData("TRACE_END\r\n", CALC_LEN, context->comm_interface);
+
+  Trace_Restart();
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void printMemoryUsage(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  static MemoryTaskUsage_t tasks[MEMORY_MAX_TASKS];
+  uint8_t num_tasks = Memory_GetTaskUsage(tasks, MEMORY_MAX_TASKS);
+
+  COMM_TransmitData("\r\nTask            Stack (B)  Min free (B)  Peak use (%)\r\n",
+      CALC_LEN, context->comm_interface);
+  for (uint8_t i = 0; i < num_tasks; i++) {
+    if (tasks[i].stack_bytes == 0) {
+      sprintf((char*) context->output_buffer, "%-15s  %9s  %12lu  %12s\r\n",
+          tasks[i].name, "?", tasks[i].min_free_bytes, "?");
+    }
+    else {
+      sprintf((char*) context->output_buffer, "%-15s  %9lu  %12lu  %12.1f\r\n",
+          tasks[i].name, tasks[i].stack_bytes, tasks[i].min_free_bytes,
+          100.0f * (tasks[i].stack_bytes - tasks[i].min_free_bytes) / tasks[i].stack_bytes);
+    }
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+
+  MemoryHeapUsage_t heap;
+  Memory_GetHeapUsage(&heap);
+  sprintf((char*) context->output_buffer, "\r\nRTOS heap: %lu B, %lu B free, "
+      "%lu B minimum ever free\r\n", heap.size_bytes, heap.free_bytes,
+      heap.min_free_bytes);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+
+  MemoryRegionUsage_t regions[4];
+  uint8_t num_regions = Memory_GetRegionUsage(regions, sizeof(regions) / sizeof(regions[0]));
+  for (uint8_t i = 0; i < num_regions; i++) {
+    sprintf((char*) context->output_buffer, "%-16s %7lu / %7lu B static\r\n",
+        regions[i].name, regions[i].used_bytes, regions[i].size_bytes);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void printUartStats(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  DauTxStats_t stats;
+  DAU_GetTxStats(&stats);
+
+  sprintf((char*) context->output_buffer, "\r\nDaughter card transmit:\r\n"
+      "Queued: %lu B\r\nSent: %lu B\r\nMost waiting: %lu B\r\n"
+      "Writes that waited for space: %lu\r\n"
+      "Dropped: %lu writes, %lu B\r\nErrors: %lu\r\n",
+      stats.queued_bytes, stats.sent_bytes, stats.max_used, stats.back_pressure,
+      stats.dropped_messages, stats.dropped_bytes, stats.errors);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+
+  DauRxStats_t rx_stats;
+  DAU_GetRxStats(&rx_stats);
+
+  sprintf((char*) context->output_buffer, "\r\nDaughter card receive:\r\n"
+      "Received: %lu B\r\nOverruns: %lu\r\nErrors: %lu\r\n",
+      rx_stats.received_bytes, rx_stats.overruns, rx_stats.errors);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
+}
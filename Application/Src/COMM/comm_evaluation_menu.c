@@ -14,6 +14,7 @@
 #include "mess_main.h"
 #include "mess_evaluate.h"
 #include "mess_packet.h"
+#include "mess_golden_vectors.h"
 
 #include "cfg_parameters.h"
 
@@ -41,6 +42,9 @@ void setEvalMsgLen(void* argument);
 void sendEvalFeedback(void* argument);
 void sendEvalTransducer(void* argument);
 void startFeedbackTests(void* argument);
+void startSnrSweep(void* argument);
+void checkGoldenVectors(void* argument);
+void startArqTest(void* argument);
 
 void sendEvalMessage(FunctionContext_t* context, Message_t* msg);
 
@@ -48,7 +52,9 @@ void sendEvalMessage(FunctionContext_t* context, Message_t* msg);
 
 static MenuID_t evalMenuChildren[] = {
   MENU_ID_EVAL_SETLEN,      MENU_ID_EVAL_FEEDBACK, 
-  MENU_ID_EVAL_TRANSDUCER,  MENU_ID_EVAL_FEEDBACKTESTS
+  MENU_ID_EVAL_TRANSDUCER,  MENU_ID_EVAL_FEEDBACKTESTS,
+  MENU_ID_EVAL_SNRSWEEP,      MENU_ID_EVAL_GOLDEN,
+  MENU_ID_EVAL_ARQ
 };
 
 static const MenuNode_t evalMenu = {
@@ -122,13 +128,60 @@ static const MenuNode_t feedbackTests = {
   .parameters = &feedbackTestsParam
 };
 
+static ParamContext_t snrSweepParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_EVAL_SNRSWEEP
+};
+static const MenuNode_t snrSweep = {
+  .id = MENU_ID_EVAL_SNRSWEEP,
+  .description = "Perform BER/PER versus SNR sweep through feedback network",
+  .handler = startSnrSweep,
+  .parent_id = MENU_ID_EVAL,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &snrSweepParam
+};
+
+static ParamContext_t goldenVectorsParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_EVAL_GOLDEN
+};
+static const MenuNode_t goldenVectors = {
+  .id = MENU_ID_EVAL_GOLDEN,
+  .description = "Check transmit chain against golden vectors",
+  .handler = checkGoldenVectors,
+  .parent_id = MENU_ID_EVAL,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &goldenVectorsParam
+};
+
+static ParamContext_t arqTestParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_EVAL_ARQ
+};
+static const MenuNode_t arqTest = {
+  .id = MENU_ID_EVAL_ARQ,
+  .description = "Perform ARQ loopback test through feedback network",
+  .handler = startArqTest,
+  .parent_id = MENU_ID_EVAL,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &arqTestParam
+};
+
 /* Exported function definitions ---------------------------------------------*/
 
 bool COMM_RegisterEvalMenu(void)
 {
   bool ret = registerMenu(&evalMenu) && 
              registerMenu(&evalSetMsgLen) && registerMenu(&evalFeedback) &&
-             registerMenu(&evalTransducer) && registerMenu(&feedbackTests);
+             registerMenu(&evalTransducer) && registerMenu(&feedbackTests) &&
+             registerMenu(&snrSweep) && registerMenu(&goldenVectors) &&
+             registerMenu(&arqTest);
   return ret;
 }
 
@@ -169,6 +222,70 @@ void startFeedbackTests(void* argument)
   context->state->state = PARAM_STATE_COMPLETE;
 }
 
+void startSnrSweep(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  osEventFlagsSet(print_event_handle, MESS_SNR_SWEEP);
+
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void startArqTest(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  osEventFlagsSet(print_event_handle, MESS_ARQ_TEST);
+
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void checkGoldenVectors(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  ParamState_t old_state = context->state->state;
+
+  do {
+    switch (context->state->state) {
+      case PARAM_STATE_0:
+        COMM_TransmitData("\r\nRecord new reference values instead of verifying? (y/n)\r\n",
+            CALC_LEN, context->comm_interface);
+        context->state->state = PARAM_STATE_1;
+        break;
+      case PARAM_STATE_1:
+        bool record;
+        if (checkYesNo(*context->input, &record) == false) {
+          COMM_TransmitData("\r\nInvalid input!\r\n", CALC_LEN, context->comm_interface);
+          context->state->state = PARAM_STATE_0;
+          break;
+        }
+        if (print_event_handle == NULL) {
+          context->state->state = PARAM_STATE_COMPLETE;
+          break;
+        }
+        COMM_TransmitData("\r\n", CALC_LEN, context->comm_interface);
+        GoldenVectors_SetRecordMode(record);
+        osEventFlagsSet(print_event_handle, MESS_GOLDEN_VECTORS);
+        uint32_t flags;
+
+        do {
+          // Waits for the MESS task to finish printing the results
+          flags = osEventFlagsWait(print_event_handle, MESS_PRINT_COMPLETE, osFlagsNoClear, osWaitForever);
+          osDelay(1);
+        } while ((flags & MESS_PRINT_COMPLETE) != MESS_PRINT_COMPLETE);
+
+        osEventFlagsClear(print_event_handle, MESS_PRINT_COMPLETE);
+
+        context->state->state = PARAM_STATE_COMPLETE;
+        break;
+      default:
+        context->state->state = PARAM_STATE_COMPLETE;
+        break;
+    }
+  } while (old_state > context->state->state);
+}
+
 void sendEvalMessage(FunctionContext_t* context, Message_t* msg)
 {
   msg->timestamp = osKernelGetTickCount();
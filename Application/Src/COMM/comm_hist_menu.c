@@ -11,6 +11,7 @@
 #include "comm_menu_system.h"
 #include "comm_function_loops.h"
 #include "sys_temperature.h"
+#include "sys_power.h"
 #include <stdio.h>
 #include <stdbool.h>
 
@@ -35,6 +36,7 @@ void printPeakPwr(void* argument);
 void printPwrSinceBoot(void* argument);
 void printAvgPwr(void* argument);
 void printCurrPwr(void* argument);
+void printEnergyPerBit(void* argument);
 void printCurrTemp(void* argument);
 void printPeakTemp(void* argument);
 void printAvgTemp(void* argument);
@@ -58,7 +60,8 @@ static const MenuNode_t histMenu = {
 
 static MenuID_t pwrHistMenuChildren[] = {
   MENU_ID_HIST_PWR_PEAK,  MENU_ID_HIST_PWR_BOOT,
-  MENU_ID_HIST_PWR_AVG,   MENU_ID_HIST_PWR_CURR
+  MENU_ID_HIST_PWR_AVG,   MENU_ID_HIST_PWR_CURR,
+  MENU_ID_HIST_PWR_ENERGY
 };
 static const MenuNode_t pwrHistMenu = {
   .id = MENU_ID_HIST_PWR,
@@ -190,6 +193,21 @@ static const MenuNode_t currPwrHist = {
   .parameters = &currPwrHistParam
 };
 
+static ParamContext_t energyPwrHistParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_HIST_PWR_ENERGY
+};
+static const MenuNode_t energyPwrHist = {
+  .id = MENU_ID_HIST_PWR_ENERGY,
+  .description = "Energy per State and per Bit",
+  .handler = printEnergyPerBit,
+  .parent_id = MENU_ID_HIST_PWR,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &energyPwrHistParam
+};
+
 static ParamContext_t currTempHistParam = {
   .state = PARAM_STATE_0,
   .param_id = MENU_ID_HIST_TEMP_CURR
@@ -246,6 +264,7 @@ bool COMM_RegisterHistoryMenu()
              registerMenu(&sentHist) && registerMenu(&errHist) &&
              registerMenu(&peakPwrHist) && registerMenu(&bootPwrHist) &&
              registerMenu(&avgPwrHist) && registerMenu(&currPwrHist) &&
+             registerMenu(&energyPwrHist) &&
              registerMenu(&currTempHist) && registerMenu(&peakTempHist) &&
              registerMenu(&avgTempHist);
   return ret;
@@ -277,36 +296,96 @@ void printErrorLog(void* argument)
   COMMLoops_NotImplemented(context);
 }
 
-// TODO: implement
 void printPeakPwr(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
   
-  COMMLoops_NotImplemented(context);
+  float power = Power_GetPeak();
+
+  sprintf((char*) context->output_buffer, "\r\nPeak power: %.3f W\r\n",
+          power);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
 }
 
-// TODO: implement
 void printPwrSinceBoot(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
   
-  COMMLoops_NotImplemented(context);
+  float energy = Power_GetEnergy();
+
+  sprintf((char*) context->output_buffer, "\r\nEnergy since startup: %.3f J "
+          "(%.4f Wh)\r\n", energy, energy / 3600.0f);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
 }
 
-// TODO: implement
 void printAvgPwr(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
   
-  COMMLoops_NotImplemented(context);
+  float power = Power_GetAverage();
+  float std_dev = Power_GetStdDev();
+
+  sprintf((char*) context->output_buffer, "\r\nAverage power: %.3f W "
+          "(std dev %.3f W)\r\n", power, std_dev);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
 }
 
-// TODO: implement
 void printCurrPwr(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
   
-  COMMLoops_NotImplemented(context);
+  float power = Power_GetCurrent();
+
+  sprintf((char*) context->output_buffer, "\r\nCurrent power: %.3f W\r\n",
+          power);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
+}
+
+void printEnergyPerBit(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+  
+  static const char* state_names[POWER_NUM_MESS_STATES] = {
+    "Transmitting", "Listening", "Processing", "Changing"
+  };
+  static const char* packet_names[NUM_POWER_PACKET_TYPES] = {"TX", "RX"};
+
+  sprintf((char*) context->output_buffer, "\r\nState         Time (s)  Energy (J)  Avg (W)\r\n");
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  for (uint8_t i = 0; i < POWER_NUM_MESS_STATES; i++) {
+    float time_s;
+    float energy = Power_GetStateEnergy((ProcessingState_t) i, &time_s);
+    float average = (time_s > 0.0f) ? energy / time_s : 0.0f;
+    sprintf((char*) context->output_buffer, "%-12s  %8.1f  %10.3f  %7.3f\r\n",
+            state_names[i], time_s, energy, average);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+
+  for (uint8_t i = 0; i < NUM_POWER_PACKET_TYPES; i++) {
+    PowerPacketStats_t stats;
+    Power_GetPacketStats((PowerPacket_t) i, &stats);
+    float per_bit = (stats.delivered_bits > 0) ?
+                    stats.energy_j / stats.delivered_bits : 0.0f;
+    sprintf((char*) context->output_buffer, "%s: %lu packets, %lu of %lu bits "
+            "delivered, last packet %.4f J, %.3e J/bit\r\n", packet_names[i],
+            stats.packets, stats.delivered_bits, stats.bits,
+            stats.last_packet_energy_j, per_bit);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  }
+
+  // Everything the modem spent, listening included, per bit received intact
+  PowerPacketStats_t rx_stats;
+  Power_GetPacketStats(POWER_PACKET_RX, &rx_stats);
+  float system_per_bit = (rx_stats.delivered_bits > 0) ?
+                         Power_GetEnergy() / rx_stats.delivered_bits : 0.0f;
+  sprintf((char*) context->output_buffer, "Total: %.3f J, %.3e J per delivered "
+          "bit\r\n", Power_GetEnergy(), system_per_bit);
+  COMM_TransmitData(context->output_buffer, CALC_LEN, context->comm_interface);
+  context->state->state = PARAM_STATE_COMPLETE;
 }
 
 void printCurrTemp(void* argument)
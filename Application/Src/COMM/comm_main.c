@@ -20,6 +20,9 @@
 
 #include "mess_main.h"
 #include "mess_evaluate.h"
+#include "mess_fragment.h"
+#include "mess_replay.h"
+#include "mess_adc.h"
 
 #include "sys_error.h"
 
@@ -43,6 +46,11 @@ typedef struct {
 #define BUFFER_BACK_TRACK_AMOUNT  5
 #define LEN_RESET                 32451
 
+// Received messages from MESS are polled. Input wakes the task immediately
+#define COMM_POLL_PERIOD_MS       10
+// USB reception paused by a full replay buffer is resumed at this period
+#define REPLAY_POLL_PERIOD_MS     1
+
 /* Private macro -------------------------------------------------------------*/
 
 #define MIN(a, b)                 (((a) < (b)) ? (a) : (b))
@@ -55,6 +63,10 @@ uint8_t out_buffer[MAX_COMM_OUT_BUFFER_SIZE];
 
 static bool print_received_messages = DEFAULT_PRINT_ENABLED;
 
+static bool replay_running = false;
+
+extern osThreadId_t commTaskHandle;
+
 /* Private function prototypes -----------------------------------------------*/
 
 static void displaySubMenus(void);
@@ -80,8 +92,10 @@ static void printBitsData(Message_t* msg);
 static void printInteger(Message_t* msg);
 static void printFloat(Message_t* msg);
 static void printEvalMessage(Message_t* msg);
+static void printFragmentTransfer(Message_t* msg);
 
 static bool registerCommParams(void);
+static void serviceReplay(void);
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -143,6 +157,8 @@ void COMM_StartTask(void *argument)
     Message_t rx_msg;
     if (MESS_GetMessageFromRxQ(&rx_msg) == pdPASS) {
       printReceivedMessage(&rx_msg);
+      // Frees the reassembly buffer even if printing is disabled
+      Fragment_Release(&rx_msg);
     }
 
     RxState_t state = USB_GetMessage(msg_buffer, &msg_buf_len);
@@ -217,7 +233,13 @@ void COMM_StartTask(void *argument)
       default:
         break;
     }
-    osDelay(10);
+    serviceReplay();
+
+    // Input left over from the last message is handled without waiting
+    if (state == NO_CHANGE) {
+      osThreadFlagsWait(COMM_INPUT_FLAG, osFlagsWaitAny,
+          (replay_running == true) ? REPLAY_POLL_PERIOD_MS : COMM_POLL_PERIOD_MS);
+    }
   }
 }
 
@@ -243,6 +265,13 @@ void COMM_TransmitData(const void *data, uint32_t data_len, CommInterface_t inte
   }
 }
 
+void COMM_SignalInput(void)
+{
+  if (commTaskHandle != NULL) {
+    osThreadFlagsSet(commTaskHandle, COMM_INPUT_FLAG);
+  }
+}
+
 /* Private function definitions ----------------------------------------------*/
 
 void displaySubMenus(void)
@@ -393,6 +422,9 @@ void printCustomData(Message_t* msg)
     case EVAL:
       printEvalMessage(msg);
       return;
+    case FRAGMENT:
+      printFragmentTransfer(msg);
+      break;
     default:
       COMM_TransmitData("Unknown data type: N/A", CALC_LEN, menu_context.interface);
       break;
@@ -560,6 +592,54 @@ void printEvalMessage(Message_t* msg)
   COMM_TransmitData(out_buffer, CALC_LEN, menu_context.interface);
 }
 
+void printFragmentTransfer(Message_t* msg)
+{
+  FragmentTransfer_t transfer;
+  if (Fragment_GetTransfer(msg, &transfer) == false) {
+    COMM_TransmitData("Fragmented transfer no longer available", CALC_LEN, menu_context.interface);
+    return;
+  }
+
+  if (transfer.complete == false) {
+    sprintf((char*) out_buffer, "Transfer %u timed out with %u/%u fragments. Missing:",
+            transfer.transfer_id, transfer.fragments_received, transfer.fragment_count);
+    COMM_TransmitData(out_buffer, CALC_LEN, menu_context.interface);
+    for (uint8_t i = 0; i < transfer.fragment_count; i++) {
+      if (Fragment_WasReceived(msg, i) == false) {
+        sprintf((char*) out_buffer, " %u", i);
+        COMM_TransmitData(out_buffer, CALC_LEN, menu_context.interface);
+      }
+    }
+    return;
+  }
+
+  sprintf((char*) out_buffer, "Transfer %u: %u bytes in %u fragments\r\n",
+          transfer.transfer_id, transfer.length_bytes, transfer.fragment_count);
+  COMM_TransmitData(out_buffer, CALC_LEN, menu_context.interface);
+
+  // Printed a line at a time since the transfer is larger than out_buffer
+  const uint16_t bytes_per_line = 32;
+  for (uint16_t start = 0; start < transfer.length_bytes; start += bytes_per_line) {
+    uint16_t line_bytes = MIN(bytes_per_line, transfer.length_bytes - start);
+    uint16_t len = 0;
+    for (uint16_t i = 0; i < line_bytes; i++) {
+      uint8_t byte = transfer.data[start + i];
+      if (transfer.data_type == STRING) {
+        // Same terminal protection as printStringData
+        out_buffer[len++] = (byte > 127) ? ' ' : byte;
+      }
+      else {
+        len += sprintf((char*) &out_buffer[len], "%02X ", byte);
+      }
+    }
+    if (transfer.data_type != STRING) {
+      out_buffer[len++] = '\r';
+      out_buffer[len++] = '\n';
+    }
+    COMM_TransmitData(out_buffer, len, menu_context.interface);
+  }
+}
+
 bool registerCommParams(void)
 {
   uint32_t min_u32 = (uint32_t) MIN_PRINT_ENABLED;
@@ -571,3 +651,37 @@ bool registerCommParams(void)
 
   return true;
 }
+
+// Replays are started from the debug menu. Samples are consumed by the ADC
+// callbacks so only flow control, the host timeout and the report are left
+void serviceReplay(void)
+{
+  if (Replay_IsActive() == true) {
+    replay_running = true;
+  }
+  if (replay_running == false || Replay_Service() == true) {
+    return;
+  }
+  replay_running = false;
+
+  ReplayStats_t stats;
+  Replay_GetStats(&stats);
+
+  // Time left before the input ring would overflow at the worst point
+  float slack_ms = 1000.0f * ((float) PROCESSING_BUFFER_SIZE -
+      (float) stats.max_unprocessed - (float) (ADC_BUFFER_SIZE / 2)) /
+      ADC_SAMPLING_RATE;
+  float occupancy = 100.0f * (float) stats.max_unprocessed /
+      (float) PROCESSING_BUFFER_SIZE;
+
+  sprintf((char*) out_buffer, "\r\nREPLAY_DONE,%lu,%lu,%lu,"
+      "%lu,%u,%.1f,%.2f,%u\r\n", stats.samples_requested,
+      stats.samples_replayed, stats.underruns, stats.overruns,
+      stats.max_unprocessed, occupancy, slack_ms, stats.timed_out);
+  COMM_TransmitData(out_buffer, CALC_LEN, COMM_USB);
+
+  sprintf((char*) out_buffer, "Replayed %lu/%lu samples, "
+      "worst ring occupancy %.1f%%, minimum deadline slack %.2f ms\r\n",
+      stats.samples_replayed, stats.samples_requested, occupancy, slack_ms);
+  COMM_TransmitData(out_buffer, CALC_LEN, COMM_USB);
+}
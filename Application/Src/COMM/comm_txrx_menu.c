@@ -15,6 +15,8 @@
 
 #include "mess_main.h"
 #include "mess_packet.h"
+#include "mess_arq.h"
+#include "mess_fragment.h"
 
 #include "cmsis_os.h"
 
@@ -50,24 +52,34 @@ void transmitIntOut(void* argument);
 void transmitIntFb(void* argument);
 void transmitFloatOut(void* argument);
 void transmitFloatFb(void* argument);
+void transmitLargeOut(void* argument);
+void transmitLargeFb(void* argument);
 void togglePrint(void* argument);
 
 void transmitBits(FunctionContext_t* context, bool is_feedback);
 void transmitString(FunctionContext_t* context, bool is_feedback);
 void transmitInt(FunctionContext_t* context, bool is_feedback);
 void transmitFloat(FunctionContext_t* context, bool is_feedback);
+void transmitLarge(FunctionContext_t* context, bool is_feedback);
 
+bool decodeHexString(FunctionContext_t* context, uint16_t max_bytes, uint16_t* num_bytes, uint8_t* decoded_bytes);
 bool parseHexString(FunctionContext_t* context, uint16_t* num_bytes, uint8_t* decoded_bytes);
 void sendMessageToTxQueue(FunctionContext_t* context, Message_t* msg, bool is_feedback);
+void sendTransfer(FunctionContext_t* context, bool is_feedback);
 
 bool inCustomMode(FunctionContext_t* context);
 
 /* Private variables ---------------------------------------------------------*/
 
+// Hexadecimal lines are collected here until the transfer is sent
+static uint8_t upload_buffer[FRAGMENT_MAX_TRANSFER_BYTES];
+static uint16_t upload_length = 0;
+
 static MenuID_t txrxMenuChildren[] = {
   MENU_ID_TXRX_BITSOUT,   MENU_ID_TXRX_BITSFB,    MENU_ID_TXRX_STROUT, 
   MENU_ID_TXRX_STRFB,     MENU_ID_TXRX_INTOUT,    MENU_ID_TXRX_INTFB,
-  MENU_ID_TXRX_FLOATOUT,  MENU_ID_TXRX_FLOATFB ,  MENU_ID_TXRX_ENPNT
+  MENU_ID_TXRX_FLOATOUT,  MENU_ID_TXRX_FLOATFB ,  MENU_ID_TXRX_LARGEOUT,
+  MENU_ID_TXRX_LARGEFB,   MENU_ID_TXRX_ENPNT
 };
 static const MenuNode_t txrxMenu = {
   .id = MENU_ID_TXRX,
@@ -200,6 +212,36 @@ static const MenuNode_t txrxFloatFeedback = {
   .parameters = &txrxFloatFeedbackParam
 };
 
+static ParamContext_t txrxLargeTransducerParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_TXRX_LARGEOUT
+};
+static const MenuNode_t txrxLargeTransducer = {
+  .id = MENU_ID_TXRX_LARGEOUT,
+  .description = "Large Binary Data Through Transducer",
+  .handler = transmitLargeOut,
+  .parent_id = MENU_ID_TXRX,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &txrxLargeTransducerParam
+};
+
+static ParamContext_t txrxLargeFeedbackParam = {
+  .state = PARAM_STATE_0,
+  .param_id = MENU_ID_TXRX_LARGEFB
+};
+static const MenuNode_t txrxLargeFeedback = {
+  .id = MENU_ID_TXRX_LARGEFB,
+  .description = "Large Binary Data Through Feedback",
+  .handler = transmitLargeFb,
+  .parent_id = MENU_ID_TXRX,
+  .children_ids = NULL,
+  .num_children = 0,
+  .access_level = 0,
+  .parameters = &txrxLargeFeedbackParam
+};
+
 static ParamContext_t txrxTogglePrintParam = {
   .state = PARAM_STATE_0,
   .param_id = MENU_ID_TXRX_ENPNT
@@ -224,7 +266,8 @@ bool COMM_RegisterTxRxMenu()
              registerMenu(&txrxStrTransducer) && registerMenu(&txrxIntTransducer) &&
              registerMenu(&txrxFloatTransducer) && registerMenu(&txrxTogglePrint) &&
              registerMenu(&txrxStrFeedback) && registerMenu(&txrxBitsFeedback) &&
-             registerMenu(&txrxIntFeedback) && registerMenu(&txrxFloatFeedback);
+             registerMenu(&txrxIntFeedback) && registerMenu(&txrxFloatFeedback) &&
+             registerMenu(&txrxLargeTransducer) && registerMenu(&txrxLargeFeedback);
   return ret;
 }
 
@@ -285,6 +328,20 @@ void transmitFloatFb(void* argument)
   transmitFloat(context, true);
 }
 
+void transmitLargeOut(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  transmitLarge(context, false);
+}
+
+void transmitLargeFb(void* argument)
+{
+  FunctionContext_t* context = (FunctionContext_t*) argument;
+
+  transmitLarge(context, true);
+}
+
 void togglePrint(void* argument)
 {
   FunctionContext_t* context = (FunctionContext_t*) argument;
@@ -469,6 +526,26 @@ void transmitFloat(FunctionContext_t* context, bool is_feedback)
 }
 
 bool parseHexString(FunctionContext_t* context, uint16_t* num_bytes, uint8_t* decoded_bytes)
+{
+  if (decodeHexString(context, PACKET_DATA_MAX_LENGTH_BYTES, num_bytes, 
+      decoded_bytes) == false) {
+    return false;
+  }
+
+  if (NumberUtils_IsPowerOf2(*num_bytes) == true) {
+    return true;
+  }
+  else { 
+    sprintf((char*) context->output_buffer,"\r\nError: The input length must "
+        "be a power of 2 and less than %u. The received input is %u bytes long\r\n",
+        PACKET_DATA_MAX_LENGTH_BYTES, *num_bytes);
+    COMM_TransmitData(context->output_buffer, CALC_LEN, 
+        context->comm_interface);
+    return false;
+  }
+}
+
+bool decodeHexString(FunctionContext_t* context, uint16_t max_bytes, uint16_t* num_bytes, uint8_t* decoded_bytes)
 {
   if (context == NULL || num_bytes == NULL) {
     COMM_TransmitData("\r\nInternal Error!\r\n", CALC_LEN, 
@@ -492,7 +569,7 @@ bool parseHexString(FunctionContext_t* context, uint16_t* num_bytes, uint8_t* de
     ptr_index += 2;
   }
 
-  while (ptr[ptr_index] != '\0' && *num_bytes < PACKET_DATA_MAX_LENGTH_BYTES) {
+  while (ptr[ptr_index] != '\0') {
 
     if (ptr_index >= context->input_len || ptr[ptr_index] == '\0') break;
 
@@ -522,6 +599,13 @@ bool parseHexString(FunctionContext_t* context, uint16_t* num_bytes, uint8_t* de
       high_digit = false;
     } 
     else {
+      if (*num_bytes >= max_bytes) {
+        sprintf((char*) context->output_buffer, "\r\nError: The input is "
+            "longer than %u bytes\r\n", max_bytes);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, 
+            context->comm_interface);
+        return false;
+      }
       current_byte |= nibble;
       decoded_bytes[(*num_bytes)++] = current_byte;
       high_digit = true;
@@ -530,18 +614,12 @@ bool parseHexString(FunctionContext_t* context, uint16_t* num_bytes, uint8_t* de
     ptr_index++;
   }
 
-  if (NumberUtils_IsPowerOf2(*num_bytes) == true && high_digit == true &&
-      *num_bytes <= PACKET_DATA_MAX_LENGTH_BYTES) {
-    return true;
-  }
-  else { 
-    sprintf((char*) context->output_buffer,"\r\nError: The input length must "
-        "be a power of 2 and less than %u. The received input is %u bytes long\r\n",
-        PACKET_DATA_MAX_LENGTH_BYTES, *num_bytes);
-    COMM_TransmitData(context->output_buffer, CALC_LEN, 
-        context->comm_interface);
+  if (high_digit == false) {
+    COMM_TransmitData("\r\nError: Odd number of hexadecimal digits\r\n", 
+        CALC_LEN, context->comm_interface);
     return false;
   }
+  return true;
 }
 
 void sendMessageToTxQueue(FunctionContext_t* context, Message_t* msg, bool is_feedback)
@@ -555,7 +633,14 @@ void sendMessageToTxQueue(FunctionContext_t* context, Message_t* msg, bool is_fe
     return;
   }
   msg->preamble.modem_id.valid = true;
-  if (MESS_AddMessageToTxQ(msg) == pdPASS) {
+
+  // Reliable delivery goes through the ARQ send window instead
+  uint8_t use_arq;
+  if (Param_GetUint8(PARAM_ARQ_ENABLED, &use_arq) == false) {
+    use_arq = false;
+  }
+  BaseType_t ret = (use_arq == true) ? Arq_Send(msg) : MESS_AddMessageToTxQ(msg);
+  if (ret == pdPASS) {
     sprintf((char*) context->output_buffer, "\r\nSuccessfully added to"
         " %s queue!\r\n\r\n", is_feedback ? "feedback network" : "transducer");
     COMM_TransmitData(context->output_buffer, CALC_LEN, 
@@ -570,6 +655,54 @@ void sendMessageToTxQueue(FunctionContext_t* context, Message_t* msg, bool is_fe
   context->state->state = PARAM_STATE_COMPLETE;
 }
 
+void transmitLarge(FunctionContext_t* context, bool is_feedback)
+{
+  ParamState_t old_state = context->state->state;
+
+  do {
+    switch (context->state->state) {
+      case PARAM_STATE_0:
+        upload_length = 0;
+        sprintf((char*) context->output_buffer, "\r\n\r\nPlease enter up to %u "
+            "bytes of binary data in hexadecimal to send to the %s with the "
+            "format 'F6 1D'. The data can be split over several lines and is "
+            "sent in fragments of up to %u bytes once an empty line is "
+            "entered:\r\n", FRAGMENT_MAX_TRANSFER_BYTES,
+            is_feedback ? "feedback network" : "transducer",
+            FRAGMENT_MAX_PAYLOAD_BYTES);
+        COMM_TransmitData(context->output_buffer, CALC_LEN, 
+            context->comm_interface);
+        context->state->state = PARAM_STATE_1;
+        break;
+      case PARAM_STATE_1:
+        if (context->input_len != 0) {
+          // A line with an error is discarded and the previous lines are kept
+          uint16_t num_bytes;
+          if (decodeHexString(context, FRAGMENT_MAX_TRANSFER_BYTES - upload_length,
+              &num_bytes, &upload_buffer[upload_length]) == true) {
+            upload_length += num_bytes;
+          }
+          sprintf((char*) context->output_buffer, "\r\n%u bytes entered\r\n",
+              upload_length);
+          COMM_TransmitData(context->output_buffer, CALC_LEN, 
+              context->comm_interface);
+        }
+        else if (upload_length == 0) {
+          COMM_TransmitData("\r\nNo data entered. Message not sent\r\n", 
+              CALC_LEN, context->comm_interface);
+          context->state->state = PARAM_STATE_COMPLETE;
+        }
+        else {
+          sendTransfer(context, is_feedback);
+        }
+        break;
+      default:
+        context->state->state = PARAM_STATE_COMPLETE;
+        break;
+    }
+  } while (old_state > context->state->state);
+}
+
 bool inCustomMode(FunctionContext_t* context)
 {
   MessagingProtocol_t protocol;
@@ -587,3 +720,23 @@ bool inCustomMode(FunctionContext_t* context)
   COMM_TransmitData("Cannot send custom messages in non-custom modes. Message not sent\r\n", CALC_LEN, context->comm_interface);
   return false;
 }
+
+void sendTransfer(FunctionContext_t* context, bool is_feedback)
+{
+  if (inCustomMode(context) == false) return;
+
+  MessageType_t type = is_feedback ? MSG_TRANSMIT_FEEDBACK : MSG_TRANSMIT_TRANSDUCER;
+  uint8_t fragment_count;
+  if (Fragment_Send(upload_buffer, upload_length, BITS, type, &fragment_count) == true) {
+    sprintf((char*) context->output_buffer, "\r\nSending %u bytes in %u "
+        "fragments through the %s\r\n\r\n", upload_length, fragment_count,
+        is_feedback ? "feedback network" : "transducer");
+    COMM_TransmitData(context->output_buffer, CALC_LEN, 
+        context->comm_interface);
+  }
+  else {
+    COMM_TransmitData("\r\nThe previous transfer is still being sent. "
+        "Message not sent\r\n\r\n", CALC_LEN, context->comm_interface);
+  }
+  context->state->state = PARAM_STATE_COMPLETE;
+}
@@ -10,6 +10,7 @@
 #include "dac_waveform.h"
 #include "cfg_parameters.h"
 #include "sys_error.h"
+#include "sys_trace.h"
 #include "cfg_main.h"
 #include "main.h"
 #include "cmsis_os.h"
@@ -64,6 +65,11 @@ void DAC_StartTask(void* argument)
     uint32_t flags;
     flags = osThreadFlagsWait(ALL_FLAGS, osFlagsWaitAny, osWaitForever);
 
+    // Both halves pending means the DMA wrapped around before a fill ran
+    if ((flags & ALL_FLAGS) == ALL_FLAGS) {
+      Trace_Fault(TRACE_EVENT_DAC_UNDERRUN, flags);
+    }
+
     if (flags & DAC_FILL_FIRST_HALF) {
       Waveform_FillBuffer(FILL_FIRST_HALF);
     }
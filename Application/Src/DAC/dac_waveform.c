@@ -15,6 +15,8 @@
 #include "cfg_defaults.h"
 #include "cfg_parameters.h"
 #include "sleep/wakeup_tones.h"
+#include "crc32.h"
+#include "sys_trace.h"
 #include "FreeRTOS.h"
 #include "cmsis_os.h"
 #include <stdbool.h>
@@ -31,6 +33,9 @@ typedef struct {
   int32_t amplitude_step;
   uint32_t amplitude_counter;
   bool amplitude_transitioning;
+  uint32_t sample_position;   // Index into the step samples with SAMPLE_POSITION_PRECISION fractional bits
+  uint32_t sample_increment;
+  uint32_t num_samples;
 } WaveformControl_t;
 
 /* Private define ------------------------------------------------------------*/
@@ -38,9 +43,17 @@ typedef struct {
 #define SINE_POINTS         1024
 #define DAC_MAX_VALUE       4095
 #define PHASE_PRECISION     32
+#define SAMPLE_POSITION_PRECISION 16
+
+// The tone fill writes two samples per word
+#if (DAC_BUFFER_SIZE % 4) != 0
+#error "Each half of the DAC buffer must hold an even number of samples"
+#endif
 
 /* Private macro -------------------------------------------------------------*/
 
+// Take the first 10 bits of the phase as the sine table has 2^10 points
+#define SINE_AT(phase)      ((uint32_t) sine_table[((phase) >> (PHASE_PRECISION - 10)) & (SINE_POINTS - 1)])
 
 
 /* Private variables ---------------------------------------------------------*/
@@ -48,7 +61,12 @@ typedef struct {
 extern osThreadId_t dacTaskHandle;
 
 static uint16_t sine_table[SINE_POINTS];
-static uint32_t dac_buffer[DAC_BUFFER_SIZE] __attribute__((section(".dma_buf")));
+// 12 bit right aligned samples sent to the DAC with halfword DMA transfers.
+// Pairs of samples are written as one word
+static union {
+  uint16_t samples[DAC_BUFFER_SIZE];
+  uint32_t pairs[DAC_BUFFER_SIZE / 2];
+} dac_buffer __attribute__((section(".dma_buf")));
 
 static WaveformControl_t wave_ctrl __attribute__((section(".dtcm")));
 static WaveformStep_t current_waveform_step;
@@ -61,6 +79,13 @@ static volatile uint32_t callback_count = 0;
 
 static uint16_t transition_length = DEFAULT_DAC_TRANSITION_LEN;
 
+// Set when the next fill should terminate the DAC output
+static bool last_fill = false;
+
+// Offline rendering overrides the step amplitude
+static bool rendering = false;
+static float render_amplitude = 0.0f;
+
 // Output tone that flushes out the DAC and prevents the first message from being scrambled
 WaveformStep_t test_step = {
     .duration_us = 1000000, // Any lower duration does not work
@@ -72,6 +97,7 @@ WaveformStep_t test_step = {
 
 static void generateSineTable(void);
 static void updateWaveformParameters(void);
+static void fillSamples(uint16_t start_index, uint16_t end_index);
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -116,7 +142,7 @@ bool Waveform_StartWaveformOutput(uint32_t channel)
   Waveform_FillBuffer(FILL_FIRST_HALF);
   Waveform_FillBuffer(FILL_LAST_HALF);
 
-  HAL_StatusTypeDef ret = HAL_DAC_Start_DMA(&hdac1, channel, (uint32_t*) dac_buffer,
+  HAL_StatusTypeDef ret = HAL_DAC_Start_DMA(&hdac1, channel, dac_buffer.pairs,
                     DAC_BUFFER_SIZE, DAC_ALIGN_12B_R);
 
   return ret == HAL_OK;
@@ -174,7 +200,7 @@ void Waveform_Flush()
   Waveform_FillBuffer(FILL_FIRST_HALF);
   Waveform_FillBuffer(FILL_LAST_HALF);
 
-  HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_FEEDBACK, (uint32_t*) dac_buffer,
+  HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_FEEDBACK, dac_buffer.pairs,
       DAC_BUFFER_SIZE, DAC_ALIGN_12B_R);
 
   HAL_TIM_Base_Start(&htim6);
@@ -187,9 +213,6 @@ void Waveform_Flush()
 
 void Waveform_FillBuffer(FillType_t type)
 {
-  // Flag that indicates that the next time this function is called it should terminate the DAC output
-  static bool last_fill = false;
-
   callback_count++;
 
   if (last_fill == true) {
@@ -218,12 +241,16 @@ void Waveform_FillBuffer(FillType_t type)
     updateWaveformParameters();
   }
 
+  if (current_waveform_step.samples != NULL) {
+    fillSamples(start_index, end_index);
+    current_symbol_duration_us += DAC_BUFFER_SIZE * DAC_SAMPLE_RATE / 1000000 / 2;
+    return;
+  }
+
   // Flag to change the output frequency has been set so perform amplitude transition
   if (wave_ctrl.amplitude_transitioning) {
     for (;i < start_index + transition_length; i++) {
-      // Take the first 10 bits of the phase as the sine table has 2^10 points
-      uint32_t index = wave_ctrl.phase_accumulator >> (PHASE_PRECISION - 10);
-      uint32_t base_value = sine_table[index & (SINE_POINTS - 1)]; // Ensures nothing out of index
+      uint32_t base_value = SINE_AT(wave_ctrl.phase_accumulator);
 
       wave_ctrl.current_amplitude = (uint32_t) ((int32_t) wave_ctrl.current_amplitude + wave_ctrl.amplitude_step);
       wave_ctrl.amplitude_counter++;
@@ -232,29 +259,87 @@ void Waveform_FillBuffer(FillType_t type)
         wave_ctrl.current_amplitude = wave_ctrl.target_amplitude;
       }
       // Add baseline offset and modulation amplitude
-      dac_buffer[i] = (DAC_MAX_VALUE + 1) / 2 - wave_ctrl.current_amplitude / 2 + ((base_value * wave_ctrl.current_amplitude) >> 12);
+      dac_buffer.samples[i] = (DAC_MAX_VALUE + 1) / 2 - wave_ctrl.current_amplitude / 2 + ((base_value * wave_ctrl.current_amplitude) >> 12);
 
       // Update phase
       wave_ctrl.phase_accumulator += wave_ctrl.phase_increment;
     }
   }
 
-  uint16_t offset_amt = (DAC_MAX_VALUE + 1) / 2 - wave_ctrl.current_amplitude / 2;
-  for (; i < end_index; i++) {
-    // Get current phase
-    uint32_t index = wave_ctrl.phase_accumulator >> (PHASE_PRECISION - 10);
-    uint32_t base_value = sine_table[index & (SINE_POINTS - 1)];
+  const uint32_t offset_amt = (DAC_MAX_VALUE + 1) / 2 - wave_ctrl.current_amplitude / 2;
+  const uint32_t amplitude = wave_ctrl.current_amplitude;
+  uint32_t phase = wave_ctrl.phase_accumulator;
 
-    // Scale output and write to buffer
-    dac_buffer[i] = offset_amt + ((base_value * wave_ctrl.current_amplitude) >> 12);
+  // An odd length transition leaves one sample before the next word
+  if ((i & 1) != 0) {
+    dac_buffer.samples[i++] = offset_amt + ((SINE_AT(phase) * amplitude) >> 12);
+    phase += wave_ctrl.phase_increment;
+  }
 
-    // Update phase
-    wave_ctrl.phase_accumulator += wave_ctrl.phase_increment;
+  // Two phases a sample apart each advance by two samples so every iteration
+  // fills a word. Samples are below 2^16 so they pack without masking
+  uint32_t phase_odd = phase + wave_ctrl.phase_increment;
+  const uint32_t pair_increment = 2 * wave_ctrl.phase_increment;
+  for (uint16_t pair = i / 2; pair < end_index / 2; pair++) {
+    uint32_t even_value = offset_amt + ((SINE_AT(phase) * amplitude) >> 12);
+    uint32_t odd_value = offset_amt + ((SINE_AT(phase_odd) * amplitude) >> 12);
+    dac_buffer.pairs[pair] = even_value | (odd_value << 16);
+
+    phase += pair_increment;
+    phase_odd += pair_increment;
   }
+  wave_ctrl.phase_accumulator = phase;
 
   current_symbol_duration_us += DAC_BUFFER_SIZE * DAC_SAMPLE_RATE / 1000000 / 2;
 }
 
+bool Waveform_Render(uint16_t num_steps, float amplitude, uint16_t transition,
+                     uint32_t* crc, uint32_t* num_samples)
+{
+  if (dac_running == true) {
+    return false;
+  }
+
+  uint16_t saved_transition_length = transition_length;
+  transition_length = transition;
+  render_amplitude = amplitude;
+  rendering = true;
+
+  Waveform_SetWaveformSequence(num_steps, true);
+  memset(&wave_ctrl, 0, sizeof(wave_ctrl));
+  last_fill = false;
+  dac_running = true;
+  updateWaveformParameters();
+
+  uint32_t running_crc = CRC32_INIT;
+  uint32_t samples = 0;
+  FillType_t type = FILL_FIRST_HALF;
+
+  while (true) {
+    Waveform_FillBuffer(type);
+    // Nothing is written on the fill that flags the end of the sequence
+    if (last_fill == true) {
+      break;
+    }
+
+    uint16_t start_index = (type == FILL_FIRST_HALF) ? 0 : DAC_BUFFER_SIZE / 2;
+    running_crc = Crc32_Update(running_crc, &dac_buffer.samples[start_index],
+                               DAC_BUFFER_SIZE / 2 * sizeof(uint16_t));
+    samples += DAC_BUFFER_SIZE / 2;
+    type = (type == FILL_FIRST_HALF) ? FILL_LAST_HALF : FILL_FIRST_HALF;
+  }
+
+  last_fill = false;
+  dac_running = false;
+  memset(&wave_ctrl, 0, sizeof(wave_ctrl));
+  transition_length = saved_transition_length;
+  rendering = false;
+
+  *crc = Crc32_Final(running_crc);
+  *num_samples = samples;
+  return true;
+}
+
 /* Private function definitions ----------------------------------------------*/
 
 // Creates a sine table with 360/SINE_POINTS degree spacing between adjacent points centered at 2047. Table has one full sine wave
@@ -268,10 +353,20 @@ static void generateSineTable(void)
 static void updateWaveformParameters()
 {
   current_waveform_step = MessDacResource_GetStep(current_step);
+  if (rendering == true) {
+    current_waveform_step.relative_amplitude = render_amplitude;
+  }
 
   // Calculate new phase increment
   wave_ctrl.phase_increment = (((uint64_t)
       current_waveform_step.freq_hz) << PHASE_PRECISION) / DAC_SAMPLE_RATE;
+  // Phase modulated steps jump relative to the continuous carrier phase
+  wave_ctrl.phase_accumulator += current_waveform_step.phase_shift;
+
+  // Sample steps are resampled from the ADC rate
+  wave_ctrl.sample_position = 0;
+  wave_ctrl.sample_increment = (((uint64_t) ADC_SAMPLING_RATE) << SAMPLE_POSITION_PRECISION) / DAC_SAMPLE_RATE;
+  wave_ctrl.num_samples = (uint32_t) (((uint64_t) current_waveform_step.duration_us * ADC_SAMPLING_RATE) / 1000000);
 
   // Setup amplitude transition
   wave_ctrl.target_amplitude = (uint32_t)
@@ -283,10 +378,42 @@ static void updateWaveformParameters()
   current_symbol_duration_us = 0;
 }
 
+// Linearly interpolates the step samples up to the DAC rate. Images sit around
+// multiples of the ADC rate, well above the transducer band
+static void fillSamples(uint16_t start_index, uint16_t end_index)
+{
+  const float* samples = current_waveform_step.samples;
+  const float fraction_scale = 1.0f / (1 << SAMPLE_POSITION_PRECISION);
+
+  for (uint16_t i = start_index; i < end_index; i++) {
+    if (wave_ctrl.amplitude_transitioning) {
+      wave_ctrl.current_amplitude = (uint32_t) ((int32_t) wave_ctrl.current_amplitude + wave_ctrl.amplitude_step);
+      wave_ctrl.amplitude_counter++;
+      if (wave_ctrl.amplitude_counter >= transition_length) {
+        wave_ctrl.amplitude_transitioning = false;
+        wave_ctrl.current_amplitude = wave_ctrl.target_amplitude;
+      }
+    }
+
+    uint32_t index = wave_ctrl.sample_position >> SAMPLE_POSITION_PRECISION;
+    if (index >= wave_ctrl.num_samples) {
+      index = wave_ctrl.num_samples - 1;
+    }
+    uint32_t next_index = (index + 1 < wave_ctrl.num_samples) ? index + 1 : index;
+    float fraction = (float) (wave_ctrl.sample_position & ((1 << SAMPLE_POSITION_PRECISION) - 1)) * fraction_scale;
+    float value = samples[index] + (samples[next_index] - samples[index]) * fraction;
+
+    dac_buffer.samples[i] = (DAC_MAX_VALUE + 1) / 2 + (int32_t) (value * (float) (wave_ctrl.current_amplitude / 2));
+
+    wave_ctrl.sample_position += wave_ctrl.sample_increment;
+  }
+}
+
 // DMA callbacks
 void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef *hdac)
 {
   (void)(hdac);
+  Trace_Record(TRACE_EVENT_DAC_HALF, 1);
   if (dac_running == true) {
     osThreadFlagsSet(dacTaskHandle, DAC_FILL_FIRST_HALF);
   }
@@ -295,6 +422,7 @@ void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef *hdac)
 void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef *hdac)
 {
   (void)(hdac);
+  Trace_Record(TRACE_EVENT_DAC_FULL, 1);
   if (dac_running == true) {
     osThreadFlagsSet(dacTaskHandle, DAC_FILL_LAST_HALF);
   }
@@ -303,6 +431,7 @@ void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef *hdac)
 void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef *hdac)
 {
   (void)(hdac);
+  Trace_Record(TRACE_EVENT_DAC_HALF, 2);
   if (dac_running == true) {
     osThreadFlagsSet(dacTaskHandle, DAC_FILL_FIRST_HALF);
   }
@@ -311,6 +440,7 @@ void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef *hdac)
 void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef *hdac)
 {
   (void)(hdac);
+  Trace_Record(TRACE_EVENT_DAC_FULL, 2);
   if (dac_running == true) {
     osThreadFlagsSet(dacTaskHandle, DAC_FILL_LAST_HALF);
   }
@@ -11,7 +11,10 @@
 #include "mess_input.h"
 #include "mess_feedback.h"
 #include "mess_background_noise.h"
+#include "mess_snr_sweep.h"
+#include "mess_replay.h"
 #include "sys_temperature.h"
+#include "sys_trace.h"
 #include "stm32h7xx_hal.h"
 #include <string.h>
 #include "FreeRTOS.h"
@@ -31,7 +34,9 @@
 
 /* Private variables ---------------------------------------------------------*/
 
-static uint16_t adc_buffer[ADC_BUFFER_SIZE] __attribute__((section(".dma_buf"))); // shared ADC buffer for both feedback and input ADCs
+// Each ADC has its own DMA stream so both can run at the same time
+static uint16_t input_dma_buffer[ADC_BUFFER_SIZE] __attribute__((section(".dma_buf")));
+static uint16_t feedback_dma_buffer[ADC_BUFFER_SIZE] __attribute__((section(".dma_buf")));
 
 volatile uint16_t input_head_pos = 0;
 volatile uint16_t input_tail_pos = 0;
@@ -43,32 +48,30 @@ static float dc_estimate = 2048.0f;
 static const float dc_alpha = 1e-5;
 
 /*
- * Only one ADC runs at a time and both have significant DSP operations done on
- * them so they benefit greatly from DTCM buffers. DTCM memory is limited, so
- * they share a buffer
+ * The input samples go through all of the demodulation DSP so they get the
+ * DTCM (64 KB of 128 KB, the MESS task stack takes most of the rest). The
+ * feedback samples are only copied and printed so they live in AXI SRAM.
  */
-typedef union {
-  float in_buf[PROCESSING_BUFFER_SIZE];
-  uint16_t fb_buf[PROCESSING_BUFFER_SIZE];
-} AdcBuffers_t;
+static float input_ring[PROCESSING_BUFFER_SIZE] __attribute__((section(".dtcm")));
+static uint16_t feedback_ring[PROCESSING_BUFFER_SIZE];
 
-static AdcBuffers_t adc_buffers __attribute__((section(".dtcm")));
+float* input_buffer = input_ring;
+uint16_t* feedback_buffer = feedback_ring;
 
-float* input_buffer = adc_buffers.in_buf;
-uint16_t* feedback_buffer = adc_buffers.fb_buf;
+// Holds recorded samples streamed over USB during a replay
+static uint16_t replay_block[ADC_BUFFER_SIZE / 2];
 
 static bool input_sample_lost = false;
 static bool feedback_sample_lost = false;
 
- // Number of times the head of either buffer has wrapped around to 0
-static uint16_t buffer_rollover_count = 0;
-static uint32_t rollover_associated_time;
+// Number of times the head of each buffer has wrapped around to 0
+static uint16_t input_rollover_count = 0;
+static uint16_t feedback_rollover_count = 0;
 
 /* Private function prototypes -----------------------------------------------*/
 
 void addToInputBuffer(bool firstHalf);
 void addToFeedbackBuffer(bool firstHalf);
-void incrementRollover();
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -81,7 +84,8 @@ bool ADC_Init()
   feedback_head_pos = 0;
   feedback_tail_pos = 0;
 
-  memset(adc_buffer, 0, ADC_BUFFER_SIZE * sizeof(uint16_t));
+  memset(input_dma_buffer, 0, ADC_BUFFER_SIZE * sizeof(uint16_t));
+  memset(feedback_dma_buffer, 0, ADC_BUFFER_SIZE * sizeof(uint16_t));
 
   return ret1 == HAL_OK;
 }
@@ -92,7 +96,7 @@ bool ADC_StartInput()
   input_tail_pos = 0;
   HAL_TIM_Base_Start(&htim8);
   BackgroundNoise_Reset();
-  HAL_StatusTypeDef ret = HAL_ADC_Start_DMA(&INPUT_ADC, (uint32_t*) adc_buffer, ADC_BUFFER_SIZE);
+  HAL_StatusTypeDef ret = HAL_ADC_Start_DMA(&INPUT_ADC, (uint32_t*) input_dma_buffer, ADC_BUFFER_SIZE);
   return ret == HAL_OK;
 }
 
@@ -100,7 +104,7 @@ bool ADC_StartFeedback()
 {
   feedback_head_pos = 0;
   feedback_tail_pos = 0;
-  HAL_StatusTypeDef ret = HAL_ADC_Start_DMA(&FEEDBACK_ADC, (uint32_t*) adc_buffer, ADC_BUFFER_SIZE);
+  HAL_StatusTypeDef ret = HAL_ADC_Start_DMA(&FEEDBACK_ADC, (uint32_t*) feedback_dma_buffer, ADC_BUFFER_SIZE);
   return ret == HAL_OK;
 }
 
@@ -129,7 +133,7 @@ void ADC_InputClear()
 {
   input_head_pos = 0;
   input_tail_pos = 0;
-  buffer_rollover_count = 0;
+  input_rollover_count = 0;
   memset(input_buffer, 0, PROCESSING_BUFFER_SIZE * sizeof(float));
 }
 
@@ -137,32 +141,35 @@ void ADC_FeedbackClear()
 {
   feedback_head_pos = 0;
   feedback_tail_pos = 0;
-  buffer_rollover_count = 0;
+  feedback_rollover_count = 0;
   memset(feedback_buffer, 0, PROCESSING_BUFFER_SIZE * sizeof(uint16_t));
 }
 
-uint16_t ADC_HeadRolloverCount()
+uint16_t ADC_HeadRolloverCount(bool feedback)
 {
-  return buffer_rollover_count;
+  return (feedback == true) ? feedback_rollover_count : input_rollover_count;
 }
 
 uint16_t ADC_TailRolloverCount(bool feedback)
 {
   uint16_t head;
   uint16_t tail;
+  uint16_t rollover_count;
   if (feedback == true) {
     head = feedback_head_pos;
     tail = feedback_tail_pos;
+    rollover_count = feedback_rollover_count;
   }
   else {
     head = input_head_pos;
     tail = input_tail_pos;
+    rollover_count = input_rollover_count;
   }
   if (head >= tail) {
-    return buffer_rollover_count;
+    return rollover_count;
   }
   else { // head has rolled over while the tail has not
-    return buffer_rollover_count - 1;
+    return rollover_count - 1;
   }
 }
 
@@ -179,16 +186,23 @@ void addToInputBuffer(bool firstHalf)
   }
   uint16_t original_head = input_head_pos;
 
+  // Recorded samples streamed over USB replace the ADC samples when replaying
+  const uint16_t* samples = &input_dma_buffer[dma_buf_start_index];
+  if (Replay_GetBlock(replay_block, ADC_BUFFER_SIZE / 2, unprocessed_samples) == true) {
+    samples = replay_block;
+  }
+
   for (uint16_t i = 0; i < ADC_BUFFER_SIZE / 2; i++) {
-    uint16_t dma_index = dma_buf_start_index + i;
-    float new_sample = (float) adc_buffer[dma_index];
+    float new_sample = (float) samples[i];
     // EMA filter
     dc_estimate = new_sample * dc_alpha + (1 - dc_alpha) * dc_estimate;
     input_buffer[input_head_pos] = new_sample - dc_estimate;
     input_head_pos = (input_head_pos + 1) & PROCESSING_BUFFER_MASK;
   }
+  SnrSweep_AddNoise(input_buffer, original_head, ADC_BUFFER_SIZE / 2,
+      PROCESSING_BUFFER_MASK);
   if (original_head > input_head_pos) {
-    incrementRollover();
+    input_rollover_count++;
   }
 }
 
@@ -197,7 +211,7 @@ void addToFeedbackBuffer(bool firstHalf)
   uint16_t dma_buf_start_index = (firstHalf == true) ? (0) : (ADC_BUFFER_SIZE / 2);
 
   // Check for overflowing buffer
-  uint16_t unprocessed_samples = (feedback_head_pos - input_tail_pos) & PROCESSING_BUFFER_MASK;
+  uint16_t unprocessed_samples = (feedback_head_pos - feedback_tail_pos) & PROCESSING_BUFFER_MASK;
   if ((unprocessed_samples + ADC_BUFFER_SIZE / 2) > PROCESSING_BUFFER_SIZE) {
     feedback_sample_lost = true;
   }
@@ -205,33 +219,29 @@ void addToFeedbackBuffer(bool firstHalf)
 
   if (feedback_head_pos + ADC_BUFFER_SIZE / 2 > PROCESSING_BUFFER_SIZE) {
     uint16_t first_block_size = PROCESSING_BUFFER_SIZE - feedback_head_pos;
-    memcpy(&feedback_buffer[feedback_head_pos], &adc_buffer[dma_buf_start_index], first_block_size * sizeof(uint16_t));
+    memcpy(&feedback_buffer[feedback_head_pos], &feedback_dma_buffer[dma_buf_start_index], first_block_size * sizeof(uint16_t));
     uint16_t second_block_size = ADC_BUFFER_SIZE / 2 - first_block_size;
-    memcpy(&feedback_buffer[0], &adc_buffer[first_block_size + dma_buf_start_index], second_block_size * sizeof(uint16_t));
+    memcpy(&feedback_buffer[0], &feedback_dma_buffer[first_block_size + dma_buf_start_index], second_block_size * sizeof(uint16_t));
   }
   else {
-    memcpy(&feedback_buffer[feedback_head_pos], &adc_buffer[dma_buf_start_index], (ADC_BUFFER_SIZE / 2) * sizeof(uint16_t));
+    memcpy(&feedback_buffer[feedback_head_pos], &feedback_dma_buffer[dma_buf_start_index], (ADC_BUFFER_SIZE / 2) * sizeof(uint16_t));
   }
 
   feedback_head_pos = (feedback_head_pos + ADC_BUFFER_SIZE / 2) & PROCESSING_BUFFER_MASK;
   if (original_head > feedback_head_pos) {
-    incrementRollover();
+    feedback_rollover_count++;
   }
 }
 
-void incrementRollover()
-{
-  buffer_rollover_count++;
-  rollover_associated_time = 0; // TODO: change to a timer
-}
-
 
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 {
   if (hadc == &INPUT_ADC) {
+    Trace_Record(TRACE_EVENT_ADC_HALF, TRACE_ADC_INPUT);
     addToInputBuffer(true);
   }
   else if (hadc == &FEEDBACK_ADC) {
+    Trace_Record(TRACE_EVENT_ADC_HALF, TRACE_ADC_FEEDBACK);
     addToFeedbackBuffer(true);
   }
 }
@@ -239,12 +249,15 @@ void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
 {
   if (hadc == &INPUT_ADC) {
+    Trace_Record(TRACE_EVENT_ADC_FULL, TRACE_ADC_INPUT);
     addToInputBuffer(false);
   }
   else if (hadc == &FEEDBACK_ADC) {
+    Trace_Record(TRACE_EVENT_ADC_FULL, TRACE_ADC_FEEDBACK);
     addToFeedbackBuffer(false);
   }
   else if (hadc == &TEMPERATURE_ADC) {
+    Trace_Record(TRACE_EVENT_ADC_FULL, TRACE_ADC_TEMPERATURE);
     Temperature_AddValue();
   }
 }
@@ -0,0 +1,752 @@
+/*
+ * mess_arq.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_arq.h"
+#include "mess_fragment.h"
+#include "mess_main.h"
+#include "mess_error_correction.h"
+
+#include "comm_main.h"
+
+#include "cfg_main.h"
+#include "cfg_parameters.h"
+#include "cfg_defaults.h"
+
+#include "dac_waveform.h"
+
+#include "hw_random.h"
+
+#include "cmsis_os.h"
+#include "queue.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+  Message_t frame;          // Frame with the link header ready to be sent
+  uint32_t sent_tick;       // Time of the last transmission
+  uint8_t transmissions;
+  bool acked;               // Also set when the frame is given up on
+  bool fast_retransmit;
+} ArqTxSlot_t;
+
+typedef struct {
+  Message_t msg;            // Frame with the link header removed
+  bool valid;
+} ArqRxSlot_t;
+
+typedef struct {
+  uint16_t sent;
+  uint16_t delivered;
+  uint16_t out_of_order;
+  uint16_t duplicates;      // Delivered more than once
+  uint16_t corrupt;
+  uint16_t frames;          // Data frame transmissions
+  uint16_t retransmissions;
+  uint16_t timeouts;
+  uint16_t fast_retransmits;
+  uint16_t given_up;
+  uint16_t acks;
+  uint16_t suppressed;      // Duplicate frames received and not delivered
+  uint16_t erased;          // Frames dropped by the loss injection
+  uint16_t next_index;      // Next test message expected in order
+  uint32_t start_tick;
+} ArqStats_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Data frame header fields
+#define HEADER_SESSION              0
+#define HEADER_SEQUENCE             1
+#define HEADER_BASE                 2
+#define HEADER_ATTEMPT              3
+#define HEADER_DATA_TYPE            4
+#define HEADER_LENGTH_HIGH          5
+#define HEADER_LENGTH_LOW           6
+
+// Acknowledgement fields. The echo of the frame that triggered the
+// acknowledgement gives a round trip even for retransmitted frames
+#define ACK_SESSION                 0
+#define ACK_CUMULATIVE              1
+#define ACK_SELECTIVE               2
+#define ACK_ECHO_SEQUENCE           3
+#define ACK_ECHO_ATTEMPT            4
+
+// A frame is given up on after this many transmissions. The receiver skips it
+// once the sender's window base moves past it
+#define ARQ_MAX_TRANSMISSIONS       8
+
+// Retransmission timeout bounds (RFC 6298 with acoustic airtimes)
+#define ARQ_MIN_RTO_MS              500
+#define ARQ_MAX_RTO_MS              300000
+// Covers the receive to transmit turnaround before any round trip is measured
+#define ARQ_RTO_MARGIN_MS           1000
+
+#define ARQ_TEST_MESSAGES           32
+#define ARQ_TEST_PAYLOAD_BYTES      8
+#define ARQ_TEST_LOSS_PERCENT       20
+// Starts close to the end of the sequence space so the test wraps around
+#define ARQ_TEST_FIRST_SEQUENCE     0xF0
+#define ARQ_TEST_TIMEOUT_MS         3600000
+#define ARQ_TEST_LOSS_SEED          0x9E3779B9u
+
+/* Private macro -------------------------------------------------------------*/
+
+#define SEQ_OFFSET(seq, base)       ((uint8_t) ((uint8_t) (seq) - (uint8_t) (base)))
+
+/* Private variables ---------------------------------------------------------*/
+
+static bool arq_enabled = DEFAULT_ARQ_STATE;
+static uint8_t arq_window = DEFAULT_ARQ_WINDOW;
+
+static QueueHandle_t arq_queue = NULL; // Messages waiting for the send window
+
+// Sender
+static ArqTxSlot_t tx_slots[MAX_ARQ_WINDOW];
+static uint8_t tx_session = 0;
+static bool tx_session_started = false;
+static uint8_t tx_base = 0;       // Oldest unacknowledged sequence number
+static uint8_t tx_next = 0;       // Next sequence number to assign
+
+// Round trip estimation in ms
+static uint32_t srtt = 0;
+static uint32_t rttvar = 0;
+static uint32_t rto = 0;
+static bool rtt_measured = false;
+
+// Receiver
+static ArqRxSlot_t rx_slots[MAX_ARQ_WINDOW];
+static uint8_t rx_session = 0;
+static bool rx_session_valid = false;
+static uint8_t rx_next = 0;       // Next sequence number to deliver
+static bool ack_pending = false;
+static MessageType_t ack_type = MSG_TRANSMIT_TRANSDUCER;
+static uint8_t echo_sequence = 0;
+static uint8_t echo_attempt = 0;
+
+static Message_t queued_msg;
+static Message_t ack_msg;
+
+// Link statistics, reset by the loopback test
+static ArqStats_t stats;
+
+static bool testing = false;
+static uint32_t loss_state = ARQ_TEST_LOSS_SEED;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void resetSender(uint8_t first_sequence);
+static void resetReceiver(uint8_t session, uint8_t first_sequence);
+static void fillWindow(const DspConfig_t* cfg);
+static bool sendAck(void);
+static void sendNextFrame(uint32_t now);
+static bool transmitSlot(ArqTxSlot_t* slot, uint32_t now);
+static void slideWindow(void);
+static void handleAck(const Message_t* msg, uint32_t now);
+static void handleData(const Message_t* msg);
+static void skipTo(uint8_t base);
+static void deliverInOrder(void);
+static void deliver(Message_t* msg);
+static void updateRto(uint32_t rtt_sample);
+static uint32_t frameAirtime(uint16_t cargo_bits, const DspConfig_t* cfg);
+static void feedTestMessages(void);
+static void checkTestDelivery(const Message_t* msg);
+static void checkTestComplete(uint32_t now);
+static void finishTest(bool timed_out);
+static bool eraseFrame(void);
+
+/* Exported function definitions ---------------------------------------------*/
+
+void Arq_InitializeQueue(void)
+{
+  static StaticQueue_t queue_control_block;
+  static uint8_t queue_storage[MSG_QUEUE_SIZE * sizeof(Message_t)];
+
+  arq_queue = xQueueCreateStatic(MSG_QUEUE_SIZE, sizeof(Message_t),
+                                 queue_storage, &queue_control_block);
+}
+
+bool Arq_RegisterParams(void)
+{
+  uint32_t min_u32 = MIN_ARQ_STATE;
+  uint32_t max_u32 = MAX_ARQ_STATE;
+  if (Param_Register(PARAM_ARQ_ENABLED, "ARQ link layer", PARAM_TYPE_UINT8,
+                     &arq_enabled, sizeof(bool), &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
+  min_u32 = MIN_ARQ_WINDOW;
+  max_u32 = MAX_ARQ_WINDOW;
+  if (Param_Register(PARAM_ARQ_WINDOW, "the ARQ window size", PARAM_TYPE_UINT8,
+                     &arq_window, sizeof(uint8_t), &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+  return true;
+}
+
+BaseType_t Arq_Send(Message_t* msg)
+{
+  if (arq_queue == NULL || msg == NULL) {
+    return pdFAIL;
+  }
+  if (msg->length_bits > ARQ_MAX_PAYLOAD_BYTES * 8) {
+    return pdFAIL;
+  }
+
+  return xQueueSend(arq_queue, msg, 5);
+}
+
+bool Arq_CanSend(void)
+{
+  return arq_queue != NULL && uxQueueSpacesAvailable(arq_queue) > 0;
+}
+
+void Arq_Process(const DspConfig_t* cfg)
+{
+  // Frames carry their link header in the custom preamble's message type
+  if (cfg->protocol != PROTOCOL_CUSTOM) {
+    return;
+  }
+  // One frame at a time. Loopback frames are received while they are sent
+  if (Waveform_IsRunning() == true) {
+    return;
+  }
+
+  uint32_t now = osKernelGetTickCount();
+
+  if (testing == true) {
+    feedTestMessages();
+    checkTestComplete(now);
+  }
+  fillWindow(cfg);
+
+  if (ack_pending == true) {
+    if (sendAck() == true) {
+      ack_pending = false;
+    }
+    return;
+  }
+
+  sendNextFrame(now);
+}
+
+bool Arq_Check(Message_t* received_msg)
+{
+  if (received_msg->protocol != PROTOCOL_CUSTOM ||
+      received_msg->preamble.message_type.valid == false) {
+    return false;
+  }
+
+  uint8_t message_type = received_msg->preamble.message_type.value;
+  if (message_type != ARQ_DATA && message_type != ARQ_ACK) {
+    return false;
+  }
+
+  // The checksum failed so none of the link header can be trusted
+  if (received_msg->error_detected == true) {
+    return true;
+  }
+  if (testing == true && eraseFrame() == true) {
+    return true;
+  }
+
+  if (message_type == ARQ_ACK) {
+    handleAck(received_msg, osKernelGetTickCount());
+  }
+  else {
+    handleData(received_msg);
+  }
+  return true;
+}
+
+void Arq_StartLoopbackTest(void)
+{
+  memset(&stats, 0, sizeof(ArqStats_t));
+  stats.start_tick = osKernelGetTickCount();
+  loss_state = ARQ_TEST_LOSS_SEED;
+  xQueueReset(arq_queue);
+  resetSender(ARQ_TEST_FIRST_SEQUENCE);
+
+  char output_buffer[96];
+  COMM_TransmitData("\r\nARQ_CFG,window,messages,payload_bytes,loss_percent\r\n",
+      CALC_LEN, COMM_USB);
+  snprintf(output_buffer, 96, "ARQ_CFG,%u,%u,%u,%u\r\n", arq_window,
+      ARQ_TEST_MESSAGES, ARQ_TEST_PAYLOAD_BYTES, ARQ_TEST_LOSS_PERCENT);
+  COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+  COMM_TransmitData("ARQ_RESULT,sent,delivered,out_of_order,duplicates,corrupt,"
+      "frames,retransmissions,timeouts,fast_retransmits,given_up,acks,"
+      "suppressed,erased,srtt_ms,rto_ms,elapsed_ms,result\r\n", CALC_LEN, COMM_USB);
+
+  testing = true;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+void resetSender(uint8_t first_sequence)
+{
+  memset(tx_slots, 0, sizeof(tx_slots));
+  // A new session tells the receiver to discard its reordering state. The
+  // first one is random so it differs from the session before a reset
+  if (tx_session_started == false) {
+    tx_session = Random_Byte();
+    tx_session_started = true;
+  }
+  else {
+    tx_session++;
+  }
+  tx_base = first_sequence;
+  tx_next = first_sequence;
+  srtt = 0;
+  rttvar = 0;
+  rto = 0;
+  rtt_measured = false;
+}
+
+void resetReceiver(uint8_t session, uint8_t first_sequence)
+{
+  memset(rx_slots, 0, sizeof(rx_slots));
+  rx_session = session;
+  rx_session_valid = true;
+  rx_next = first_sequence;
+}
+
+// Moves queued messages into free window slots and adds the link header
+void fillWindow(const DspConfig_t* cfg)
+{
+  if (tx_session_started == false) {
+    resetSender(Random_Byte());
+  }
+
+  while (SEQ_OFFSET(tx_next, tx_base) < arq_window) {
+    if (xQueueReceive(arq_queue, &queued_msg, 0) != pdPASS) {
+      return;
+    }
+    ArqTxSlot_t* slot = &tx_slots[tx_next % MAX_ARQ_WINDOW];
+    Message_t* frame = &slot->frame;
+    memset(frame, 0, sizeof(Message_t));
+    frame->type = queued_msg.type;
+    frame->timestamp = queued_msg.timestamp;
+    frame->data_type = ARQ_DATA;
+    frame->preamble.message_type.value = ARQ_DATA;
+    frame->preamble.message_type.valid = true;
+    frame->protocol = PROTOCOL_CUSTOM;
+    frame->length_bits = queued_msg.length_bits + ARQ_DATA_HEADER_BYTES * 8;
+    frame->data[HEADER_SESSION] = tx_session;
+    frame->data[HEADER_SEQUENCE] = tx_next;
+    frame->data[HEADER_DATA_TYPE] = queued_msg.data_type;
+    frame->data[HEADER_LENGTH_HIGH] = queued_msg.length_bits >> 8;
+    frame->data[HEADER_LENGTH_LOW] = queued_msg.length_bits & 0xFF;
+    memcpy(&frame->data[ARQ_DATA_HEADER_BYTES], queued_msg.data,
+        (queued_msg.length_bits + 7) / 8);
+
+    slot->transmissions = 0;
+    slot->acked = false;
+    slot->fast_retransmit = false;
+
+    // Until a round trip is measured assume a frame and an acknowledgement
+    // both have to cross the channel
+    if (rtt_measured == false) {
+      uint32_t initial_rto = 2 * (frameAirtime(frame->length_bits, cfg) +
+          frameAirtime(ARQ_ACK_BYTES * 8, cfg)) + ARQ_RTO_MARGIN_MS;
+      if (initial_rto > rto) {
+        rto = (initial_rto > ARQ_MAX_RTO_MS) ? ARQ_MAX_RTO_MS : initial_rto;
+      }
+    }
+    tx_next++;
+  }
+}
+
+bool sendAck()
+{
+  memset(&ack_msg, 0, sizeof(Message_t));
+  ack_msg.type = ack_type;
+  ack_msg.timestamp = osKernelGetTickCount();
+  ack_msg.data_type = ARQ_ACK;
+  ack_msg.preamble.message_type.value = ARQ_ACK;
+  ack_msg.preamble.message_type.valid = true;
+  ack_msg.protocol = PROTOCOL_CUSTOM;
+  ack_msg.length_bits = ARQ_ACK_BYTES * 8;
+
+  // Bit i of the bitmap is set if sequence number rx_next + 1 + i is buffered
+  uint8_t selective = 0;
+  for (uint8_t i = 0; i < MAX_ARQ_WINDOW - 1; i++) {
+    if (rx_slots[(uint8_t) (rx_next + 1 + i) % MAX_ARQ_WINDOW].valid == true) {
+      selective |= 1 << i;
+    }
+  }
+  ack_msg.data[ACK_SESSION] = rx_session;
+  ack_msg.data[ACK_CUMULATIVE] = rx_next;
+  ack_msg.data[ACK_SELECTIVE] = selective;
+  ack_msg.data[ACK_ECHO_SEQUENCE] = echo_sequence;
+  ack_msg.data[ACK_ECHO_ATTEMPT] = echo_attempt;
+
+  return MESS_AddMessageToTxQ(&ack_msg) == pdPASS;
+}
+
+// Retransmissions are sent before new frames, oldest first
+void sendNextFrame(uint32_t now)
+{
+  uint8_t in_flight = SEQ_OFFSET(tx_next, tx_base);
+
+  for (uint8_t i = 0; i < in_flight; i++) {
+    uint8_t seq = tx_base + i;
+    ArqTxSlot_t* slot = &tx_slots[seq % MAX_ARQ_WINDOW];
+    if (slot->acked == true || slot->transmissions == 0) {
+      continue;
+    }
+
+    bool timed_out = (now - slot->sent_tick) >= rto;
+    if (timed_out == false && slot->fast_retransmit == false) {
+      continue;
+    }
+
+    if (slot->transmissions >= ARQ_MAX_TRANSMISSIONS) {
+      slot->acked = true;
+      stats.given_up++;
+      continue;
+    }
+
+    if (timed_out == true) {
+      stats.timeouts++;
+      // Back off once per expiry of the oldest frame rather than per frame
+      if (seq == tx_base) {
+        rto = (2 * rto > ARQ_MAX_RTO_MS) ? ARQ_MAX_RTO_MS : 2 * rto;
+      }
+    }
+    else {
+      stats.fast_retransmits++;
+    }
+    if (transmitSlot(slot, now) == true) {
+      stats.retransmissions++;
+    }
+    slideWindow();
+    return;
+  }
+
+  slideWindow();
+
+  in_flight = SEQ_OFFSET(tx_next, tx_base);
+  for (uint8_t i = 0; i < in_flight; i++) {
+    ArqTxSlot_t* slot = &tx_slots[(uint8_t) (tx_base + i) % MAX_ARQ_WINDOW];
+    if (slot->acked == false && slot->transmissions == 0) {
+      transmitSlot(slot, now);
+      return;
+    }
+  }
+}
+
+bool transmitSlot(ArqTxSlot_t* slot, uint32_t now)
+{
+  // Lets the receiver skip frames that the sender has given up on
+  slot->frame.data[HEADER_BASE] = tx_base;
+  slot->frame.data[HEADER_ATTEMPT] = slot->transmissions + 1;
+  if (MESS_AddMessageToTxQ(&slot->frame) != pdPASS) {
+    return false;
+  }
+  slot->sent_tick = now;
+  slot->transmissions++;
+  slot->fast_retransmit = false;
+  stats.frames++;
+  return true;
+}
+
+void slideWindow()
+{
+  while (tx_base != tx_next) {
+    if (tx_slots[tx_base % MAX_ARQ_WINDOW].acked == false) {
+      return;
+    }
+    tx_base++;
+  }
+}
+
+void handleAck(const Message_t* msg, uint32_t now)
+{
+  if (msg->length_bits < ARQ_ACK_BYTES * 8 ||
+      msg->data[ACK_SESSION] != tx_session) {
+    return;
+  }
+  stats.acks++;
+
+  uint8_t cumulative = msg->data[ACK_CUMULATIVE];
+  uint8_t selective = msg->data[ACK_SELECTIVE];
+  uint8_t in_flight = SEQ_OFFSET(tx_next, tx_base);
+  // Stale acknowledgement from before the window moved
+  if (SEQ_OFFSET(cumulative, tx_base) > in_flight) {
+    return;
+  }
+
+  // The echoed transmission is only matched if it is the latest one so the
+  // send time is the one the receiver responded to
+  uint8_t echo = msg->data[ACK_ECHO_SEQUENCE];
+  if (SEQ_OFFSET(echo, tx_base) < in_flight) {
+    ArqTxSlot_t* slot = &tx_slots[echo % MAX_ARQ_WINDOW];
+    if (slot->transmissions == msg->data[ACK_ECHO_ATTEMPT]) {
+      updateRto(now - slot->sent_tick);
+    }
+  }
+
+  uint8_t highest_received = 0;
+  bool any_selective = false;
+
+  for (uint8_t i = 0; i < in_flight; i++) {
+    uint8_t seq = tx_base + i;
+    bool received = SEQ_OFFSET(seq, tx_base) < SEQ_OFFSET(cumulative, tx_base);
+    uint8_t selective_index = SEQ_OFFSET(seq, cumulative) - 1;
+    if (received == false && SEQ_OFFSET(seq, cumulative) != 0 &&
+        selective_index < 8 && (selective & (1 << selective_index)) != 0) {
+      received = true;
+      any_selective = true;
+      highest_received = i;
+    }
+    if (received == true && tx_slots[seq % MAX_ARQ_WINDOW].transmissions != 0) {
+      tx_slots[seq % MAX_ARQ_WINDOW].acked = true;
+    }
+  }
+
+  // Holes below a selectively acknowledged frame that were sent before it
+  // must have been lost
+  if (any_selective == true) {
+    uint32_t reference_tick = tx_slots[(uint8_t) (tx_base + highest_received) % MAX_ARQ_WINDOW].sent_tick;
+    for (uint8_t i = 0; i < highest_received; i++) {
+      ArqTxSlot_t* slot = &tx_slots[(uint8_t) (tx_base + i) % MAX_ARQ_WINDOW];
+      if (slot->acked == false && slot->transmissions != 0 &&
+          slot->sent_tick < reference_tick) {
+        slot->fast_retransmit = true;
+      }
+    }
+  }
+
+  slideWindow();
+}
+
+void handleData(const Message_t* msg)
+{
+  if (msg->length_bits < ARQ_DATA_HEADER_BYTES * 8) {
+    return;
+  }
+  uint8_t session = msg->data[HEADER_SESSION];
+  uint8_t seq = msg->data[HEADER_SEQUENCE];
+  uint8_t base = msg->data[HEADER_BASE];
+  uint16_t payload_bits = (msg->data[HEADER_LENGTH_HIGH] << 8) |
+                          msg->data[HEADER_LENGTH_LOW];
+  // The cargo is rounded up to whole length steps so it can only be longer
+  if (payload_bits > msg->length_bits - ARQ_DATA_HEADER_BYTES * 8) {
+    return;
+  }
+
+  // The received message type does not say which medium the frame arrived
+  // on, so acknowledgements only use the feedback network for the loopback test
+  ack_type = (testing == true) ? MSG_TRANSMIT_FEEDBACK : MSG_TRANSMIT_TRANSDUCER;
+  echo_sequence = seq;
+  echo_attempt = msg->data[HEADER_ATTEMPT];
+  ack_pending = true;
+
+  if (rx_session_valid == false || session != rx_session) {
+    resetReceiver(session, base);
+  }
+  // The sender gave up on everything below its window base
+  if (SEQ_OFFSET(base, rx_next) != 0 && SEQ_OFFSET(base, rx_next) < 128) {
+    skipTo(base);
+  }
+
+  uint8_t offset = SEQ_OFFSET(seq, rx_next);
+  if (offset >= MAX_ARQ_WINDOW) {
+    // Already delivered (the acknowledgement was lost) or outside the window
+    if (offset >= 128) {
+      stats.suppressed++;
+    }
+    return;
+  }
+
+  ArqRxSlot_t* slot = &rx_slots[seq % MAX_ARQ_WINDOW];
+  if (slot->valid == true) {
+    stats.suppressed++;
+    return;
+  }
+
+  // Restore the original message without the link header
+  memcpy(&slot->msg, msg, sizeof(Message_t));
+  slot->msg.data_type = msg->data[HEADER_DATA_TYPE];
+  slot->msg.preamble.message_type.value = msg->data[HEADER_DATA_TYPE];
+  slot->msg.length_bits = payload_bits;
+  memmove(slot->msg.data, &msg->data[ARQ_DATA_HEADER_BYTES], (payload_bits + 7) / 8);
+  slot->valid = true;
+
+  deliverInOrder();
+}
+
+// Delivers what is buffered up to the new base and skips the missing frames
+void skipTo(uint8_t base)
+{
+  while (rx_next != base) {
+    ArqRxSlot_t* slot = &rx_slots[rx_next % MAX_ARQ_WINDOW];
+    if (slot->valid == true) {
+      deliver(&slot->msg);
+      slot->valid = false;
+    }
+    rx_next++;
+  }
+  deliverInOrder();
+}
+
+void deliverInOrder()
+{
+  ArqRxSlot_t* slot = &rx_slots[rx_next % MAX_ARQ_WINDOW];
+  while (slot->valid == true) {
+    deliver(&slot->msg);
+    slot->valid = false;
+    rx_next++;
+    slot = &rx_slots[rx_next % MAX_ARQ_WINDOW];
+  }
+}
+
+void deliver(Message_t* msg)
+{
+  if (testing == true) {
+    checkTestDelivery(msg);
+    return;
+  }
+  if (Fragment_Check(msg) == false) {
+    MESS_AddMessageToRxQ(msg);
+  }
+}
+
+// Jacobson/Karels estimator from RFC 6298 with alpha = 1/8 and beta = 1/4
+void updateRto(uint32_t rtt_sample)
+{
+  if (rtt_measured == false) {
+    srtt = rtt_sample;
+    rttvar = rtt_sample / 2;
+    rtt_measured = true;
+  }
+  else {
+    uint32_t delta = (srtt > rtt_sample) ? (srtt - rtt_sample) : (rtt_sample - srtt);
+    rttvar = (3 * rttvar + delta) / 4;
+    srtt = (7 * srtt + rtt_sample) / 8;
+  }
+
+  rto = srtt + 4 * rttvar;
+  if (rto < ARQ_MIN_RTO_MS) {
+    rto = ARQ_MIN_RTO_MS;
+  }
+  else if (rto > ARQ_MAX_RTO_MS) {
+    rto = ARQ_MAX_RTO_MS;
+  }
+}
+
+// Upper bound since some modulations carry more than one bit per symbol
+uint32_t frameAirtime(uint16_t cargo_bits, const DspConfig_t* cfg)
+{
+  uint16_t preamble_bits = ErrorCorrection_CodedLength(
+      PACKET_PREAMBLE_LENGTH_BITS + PACKET_MAX_ERROR_DETECTION_BITS,
+      cfg->preamble_ecc_method);
+  uint16_t coded_cargo_bits = ErrorCorrection_CodedLength(
+      cargo_bits + PACKET_MAX_ERROR_DETECTION_BITS, cfg->cargo_ecc_method);
+  return (uint32_t) (1000.0f * (preamble_bits + coded_cargo_bits) / cfg->baud_rate);
+}
+
+void feedTestMessages()
+{
+  while (stats.sent < ARQ_TEST_MESSAGES) {
+    memset(&queued_msg, 0, sizeof(Message_t));
+    queued_msg.type = MSG_TRANSMIT_FEEDBACK;
+    queued_msg.timestamp = osKernelGetTickCount();
+    queued_msg.data_type = BITS;
+    queued_msg.length_bits = ARQ_TEST_PAYLOAD_BYTES * 8;
+    for (uint8_t i = 0; i < ARQ_TEST_PAYLOAD_BYTES; i++) {
+      queued_msg.data[i] = (uint8_t) (stats.sent * 7 + i);
+    }
+    queued_msg.data[0] = (uint8_t) stats.sent;
+    if (xQueueSend(arq_queue, &queued_msg, 0) != pdPASS) {
+      return;
+    }
+    stats.sent++;
+  }
+}
+
+void checkTestDelivery(const Message_t* msg)
+{
+  bool valid = msg->data_type == BITS &&
+      msg->length_bits == ARQ_TEST_PAYLOAD_BYTES * 8;
+  uint8_t index = msg->data[0];
+  for (uint8_t i = 1; i < ARQ_TEST_PAYLOAD_BYTES && valid == true; i++) {
+    valid = msg->data[i] == (uint8_t) (index * 7 + i);
+  }
+  if (valid == false) {
+    stats.corrupt++;
+    return;
+  }
+
+  if (index < stats.next_index) {
+    stats.duplicates++;
+  }
+  else {
+    if (index != stats.next_index) {
+      stats.out_of_order++;
+    }
+    stats.next_index = index + 1;
+  }
+  stats.delivered++;
+
+  char output_buffer[64];
+  snprintf(output_buffer, 64, "ARQ_RX,%u,%lu\r\n", index,
+      osKernelGetTickCount() - stats.start_tick);
+  COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+}
+
+// Done once every test message has been acknowledged or given up on
+void checkTestComplete(uint32_t now)
+{
+  if ((now - stats.start_tick) >= ARQ_TEST_TIMEOUT_MS) {
+    finishTest(true);
+    return;
+  }
+  if (stats.sent == ARQ_TEST_MESSAGES && uxQueueMessagesWaiting(arq_queue) == 0 &&
+      tx_base == tx_next) {
+    finishTest(false);
+  }
+}
+
+void finishTest(bool timed_out)
+{
+  testing = false;
+
+  bool pass = timed_out == false &&
+      stats.delivered == ARQ_TEST_MESSAGES &&
+      stats.out_of_order == 0 && stats.duplicates == 0 &&
+      stats.corrupt == 0;
+
+  char output_buffer[192];
+  snprintf(output_buffer, 192, "ARQ_RESULT,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,"
+      "%u,%u,%lu,%lu,%lu,%s\r\n", stats.sent, stats.delivered,
+      stats.out_of_order, stats.duplicates, stats.corrupt,
+      stats.frames, stats.retransmissions, stats.timeouts,
+      stats.fast_retransmits, stats.given_up, stats.acks,
+      stats.suppressed, stats.erased, srtt, rto,
+      osKernelGetTickCount() - stats.start_tick, pass ? "PASS" : "FAIL");
+  COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+  COMM_TransmitData("ARQ_END\r\n", CALC_LEN, COMM_USB);
+}
+
+// Erasure channel on top of the feedback network (xorshift32)
+bool eraseFrame()
+{
+  loss_state ^= loss_state << 13;
+  loss_state ^= loss_state >> 17;
+  loss_state ^= loss_state << 5;
+  if ((loss_state % 100) < ARQ_TEST_LOSS_PERCENT) {
+    stats.erased++;
+    return true;
+  }
+  return false;
+}
@@ -139,6 +139,9 @@ bool addCustomCargo(BitMessage_t* bit_msg, Message_t* msg, const DspConfig_t* cf
     case FLOAT:
     case BITS:
     case UNKNOWN:
+    case ARQ_DATA:
+    case ARQ_ACK:
+    case FRAGMENT:
       return addDataCustomCargo(bit_msg, msg, cfg);
     case EVAL:
       return Evaluate_AddCargo(bit_msg);
@@ -249,6 +252,9 @@ bool extractCustomCargo(BitMessage_t* bit_msg, Message_t* msg)
     case FLOAT:
     case BITS:
     case UNKNOWN:
+    case ARQ_DATA:
+    case ARQ_ACK:
+    case FRAGMENT:
       return extractDataCustomCargo(bit_msg, msg);
     case EVAL:
       return Evaluate_CodedBer(&msg->eval_info, bit_msg);
@@ -11,6 +11,7 @@
 #include "mess_adc.h"
 #include "mess_main.h"
 #include "mess_modulate.h"
+#include "mess_ofdm.h"
 
 #include "cfg_defaults.h"
 #include "cfg_parameters.h"
@@ -28,6 +29,11 @@ typedef struct {
   float energy_f1;
 } DemodulationHistory_t;
 
+typedef struct {
+  float real;
+  float imag;
+} ComplexSample_t;
+
 /* Private define ------------------------------------------------------------*/
 
 #define NUM_DEMODULATION_HISTORY          8 // Number of demodulations to look back on. Must be a power of 2
@@ -56,9 +62,15 @@ static float significant_shift_threshold = DEFAULT_HIST_CMP_THRESH;
 static WindowFunction_t window_function = DEFAULT_WINDOW_FUNCTION;
 float window[WINDOW_FUNCTION_SIZE];
 
+// Carrier bin of the previous DPSK symbol
+static ComplexSample_t previous_symbol;
+
 /* Private function prototypes -----------------------------------------------*/
 
 static void GoertzelInfoCopy(GoertzelInfo_t* goertzel_info, DemodulationInfo_t* data);
+static bool demodulateMfsk(DemodulationInfo_t* data, const DspConfig_t* cfg);
+static bool demodulateDpsk(DemodulationInfo_t* data, const DspConfig_t* cfg);
+static float binarySoftBit(float energy_f0, float energy_f1);
 static void updateWindow();
 static void setWindowRectangular();
 static void setWindowHann();
@@ -87,6 +99,8 @@ bool Demodulate_Perform(DemodulationInfo_t* data, const DspConfig_t* cfg)
 
       data->analysis_done = true;
       data->decoded_bit = (goertzel_info.e_f[0] > goertzel_info.e_f[1]) ? false : true;
+      data->num_bits = 1;
+      data->soft_bits[0] = binarySoftBit(goertzel_info.e_f[0], goertzel_info.e_f[1]);
       break;
     case MOD_DEMOD_FHBFSK: {
       data->f0 = Modulate_GetFhbfskFrequency(false, data->chip_index, cfg);
@@ -103,8 +117,18 @@ bool Demodulate_Perform(DemodulationInfo_t* data, const DspConfig_t* cfg)
 
       data->analysis_done = true;
       data->decoded_bit = (goertzel_info.e_f[0] > goertzel_info.e_f[1]) ? false : true;
+      data->num_bits = 1;
+      data->soft_bits[0] = binarySoftBit(goertzel_info.e_f[0], goertzel_info.e_f[1]);
       break;
     }
+    case MOD_DEMOD_MFSK:
+      // The decision methods only apply to binary tone pairs
+      return demodulateMfsk(data, cfg);
+    case MOD_DEMOD_DBPSK:
+    case MOD_DEMOD_DQPSK:
+      return demodulateDpsk(data, cfg);
+    case MOD_DEMOD_OFDM:
+      return Ofdm_DemodulateSymbol(data, cfg);
     default:
       return false;
   }
@@ -180,6 +204,14 @@ bool Demodulate_Perform(DemodulationInfo_t* data, const DspConfig_t* cfg)
   return true;
 }
 
+uint16_t Demodulate_SymbolLength(const DspConfig_t* cfg)
+{
+  if (cfg->mod_demod_method == MOD_DEMOD_OFDM) {
+    return OFDM_SYMBOL_SAMPLES;
+  }
+  return (uint16_t) ((float) ADC_SAMPLING_RATE / cfg->baud_rate);
+}
+
 float Demodulate_PowerNormalization()
 {
   switch (window_function) {
@@ -245,6 +277,149 @@ void GoertzelInfoCopy(GoertzelInfo_t* goertzel_info, DemodulationInfo_t* data)
   goertzel_info->window_size = WINDOW_FUNCTION_SIZE;
 }
 
+// Max-energy decision over the M tone bank
+bool demodulateMfsk(DemodulationInfo_t* data, const DspConfig_t* cfg)
+{
+  if ((cfg->mfsk_bits_per_symbol < MIN_MFSK_BITS_PER_SYMBOL) ||
+      (cfg->mfsk_bits_per_symbol > MAX_MFSK_BITS_PER_SYMBOL)) {
+    return false;
+  }
+  uint16_t num_tones = 1 << cfg->mfsk_bits_per_symbol;
+
+  uint32_t f[MFSK_MAX_TONES];
+  float e_f[MFSK_MAX_TONES];
+  for (uint16_t symbol = 0; symbol < num_tones; symbol++) {
+    f[symbol] = Modulate_GetMfskFrequency(symbol, cfg);
+  }
+
+  GoertzelInfo_t goertzel_info;
+  GoertzelInfoCopy(&goertzel_info, data);
+  goertzel_info.energy_normalization = Demodulate_PowerNormalization();
+
+  // M is always a multiple of 4
+  for (uint16_t i = 0; i < num_tones; i += 4) {
+    goertzel_info.f = &f[i];
+    goertzel_info.e_f = &e_f[i];
+    goertzel_4(&goertzel_info);
+  }
+
+  uint8_t best_symbol = 0;
+  float total_energy = 0.0f;
+  for (uint16_t symbol = 0; symbol < num_tones; symbol++) {
+    total_energy += e_f[symbol];
+    if (e_f[symbol] > e_f[best_symbol]) {
+      best_symbol = symbol;
+    }
+  }
+
+  // Max-log approximation of each bit's likelihood normalized by the total
+  // energy in the bank
+  for (uint8_t bit = 0; bit < cfg->mfsk_bits_per_symbol; bit++) {
+    uint8_t bit_mask = 1 << (cfg->mfsk_bits_per_symbol - 1 - bit);
+    float max_energy_0 = 0.0f;
+    float max_energy_1 = 0.0f;
+    for (uint16_t symbol = 0; symbol < num_tones; symbol++) {
+      if (symbol & bit_mask) {
+        max_energy_1 = MAX(max_energy_1, e_f[symbol]);
+      }
+      else {
+        max_energy_0 = MAX(max_energy_0, e_f[symbol]);
+      }
+    }
+    data->soft_bits[bit] = (total_energy > 0.0f) ?
+        (max_energy_1 - max_energy_0) / total_energy : 0.0f;
+  }
+
+  data->analysis_done = true;
+  data->num_bits = cfg->mfsk_bits_per_symbol;
+  data->decoded_symbol = best_symbol;
+  data->decoded_bit = (best_symbol >> (cfg->mfsk_bits_per_symbol - 1)) & 1;
+  return true;
+}
+
+// Differential detection of the carrier phase against the previous symbol.
+// The first block is the phase reference and carries no data
+bool demodulateDpsk(DemodulationInfo_t* data, const DspConfig_t* cfg)
+{
+  uint32_t f[1] = {cfg->fc};
+  float e_f[1];
+  ComplexSample_t current_symbol;
+
+  GoertzelInfo_t goertzel_info;
+  GoertzelInfoCopy(&goertzel_info, data);
+  goertzel_info.f = f;
+  goertzel_info.e_f = e_f;
+  goertzel_info.energy_normalization = Demodulate_PowerNormalization();
+
+  goertzel_1_iq(&goertzel_info, &current_symbol.real, &current_symbol.imag);
+
+  data->f0 = cfg->fc;
+  data->f1 = cfg->fc;
+  data->energy_f0 = e_f[0];
+  data->energy_f1 = e_f[0];
+  data->analysis_done = true;
+
+  if (data->bit_index < DPSK_REFERENCE_SYMBOLS) {
+    previous_symbol = current_symbol;
+    data->num_bits = 0;
+    return true;
+  }
+
+  // z = y[k] * conj(y[k-1])
+  float z_real = current_symbol.real * previous_symbol.real +
+                 current_symbol.imag * previous_symbol.imag;
+  float z_imag = current_symbol.imag * previous_symbol.real -
+                 current_symbol.real * previous_symbol.imag;
+  previous_symbol = current_symbol;
+
+  // Remove the carrier phase advance across one block (pre-scaled by pi). DQPSK
+  // is rotated a further pi/4 so the decision boundaries lie on the axes
+  uint64_t advance = ((uint64_t) 2 * cfg->fc * data->data_len) % (2 * ADC_SAMPLING_RATE);
+  float angle = (float) advance / ADC_SAMPLING_RATE;
+  if (cfg->mod_demod_method == MOD_DEMOD_DQPSK) {
+    angle += 0.25f;
+  }
+  if (angle >= 1.0f) {
+    angle -= 2.0f;
+  }
+  float cos_angle = uam_cosf(angle);
+  float sin_angle = uam_sinf(angle);
+  float rotated_real = z_real * cos_angle + z_imag * sin_angle;
+  float rotated_imag = z_imag * cos_angle - z_real * sin_angle;
+
+  float magnitude = sqrtf(rotated_real * rotated_real + rotated_imag * rotated_imag);
+  float inverse_magnitude = (magnitude > 0.0f) ? 1.0f / magnitude : 0.0f;
+
+  if (cfg->mod_demod_method == MOD_DEMOD_DBPSK) {
+    // 0 -> no change, 1 -> pi
+    data->num_bits = 1;
+    data->decoded_bit = rotated_real < 0.0f;
+    data->decoded_symbol = data->decoded_bit;
+    data->soft_bits[0] = -rotated_real * inverse_magnitude;
+    return true;
+  }
+
+  // Gray coded quadrants after the pi/4 rotation: the first bit is set in the
+  // left half plane and the second bit in the upper half plane
+  bool first_bit = rotated_real < 0.0f;
+  bool second_bit = rotated_imag > 0.0f;
+  data->num_bits = 2;
+  data->decoded_bit = first_bit;
+  data->decoded_symbol = (first_bit << 1) | second_bit;
+  data->soft_bits[0] = -rotated_real * inverse_magnitude;
+  data->soft_bits[1] = rotated_imag * inverse_magnitude;
+  return true;
+}
+
+float binarySoftBit(float energy_f0, float energy_f1)
+{
+  float total_energy = energy_f0 + energy_f1;
+  if (total_energy <= 0.0f) {
+    return 0.0f;
+  }
+  return (energy_f1 - energy_f0) / total_energy;
+}
+
 void updateWindow()
 {
   switch (window_function) {
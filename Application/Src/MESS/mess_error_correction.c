@@ -14,6 +14,8 @@
 #include "mess_error_correction.h"
 #include "mess_packet.h"
 #include "number_utils.h"
+#include "cfg_defaults.h"
+#include "cfg_parameters.h"
 #include <stdbool.h>
 #include <string.h>
 
@@ -23,6 +25,31 @@ typedef struct {
   uint16_t register_state;
 } ConvEncoder_t;
 
+typedef struct {
+  const int8_t* shifts;   // num_rows x LDPC_BASE_COLUMNS. -1 is a zero block
+  uint8_t num_rows;       // Number of parity block columns
+  bool modulo_scaling;    // Shifts are reduced mod Z instead of scaled by Z/96
+} LdpcBaseMatrix_t;
+
+typedef struct {
+  const LdpcBaseMatrix_t* base;
+  uint16_t num_blocks;    // Codewords in the section
+  uint8_t lifting;        // Z
+  uint16_t info_bits;     // Including shortened bits
+  uint16_t parity_bits;
+} LdpcLayout_t;
+
+typedef struct {
+  bool active;                    // A section is partially decoded
+  bool is_preamble;
+  ErrorCorrectionMethod_t method;
+  uint16_t input_bits;            // Coded bits consumed from the section
+  uint16_t output_bits;           // Raw bits decided so far
+  uint16_t block;                 // Next Reed-Solomon or LDPC block
+  bool error_detected;
+  bool all_corrected;             // Every block with an error was corrected
+} StreamDecoder_t;
+
 /* Private define ------------------------------------------------------------*/
 
 /* 1:2 convolutional encoder defines -----------------------------------------*/
@@ -41,6 +68,28 @@ typedef struct {
 
 #define JANUS_SOFT_DECISION     (false) // true to use soft decision and false otherwise
 
+/* Reed-Solomon defines ------------------------------------------------------*/
+
+// Symbols are elements of GF(256) built from x^8 + x^4 + x^3 + x^2 + 1 with
+// alpha = 2. The first consecutive root of the generator is alpha^0
+#define RS_SYMBOL_BITS          8
+#define RS_FIELD_ORDER          255
+#define RS_MAX_BLOCK_LENGTH     (MAX_RS_BLOCK_LENGTH)
+#define RS_MAX_PARITY_SYMBOLS   (MAX_RS_PARITY_SYMBOLS)
+
+/* LDPC defines --------------------------------------------------------------*/
+
+#define LDPC_MAX_BASE_ROWS      12
+#define LDPC_MAX_BASE_EDGES     85  // Rate 3/4
+#define LDPC_MAX_ROW_WEIGHT     15  // Rate 3/4
+#define LDPC_STANDARD_LIFTING   96  // Z the base matrix shifts are defined for
+#define LDPC_MIN_LIFTING        4
+#define LDPC_MAX_PARITY_BITS    (LDPC_MAX_BASE_ROWS * LDPC_MAX_LIFTING)
+
+#define LDPC_CHANNEL_LLR        16  // Confidence of a bit without a soft decision
+#define LDPC_CONFIDENCE_LLR     2   // LLR per level of a soft decision (max 30)
+#define LDPC_MAX_LLR            127
+
 typedef struct {
   float path_metrics[JANUS_NUM_STATES];                         // Current path metrics
   float next_path_metrics[JANUS_NUM_STATES];                    // Next iteration path metrics
@@ -52,18 +101,152 @@ typedef struct {
 /* Private macro -------------------------------------------------------------*/
 
 #define MIN(x, y) ((x < y) ? (x) : (y))
+#define MAX(x, y) ((x > y) ? (x) : (y))
+
+// Normalized min-sum scaling of 0.75
+#define LDPC_NORMALIZE(x) (((x) * 3) >> 2)
 
 /* Private variables ---------------------------------------------------------*/
 
 static uint8_t message_buffer[PACKET_MAX_LENGTH_BYTES] = {0};
 
+// Decoded bits are held here until the section is finished so the coded bits
+// stay intact for the uncoded BER evaluation
+static uint8_t stream_buffer[PACKET_MAX_LENGTH_BYTES];
+static StreamDecoder_t stream = {0};
+static JanusVitrebiDecoder_t janus_decoder;
+
+static uint8_t rs_block_length = DEFAULT_RS_BLOCK_LENGTH;
+static uint8_t rs_parity_symbols = DEFAULT_RS_PARITY_SYMBOLS;
+
+static LdpcRate_t ldpc_rate = DEFAULT_LDPC_RATE;
+static uint8_t ldpc_max_iterations = DEFAULT_LDPC_ITERATIONS;
+
+// alpha^i for i in [0, 510] so products never need a modulo
+static const uint8_t gf_exp[512] = {
+  0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+  0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+  0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+  0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+  0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+  0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+  0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+  0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+  0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+  0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+  0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+  0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+  0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+  0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+  0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+  0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+  0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C,
+  0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+  0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23, 0x46,
+  0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F,
+  0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+  0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2, 0xD9,
+  0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81,
+  0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+  0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54, 0xA8,
+  0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6,
+  0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+  0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41, 0x82,
+  0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51,
+  0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+  0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16, 0x2C,
+  0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01, 0x02
+};
+
+// log_alpha(x). gf_log[0] is unused
+static const uint8_t gf_log[256] = {
+  0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+  0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+  0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+  0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+  0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+  0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+  0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+  0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+  0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+  0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+  0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+  0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+  0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+  0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+  0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+  0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF
+};
+
+// IEEE 802.16e rate 1/2
+static const int8_t ldpc_base_1_2[12][LDPC_BASE_COLUMNS] = {
+  {-1, 94, 73, -1, -1, -1, -1, -1, 55, 83, -1, -1,  7,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+  {-1, 27, -1, -1, -1, 22, 79,  9, -1, -1, -1, 12, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+  {-1, -1, -1, 24, 22, 81, -1, 33, -1, -1, -1,  0, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1},
+  {61, -1, 47, -1, -1, -1, -1, -1, 65, 25, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1},
+  {-1, -1, 39, -1, -1, -1, 84, -1, -1, 41, 72, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1},
+  {-1, -1, -1, -1, 46, 40, -1, 82, -1, -1, -1, 79,  0, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1},
+  {-1, -1, 95, 53, -1, -1, -1, -1, -1, 14, 18, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1},
+  {-1, 11, 73, -1, -1, -1,  2, -1, -1, 47, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1},
+  {12, -1, -1, -1, 83, 24, -1, 43, -1, -1, -1, 51, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1},
+  {-1, -1, -1, -1, -1, 94, -1, 59, -1, -1, 70, 72, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1},
+  {-1, -1,  7, 65, -1, -1, -1, -1, 39, 49, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0},
+  {43, -1, -1, -1, -1, 66, -1, 41, -1, -1, -1, 26,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0}
+};
+
+// IEEE 802.16e rate 2/3A
+static const int8_t ldpc_base_2_3[8][LDPC_BASE_COLUMNS] = {
+  { 3,  0, -1, -1,  2,  0, -1,  3,  7, -1,  1,  1, -1, -1, -1, -1,  1,  0, -1, -1, -1, -1, -1, -1},
+  {-1, -1,  1, -1, 36, -1, -1, 34, 10, -1, -1, 18,  2, -1,  3,  0, -1,  0,  0, -1, -1, -1, -1, -1},
+  {-1, -1, 12,  2, -1, 15, -1, 40, -1,  3, -1, 15, -1,  2, 13, -1, -1, -1,  0,  0, -1, -1, -1, -1},
+  {-1, -1, 19, 24, -1,  3,  0, -1,  6, -1, 17, -1, -1, -1,  8, 39, -1, -1, -1,  0,  0, -1, -1, -1},
+  {20, -1,  6, -1, -1, 10, 29, -1, -1, 28, -1, 14, -1, 38, -1, -1,  0, -1, -1, -1,  0,  0, -1, -1},
+  {-1, -1, 10, -1, 28, 20, -1, -1,  8, -1, 36, -1,  9, -1, 21, 45, -1, -1, -1, -1, -1,  0,  0, -1},
+  {35, 25, -1, 37, -1, 21, -1, -1,  5, -1, -1,  0, -1,  4, 20, -1, -1, -1, -1, -1, -1, -1,  0,  0},
+  {-1,  6,  6, -1, -1, -1,  4, -1, 14, 30, -1,  3, 36, -1, 14, -1,  1, -1, -1, -1, -1, -1, -1,  0}
+};
+
+// IEEE 802.16e rate 3/4A
+static const int8_t ldpc_base_3_4[6][LDPC_BASE_COLUMNS] = {
+  { 6, 38,  3, 93, -1, -1, -1, 30, 70, -1, 86, -1, 37, 38,  4, 11, -1, 46, 48,  0, -1, -1, -1, -1},
+  {62, 94, 19, 84, -1, 92, 78, -1, 15, -1, -1, 92, -1, 45, 24, 32, 30, -1, -1,  0,  0, -1, -1, -1},
+  {71, -1, 55, -1, 12, 66, 45, 79, -1, 78, -1, -1, 10, -1, 22, 55, 70, 82, -1, -1,  0,  0, -1, -1},
+  {38, 61, -1, 66,  9, 73, 47, 64, -1, 39, 61, 43, -1, -1, -1, -1, 95, 32,  0, -1, -1,  0,  0, -1},
+  {-1, -1, -1, -1, 32, 52, 55, 80, 95, 22,  6, 51, 24, 90, 44, 20, -1, -1, -1, -1, -1, -1,  0,  0},
+  {-1, 63, 31, 88, 20, -1, -1, -1,  6, 40, 56, 16, 71, 53, -1, -1, 27, 26, 48, -1, -1, -1, -1,  0}
+};
+
+static const LdpcBaseMatrix_t ldpc_base_matrices[NUM_LDPC_RATES] = {
+  [LDPC_RATE_1_2] = {&ldpc_base_1_2[0][0], 12, false},
+  [LDPC_RATE_2_3] = {&ldpc_base_2_3[0][0], 8, true},
+  [LDPC_RATE_3_4] = {&ldpc_base_3_4[0][0], 6, false}
+};
+
+// Encoder and decoder working memory. Bits are stored one per byte
+static uint8_t ldpc_codeword[LDPC_MAX_CODEWORD_BITS];
+static uint8_t ldpc_lambda[LDPC_MAX_PARITY_BITS];
+static int16_t ldpc_posterior[LDPC_MAX_CODEWORD_BITS];
+static int8_t ldpc_check_messages[LDPC_MAX_BASE_EDGES * LDPC_MAX_LIFTING];
+
 /* Private function prototypes -----------------------------------------------*/
 
+static bool addUncoded(BitMessage_t* bit_msg, bool is_preamble, uint16_t* bits_added);
+static bool moveUncoded(BitMessage_t* bit_msg, bool is_preamble);
+
 static bool addHamming(BitMessage_t* bit_msg, bool is_preamble, uint16_t* bits_added);
 static bool decodeHamming(BitMessage_t* bit_msg, bool is_preamble, bool* error_detected, bool* error_corrected);
 
 static bool addJanusConvolutional(BitMessage_t* bit_msg, bool is_preamble, uint16_t* bits_added);
-static bool decodeJanusConvolutional(BitMessage_t* bit_msg, bool is_preamble, bool* error_detected, bool* error_corrected);
+static bool consumeJanusConvolutional(BitMessage_t* bit_msg, uint16_t available_bits);
+
+static bool addReedSolomon(BitMessage_t* bit_msg, bool is_preamble, uint16_t* bits_added);
+static bool consumeReedSolomon(BitMessage_t* bit_msg, uint16_t available_bits);
+
+static bool addLdpc(BitMessage_t* bit_msg, bool is_preamble, uint16_t* bits_added);
+static bool consumeLdpc(BitMessage_t* bit_msg, uint16_t available_bits);
+
+static bool decodeStreamed(BitMessage_t* bit_msg, ErrorCorrectionMethod_t method,
+                           bool is_preamble, bool* error_detected, bool* error_corrected);
 
 // Hamming functions
 static uint16_t calculateNumParityBits(const uint16_t num_bits);
@@ -80,6 +263,35 @@ static void janusVitrebiDecodePair(JanusVitrebiDecoder_t* decoder, bool received
 static bool janusVitrebiTraceback(JanusVitrebiDecoder_t* decoder, bool* bit, uint16_t bit_index);
 static uint16_t janusVitrebiFindBestState(JanusVitrebiDecoder_t* decoder);
 
+// Reed-Solomon functions
+static uint8_t gfMultiply(uint8_t a, uint8_t b);
+static uint8_t gfDivide(uint8_t a, uint8_t b);
+static bool rsValidParameters(void);
+static uint16_t rsNumBlocks(uint16_t raw_len);
+static void rsGenerator(uint8_t* generator, uint8_t num_parity);
+static void rsEncodeBlock(uint8_t* codeword, uint8_t num_data,
+                          const uint8_t* generator, uint8_t num_parity);
+static bool rsCalculateSyndromes(const uint8_t* codeword, uint8_t length,
+                                 uint8_t num_parity, uint8_t* syndromes);
+static bool rsDecodeBlock(uint8_t* codeword, uint8_t length, uint8_t num_parity,
+                          const uint8_t* erasures, uint8_t num_erasures,
+                          bool* error_found);
+
+// LDPC functions
+static bool ldpcGetLayout(uint16_t raw_len, LdpcLayout_t* layout);
+static uint16_t ldpcBlockLength(uint16_t raw_len, uint16_t num_blocks, uint16_t block);
+static uint16_t ldpcUncodedLength(uint16_t coded_len);
+static int16_t ldpcShift(const LdpcBaseMatrix_t* base, uint8_t row, uint8_t column, uint8_t lifting);
+static void ldpcEncodeBlock(const LdpcLayout_t* layout);
+static bool ldpcCheckSyndrome(const LdpcLayout_t* layout);
+static bool ldpcDecodeBlock(const LdpcLayout_t* layout);
+
+// Streaming decoder functions
+static void streamStart(ErrorCorrectionMethod_t method, bool is_preamble);
+static bool streamConsume(BitMessage_t* bit_msg, uint16_t available_bits);
+static bool streamFinish(BitMessage_t* bit_msg, bool* error_detected, bool* error_corrected);
+static bool setBitInStream(bool bit, uint16_t position);
+
 // General helper functions
 static void clearBuffer(void);
 static bool setBitInBuffer(bool bit, uint16_t position);
@@ -95,7 +307,10 @@ bool ErrorCorrection_AddCorrection(BitMessage_t* bit_msg,
   clearBuffer();
   switch (cfg->preamble_ecc_method) {
     case NO_ECC:
-      return true;
+      if (addUncoded(bit_msg, true, &bits_added) == false) {
+        return false;
+      }
+      break;
     case HAMMING_CODE:
       if (addHamming(bit_msg, true, &bits_added) == false) {
         return false;
@@ -106,13 +321,26 @@ bool ErrorCorrection_AddCorrection(BitMessage_t* bit_msg,
         return false;
       }
       break;
+    case REED_SOLOMON:
+      if (addReedSolomon(bit_msg, true, &bits_added) == false) {
+        return false;
+      }
+      break;
+    case QC_LDPC:
+      if (addLdpc(bit_msg, true, &bits_added) == false) {
+        return false;
+      }
+      break;
     default:
       return false;
   }
 
   switch (cfg->cargo_ecc_method) {
     case NO_ECC:
-      return true;
+      if (addUncoded(bit_msg, false, &bits_added) == false) {
+        return false;
+      }
+      break;
     case HAMMING_CODE:
       if (addHamming(bit_msg, false, &bits_added) == false) {
         return false;
@@ -123,6 +351,16 @@ bool ErrorCorrection_AddCorrection(BitMessage_t* bit_msg,
         return false;
       }
       break;
+    case REED_SOLOMON:
+      if (addReedSolomon(bit_msg, false, &bits_added) == false) {
+        return false;
+      }
+      break;
+    case QC_LDPC:
+      if (addLdpc(bit_msg, false, &bits_added) == false) {
+        return false;
+      }
+      break;
     default:
       return false;
   }
@@ -146,14 +384,14 @@ bool ErrorCorrection_CheckCorrection(BitMessage_t* bit_msg,
   if (is_preamble) {
     switch (cfg->preamble_ecc_method) {
       case NO_ECC:
-        *error_detected = false;
-        *error_corrected = false;
-        return true;
+        return moveUncoded(bit_msg, true);
       case HAMMING_CODE:
         return decodeHamming(bit_msg, true, error_detected, error_corrected);
       case JANUS_CONVOLUTIONAL:
-        return decodeJanusConvolutional(bit_msg, true, error_detected,
-                                        error_corrected);
+      case REED_SOLOMON:
+      case QC_LDPC:
+        return decodeStreamed(bit_msg, cfg->preamble_ecc_method, true, error_detected,
+                              error_corrected);
       default:
         return false;
     }
@@ -161,20 +399,53 @@ bool ErrorCorrection_CheckCorrection(BitMessage_t* bit_msg,
   else {
     switch (cfg->cargo_ecc_method) {
       case NO_ECC:
-        *error_detected = false;
-        *error_corrected = false;
-        return true;
+        return moveUncoded(bit_msg, false);
       case HAMMING_CODE:
         return decodeHamming(bit_msg, false, error_detected, error_corrected);
       case JANUS_CONVOLUTIONAL:
-        return decodeJanusConvolutional(bit_msg, false, error_detected,
-                                        error_corrected);
+      case REED_SOLOMON:
+      case QC_LDPC:
+        return decodeStreamed(bit_msg, cfg->cargo_ecc_method, false, error_detected,
+                              error_corrected);
       default:
         return false;
     }
   }
 }
 
+bool ErrorCorrection_StreamCargo(BitMessage_t* bit_msg, const DspConfig_t* cfg)
+{
+  // The interleaver spans the whole section so nothing can be decoded early
+  if (cfg->use_interleaver == true) {
+    return true;
+  }
+  switch (cfg->cargo_ecc_method) {
+    case JANUS_CONVOLUTIONAL:
+    case REED_SOLOMON:
+    case QC_LDPC:
+      break;
+    default:
+      return true;
+  }
+
+  if (stream.active == false || stream.is_preamble == true ||
+      stream.method != cfg->cargo_ecc_method) {
+    streamStart(cfg->cargo_ecc_method, false);
+  }
+
+  uint16_t available_bits = 0;
+  if (bit_msg->bit_count > bit_msg->cargo.ecc_start_index) {
+    available_bits = MIN(bit_msg->bit_count - bit_msg->cargo.ecc_start_index,
+                         bit_msg->cargo.ecc_len);
+  }
+  return streamConsume(bit_msg, available_bits);
+}
+
+void ErrorCorrection_ResetStream(void)
+{
+  stream.active = false;
+}
+
 uint16_t ErrorCorrection_CodedLength(const uint16_t length, 
                                      const ErrorCorrectionMethod_t method)
 {
@@ -185,6 +456,19 @@ uint16_t ErrorCorrection_CodedLength(const uint16_t length,
       return calculateNumParityBits(length) + length;
     case JANUS_CONVOLUTIONAL:
       return 2 * (length + JANUS_FLUSH_LENGTH);
+    case REED_SOLOMON:
+      if (rsValidParameters() == false) {
+        return 0;
+      }
+      return length + rsNumBlocks(length) * rs_parity_symbols * RS_SYMBOL_BITS;
+    case QC_LDPC:
+    {
+      LdpcLayout_t layout;
+      if (ldpcGetLayout(length, &layout) == false) {
+        return 0;
+      }
+      return length + layout.num_blocks * layout.parity_bits;
+    }
     default:
       return 0;
   }
@@ -200,11 +484,56 @@ uint16_t ErrorCorrection_UncodedLength(const uint16_t length,
       return length - (16 - countLeadingZeros(length));
     case JANUS_CONVOLUTIONAL:
       return (length / 2) - 8;
+    case REED_SOLOMON:
+    {
+      if (rsValidParameters() == false) {
+        return 0;
+      }
+      // Every block but the last is full so the block count follows directly
+      uint16_t block_bits = rs_block_length * RS_SYMBOL_BITS;
+      uint16_t num_blocks = (length + block_bits - 1) / block_bits;
+      uint16_t parity_bits = num_blocks * rs_parity_symbols * RS_SYMBOL_BITS;
+      return (length > parity_bits) ? length - parity_bits : 0;
+    }
+    case QC_LDPC:
+      return ldpcUncodedLength(length);
     default:
       return 0;
   }
 }
 
+bool ErrorCorrection_RegisterParams(void)
+{
+  uint32_t min_u32 = MIN_RS_BLOCK_LENGTH;
+  uint32_t max_u32 = MAX_RS_BLOCK_LENGTH;
+  if (Param_Register(PARAM_RS_BLOCK_LENGTH, "the Reed-Solomon block length", PARAM_TYPE_UINT8,
+                     &rs_block_length, sizeof(uint8_t), &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
+  min_u32 = MIN_RS_PARITY_SYMBOLS;
+  max_u32 = MAX_RS_PARITY_SYMBOLS;
+  if (Param_Register(PARAM_RS_PARITY_SYMBOLS, "the Reed-Solomon parity symbols", PARAM_TYPE_UINT8,
+                     &rs_parity_symbols, sizeof(uint8_t), &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
+  min_u32 = MIN_LDPC_RATE;
+  max_u32 = MAX_LDPC_RATE;
+  if (Param_Register(PARAM_LDPC_RATE, "the LDPC code rate", PARAM_TYPE_UINT8,
+                     &ldpc_rate, sizeof(uint8_t), &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
+  min_u32 = MIN_LDPC_ITERATIONS;
+  max_u32 = MAX_LDPC_ITERATIONS;
+  if (Param_Register(PARAM_LDPC_MAX_ITERATIONS, "the LDPC decoder iterations", PARAM_TYPE_UINT8,
+                     &ldpc_max_iterations, sizeof(uint8_t), &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+  return true;
+}
+
 /* Private function definitions ----------------------------------------------*/
 
 /*
@@ -226,6 +555,45 @@ uint16_t ErrorCorrection_UncodedLength(const uint16_t length,
  * 
  * Encoded message: 1001100
  */
+// A section without ECC is still copied so the other section can be coded
+bool addUncoded(BitMessage_t* bit_msg, bool is_preamble, uint16_t* bits_added)
+{
+  SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
+
+  for (uint16_t i = 0; i < section_info.raw_len; i++) {
+    bool bit;
+    if (Packet_GetBit(bit_msg, section_info.raw_start_index + i, &bit) == false) {
+      return false;
+    }
+    if (setBitInBuffer(bit, section_info.ecc_start_index + i) == false) {
+      return false;
+    }
+  }
+  *bits_added += section_info.raw_len;
+  return true;
+}
+
+// Moves the bits of a section without ECC next to the decoded preamble. The
+// raw start never comes after the coded start so copying forward is safe
+bool moveUncoded(BitMessage_t* bit_msg, bool is_preamble)
+{
+  SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
+
+  if (section_info.raw_start_index == section_info.ecc_start_index) {
+    return true;
+  }
+  for (uint16_t i = 0; i < section_info.raw_len; i++) {
+    bool bit;
+    if (Packet_GetBit(bit_msg, section_info.ecc_start_index + i, &bit) == false) {
+      return false;
+    }
+    if (Packet_SetBit(bit_msg, section_info.raw_start_index + i, bit) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool addHamming(BitMessage_t* bit_msg, 
                 bool is_preamble, 
                 uint16_t* bits_added)
@@ -457,19 +825,13 @@ bool addJanusConvolutional(BitMessage_t* bit_msg,
  * determine an error metric. This can then be used in conjunction with each
  * of the path metrics to determine the best path. 
  */
-bool decodeJanusConvolutional(BitMessage_t* bit_msg, 
-                              bool is_preamble, 
-                              bool* error_detected, 
-                              bool* error_corrected)
+bool consumeJanusConvolutional(BitMessage_t* bit_msg, uint16_t available_bits)
 {
-  JanusVitrebiDecoder_t janus_decoder;
-  SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
-  janusVitrebiInit(&janus_decoder);
-
-  uint16_t output_bit_index = 0;
+  SectionInfo_t section_info = stream.is_preamble ? bit_msg->preamble : bit_msg->cargo;
 
   // Decode all received bits and decide bits that we have enough information for
-  for (uint16_t i = 0; i < section_info.ecc_len; i += 2) {
+  while (stream.input_bits + 2 <= available_bits) {
+    uint16_t i = stream.input_bits;
     // Flush bits are handled by forcing the decoding process to only use a 0
     bool is_flush_bit = i >= (section_info.ecc_len - 2 * JANUS_FLUSH_LENGTH);
     uint16_t bit_position = section_info.ecc_start_index + i;
@@ -480,6 +842,7 @@ bool decodeJanusConvolutional(BitMessage_t* bit_msg,
     if (Packet_GetBit(bit_msg, bit_position + 1, &bit2) == false) {
       return false;
     }
+    stream.input_bits += 2;
 
     janusVitrebiDecodePair(&janus_decoder, bit1, bit2, is_flush_bit);
 
@@ -487,39 +850,348 @@ bool decodeJanusConvolutional(BitMessage_t* bit_msg,
     // result in the history buffer being overwritten
     if (janus_decoder.traceback_index >= JANUS_TRACEBACK_LENGTH) {
       bool bit;
-      if (janusVitrebiTraceback(&janus_decoder, &bit, output_bit_index) == false) {
+      if (janusVitrebiTraceback(&janus_decoder, &bit, stream.output_bits) == false) {
         return false;
       }
-      if (Packet_SetBit(bit_msg, section_info.raw_start_index + output_bit_index, bit) == false) {
+      // Bits decided past the raw length are the flush bits
+      if (stream.output_bits < section_info.raw_len) {
+        if (setBitInStream(bit, stream.output_bits) == false) {
+          return false;
+        }
+      }
+      stream.output_bits++;
+    }
+  }
+  return true;
+}
+
+/*
+ * Reed-Solomon codes work on symbols instead of bits. Here a symbol is a byte
+ * and each byte is treated as an element of GF(256). A block of k data
+ * symbols is viewed as the coefficients of a polynomial d(x) and the n - k
+ * parity symbols are the remainder of d(x) * x^(n-k) divided by the
+ * generator polynomial g(x) = (x - a^0)(x - a^1)...(x - a^(n-k-1)). Appending
+ * the remainder makes the codeword divisible by g(x) so every root of g(x) is
+ * also a root of a valid codeword.
+ *
+ * Multiplication in GF(256) is not regular integer multiplication. Every
+ * nonzero element is a power of a (alpha) so multiplication becomes addition
+ * of exponents using log/antilog tables stored in flash:
+ * 0x53 * 0xCA = a^gf_log[0x53] * a^gf_log[0xCA] = a^(0xCE + 0x49) = 0x8F
+ * Addition and subtraction are both XOR.
+ *
+ * Since errors corrupt whole symbols, a burst of up to 8 bit errors inside a
+ * symbol costs the same as a single bit error. n - k parity symbols correct
+ * up to (n - k) / 2 symbol errors per block.
+ *
+ * Sections rarely fill a full block so the code is shortened: the raw bits
+ * are packed MSB first into symbols, split into blocks of at most k data
+ * symbols and each block is treated as if it were prefixed by zeros. The
+ * zeros (and the padding bits of a partial final symbol) are never sent.
+ *
+ * Bit layout of a section: [data bits 0][parity 0][data bits 1][parity 1]...
+ */
+bool addReedSolomon(BitMessage_t* bit_msg,
+                    bool is_preamble,
+                    uint16_t* bits_added)
+{
+  SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
+  if (rsValidParameters() == false) {
+    return false;
+  }
+
+  uint8_t num_parity = rs_parity_symbols;
+  uint8_t data_per_block = rs_block_length - rs_parity_symbols;
+  uint8_t generator[RS_MAX_PARITY_SYMBOLS + 1];
+  uint8_t codeword[RS_MAX_BLOCK_LENGTH];
+  rsGenerator(generator, num_parity);
+
+  uint16_t num_symbols = (section_info.raw_len + RS_SYMBOL_BITS - 1) / RS_SYMBOL_BITS;
+  uint16_t num_blocks = rsNumBlocks(section_info.raw_len);
+  uint16_t input_index = 0;
+  uint16_t output_index = section_info.ecc_start_index;
+
+  for (uint16_t block = 0; block < num_blocks; block++) {
+    uint16_t symbols_left = num_symbols - block * data_per_block;
+    uint8_t num_data = MIN(symbols_left, data_per_block);
+
+    for (uint8_t s = 0; s < num_data; s++) {
+      codeword[s] = 0;
+      for (uint8_t b = 0; b < RS_SYMBOL_BITS; b++) {
+        bool bit = false;
+        if (input_index < section_info.raw_len) {
+          if (Packet_GetBit(bit_msg, section_info.raw_start_index + input_index++, &bit) == false) {
+            return false;
+          }
+          if (setBitInBuffer(bit, output_index++) == false) {
+            return false;
+          }
+        }
+        codeword[s] = (codeword[s] << 1) | bit;
+      }
+    }
+
+    rsEncodeBlock(codeword, num_data, generator, num_parity);
+
+    for (uint8_t s = num_data; s < num_data + num_parity; s++) {
+      for (int8_t b = RS_SYMBOL_BITS - 1; b >= 0; b--) {
+        if (setBitInBuffer((codeword[s] >> b) & 1, output_index++) == false) {
+          return false;
+        }
+      }
+    }
+  }
+
+  *bits_added += output_index - section_info.ecc_start_index;
+  return true;
+}
+
+/*
+ * Decoding evaluates the received polynomial r(x) at the roots of g(x). The
+ * results are the syndromes S_j = r(a^j) which are all zero for a valid
+ * codeword. Otherwise the decoder has to find where the errors are and what
+ * they are:
+ * 1. Berlekamp-Massey finds the shortest error locator polynomial L(x) that
+ *    generates the syndrome sequence. Its roots are the inverses of the error
+ *    locations X = a^(n-1-i) for an error in symbol i.
+ * 2. Chien search tries every symbol position in the block to find the roots
+ *    of L(x). If the number of roots found does not match the degree of L(x)
+ *    there are more errors than the code can correct.
+ * 3. Forney's algorithm gives the error value at each location from the error
+ *    evaluator O(x) = S(x)L(x) mod x^(n-k): e = X * O(1/X) / L'(1/X)
+ *
+ * Erasures (symbols known to be unreliable) only cost one parity symbol each
+ * instead of two. The block decoder seeds Berlekamp-Massey with the erasure
+ * locator so any combination where 2 * errors + erasures <= n - k is
+ * corrected. The bit message does not carry per-symbol reliability yet so
+ * sections are decoded without erasures.
+ */
+bool consumeReedSolomon(BitMessage_t* bit_msg, uint16_t available_bits)
+{
+  SectionInfo_t section_info = stream.is_preamble ? bit_msg->preamble : bit_msg->cargo;
+  if (rsValidParameters() == false) {
+    return false;
+  }
+
+  uint8_t num_parity = rs_parity_symbols;
+  uint8_t data_per_block = rs_block_length - rs_parity_symbols;
+  uint8_t codeword[RS_MAX_BLOCK_LENGTH];
+
+  uint16_t num_symbols = (section_info.raw_len + RS_SYMBOL_BITS - 1) / RS_SYMBOL_BITS;
+  uint16_t num_blocks = rsNumBlocks(section_info.raw_len);
+
+  while (stream.block < num_blocks) {
+    uint16_t symbols_left = num_symbols - stream.block * data_per_block;
+    uint8_t num_data = MIN(symbols_left, data_per_block);
+    // Padding bits of the final data symbol were not sent
+    uint16_t data_bits = MIN(num_data * RS_SYMBOL_BITS, section_info.raw_len - stream.output_bits);
+    if (stream.input_bits + data_bits + num_parity * RS_SYMBOL_BITS > available_bits) {
+      break;
+    }
+
+    uint16_t input_index = section_info.ecc_start_index + stream.input_bits;
+    for (uint8_t s = 0; s < num_data + num_parity; s++) {
+      codeword[s] = 0;
+      for (uint8_t b = 0; b < RS_SYMBOL_BITS; b++) {
+        bool bit = false;
+        if (s >= num_data || s * RS_SYMBOL_BITS + b < data_bits) {
+          if (Packet_GetBit(bit_msg, input_index++, &bit) == false) {
+            return false;
+          }
+        }
+        codeword[s] = (codeword[s] << 1) | bit;
+      }
+    }
+
+    bool block_error = false;
+    if (rsDecodeBlock(codeword, num_data + num_parity, num_parity, NULL, 0,
+                      &block_error) == false) {
+      stream.all_corrected = false;
+    }
+    if (block_error == true) {
+      stream.error_detected = true;
+    }
+
+    for (uint16_t i = 0; i < data_bits; i++) {
+      bool bit = (codeword[i / RS_SYMBOL_BITS] >> (7 - i % RS_SYMBOL_BITS)) & 1;
+      if (setBitInStream(bit, stream.output_bits + i) == false) {
         return false;
       }
-      output_bit_index++;
     }
-  } 
+    stream.input_bits = input_index - section_info.ecc_start_index;
+    stream.output_bits += data_bits;
+    stream.block++;
+  }
+  return true;
+}
 
-  // There are no more input bits so no more information can be gathered about
-  // the sequence.
-  uint16_t remaining_bits = MIN(section_info.raw_len, JANUS_TRACEBACK_LENGTH - 1);
-  for (uint16_t i = 0; i < remaining_bits; i++) {
-    bool bit;
-    if (janusVitrebiTraceback(&janus_decoder, &bit, output_bit_index) == false) {
-      return false;
+/*
+ * LDPC codes are linear block codes defined by a sparse parity check matrix
+ * H where every valid codeword c satisfies Hc = 0. Each row of H is a parity
+ * check over a handful of bits and each column (bit) takes part in only a few
+ * checks.
+ *
+ * Quasi-cyclic codes build H from a small base matrix. Every base entry is
+ * replaced with a Z x Z identity matrix cyclically shifted by the entry (or a
+ * zero block for -1). The lifting factor Z scales the code without changing
+ * its rate so one base matrix per rate covers every message length:
+ * base entry 2 with Z = 4 becomes
+ * 0 0 1 0
+ * 0 0 0 1
+ * 1 0 0 0
+ * 0 1 0 0
+ *
+ * The base matrices are the IEEE 802.16e ones. The last columns have a dual
+ * diagonal structure so parity can be computed directly from H without a
+ * separate generator matrix:
+ * 1. lambda_i = sum of the shifted info blocks in block row i
+ * 2. Summing every block row cancels the dual diagonal leaving the first
+ *    parity block p0 = sum(lambda_i)
+ * 3. Each block row then gives the next parity block from the previous one
+ *
+ * A section is split into as few blocks as possible. Z is the smallest lift
+ * that fits the block and the unused info bits are fixed to zero and not sent
+ * (shortening). The decoder knows these bits so they only help.
+ *
+ * Bit layout of a section: [data bits 0][parity 0][data bits 1][parity 1]...
+ */
+bool addLdpc(BitMessage_t* bit_msg,
+             bool is_preamble,
+             uint16_t* bits_added)
+{
+  SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
+  LdpcLayout_t layout;
+  if (ldpcGetLayout(section_info.raw_len, &layout) == false) {
+    return false;
+  }
+
+  uint16_t input_index = 0;
+  uint16_t output_index = section_info.ecc_start_index;
+  for (uint16_t block = 0; block < layout.num_blocks; block++) {
+    uint16_t block_bits = ldpcBlockLength(section_info.raw_len, layout.num_blocks, block);
+    memset(ldpc_codeword, 0, layout.info_bits + layout.parity_bits);
+
+    for (uint16_t i = 0; i < block_bits; i++) {
+      bool bit;
+      if (Packet_GetBit(bit_msg, section_info.raw_start_index + input_index++, &bit) == false) {
+        return false;
+      }
+      ldpc_codeword[i] = bit;
+      if (setBitInBuffer(bit, output_index++) == false) {
+        return false;
+      }
     }
-    if (Packet_SetBit(bit_msg, section_info.raw_start_index + output_bit_index, bit) == false) {
-      return false;
+
+    ldpcEncodeBlock(&layout);
+
+    for (uint16_t i = 0; i < layout.parity_bits; i++) {
+      if (setBitInBuffer(ldpc_codeword[layout.info_bits + i], output_index++) == false) {
+        return false;
+      }
     }
-    output_bit_index++;
   }
 
-  bit_msg->normalized_vitrebi_error_metric =
-      (float) janus_decoder.error_metric / (section_info.ecc_len / 2.0f);
+  *bits_added += output_index - section_info.ecc_start_index;
+  return true;
+}
+
+/*
+ * Decoding passes messages between the bits and the checks. Every bit starts
+ * with a log likelihood ratio (LLR) from the channel where positive means 0.
+ * Each check tells each of its bits what it thinks the bit should be given
+ * every other bit in the check:
+ * - sign: product of the signs of the other bits (keeps the parity even)
+ * - magnitude: smallest magnitude of the other bits (weakest link)
+ * Min-sum overestimates the confidence so the magnitude is scaled by 0.75.
+ *
+ * The layered schedule processes one block row at a time and updates the bit
+ * LLRs immediately so later rows in the same iteration already see the new
+ * values. This converges in about half the iterations of flooding. Within a
+ * block row every bit appears at most once so the Z rows are independent.
+ *
+ * Check to bit messages are stored as int8 to keep the edge memory small.
+ * After every iteration the hard decisions are checked against H and the
+ * decoder stops as soon as all checks pass. Otherwise it gives up after the
+ * configured number of iterations and outputs its best guess which the error
+ * detection then catches.
+ *
+ * The channel LLR of each bit is scaled from the demodulator's soft decision
+ * so a weak symbol is easier to flip than a strong one. Bits without a soft
+ * decision (OFDM, decoders run on a message that was not received) all start
+ * with the same confidence.
+ */
+bool consumeLdpc(BitMessage_t* bit_msg, uint16_t available_bits)
+{
+  SectionInfo_t section_info = stream.is_preamble ? bit_msg->preamble : bit_msg->cargo;
+  LdpcLayout_t layout;
+  if (ldpcGetLayout(section_info.raw_len, &layout) == false) {
+    return false;
+  }
+
+  while (stream.block < layout.num_blocks) {
+    uint16_t block_bits = ldpcBlockLength(section_info.raw_len, layout.num_blocks, stream.block);
+    if (stream.input_bits + block_bits + layout.parity_bits > available_bits) {
+      break;
+    }
 
-  *error_detected = bit_msg->normalized_vitrebi_error_metric != 0.0f;
-  *error_corrected = *error_detected;
+    uint16_t input_index = section_info.ecc_start_index + stream.input_bits;
+    for (uint16_t i = 0; i < layout.info_bits + layout.parity_bits; i++) {
+      bool bit = false;
+      if (i < block_bits || i >= layout.info_bits) {
+        if (Packet_GetBit(bit_msg, input_index, &bit) == false) {
+          return false;
+        }
+        uint8_t confidence = Packet_GetConfidence(bit_msg, input_index);
+        int8_t llr = (confidence == 0) ? LDPC_CHANNEL_LLR : confidence * LDPC_CONFIDENCE_LLR;
+        ldpc_posterior[i] = (bit == true) ? -llr : llr;
+        input_index++;
+      }
+      else {
+        // Shortened bits are known zeros
+        ldpc_posterior[i] = LDPC_MAX_LLR;
+      }
+      ldpc_codeword[i] = bit;
+    }
 
+    if (ldpcCheckSyndrome(&layout) == false) {
+      stream.error_detected = true;
+      if (ldpcDecodeBlock(&layout) == false) {
+        stream.all_corrected = false;
+      }
+    }
+
+    for (uint16_t i = 0; i < block_bits; i++) {
+      if (setBitInStream(ldpc_codeword[i], stream.output_bits + i) == false) {
+        return false;
+      }
+    }
+    stream.input_bits = input_index - section_info.ecc_start_index;
+    stream.output_bits += block_bits;
+    stream.block++;
+  }
   return true;
 }
 
+// Picks up from wherever ErrorCorrection_StreamCargo left off
+bool decodeStreamed(BitMessage_t* bit_msg,
+                    ErrorCorrectionMethod_t method,
+                    bool is_preamble,
+                    bool* error_detected,
+                    bool* error_corrected)
+{
+  if (stream.active == false || stream.is_preamble != is_preamble ||
+      stream.method != method) {
+    streamStart(method, is_preamble);
+  }
+
+  SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
+  if (streamConsume(bit_msg, section_info.ecc_len) == false) {
+    stream.active = false;
+    return false;
+  }
+  return streamFinish(bit_msg, error_detected, error_corrected);
+}
+
 uint16_t calculateNumParityBits(const uint16_t num_bits)
 {
   uint16_t parity_bits = 0;
@@ -681,6 +1353,514 @@ static uint16_t janusVitrebiFindBestState(JanusVitrebiDecoder_t* decoder)
   return best_state;
 }
 
+uint8_t gfMultiply(uint8_t a, uint8_t b)
+{
+  if (a == 0 || b == 0) {
+    return 0;
+  }
+  return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+// b must be nonzero
+uint8_t gfDivide(uint8_t a, uint8_t b)
+{
+  if (a == 0) {
+    return 0;
+  }
+  return gf_exp[gf_log[a] + RS_FIELD_ORDER - gf_log[b]];
+}
+
+bool rsValidParameters(void)
+{
+  return (rs_parity_symbols <= RS_MAX_PARITY_SYMBOLS) &&
+         (rs_parity_symbols < rs_block_length);
+}
+
+uint16_t rsNumBlocks(uint16_t raw_len)
+{
+  uint16_t num_symbols = (raw_len + RS_SYMBOL_BITS - 1) / RS_SYMBOL_BITS;
+  uint8_t data_per_block = rs_block_length - rs_parity_symbols;
+  return (num_symbols + data_per_block - 1) / data_per_block;
+}
+
+// Coefficients are stored highest power first with generator[0] = 1
+void rsGenerator(uint8_t* generator, uint8_t num_parity)
+{
+  memset(generator, 0, num_parity + 1);
+  generator[0] = 1;
+  for (uint8_t i = 0; i < num_parity; i++) {
+    uint8_t root = gf_exp[i];
+    for (uint8_t j = i + 1; j > 0; j--) {
+      generator[j] ^= gfMultiply(generator[j - 1], root);
+    }
+  }
+}
+
+// Systematic encoding with an LFSR. Parity is written after the data symbols
+void rsEncodeBlock(uint8_t* codeword, uint8_t num_data,
+                   const uint8_t* generator, uint8_t num_parity)
+{
+  uint8_t* parity = &codeword[num_data];
+  memset(parity, 0, num_parity);
+
+  for (uint8_t i = 0; i < num_data; i++) {
+    uint8_t feedback = codeword[i] ^ parity[0];
+    for (uint8_t j = 0; j < num_parity - 1; j++) {
+      parity[j] = parity[j + 1] ^ gfMultiply(feedback, generator[j + 1]);
+    }
+    parity[num_parity - 1] = gfMultiply(feedback, generator[num_parity]);
+  }
+}
+
+// Returns true if any syndrome is nonzero
+bool rsCalculateSyndromes(const uint8_t* codeword, uint8_t length,
+                          uint8_t num_parity, uint8_t* syndromes)
+{
+  bool error_found = false;
+  for (uint8_t j = 0; j < num_parity; j++) {
+    uint8_t root = gf_exp[j];
+    uint8_t syndrome = 0;
+    for (uint8_t i = 0; i < length; i++) {
+      syndrome = gfMultiply(syndrome, root) ^ codeword[i];
+    }
+    syndromes[j] = syndrome;
+    if (syndrome != 0) {
+      error_found = true;
+    }
+  }
+  return error_found;
+}
+
+// Erasures are symbol indices within the codeword. The codeword is only
+// modified if the decode succeeds
+bool rsDecodeBlock(uint8_t* codeword, uint8_t length, uint8_t num_parity,
+                   const uint8_t* erasures, uint8_t num_erasures,
+                   bool* error_found)
+{
+  uint8_t syndromes[RS_MAX_PARITY_SYMBOLS];
+  *error_found = rsCalculateSyndromes(codeword, length, num_parity, syndromes);
+  if (*error_found == false) {
+    return true;
+  }
+  if (num_erasures > num_parity) {
+    return false;
+  }
+
+  // Polynomials below are stored lowest power first
+  uint8_t locator[RS_MAX_PARITY_SYMBOLS + 1] = {0};
+  uint8_t correction[RS_MAX_PARITY_SYMBOLS + 1];
+  uint8_t previous[RS_MAX_PARITY_SYMBOLS + 1];
+
+  // Erasure locator: product of (1 + X x) for every erased position
+  locator[0] = 1;
+  for (uint8_t e = 0; e < num_erasures; e++) {
+    if (erasures[e] >= length) {
+      return false;
+    }
+    uint8_t location = gf_exp[length - 1 - erasures[e]];
+    for (uint8_t j = e + 1; j > 0; j--) {
+      locator[j] ^= gfMultiply(locator[j - 1], location);
+    }
+  }
+  memcpy(correction, locator, sizeof(correction));
+
+  // Berlekamp-Massey. The correction polynomial is kept pre-scaled by the
+  // inverse of the last nonzero discrepancy and shifted by x every step
+  uint8_t num_errors = num_erasures;
+  for (uint8_t r = num_erasures; r < num_parity; r++) {
+    uint8_t discrepancy = 0;
+    for (uint8_t j = 0; j <= num_errors && j <= r; j++) {
+      discrepancy ^= gfMultiply(locator[j], syndromes[r - j]);
+    }
+
+    memmove(&correction[1], correction, num_parity);
+    correction[0] = 0;
+    if (discrepancy == 0) {
+      continue;
+    }
+
+    memcpy(previous, locator, sizeof(previous));
+    for (uint8_t j = 0; j <= num_parity; j++) {
+      locator[j] ^= gfMultiply(discrepancy, correction[j]);
+    }
+    if (2 * num_errors <= r + num_erasures) {
+      num_errors = r + 1 + num_erasures - num_errors;
+      for (uint8_t j = 0; j <= num_parity; j++) {
+        correction[j] = gfDivide(previous[j], discrepancy);
+      }
+    }
+  }
+  if (num_errors > num_parity) {
+    return false;
+  }
+
+  // Chien search. Position i has location X = a^(length - 1 - i)
+  uint8_t positions[RS_MAX_PARITY_SYMBOLS];
+  uint8_t num_roots = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    uint8_t x_inverse = gf_exp[RS_FIELD_ORDER - (length - 1 - i)];
+    uint8_t value = 0;
+    for (int16_t j = num_errors; j >= 0; j--) {
+      value = gfMultiply(value, x_inverse) ^ locator[j];
+    }
+    if (value == 0) {
+      if (num_roots >= num_errors) {
+        return false;
+      }
+      positions[num_roots++] = i;
+    }
+  }
+  if (num_roots != num_errors) {
+    return false;
+  }
+
+  // Error evaluator O(x) = S(x)L(x) mod x^(n-k)
+  uint8_t evaluator[RS_MAX_PARITY_SYMBOLS] = {0};
+  for (uint8_t i = 0; i < num_parity; i++) {
+    for (uint8_t j = 0; j <= i && j <= num_errors; j++) {
+      evaluator[i] ^= gfMultiply(syndromes[i - j], locator[j]);
+    }
+  }
+
+  // Forney
+  uint8_t magnitudes[RS_MAX_PARITY_SYMBOLS];
+  for (uint8_t k = 0; k < num_roots; k++) {
+    uint8_t power = length - 1 - positions[k];
+    uint8_t location = gf_exp[power];
+    uint8_t x_inverse = gf_exp[RS_FIELD_ORDER - power];
+
+    uint8_t numerator = 0;
+    for (int16_t j = num_parity - 1; j >= 0; j--) {
+      numerator = gfMultiply(numerator, x_inverse) ^ evaluator[j];
+    }
+
+    // Formal derivative only keeps the odd powers
+    uint8_t x_inverse_squared = gfMultiply(x_inverse, x_inverse);
+    uint8_t x_term = 1;
+    uint8_t denominator = 0;
+    for (uint8_t j = 1; j <= num_errors; j += 2) {
+      denominator ^= gfMultiply(locator[j], x_term);
+      x_term = gfMultiply(x_term, x_inverse_squared);
+    }
+    if (denominator == 0) {
+      return false;
+    }
+    magnitudes[k] = gfMultiply(location, gfDivide(numerator, denominator));
+  }
+
+  for (uint8_t k = 0; k < num_roots; k++) {
+    codeword[positions[k]] ^= magnitudes[k];
+  }
+
+  // Too many errors can still produce a consistent looking locator
+  if (rsCalculateSyndromes(codeword, length, num_parity, syndromes) == true) {
+    for (uint8_t k = 0; k < num_roots; k++) {
+      codeword[positions[k]] ^= magnitudes[k];
+    }
+    return false;
+  }
+  return true;
+}
+
+bool ldpcGetLayout(uint16_t raw_len, LdpcLayout_t* layout)
+{
+  if (raw_len == 0 || ldpc_rate >= NUM_LDPC_RATES) {
+    return false;
+  }
+
+  layout->base = &ldpc_base_matrices[ldpc_rate];
+  uint8_t info_columns = LDPC_BASE_COLUMNS - layout->base->num_rows;
+  uint16_t max_block_bits = info_columns * LDPC_MAX_LIFTING;
+  layout->num_blocks = (raw_len + max_block_bits - 1) / max_block_bits;
+
+  uint16_t largest_block = (raw_len + layout->num_blocks - 1) / layout->num_blocks;
+  uint16_t lifting = (largest_block + info_columns - 1) / info_columns;
+  layout->lifting = MAX(lifting, LDPC_MIN_LIFTING);
+  layout->info_bits = info_columns * layout->lifting;
+  layout->parity_bits = layout->base->num_rows * layout->lifting;
+  return true;
+}
+
+// The first blocks take the remainder so block lengths differ by at most 1
+uint16_t ldpcBlockLength(uint16_t raw_len, uint16_t num_blocks, uint16_t block)
+{
+  return raw_len / num_blocks + ((block < raw_len % num_blocks) ? 1 : 0);
+}
+
+// Each block is shortened by less than one lift per info column so the lift
+// can be recovered from the average length of a coded block
+uint16_t ldpcUncodedLength(uint16_t coded_len)
+{
+  if (coded_len == 0 || ldpc_rate >= NUM_LDPC_RATES) {
+    return 0;
+  }
+
+  const LdpcBaseMatrix_t* base = &ldpc_base_matrices[ldpc_rate];
+  for (uint32_t num_blocks = 1; ; num_blocks++) {
+    uint32_t block_columns = num_blocks * LDPC_BASE_COLUMNS;
+    uint32_t lifting = (coded_len + block_columns - 1) / block_columns;
+    lifting = MAX(lifting, LDPC_MIN_LIFTING);
+    if (lifting <= LDPC_MAX_LIFTING) {
+      uint32_t parity_bits = num_blocks * base->num_rows * lifting;
+      return (coded_len > parity_bits) ? coded_len - parity_bits : 0;
+    }
+  }
+}
+
+// Returns -1 for a zero block. Shifts are defined for Z = 96 and scaled down
+// for smaller lifts following 802.16e
+int16_t ldpcShift(const LdpcBaseMatrix_t* base, uint8_t row, uint8_t column, uint8_t lifting)
+{
+  int16_t shift = base->shifts[row * LDPC_BASE_COLUMNS + column];
+  if (shift < 0) {
+    return -1;
+  }
+  if (base->modulo_scaling == true) {
+    return shift % lifting;
+  }
+  return (shift * lifting) / LDPC_STANDARD_LIFTING;
+}
+
+// Info bits must already be in ldpc_codeword. Parity is written after them
+void ldpcEncodeBlock(const LdpcLayout_t* layout)
+{
+  const LdpcBaseMatrix_t* base = layout->base;
+  uint8_t z = layout->lifting;
+  uint8_t info_columns = LDPC_BASE_COLUMNS - base->num_rows;
+  uint8_t* parity = &ldpc_codeword[layout->info_bits];
+
+  memset(ldpc_lambda, 0, layout->parity_bits);
+  for (uint8_t i = 0; i < base->num_rows; i++) {
+    for (uint8_t j = 0; j < info_columns; j++) {
+      int16_t shift = ldpcShift(base, i, j, z);
+      if (shift < 0) {
+        continue;
+      }
+      for (uint8_t r = 0; r < z; r++) {
+        ldpc_lambda[i * z + r] ^= ldpc_codeword[j * z + (r + shift) % z];
+      }
+    }
+  }
+
+  memset(parity, 0, z);
+  for (uint8_t i = 0; i < base->num_rows; i++) {
+    for (uint8_t r = 0; r < z; r++) {
+      parity[r] ^= ldpc_lambda[i * z + r];
+    }
+  }
+
+  // Block row i links parity block i (previous) with block i + 1 (next)
+  for (uint8_t i = 0; i < base->num_rows - 1; i++) {
+    int16_t shift = ldpcShift(base, i, info_columns, z);
+    for (uint8_t r = 0; r < z; r++) {
+      uint8_t bit = ldpc_lambda[i * z + r];
+      if (shift >= 0) {
+        bit ^= parity[(r + shift) % z];
+      }
+      if (i > 0) {
+        bit ^= parity[i * z + r];
+      }
+      parity[(i + 1) * z + r] = bit;
+    }
+  }
+}
+
+// Returns true if the hard decisions in ldpc_codeword satisfy every check
+bool ldpcCheckSyndrome(const LdpcLayout_t* layout)
+{
+  const LdpcBaseMatrix_t* base = layout->base;
+  uint8_t z = layout->lifting;
+
+  for (uint8_t i = 0; i < base->num_rows; i++) {
+    for (uint8_t r = 0; r < z; r++) {
+      uint8_t parity = 0;
+      for (uint8_t j = 0; j < LDPC_BASE_COLUMNS; j++) {
+        int16_t shift = ldpcShift(base, i, j, z);
+        if (shift >= 0) {
+          parity ^= ldpc_codeword[j * z + (r + shift) % z];
+        }
+      }
+      if (parity != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Channel LLRs must already be in ldpc_posterior. Hard decisions are left in
+// ldpc_codeword
+bool ldpcDecodeBlock(const LdpcLayout_t* layout)
+{
+  const LdpcBaseMatrix_t* base = layout->base;
+  uint8_t z = layout->lifting;
+  uint16_t codeword_bits = layout->info_bits + layout->parity_bits;
+
+  // Flatten the base matrix into per row edge lists
+  uint8_t edge_column[LDPC_MAX_BASE_EDGES];
+  uint8_t edge_shift[LDPC_MAX_BASE_EDGES];
+  uint8_t row_start[LDPC_MAX_BASE_ROWS + 1];
+  uint8_t num_edges = 0;
+  for (uint8_t i = 0; i < base->num_rows; i++) {
+    row_start[i] = num_edges;
+    for (uint8_t j = 0; j < LDPC_BASE_COLUMNS; j++) {
+      int16_t shift = ldpcShift(base, i, j, z);
+      if (shift >= 0) {
+        edge_column[num_edges] = j;
+        edge_shift[num_edges] = shift;
+        num_edges++;
+      }
+    }
+  }
+  row_start[base->num_rows] = num_edges;
+  memset(ldpc_check_messages, 0, num_edges * z);
+
+  for (uint8_t iteration = 0; iteration < ldpc_max_iterations; iteration++) {
+    for (uint8_t i = 0; i < base->num_rows; i++) {
+      uint8_t row_weight = row_start[i + 1] - row_start[i];
+      for (uint8_t r = 0; r < z; r++) {
+        int16_t bit_messages[LDPC_MAX_ROW_WEIGHT];
+        uint16_t bit_index[LDPC_MAX_ROW_WEIGHT];
+        uint8_t min1 = LDPC_MAX_LLR;
+        uint8_t min2 = LDPC_MAX_LLR;
+        uint8_t min_position = 0;
+        bool negative = false;
+
+        // Remove the old check message to get what each bit tells the check
+        for (uint8_t k = 0; k < row_weight; k++) {
+          uint8_t e = row_start[i] + k;
+          bit_index[k] = edge_column[e] * z + (r + edge_shift[e]) % z;
+          int16_t value = ldpc_posterior[bit_index[k]] - ldpc_check_messages[e * z + r];
+          value = MAX(MIN(value, LDPC_MAX_LLR), -LDPC_MAX_LLR);
+          bit_messages[k] = value;
+
+          uint8_t magnitude = (value < 0) ? -value : value;
+          negative ^= (value < 0);
+          if (magnitude < min1) {
+            min2 = min1;
+            min1 = magnitude;
+            min_position = k;
+          }
+          else if (magnitude < min2) {
+            min2 = magnitude;
+          }
+        }
+
+        for (uint8_t k = 0; k < row_weight; k++) {
+          uint8_t e = row_start[i] + k;
+          int8_t message = LDPC_NORMALIZE((k == min_position) ? min2 : min1);
+          if (negative ^ (bit_messages[k] < 0)) {
+            message = -message;
+          }
+          ldpc_check_messages[e * z + r] = message;
+          ldpc_posterior[bit_index[k]] = bit_messages[k] + message;
+        }
+      }
+    }
+
+    for (uint16_t v = 0; v < codeword_bits; v++) {
+      ldpc_codeword[v] = ldpc_posterior[v] < 0;
+    }
+    if (ldpcCheckSyndrome(layout) == true) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void streamStart(ErrorCorrectionMethod_t method, bool is_preamble)
+{
+  stream.active = true;
+  stream.is_preamble = is_preamble;
+  stream.method = method;
+  stream.input_bits = 0;
+  stream.output_bits = 0;
+  stream.block = 0;
+  stream.error_detected = false;
+  stream.all_corrected = true;
+  if (method == JANUS_CONVOLUTIONAL) {
+    janusVitrebiInit(&janus_decoder);
+  }
+}
+
+bool streamConsume(BitMessage_t* bit_msg, uint16_t available_bits)
+{
+  switch (stream.method) {
+    case JANUS_CONVOLUTIONAL:
+      return consumeJanusConvolutional(bit_msg, available_bits);
+    case REED_SOLOMON:
+      return consumeReedSolomon(bit_msg, available_bits);
+    case QC_LDPC:
+      return consumeLdpc(bit_msg, available_bits);
+    default:
+      return false;
+  }
+}
+
+// Decides any remaining bits and moves the decoded section into place
+bool streamFinish(BitMessage_t* bit_msg, bool* error_detected, bool* error_corrected)
+{
+  SectionInfo_t section_info = stream.is_preamble ? bit_msg->preamble : bit_msg->cargo;
+  stream.active = false;
+
+  if (stream.method == JANUS_CONVOLUTIONAL) {
+    // There are no more input bits so no more information can be gathered
+    // about the sequence.
+    while (stream.output_bits < section_info.raw_len) {
+      bool bit;
+      if (janusVitrebiTraceback(&janus_decoder, &bit, stream.output_bits) == false) {
+        return false;
+      }
+      if (setBitInStream(bit, stream.output_bits++) == false) {
+        return false;
+      }
+    }
+
+    bit_msg->normalized_vitrebi_error_metric =
+        (float) janus_decoder.error_metric / (section_info.ecc_len / 2.0f);
+
+    stream.error_detected = bit_msg->normalized_vitrebi_error_metric != 0.0f;
+  }
+  if (stream.output_bits < section_info.raw_len) {
+    return false;
+  }
+
+  for (uint16_t i = 0; i < section_info.raw_len; i++) {
+    bool bit = (stream_buffer[i / 8] & (1 << (7 - i % 8))) != 0;
+    if (Packet_SetBit(bit_msg, section_info.raw_start_index + i, bit) == false) {
+      return false;
+    }
+  }
+
+  // The Vitrebi metric covers the whole section while the block codes only
+  // report blocks that failed their check
+  if (stream.method == JANUS_CONVOLUTIONAL) {
+    *error_detected = stream.error_detected;
+  }
+  else if (stream.error_detected == true) {
+    *error_detected = true;
+  }
+  *error_corrected = (*error_detected == true) && (stream.all_corrected == true);
+  return true;
+}
+
+bool setBitInStream(bool bit, uint16_t position)
+{
+  if (position >= sizeof(stream_buffer) * 8) {
+    return false;
+  }
+
+  uint16_t byte_index = position / 8;
+  uint8_t bit_position = position % 8;
+
+  if (bit == true) {
+    stream_buffer[byte_index] |= (1 << (7 - bit_position));
+  } else {
+    stream_buffer[byte_index] &= ~(1 << (7 - bit_position));
+  }
+  return true;
+}
+
 void clearBuffer(void)
 {
   memset(message_buffer, 0, sizeof(message_buffer) / sizeof(message_buffer[0]));
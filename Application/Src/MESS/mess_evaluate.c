@@ -10,6 +10,7 @@
 #include "mess_evaluate.h"
 #include "mess_main.h"
 #include "mess_packet.h"
+#include "mess_link_adapt.h"
 
 #include "cfg_parameters.h"
 #include "cfg_defaults.h"
@@ -35,6 +36,10 @@
 
 static uint16_t eval_message_length = DEFAULT_EVAL_MESSAGE_LEN;
 
+// Reference packet for the uncoded BER. Kept off the MESS task stack
+static BitMessage_t reference_bit_msg;
+static Message_t reference_msg;
+
 /* Private function prototypes -----------------------------------------------*/
 
 
@@ -76,12 +81,13 @@ bool Evaluate_CodedBer(EvalMessageInfo_t* eval_info, BitMessage_t* bit_msg)
 bool Evaluate_UncodedBer(EvalMessageInfo_t* eval_info, BitMessage_t* bit_msg, const DspConfig_t* cfg)
 {
   eval_info->uncoded_errors = 0;
-  BitMessage_t reference_bit_msg;
-  Message_t reference_msg;
   reference_msg.length_bits = bit_msg->cargo.raw_len;
   reference_msg.data_type = EVAL;
   reference_msg.preamble.message_type.value = EVAL;
   reference_msg.preamble.message_type.valid = true;
+  // Only sets the preamble length. The cargo is coded with cfg regardless
+  reference_msg.preamble.rate_profile.value = RATE_PROFILE_CONFIGURED;
+  reference_msg.preamble.rate_profile.valid = true;
   if (Packet_PrepareTx(&reference_msg, &reference_bit_msg, cfg) == false) {
     return false;
   }
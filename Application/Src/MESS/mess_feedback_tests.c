@@ -11,6 +11,7 @@
 #include "mess_dsp_config.h"
 #include "mess_packet.h"
 #include "mess_main.h"
+#include "mess_modulate.h"
 
 #include "comm_main.h"
 
@@ -578,6 +579,9 @@ static uint16_t current_test = 0;
 static uint16_t call_count = 0;
 static LastAction_t last_action = DECODED_MESSAGE;
 
+// Reference packet of the current test. Kept off the MESS task stack
+static BitMessage_t reference_bit_msg;
+
 /* Private function prototypes -----------------------------------------------*/
 
 static bool getTestIndex(uint16_t* index);
@@ -711,16 +715,14 @@ bool FeedbackTests_Check(Message_t* received_msg, BitMessage_t* received_bit_msg
     return false;
   }
 
-  BitMessage_t bit_msg;
-
   if (Packet_PrepareTx(&feedback_tests[test_index].reference_message->test_msg,
-      &bit_msg, &feedback_tests[test_index].cfg) == false) {
+      &reference_bit_msg, &feedback_tests[test_index].cfg) == false) {
     return false;
   }
 
   // Compares the bit messages to see if the bits match up
   bool identical_bits;
-  if (Packet_Compare(&bit_msg,
+  if (Packet_Compare(&reference_bit_msg,
       received_bit_msg, &identical_bits) == false) {
     return false;
   }
@@ -742,7 +744,7 @@ bool FeedbackTests_Check(Message_t* received_msg, BitMessage_t* received_bit_msg
     feedback_tests[test_index].messages_with_errors_detected++;
   }
 
-  if (received_bit_msg->data_len_bits != bit_msg.data_len_bits) {
+  if (received_bit_msg->data_len_bits != reference_bit_msg.data_len_bits) {
     feedback_tests[test_index].messages_with_incorrect_length++;
   }
 
@@ -932,6 +934,34 @@ static void printStatistics(void)
       snprintf(output_buffer, 128, "Dwell: %hu\r\n", cfg->fhbfsk_dwell_time);
       COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
     }
+    else if (cfg->mod_demod_method == MOD_DEMOD_MFSK) {
+      snprintf(output_buffer, 128, "fc: %lu\r\n", cfg->fc);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+
+      snprintf(output_buffer, 128, "Frequency spacing: %hu\r\n",
+          cfg->fhbfsk_freq_spacing);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+
+      snprintf(output_buffer, 128, "Bits per symbol: %hu\r\n",
+          cfg->mfsk_bits_per_symbol);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+    }
+    else if (cfg->mod_demod_method == MOD_DEMOD_OFDM) {
+      snprintf(output_buffer, 128, "fc: %lu\r\n", cfg->fc);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+
+      snprintf(output_buffer, 128, "Subcarriers: %hu\r\n",
+          cfg->ofdm_num_subcarriers);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+    }
+    else if (Modulate_IsDifferential(cfg) == true) {
+      snprintf(output_buffer, 128, "fc: %lu\r\n", cfg->fc);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+
+      snprintf(output_buffer, 128, "Bits per symbol: %hu\r\n",
+          Modulate_BitsPerSymbol(cfg));
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+    }
 
     snprintf(output_buffer, 128, "Results %u:\r\n", i + 1);
     COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
@@ -0,0 +1,429 @@
+/*
+ * mess_fragment.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_fragment.h"
+#include "mess_main.h"
+#include "mess_arq.h"
+
+#include "cfg_main.h"
+#include "cfg_parameters.h"
+#include "cfg_defaults.h"
+
+#include "dac_waveform.h"
+
+#include "hw_random.h"
+
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef enum {
+  SLOT_FREE,
+  SLOT_RECEIVING,
+  SLOT_REPORT_PENDING,      // Done but the reception queue was full
+  SLOT_REPORTED             // Owned by COMM until released
+} FragmentSlotState_t;
+
+typedef struct {
+  uint8_t data[FRAGMENT_MAX_TRANSFER_BYTES];
+  uint32_t received[(FRAGMENT_MAX_FRAGMENTS + 31) / 32];
+  PreambleContent_t preamble;   // Preamble of the first fragment
+  MessageType_t type;
+  uint32_t last_tick;           // Arrival of the latest fragment
+  uint16_t length_bytes;
+  uint8_t transfer_id;
+  uint8_t fragment_count;
+  uint8_t fragments_received;
+  uint8_t data_type;
+  bool complete;
+  volatile FragmentSlotState_t state;
+} FragmentRxSlot_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Fragment header fields
+#define HEADER_TRANSFER             0
+#define HEADER_INDEX                1
+#define HEADER_COUNT                2
+#define HEADER_DATA_TYPE            3
+#define HEADER_LENGTH_HIGH          4
+#define HEADER_LENGTH_LOW           5
+
+// Report message fields
+#define REPORT_SLOT                 0
+#define REPORT_TRANSFER             1
+
+// Number of transfers reassembled at the same time. Each one holds a full
+// transfer buffer
+#define FRAGMENT_POOL_SIZE          2
+
+// Finished transfers whose late duplicate fragments are ignored instead of
+// starting a new reassembly
+#define FRAGMENT_RECENT_TRANSFERS   4
+
+/* Private macro -------------------------------------------------------------*/
+
+#define MIN(a, b)                   (((a) < (b)) ? (a) : (b))
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint16_t reassembly_timeout_s = DEFAULT_FRAGMENT_TIMEOUT;
+
+// Sender. COMM fills the buffer while tx_active is false and the MESS task
+// owns it while it is true
+static uint8_t tx_buffer[FRAGMENT_MAX_TRANSFER_BYTES];
+static volatile bool tx_active = false;
+static uint16_t tx_length_bytes = 0;
+static uint8_t tx_fragment_count = 0;
+static uint8_t tx_next_index = 0;
+static uint8_t tx_transfer_id = 0;
+static bool tx_transfer_started = false;
+static uint8_t tx_data_type = BITS;
+static MessageType_t tx_type = MSG_TRANSMIT_TRANSDUCER;
+
+static Message_t fragment_msg;
+
+// Receiver
+static FragmentRxSlot_t rx_pool[FRAGMENT_POOL_SIZE];
+static uint16_t recent_transfers[FRAGMENT_RECENT_TRANSFERS];
+static uint8_t recent_count = 0;
+static uint8_t recent_index = 0;
+
+static Message_t report_msg;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t fragmentsNeeded(uint16_t length_bytes);
+static bool sendNextFragment(void);
+static void handleFragment(const Message_t* msg, uint32_t now);
+static FragmentRxSlot_t* getSlot(uint8_t sender_id, uint8_t transfer_id);
+static bool isRecent(uint8_t sender_id, uint8_t transfer_id);
+static void rememberTransfer(FragmentRxSlot_t* slot);
+static void reportSlot(FragmentRxSlot_t* slot);
+static FragmentRxSlot_t* getReportedSlot(const Message_t* report);
+
+/* Exported function definitions ---------------------------------------------*/
+
+bool Fragment_RegisterParams(void)
+{
+  uint32_t min_u32 = MIN_FRAGMENT_TIMEOUT;
+  uint32_t max_u32 = MAX_FRAGMENT_TIMEOUT;
+  if (Param_Register(PARAM_FRAGMENT_TIMEOUT, "the fragment reassembly timeout",
+                     PARAM_TYPE_UINT16, &reassembly_timeout_s, sizeof(uint16_t),
+                     &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+  return true;
+}
+
+bool Fragment_Send(const uint8_t* data, uint16_t length_bytes,
+                   CustomMessageData_t data_type, MessageType_t type,
+                   uint8_t* fragment_count)
+{
+  if (data == NULL || length_bytes == 0 ||
+      length_bytes > FRAGMENT_MAX_TRANSFER_BYTES) {
+    return false;
+  }
+  if (tx_active == true) {
+    return false;
+  }
+
+  memcpy(tx_buffer, data, length_bytes);
+  tx_length_bytes = length_bytes;
+  tx_fragment_count = fragmentsNeeded(length_bytes);
+  tx_next_index = 0;
+  tx_data_type = data_type;
+  tx_type = type;
+  // Start from a random id so a restarted sender does not reuse an id the
+  // receiver still remembers. The tick count is nearly the same every reset
+  if (tx_transfer_started == false) {
+    tx_transfer_id = Random_Byte();
+    tx_transfer_started = true;
+  }
+  else {
+    tx_transfer_id++;
+  }
+
+  if (fragment_count != NULL) {
+    *fragment_count = tx_fragment_count;
+  }
+  tx_active = true;
+  return true;
+}
+
+void Fragment_Process(const DspConfig_t* cfg)
+{
+  uint32_t now = osKernelGetTickCount();
+
+  for (uint8_t i = 0; i < FRAGMENT_POOL_SIZE; i++) {
+    FragmentRxSlot_t* slot = &rx_pool[i];
+    if (slot->state == SLOT_RECEIVING &&
+        (now - slot->last_tick) >= (uint32_t) reassembly_timeout_s * 1000) {
+      slot->complete = false;
+      rememberTransfer(slot);
+      reportSlot(slot);
+    }
+    else if (slot->state == SLOT_REPORT_PENDING) {
+      reportSlot(slot);
+    }
+  }
+
+  // Fragments carry their header in the custom preamble's message type
+  if (tx_active == false || cfg->protocol != PROTOCOL_CUSTOM) {
+    return;
+  }
+  // The next fragment is queued as soon as the previous one has left the DAC
+  if (Waveform_IsRunning() == true) {
+    return;
+  }
+
+  if (sendNextFragment() == true) {
+    tx_next_index++;
+    if (tx_next_index == tx_fragment_count) {
+      tx_active = false;
+    }
+  }
+}
+
+bool Fragment_Check(Message_t* received_msg)
+{
+  if (received_msg->protocol != PROTOCOL_CUSTOM ||
+      received_msg->preamble.message_type.valid == false ||
+      received_msg->preamble.message_type.value != FRAGMENT) {
+    return false;
+  }
+
+  // The checksum failed so none of the fragment header can be trusted
+  if (received_msg->error_detected == true) {
+    return true;
+  }
+
+  handleFragment(received_msg, osKernelGetTickCount());
+  return true;
+}
+
+bool Fragment_GetTransfer(const Message_t* report, FragmentTransfer_t* transfer)
+{
+  FragmentRxSlot_t* slot = getReportedSlot(report);
+  if (slot == NULL || transfer == NULL) {
+    return false;
+  }
+
+  transfer->data = slot->data;
+  transfer->length_bytes = slot->length_bytes;
+  transfer->sender_id = slot->preamble.modem_id.value;
+  transfer->transfer_id = slot->transfer_id;
+  transfer->fragment_count = slot->fragment_count;
+  transfer->fragments_received = slot->fragments_received;
+  transfer->data_type = slot->data_type;
+  transfer->complete = slot->complete;
+  return true;
+}
+
+bool Fragment_WasReceived(const Message_t* report, uint8_t index)
+{
+  FragmentRxSlot_t* slot = getReportedSlot(report);
+  if (slot == NULL || index >= slot->fragment_count) {
+    return false;
+  }
+  return (slot->received[index / 32] & (1UL << (index % 32))) != 0;
+}
+
+void Fragment_Release(const Message_t* report)
+{
+  FragmentRxSlot_t* slot = getReportedSlot(report);
+  if (slot != NULL) {
+    slot->state = SLOT_FREE;
+  }
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+uint8_t fragmentsNeeded(uint16_t length_bytes)
+{
+  return (length_bytes + FRAGMENT_MAX_PAYLOAD_BYTES - 1) / FRAGMENT_MAX_PAYLOAD_BYTES;
+}
+
+// Hands the next fragment to the ARQ layer or the transmission queue
+bool sendNextFragment()
+{
+  uint8_t use_arq;
+  if (Param_GetUint8(PARAM_ARQ_ENABLED, &use_arq) == false) {
+    use_arq = false;
+  }
+  if (use_arq == true && Arq_CanSend() == false) {
+    return false;
+  }
+
+  uint16_t offset = tx_next_index * FRAGMENT_MAX_PAYLOAD_BYTES;
+  uint16_t payload_bytes = MIN(FRAGMENT_MAX_PAYLOAD_BYTES, tx_length_bytes - offset);
+
+  memset(&fragment_msg, 0, sizeof(Message_t));
+  fragment_msg.type = tx_type;
+  fragment_msg.timestamp = osKernelGetTickCount();
+  fragment_msg.data_type = FRAGMENT;
+  fragment_msg.preamble.message_type.value = FRAGMENT;
+  fragment_msg.preamble.message_type.valid = true;
+  fragment_msg.protocol = PROTOCOL_CUSTOM;
+  fragment_msg.length_bits = (FRAGMENT_HEADER_BYTES + payload_bytes) * 8;
+  fragment_msg.data[HEADER_TRANSFER] = tx_transfer_id;
+  fragment_msg.data[HEADER_INDEX] = tx_next_index;
+  fragment_msg.data[HEADER_COUNT] = tx_fragment_count;
+  fragment_msg.data[HEADER_DATA_TYPE] = tx_data_type;
+  fragment_msg.data[HEADER_LENGTH_HIGH] = tx_length_bytes >> 8;
+  fragment_msg.data[HEADER_LENGTH_LOW] = tx_length_bytes & 0xFF;
+  memcpy(&fragment_msg.data[FRAGMENT_HEADER_BYTES], &tx_buffer[offset], payload_bytes);
+
+  if (use_arq == true) {
+    return Arq_Send(&fragment_msg) == pdPASS;
+  }
+  return MESS_AddMessageToTxQ(&fragment_msg) == pdPASS;
+}
+
+void handleFragment(const Message_t* msg, uint32_t now)
+{
+  if (msg->length_bits < FRAGMENT_HEADER_BYTES * 8) {
+    return;
+  }
+  uint8_t transfer_id = msg->data[HEADER_TRANSFER];
+  uint8_t index = msg->data[HEADER_INDEX];
+  uint8_t count = msg->data[HEADER_COUNT];
+  uint16_t length_bytes = (msg->data[HEADER_LENGTH_HIGH] << 8) |
+                          msg->data[HEADER_LENGTH_LOW];
+  if (length_bytes == 0 || length_bytes > FRAGMENT_MAX_TRANSFER_BYTES ||
+      count != fragmentsNeeded(length_bytes) || index >= count) {
+    return;
+  }
+  uint16_t offset = index * FRAGMENT_MAX_PAYLOAD_BYTES;
+  uint16_t payload_bytes = MIN(FRAGMENT_MAX_PAYLOAD_BYTES, length_bytes - offset);
+  // The cargo is rounded up to whole length steps so it can only be longer
+  if (payload_bytes * 8 > msg->length_bits - FRAGMENT_HEADER_BYTES * 8) {
+    return;
+  }
+
+  uint8_t sender_id = msg->preamble.modem_id.value;
+  if (isRecent(sender_id, transfer_id) == true) {
+    return;
+  }
+
+  FragmentRxSlot_t* slot = getSlot(sender_id, transfer_id);
+  if (slot == NULL) {
+    return;
+  }
+  if (slot->state == SLOT_FREE) {
+    memset(slot->received, 0, sizeof(slot->received));
+    memcpy(&slot->preamble, &msg->preamble, sizeof(PreambleContent_t));
+    slot->type = msg->type;
+    slot->length_bytes = length_bytes;
+    slot->transfer_id = transfer_id;
+    slot->fragment_count = count;
+    slot->fragments_received = 0;
+    slot->data_type = msg->data[HEADER_DATA_TYPE];
+    slot->complete = false;
+    slot->state = SLOT_RECEIVING;
+  }
+  else if (slot->length_bytes != length_bytes) {
+    return;
+  }
+  slot->last_tick = now;
+
+  uint32_t mask = 1UL << (index % 32);
+  if ((slot->received[index / 32] & mask) != 0) {
+    return;
+  }
+  memcpy(&slot->data[offset], &msg->data[FRAGMENT_HEADER_BYTES], payload_bytes);
+  slot->received[index / 32] |= mask;
+  slot->fragments_received++;
+
+  if (slot->fragments_received == slot->fragment_count) {
+    slot->complete = true;
+    rememberTransfer(slot);
+    reportSlot(slot);
+  }
+}
+
+// Finds the reassembly of a transfer or starts a new one in a free slot
+FragmentRxSlot_t* getSlot(uint8_t sender_id, uint8_t transfer_id)
+{
+  FragmentRxSlot_t* free_slot = NULL;
+  for (uint8_t i = 0; i < FRAGMENT_POOL_SIZE; i++) {
+    FragmentRxSlot_t* slot = &rx_pool[i];
+    if (slot->state == SLOT_RECEIVING && slot->transfer_id == transfer_id &&
+        slot->preamble.modem_id.value == sender_id) {
+      return slot;
+    }
+    if (slot->state == SLOT_FREE && free_slot == NULL) {
+      free_slot = slot;
+    }
+  }
+  return free_slot;
+}
+
+bool isRecent(uint8_t sender_id, uint8_t transfer_id)
+{
+  uint16_t key = (sender_id << 8) | transfer_id;
+  for (uint8_t i = 0; i < recent_count; i++) {
+    if (recent_transfers[i] == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void rememberTransfer(FragmentRxSlot_t* slot)
+{
+  recent_transfers[recent_index] = (slot->preamble.modem_id.value << 8) |
+                                   slot->transfer_id;
+  recent_index = (recent_index + 1) % FRAGMENT_RECENT_TRANSFERS;
+  if (recent_count < FRAGMENT_RECENT_TRANSFERS) {
+    recent_count++;
+  }
+}
+
+// The slot is handed to COMM before the report is queued since COMM may
+// release it before the queue call returns
+void reportSlot(FragmentRxSlot_t* slot)
+{
+  memset(&report_msg, 0, sizeof(Message_t));
+  report_msg.type = (slot->type == MSG_RECEIVED_FEEDBACK) ?
+                    MSG_RECEIVED_FEEDBACK : MSG_RECEIVED_TRANSDUCER;
+  report_msg.timestamp = osKernelGetTickCount();
+  report_msg.data_type = FRAGMENT;
+  report_msg.protocol = PROTOCOL_CUSTOM;
+  memcpy(&report_msg.preamble, &slot->preamble, sizeof(PreambleContent_t));
+  report_msg.preamble.message_type.value = FRAGMENT;
+  report_msg.preamble.message_type.valid = true;
+  report_msg.length_bits = (slot->complete == true) ? slot->length_bytes * 8 : 0;
+  report_msg.uncoded_data_len = report_msg.length_bits;
+  report_msg.data[REPORT_SLOT] = slot - rx_pool;
+  report_msg.data[REPORT_TRANSFER] = slot->transfer_id;
+
+  slot->state = SLOT_REPORTED;
+  if (MESS_AddMessageToRxQ(&report_msg) != pdPASS) {
+    slot->state = SLOT_REPORT_PENDING;
+  }
+}
+
+FragmentRxSlot_t* getReportedSlot(const Message_t* report)
+{
+  if (report == NULL || report->protocol != PROTOCOL_CUSTOM ||
+      report->data_type != FRAGMENT ||
+      report->data[REPORT_SLOT] >= FRAGMENT_POOL_SIZE) {
+    return NULL;
+  }
+  FragmentRxSlot_t* slot = &rx_pool[report->data[REPORT_SLOT]];
+  if (slot->state != SLOT_REPORTED ||
+      slot->transfer_id != report->data[REPORT_TRANSFER]) {
+    return NULL;
+  }
+  return slot;
+}
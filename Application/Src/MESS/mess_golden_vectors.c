@@ -0,0 +1,489 @@
+/*
+ * mess_golden_vectors.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_golden_vectors.h"
+#include "mess_main.h"
+#include "mess_packet.h"
+#include "mess_dsp_config.h"
+#include "mess_error_correction.h"
+#include "mess_interleaver.h"
+#include "mess_dac_resources.h"
+#include "mess_modulate.h"
+
+#include "dac_waveform.h"
+
+#include "comm_main.h"
+
+#include "cfg_defaults.h"
+
+#include "crc32.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+  uint16_t packet_bits;       // After Packet_PrepareTx (preamble, cargo, detection)
+  uint32_t packet_crc;
+  uint16_t ecc_bits;          // After ErrorCorrection_AddCorrection
+  uint32_t ecc_crc;
+  uint32_t interleaved_crc;   // After Interleaver_Apply
+  uint16_t num_steps;         // Wakeup, sync and data steps
+  uint32_t steps_crc;         // Frequency and duration of every step
+  uint32_t num_samples;
+  uint32_t dac_crc;
+} GoldenResult_t;
+
+typedef struct {
+  const char* name;
+  DspConfig_t cfg;
+  Message_t msg;
+  GoldenResult_t expected;
+} GoldenVector_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Fixed so the rendered samples do not depend on saved parameters
+#define GOLDEN_AMPLITUDE          0.5f
+#define GOLDEN_TRANSITION_LEN     DEFAULT_DAC_TRANSITION_LEN
+
+/* Private macro -------------------------------------------------------------*/
+
+#define VALID(x)                  {(x), true}
+
+// Every preamble field is set so no saved parameters are used
+#define CUSTOM_PREAMBLE(type) \
+  { \
+    .modem_id = VALID(2), \
+    .message_type = VALID(type), \
+    .is_mobile = VALID(0) \
+  }
+
+#define JANUS_PREAMBLE \
+  { \
+    .modem_id = VALID(73), \
+    .destination_id = VALID(255), \
+    .is_mobile = VALID(0), \
+    .tx_rx_capable = VALID(1), \
+    .can_forward = VALID(0), \
+    .coding = VALID(CODING_ASCII8), \
+    .encryption = VALID(ENCRYPTION_NONE) \
+  }
+
+/* Private variables ---------------------------------------------------------*/
+
+static const GoldenVector_t golden_vectors[] = {
+  {
+    .name = "custom_fsk_plain",
+    .cfg = {
+      .baud_rate = 100.0f,
+      .mod_demod_method = MOD_DEMOD_FSK,
+      .fsk_f0 = 30000,
+      .fsk_f1 = 33000,
+      .fc = 31000,
+      .fhbfsk_freq_spacing = 1,
+      .fhbfsk_num_tones = 10,
+      .fhbfsk_dwell_time = 1,
+      .preamble_validation = CRC_8,
+      .cargo_validation = CRC_16,
+      .preamble_ecc_method = NO_ECC,
+      .cargo_ecc_method = NO_ECC,
+      .use_interleaver = false,
+      .fhbfsk_hopper = HOPPER_INCREMENT,
+      .sync_method = NO_SYNC,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = {0x12, 0x34, 0x56, 0x78},
+      .length_bits = 32,
+      .data_type = BITS,
+      .preamble = CUSTOM_PREAMBLE(BITS)
+    },
+    .expected = {72, 0xFBCB98ED, 72, 0xFBCB98ED, 0xFBCB98ED, 72, 0x09263DEB, 720000, 0x5859C35E}
+  },
+  {
+    .name = "custom_fsk_hamming_interleaved",
+    .cfg = {
+      .baud_rate = 100.0f,
+      .mod_demod_method = MOD_DEMOD_FSK,
+      .fsk_f0 = 30000,
+      .fsk_f1 = 33000,
+      .fc = 31000,
+      .fhbfsk_freq_spacing = 1,
+      .fhbfsk_num_tones = 10,
+      .fhbfsk_dwell_time = 1,
+      .preamble_validation = CRC_8,
+      .cargo_validation = CRC_32,
+      .preamble_ecc_method = HAMMING_CODE,
+      .cargo_ecc_method = HAMMING_CODE,
+      .use_interleaver = true,
+      .fhbfsk_hopper = HOPPER_INCREMENT,
+      .sync_method = NO_SYNC,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = "OpenAquatix",
+      .length_bits = 88,
+      .data_type = STRING,
+      .preamble = CUSTOM_PREAMBLE(STRING)
+    },
+    .expected = {144, 0xAB4323B3, 156, 0x5AFAAFB5, 0xE4C03A50, 156, 0x2201DC4C, 1560000, 0x31C71ED5}
+  },
+  {
+    .name = "custom_fhbfsk_increment_conv",
+    .cfg = {
+      .baud_rate = 100.0f,
+      .mod_demod_method = MOD_DEMOD_FHBFSK,
+      .fsk_f0 = 30000,
+      .fsk_f1 = 33000,
+      .fc = 31000,
+      .fhbfsk_freq_spacing = 1,
+      .fhbfsk_num_tones = 10,
+      .fhbfsk_dwell_time = 1,
+      .preamble_validation = CHECKSUM_8,
+      .cargo_validation = CHECKSUM_16,
+      .preamble_ecc_method = JANUS_CONVOLUTIONAL,
+      .cargo_ecc_method = JANUS_CONVOLUTIONAL,
+      .use_interleaver = false,
+      .fhbfsk_hopper = HOPPER_INCREMENT,
+      .sync_method = NO_SYNC,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = {0xDE, 0xAD, 0xBE, 0xEF, 0x01, 0x23, 0x45, 0x67},
+      .length_bits = 64,
+      .data_type = BITS,
+      .preamble = CUSTOM_PREAMBLE(BITS)
+    },
+    .expected = {104, 0xE90E4DF6, 240, 0x7CB27494, 0x7CB27494, 240, 0x46518AEA, 2400000, 0xB4BB5684}
+  },
+  {
+    .name = "custom_fhbfsk_galois_sync_wakeup",
+    .cfg = {
+      .baud_rate = 500.0f,
+      .mod_demod_method = MOD_DEMOD_FHBFSK,
+      .fsk_f0 = 30000,
+      .fsk_f1 = 33000,
+      .fc = 31000,
+      .fhbfsk_freq_spacing = 1,
+      .fhbfsk_num_tones = 10,
+      .fhbfsk_dwell_time = 1,
+      .preamble_validation = CRC_8,
+      .cargo_validation = CRC_16,
+      .preamble_ecc_method = JANUS_CONVOLUTIONAL,
+      .cargo_ecc_method = JANUS_CONVOLUTIONAL,
+      .use_interleaver = true,
+      .fhbfsk_hopper = HOPPER_GALOIS,
+      .sync_method = SYNC_PN_32_JANUS,
+      .wakeup_tones = true,
+      .wakeup_tone1 = 27000,
+      .wakeup_tone2 = 30000,
+      .wakeup_tone3 = 33000,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = {0x12, 0x34, 0x56, 0x78},
+      .length_bits = 32,
+      .data_type = BITS,
+      .preamble = CUSTOM_PREAMBLE(BITS)
+    },
+    .expected = {72, 0xFBCB98ED, 176, 0x72A6766D, 0x398FF3A7, 212, 0xB7ECDBBA, 440500, 0x69F3EFED}
+  },
+  {
+    .name = "custom_fhbfsk_prime_dwell",
+    .cfg = {
+      .baud_rate = 200.0f,
+      .mod_demod_method = MOD_DEMOD_FHBFSK,
+      .fsk_f0 = 30000,
+      .fsk_f1 = 33000,
+      .fc = 31000,
+      .fhbfsk_freq_spacing = 2,
+      .fhbfsk_num_tones = 12,
+      .fhbfsk_dwell_time = 2,
+      .preamble_validation = CRC_16,
+      .cargo_validation = CHECKSUM_32,
+      .preamble_ecc_method = HAMMING_CODE,
+      .cargo_ecc_method = HAMMING_CODE,
+      .use_interleaver = true,
+      .fhbfsk_hopper = HOPPER_PRIME,
+      .sync_method = NO_SYNC,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = {0xA5, 0x5A},
+      .length_bits = 16,
+      .data_type = BITS,
+      .preamble = CUSTOM_PREAMBLE(BITS)
+    },
+    .expected = {80, 0xA0D17B70, 92, 0xCD3390E4, 0xE8154B88, 92, 0x3B406CA3, 460000, 0x4DFD2BD6}
+  },
+  {
+    .name = "custom_mfsk16_hamming",
+    .cfg = {
+      .baud_rate = 250.0f,
+      .mod_demod_method = MOD_DEMOD_MFSK,
+      .fc = 31500,
+      .fhbfsk_freq_spacing = 1,
+      .fhbfsk_num_tones = 10,
+      .fhbfsk_dwell_time = 1,
+      .mfsk_bits_per_symbol = 4,
+      .preamble_validation = CRC_8,
+      .cargo_validation = CRC_16,
+      .preamble_ecc_method = HAMMING_CODE,
+      .cargo_ecc_method = HAMMING_CODE,
+      .use_interleaver = true,
+      .fhbfsk_hopper = HOPPER_INCREMENT,
+      .sync_method = NO_SYNC,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = "MFSK",
+      .length_bits = 32,
+      .data_type = STRING,
+      .preamble = CUSTOM_PREAMBLE(STRING)
+    },
+    .expected = {72, 0xA06A46AF, 83, 0x36A7EBEA, 0x64E9989B, 21, 0xB206BF10, 84000, 0x18D83FC2}
+  },
+  {
+    .name = "custom_dqpsk_hamming",
+    .cfg = {
+      .baud_rate = 500.0f,
+      .mod_demod_method = MOD_DEMOD_DQPSK,
+      .fc = 31300,
+      .fhbfsk_freq_spacing = 1,
+      .fhbfsk_num_tones = 10,
+      .fhbfsk_dwell_time = 1,
+      .mfsk_bits_per_symbol = 2,
+      .preamble_validation = CRC_8,
+      .cargo_validation = CRC_16,
+      .preamble_ecc_method = HAMMING_CODE,
+      .cargo_ecc_method = HAMMING_CODE,
+      .use_interleaver = true,
+      .fhbfsk_hopper = HOPPER_INCREMENT,
+      .sync_method = NO_SYNC,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_CUSTOM
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = "DQPSK",
+      .length_bits = 40,
+      .data_type = STRING,
+      .preamble = CUSTOM_PREAMBLE(STRING)
+    },
+    .expected = {80, 0xF6324488, 91, 0x8C1BEF70, 0x98416FA3, 47, 0xB60F9804, 94000, 0x5036A787}
+  },
+  {
+    .name = "janus_011_01_sms",
+    .cfg = {
+      .baud_rate = JANUS_BAUD,
+      .mod_demod_method = JANUS_MOD_DEMOD,
+      .fc = JANUS_FC,
+      .fhbfsk_freq_spacing = JANUS_FHBFSK_FREQ_SPACING,
+      .fhbfsk_num_tones = JANUS_FHBFSK_NUM_TONES,
+      .fhbfsk_dwell_time = JANUS_FHBFSK_DWELL_TIME,
+      .preamble_validation = JANUS_PREAMBLE_VALIDATION,
+      .cargo_validation = JANUS_CARGO_VALIDATION,
+      .preamble_ecc_method = JANUS_PREAMBLE_ECC,
+      .cargo_ecc_method = JANUS_CARGO_ECC,
+      .use_interleaver = JANUS_INTERLEAVER,
+      .fhbfsk_hopper = JANUS_HOPPER,
+      .sync_method = JANUS_SYNC_METHOD,
+      .wakeup_tones = false,
+      .protocol = PROTOCOL_JANUS
+    },
+    .msg = {
+      .type = MSG_TRANSMIT_FEEDBACK,
+      .data = "HELLO",
+      .length_bits = 40,
+      .janus_data_type = JANUS_011_01_SMS,
+      .preamble = JANUS_PREAMBLE
+    },
+    .expected = {136, 0x88910061, 304, 0xD3F6D337, 0x38C0D878, 336, 0x519EF791, 1344000, 0x3954931E}
+  }
+};
+
+static const uint16_t num_vectors = sizeof(golden_vectors) / sizeof(golden_vectors[0]);
+
+static bool record_mode = false;
+
+// Working copies since the transmit chain modifies the message
+static Message_t golden_msg;
+static BitMessage_t golden_bit_msg;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool computeResult(const GoldenVector_t* vector, GoldenResult_t* result);
+static bool bitStreamCrc(const BitMessage_t* bit_msg, uint32_t* crc);
+static void printRecord(const GoldenVector_t* vector, const GoldenResult_t* result);
+static bool printComparison(uint16_t index, const GoldenVector_t* vector, const GoldenResult_t* result);
+
+/* Exported function definitions ---------------------------------------------*/
+
+void GoldenVectors_SetRecordMode(bool record)
+{
+  record_mode = record;
+}
+
+bool GoldenVectors_Run()
+{
+  uint16_t failures = 0;
+  char output_buffer[96];
+
+  for (uint16_t i = 0; i < num_vectors; i++) {
+    GoldenResult_t result;
+    if (computeResult(&golden_vectors[i], &result) == false) {
+      snprintf(output_buffer, 96, "GOLDEN,%u,%s,ERROR\r\n", i,
+          golden_vectors[i].name);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+      return false;
+    }
+
+    if (record_mode == true) {
+      printRecord(&golden_vectors[i], &result);
+    }
+    else if (printComparison(i, &golden_vectors[i], &result) == false) {
+      failures++;
+    }
+  }
+
+  if (record_mode == false) {
+    snprintf(output_buffer, 96, "GOLDEN_END,%u/%u passed\r\n",
+        num_vectors - failures, num_vectors);
+    COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+  }
+  return true;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+bool computeResult(const GoldenVector_t* vector, GoldenResult_t* result)
+{
+  const DspConfig_t* cfg = &vector->cfg;
+  memcpy(&golden_msg, &vector->msg, sizeof(Message_t));
+
+  // Same sequence as the MESS task uses for transmission
+  if (Packet_PrepareTx(&golden_msg, &golden_bit_msg, cfg) == false) {
+    return false;
+  }
+  result->packet_bits = golden_bit_msg.bit_count;
+  if (bitStreamCrc(&golden_bit_msg, &result->packet_crc) == false) {
+    return false;
+  }
+
+  if (ErrorCorrection_AddCorrection(&golden_bit_msg, cfg) == false) {
+    return false;
+  }
+  result->ecc_bits = golden_bit_msg.bit_count;
+  if (bitStreamCrc(&golden_bit_msg, &result->ecc_crc) == false) {
+    return false;
+  }
+
+  if (Interleaver_Apply(&golden_bit_msg, cfg) == false) {
+    return false;
+  }
+  if (bitStreamCrc(&golden_bit_msg, &result->interleaved_crc) == false) {
+    return false;
+  }
+
+  // Step schedule as seen by the DAC (wakeup tones, sync and hop frequencies).
+  // DPSK phase shifts only show up in the rendered samples
+  uint16_t data_steps = Modulate_NumDataSteps(golden_bit_msg.bit_count, cfg);
+  MessDacResource_RegisterMessageConfiguration(cfg, &golden_bit_msg);
+  result->num_steps = data_steps + MessDacResource_SyncWakeupSteps();
+
+  uint32_t crc = CRC32_INIT;
+  for (uint16_t step = 0; step < result->num_steps; step++) {
+    WaveformStep_t waveform_step = MessDacResource_GetStep(step);
+    crc = Crc32_Update(crc, &waveform_step.freq_hz, sizeof(uint32_t));
+    crc = Crc32_Update(crc, &waveform_step.duration_us, sizeof(uint32_t));
+  }
+  result->steps_crc = Crc32_Final(crc);
+
+  return Waveform_Render(data_steps, GOLDEN_AMPLITUDE, GOLDEN_TRANSITION_LEN,
+      &result->dac_crc, &result->num_samples);
+}
+
+// Bits are packed MSB first with the final byte zero padded
+bool bitStreamCrc(const BitMessage_t* bit_msg, uint32_t* crc)
+{
+  uint32_t running_crc = CRC32_INIT;
+  uint8_t byte = 0;
+
+  for (uint16_t i = 0; i < bit_msg->bit_count; i++) {
+    bool bit;
+    if (Packet_GetBit(bit_msg, i, &bit) == false) {
+      return false;
+    }
+    byte = (byte << 1) | bit;
+    if ((i & 7) == 7) {
+      running_crc = Crc32_Update(running_crc, &byte, 1);
+      byte = 0;
+    }
+  }
+  if ((bit_msg->bit_count & 7) != 0) {
+    byte <<= 8 - (bit_msg->bit_count & 7);
+    running_crc = Crc32_Update(running_crc, &byte, 1);
+  }
+
+  *crc = Crc32_Final(running_crc);
+  return true;
+}
+
+// Prints the expected block in the same form as the table above
+void printRecord(const GoldenVector_t* vector, const GoldenResult_t* result)
+{
+  char output_buffer[160];
+
+  snprintf(output_buffer, 160, "// %s\r\n.expected = {%u, 0x%08lX, %u, 0x%08lX, "
+      "0x%08lX, %u, 0x%08lX, %lu, 0x%08lX}\r\n", vector->name,
+      result->packet_bits, result->packet_crc, result->ecc_bits, result->ecc_crc,
+      result->interleaved_crc, result->num_steps, result->steps_crc,
+      result->num_samples, result->dac_crc);
+  COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+}
+
+bool printComparison(uint16_t index, const GoldenVector_t* vector, const GoldenResult_t* result)
+{
+  const GoldenResult_t* expected = &vector->expected;
+  char output_buffer[128];
+
+  bool packet_ok = result->packet_bits == expected->packet_bits &&
+      result->packet_crc == expected->packet_crc;
+  bool ecc_ok = result->ecc_bits == expected->ecc_bits &&
+      result->ecc_crc == expected->ecc_crc;
+  bool interleaver_ok = result->interleaved_crc == expected->interleaved_crc;
+  bool steps_ok = result->num_steps == expected->num_steps &&
+      result->steps_crc == expected->steps_crc;
+  bool dac_ok = result->num_samples == expected->num_samples &&
+      result->dac_crc == expected->dac_crc;
+  bool passed = packet_ok && ecc_ok && interleaver_ok && steps_ok && dac_ok;
+
+  // Earlier stages failing will cause all later stages to fail as well
+  snprintf(output_buffer, 128, "GOLDEN,%u,%s,%s,packet=%u,ecc=%u,"
+      "interleaver=%u,steps=%u,dac=%u\r\n", index, vector->name,
+      passed ? "PASS" : "FAIL", packet_ok, ecc_ok, interleaver_ok, steps_ok,
+      dac_ok);
+  COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+
+  return passed;
+}
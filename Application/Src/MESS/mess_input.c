@@ -13,10 +13,12 @@
 #include "mess_packet.h"
 #include "mess_main.h"
 #include "mess_modulate.h"
+#include "mess_ofdm.h"
 #include "mess_error_correction.h"
 #include "mess_interleaver.h"
 #include "mess_sync.h"
 #include "mess_preamble.h"
+#include "mess_link_adapt.h"
 #include "cfg_defaults.h"
 #include "cfg_parameters.h"
 #include "cfg_main.h"
@@ -82,13 +84,14 @@ typedef struct {
 
 /* Private variables ---------------------------------------------------------*/
 
+// Ring of symbols waiting to be demodulated. The blocks only reference the
+// ADC buffer so the ring size does not depend on the message length
 static DemodulationInfo_t analysis_blocks[MAX_ANALYSIS_BUFFER_SIZE];
 
-static volatile uint16_t analysis_count1 = 0;
-static volatile uint16_t analysis_count2 = 0;
-
-static volatile uint8_t analysis_start_index = 0;
-static volatile uint8_t analysis_length = 0;
+// Free running producer/consumer counts. Only the low bits index the ring
+static volatile uint16_t analysis_head = 0; // Blocks segmented
+static volatile uint16_t analysis_tail = 0; // Blocks demodulated
+static uint16_t segmented_samples = 0; // ADC samples held by queued blocks
 static uint16_t bit_index = 0;
 
 static uint16_t print_waveform_start_index = 0;
@@ -136,6 +139,7 @@ static uint16_t findStartPosition(uint16_t analysis_index, uint16_t check_length
 static bool printReceivedWaveform(char* preamble_sequence);
 static void updateFrequencyIndices(const DspConfig_t* cfg);
 static uint32_t totalWaitSamples(const DspConfig_t* cfg);
+static bool addDecodedBits(BitMessage_t* bit_msg, const DemodulationInfo_t* block);
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -220,32 +224,30 @@ bool Input_DetectMessageStart(const DspConfig_t* cfg)
   return false;
 }
 
-// Segments blocks and adds them to array of blocks to be processed
+// Segments blocks and adds them to the ring of blocks to be processed
 bool Input_SegmentBlocks(const DspConfig_t* cfg)
 {
-  uint16_t analysis_buffer_length = (uint16_t) ((float) ADC_SAMPLING_RATE / cfg->baud_rate);
-  while (ADC_InputAvailableSamples() >= analysis_buffer_length) {
-
-    analysis_count1++;
-
-    uint16_t sync_chips = Sync_NumSteps(cfg);
+  uint16_t analysis_buffer_length = Demodulate_SymbolLength(cfg);
+  uint16_t sync_chips = Sync_NumSteps(cfg);
+  // The ADC tail stays on the oldest queued block so its samples are only
+  // released once demodulated. Segmentation reads ahead of the tail
+  while (ADC_InputAvailableSamples() - segmented_samples >= analysis_buffer_length) {
+    if ((uint16_t) (analysis_head - analysis_tail) >= MAX_ANALYSIS_BUFFER_SIZE) {
+      break;
+    }
 
-    uint16_t analysis_index = (analysis_start_index + analysis_length) % MAX_ANALYSIS_BUFFER_SIZE;
+    uint16_t analysis_index = analysis_head & ANALYSIS_BUFFER_MASK;
     analysis_blocks[analysis_index].buf_len = PROCESSING_BUFFER_SIZE;
     analysis_blocks[analysis_index].data_len = analysis_buffer_length;
-    analysis_blocks[analysis_index].data_start_index = ADC_InputGetTail();
+    analysis_blocks[analysis_index].data_start_index =
+        (ADC_InputGetTail() + segmented_samples) & PROCESSING_BUFFER_MASK;
     analysis_blocks[analysis_index].chip_index = bit_index + sync_chips;
     analysis_blocks[analysis_index].bit_index = bit_index++;
     analysis_blocks[analysis_index].decoded_bit = false;
     analysis_blocks[analysis_index].analysis_done = false;
 
-    analysis_length++;
-
-    if (analysis_length >= MAX_ANALYSIS_BUFFER_SIZE) {
-      return false; // overflow of analysis buffers
-    }
-
-    ADC_InputTailAdvance(analysis_buffer_length);
+    analysis_head++;
+    segmented_samples += analysis_buffer_length;
   }
   return true;
 }
@@ -260,27 +262,32 @@ bool Input_ProcessBlocks(BitMessage_t* bit_msg, const DspConfig_t* cfg)
     return true;
   }
 
-  while (analysis_length != 0) {
-    analysis_count2++;
-    if (Demodulate_Perform(&analysis_blocks[analysis_start_index], cfg) == false) {
-      return false;
+  while (analysis_tail != analysis_head) {
+    // Symbols past the end of the message are dropped by Input_Reset
+    if (bit_msg->preamble_received == true &&
+        bit_msg->bit_count >= bit_msg->final_length) {
+      break;
     }
-    if (Packet_AddBit(bit_msg, analysis_blocks[analysis_start_index].decoded_bit) == false) {
+
+    DemodulationInfo_t* block = &analysis_blocks[analysis_tail & ANALYSIS_BUFFER_MASK];
+    if (Demodulate_Perform(block, cfg) == false) {
       return false;
     }
-
-    analysis_start_index = (analysis_start_index + 1) % MAX_ANALYSIS_BUFFER_SIZE;
-    if (analysis_length == 0) {
+    LinkAdapt_AddSymbol(block);
+    if (addDecodedBits(bit_msg, block) == false) {
       return false;
     }
-    analysis_length--;
+    ADC_InputTailAdvance(block->data_len);
+    segmented_samples -= block->data_len;
+    analysis_tail++;
   }
 
   return true;
 }
 
 // Goes through message to see if enough bits have been received to decode the
-// length and data type
+// length and data type. Once the preamble is known the cargo error correction
+// is run on the bits received so far
 bool Input_DecodeBits(BitMessage_t* bit_msg, const DspConfig_t* cfg, Message_t* msg)
 {
   if (bit_msg == NULL) {
@@ -312,17 +319,26 @@ bool Input_DecodeBits(BitMessage_t* bit_msg, const DspConfig_t* cfg, Message_t*
       bit_msg->preamble_received = true;
     }
   }
+
+  // Decode the cargo as it arrives so only the tail is left once received
+  if (bit_msg->preamble_received == true && bit_msg->added_to_queue == false) {
+    if (ErrorCorrection_StreamCargo(bit_msg, LinkAdapt_CargoConfig(cfg, &msg->preamble)) == false) {
+      return false;
+    }
+  }
   return true;
 }
 
 void Input_Reset()
 {
   ADC_InputClear();
-  analysis_start_index = 0;
-  analysis_length = 0;
+  analysis_head = 0;
+  analysis_tail = 0;
+  segmented_samples = 0;
   fft_analysis_index = 0;
   fft_analysis_length = 0;
   bit_index = 0;
+  ErrorCorrection_ResetStream();
 }
 
 void Input_PrintNoise()
@@ -689,6 +705,33 @@ void updateFrequencyIndices(const DspConfig_t* cfg)
     frequency0 = cfg->fsk_f0;
     frequency1 = cfg->fsk_f1;
   }
+  else if (cfg->mod_demod_method == MOD_DEMOD_MFSK) {
+    // Outermost tones. Gray coding means these are not the extreme symbols
+    uint16_t num_tones = 1 << cfg->mfsk_bits_per_symbol;
+    frequency0 = UINT32_MAX;
+    frequency1 = 0;
+    for (uint16_t symbol = 0; symbol < num_tones; symbol++) {
+      uint32_t frequency = Modulate_GetMfskFrequency(symbol, cfg);
+      if (frequency < frequency0) {
+        frequency0 = frequency;
+      }
+      if (frequency > frequency1) {
+        frequency1 = frequency;
+      }
+    }
+  }
+  else if (cfg->mod_demod_method == MOD_DEMOD_OFDM) {
+    // Outermost subcarriers
+    if (Ofdm_GetBand(cfg, &frequency0, &frequency1) == false) {
+      frequency0 = cfg->fc;
+      frequency1 = cfg->fc;
+    }
+  }
+  else if (Modulate_IsDifferential(cfg) == true) {
+    // Single carrier so both checks land on fc
+    frequency0 = cfg->fc;
+    frequency1 = cfg->fc;
+  }
   else {
     frequency0 = Modulate_GetFhbfskFrequency(false, 0, cfg);
     frequency1 = Modulate_GetFhbfskFrequency(true, 0, cfg);
@@ -728,6 +771,39 @@ void updateFrequencyIndices(const DspConfig_t* cfg)
   }
 }
 
+// Unpacks every bit carried by a demodulated symbol. Padding bits in the final
+// multi-bit symbol are dropped once the full message length is known. A DPSK
+// phase reference carries no bits
+static bool addDecodedBits(BitMessage_t* bit_msg, const DemodulationInfo_t* block)
+{
+  for (uint8_t i = 0; i < block->num_bits; i++) {
+    if (bit_msg->preamble_received == true && bit_msg->bit_count >= bit_msg->final_length) {
+      break;
+    }
+    if (bit_msg->bit_count >= PACKET_MAX_LENGTH_BYTES * 8) {
+      break; // Padding past the end of the largest message
+    }
+    bool bit;
+    if (block->num_bits == 1) {
+      bit = block->decoded_bit;
+    }
+    else if (block->num_bits > 8) {
+      bit = (block->symbol_bits[i / 8] >> (7 - i % 8)) & 1;
+    }
+    else {
+      bit = (block->decoded_symbol >> (block->num_bits - 1 - i)) & 1;
+    }
+    if (Packet_AddBit(bit_msg, bit) == false) {
+      return false;
+    }
+    // OFDM symbols carry no soft decisions
+    if (block->num_bits <= MFSK_MAX_BITS_PER_SYMBOL) {
+      Packet_SetConfidence(bit_msg, bit_msg->bit_count - 1, block->soft_bits[i]);
+    }
+  }
+  return true;
+}
+
 static uint32_t totalWaitSamples(const DspConfig_t* cfg)
 {
   uint16_t num_steps = Sync_NumSteps(cfg);
@@ -34,6 +34,9 @@ const uint16_t primes[50] = {
 
 static const uint16_t num_primes = sizeof(primes) / sizeof(primes[0]);
 
+// Scratch copy of the bits being reordered. Kept off the MESS task stack
+static BitMessage_t scratch_bit_msg;
+
 /* Private function prototypes -----------------------------------------------*/
 
 // These functions directly modify the input bit message. Both functions are
@@ -53,16 +56,15 @@ bool Interleaver_Apply(BitMessage_t* bit_msg, const DspConfig_t* cfg)
     return true;
   }
   // First interleave the preamble separately following the JANUS standard
-  BitMessage_t buffer_bit_msg;
-  buffer_bit_msg.bit_count = bit_msg->bit_count;
+  scratch_bit_msg.bit_count = bit_msg->bit_count;
   if (interleave(bit_msg->preamble.ecc_start_index, bit_msg->preamble.ecc_len,
-                 bit_msg, &buffer_bit_msg) == false) {
+                 bit_msg, &scratch_bit_msg) == false) {
     return false;
   }
 
   // Then interleave the message cargo separately
   if (interleave(bit_msg->cargo.ecc_start_index, bit_msg->cargo.ecc_len,
-                 bit_msg, &buffer_bit_msg) == false) {
+                 bit_msg, &scratch_bit_msg) == false) {
     return false;
   }
   return true;
@@ -73,12 +75,11 @@ bool Interleaver_Undo(BitMessage_t* bit_msg, const DspConfig_t* cfg, bool is_pre
   if (cfg->use_interleaver == false) {
     return true;
   }
-  BitMessage_t buffer_bit_msg;
-  buffer_bit_msg.bit_count = bit_msg->bit_count;
+  scratch_bit_msg.bit_count = bit_msg->bit_count;
   SectionInfo_t section_info = is_preamble ? bit_msg->preamble : bit_msg->cargo;
 
   return deinterleave(section_info.ecc_start_index, section_info.ecc_len,
-      bit_msg, &buffer_bit_msg);
+      bit_msg, &scratch_bit_msg);
 }
 
 /* Private function definitions ----------------------------------------------*/
@@ -139,6 +140,9 @@ bool deinterleave(uint16_t start_index, uint16_t length,
     return false;
   }
 
+  // The soft decisions stay in received order and are looked up through the
+  // same mapping
+  Packet_DeinterleaveConfidence(input_bit_msg, start_index, length, interleaver_depth);
   return true;
 }
 
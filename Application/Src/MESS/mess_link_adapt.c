@@ -0,0 +1,411 @@
+/*
+ * mess_link_adapt.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_link_adapt.h"
+#include "mess_main.h"
+#include "mess_sync.h"
+#include "mess_modulate.h"
+#include "mess_error_correction.h"
+#include "mess_error_detection.h"
+
+#include "cfg_main.h"
+#include "cfg_parameters.h"
+#include "cfg_defaults.h"
+
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+  ErrorCorrectionMethod_t cargo_ecc_method;
+  const char* name;
+} RateProfile_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Peers that have not been heard from for this long no longer limit the rate
+#define PEER_STALE_MS               600000
+// Weight of the newest message in the smoothed SNR of a peer
+#define SNR_SMOOTHING               0.25f
+// Outer loop step after a cargo failure. Each success steps back by
+// target / (1 - target) of this so the offset settles where the observed
+// packet error rate matches the target
+#define OLLA_STEP_DB                1.0f
+#define OLLA_MIN_OFFSET_DB          (-3.0f)
+#define OLLA_MAX_OFFSET_DB          10.0f
+// Fewer soft decisions than this fall back to the synchronization SNR
+#define MIN_SOFT_BITS               32
+#define MIN_SNR_LINEAR              1e-3f
+#define MIN_SOFT_ERROR              1e-4f
+
+// Free distance of the JANUS K = 9 convolutional code and the number of
+// error events at that distance
+#define CONV_FREE_DISTANCE          12
+#define CONV_FREE_DISTANCE_EVENTS   11.0f
+
+/* Private macro -------------------------------------------------------------*/
+
+#define NUM_RATE_PROFILES           (sizeof(rate_profiles) / sizeof(rate_profiles[0]))
+
+/* Private variables ---------------------------------------------------------*/
+
+// Index 0 is the configured cargo ECC. Must fit PACKET_RATE_PROFILE_BITS
+static const RateProfile_t rate_profiles[] = {
+  {NO_ECC, "configured"},
+  {JANUS_CONVOLUTIONAL, "convolutional"},
+  {QC_LDPC, "QC-LDPC"},
+  {REED_SOLOMON, "Reed-Solomon"},
+  {HAMMING_CODE, "Hamming"},
+  {NO_ECC, "uncoded"}
+};
+
+// Hard decision fraction of errors each LDPC rate is assumed to correct
+static const float ldpc_correctable_fraction[NUM_LDPC_RATES] = {
+  0.05f, 0.03f, 0.02f
+};
+
+static uint8_t per_target_percent = DEFAULT_LINK_ADAPT_PER;
+
+static LinkPeer_t peers[LINK_ADAPT_MAX_PEERS];
+
+static DspConfig_t profile_config;
+static uint8_t last_tx_profile = RATE_PROFILE_CONFIGURED;
+
+// Soft decision measurement of the message being received
+static float soft_error_sum = 0.0f;
+static uint16_t soft_bit_count = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool measuredSnr(const DspConfig_t* cfg, float* snr_db);
+static float channelBitErrorRate(float snr_db, const DspConfig_t* cfg);
+static float binomialTail(uint16_t n, uint16_t t, float p);
+static float packetErrorRate(ErrorCorrectionMethod_t method, uint16_t raw_bits,
+                             uint16_t coded_bits, float p);
+static uint8_t selectProfile(uint16_t raw_bits, const DspConfig_t* cfg);
+static bool weakestPeer(float* snr_db);
+
+/* Exported function definitions ---------------------------------------------*/
+
+bool LinkAdapt_RegisterParams(void)
+{
+  uint32_t min_u32 = MIN_LINK_ADAPT_PER;
+  uint32_t max_u32 = MAX_LINK_ADAPT_PER;
+  if (Param_Register(PARAM_LINK_ADAPT_PER_TARGET, "the link adaptation PER target",
+                     PARAM_TYPE_UINT8, &per_target_percent, sizeof(uint8_t),
+                     &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+  return true;
+}
+
+void LinkAdapt_StartPacket(void)
+{
+  soft_error_sum = 0.0f;
+  soft_bit_count = 0;
+}
+
+void LinkAdapt_AddSymbol(const DemodulationInfo_t* block)
+{
+  // OFDM symbols and DPSK phase references carry no soft decisions
+  if (block->num_bits == 0 || block->num_bits > MFSK_MAX_BITS_PER_SYMBOL) {
+    return;
+  }
+  for (uint8_t i = 0; i < block->num_bits; i++) {
+    soft_error_sum += (1.0f - fabsf(block->soft_bits[i])) * 0.5f;
+    soft_bit_count++;
+  }
+}
+
+void LinkAdapt_Observe(const Message_t* msg, const BitMessage_t* bit_msg,
+                       const DspConfig_t* cfg)
+{
+  if (cfg->protocol != PROTOCOL_CUSTOM || cfg->link_adaptation == false) {
+    return;
+  }
+  if (bit_msg->error_preamble == true || msg->preamble.modem_id.valid == false) {
+    return;
+  }
+  uint8_t modem_id = msg->preamble.modem_id.value;
+  if (modem_id >= LINK_ADAPT_MAX_PEERS) {
+    return;
+  }
+  LinkPeer_t* peer = &peers[modem_id];
+
+  float snr_db;
+  if (measuredSnr(cfg, &snr_db) == true) {
+    peer->snr_db = (peer->valid == true) ?
+        peer->snr_db + SNR_SMOOTHING * (snr_db - peer->snr_db) : snr_db;
+    peer->valid = true;
+  }
+  if (peer->valid == false) {
+    return;
+  }
+
+  float target = per_target_percent / 100.0f;
+  if (msg->error_detected == true) {
+    peer->offset_db += OLLA_STEP_DB;
+    peer->failures++;
+  }
+  else {
+    peer->offset_db -= OLLA_STEP_DB * target / (1.0f - target);
+  }
+  if (peer->offset_db > OLLA_MAX_OFFSET_DB) {
+    peer->offset_db = OLLA_MAX_OFFSET_DB;
+  }
+  else if (peer->offset_db < OLLA_MIN_OFFSET_DB) {
+    peer->offset_db = OLLA_MIN_OFFSET_DB;
+  }
+
+  peer->packets++;
+  peer->last_tick = osKernelGetTickCount();
+  peer->last_profile = msg->preamble.rate_profile.value;
+}
+
+const DspConfig_t* LinkAdapt_PrepareTx(Message_t* msg, const DspConfig_t* cfg)
+{
+  if (cfg->protocol != PROTOCOL_CUSTOM || cfg->link_adaptation == false) {
+    return cfg;
+  }
+
+  // Evaluation messages are compared against the configured coding
+  uint8_t profile = RATE_PROFILE_CONFIGURED;
+  if (msg->data_type != EVAL) {
+    uint16_t detection_bits;
+    if (ErrorDetection_CheckLength(&detection_bits, cfg->cargo_validation) == false) {
+      detection_bits = PACKET_MAX_ERROR_DETECTION_BITS;
+    }
+    profile = selectProfile(msg->length_bits + detection_bits, cfg);
+  }
+  msg->preamble.rate_profile.value = profile;
+  msg->preamble.rate_profile.valid = true;
+  last_tx_profile = profile;
+  return LinkAdapt_CargoConfig(cfg, &msg->preamble);
+}
+
+const DspConfig_t* LinkAdapt_CargoConfig(const DspConfig_t* cfg,
+                                         const PreambleContent_t* preamble)
+{
+  if (cfg->protocol != PROTOCOL_CUSTOM || cfg->link_adaptation == false) {
+    return cfg;
+  }
+  // A corrupted profile is left to fail the cargo validation
+  if (preamble->rate_profile.valid == false ||
+      preamble->rate_profile.value == RATE_PROFILE_CONFIGURED ||
+      preamble->rate_profile.value >= NUM_RATE_PROFILES) {
+    return cfg;
+  }
+  memcpy(&profile_config, cfg, sizeof(DspConfig_t));
+  profile_config.cargo_ecc_method = rate_profiles[preamble->rate_profile.value].cargo_ecc_method;
+  return &profile_config;
+}
+
+bool LinkAdapt_GetPeer(uint8_t modem_id, LinkPeer_t* peer)
+{
+  if (modem_id >= LINK_ADAPT_MAX_PEERS || peers[modem_id].valid == false) {
+    return false;
+  }
+  memcpy(peer, &peers[modem_id], sizeof(LinkPeer_t));
+  return true;
+}
+
+uint8_t LinkAdapt_LastTxProfile(void)
+{
+  return last_tx_profile;
+}
+
+const char* LinkAdapt_ProfileName(uint8_t profile)
+{
+  if (profile >= NUM_RATE_PROFILES) {
+    return "invalid";
+  }
+  return rate_profiles[profile].name;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+// The soft decisions give the fraction of energy on the losing side of each
+// bit. For energy detectors that is about 1 / (SNR + 2) and for DPSK the phase
+// error gives about 1 / (4 SNR). The PN synchronization SNR is only used when
+// the modulation has no soft decisions. Any bias is absorbed by the outer loop
+bool measuredSnr(const DspConfig_t* cfg, float* snr_db)
+{
+  float snr;
+  if (soft_bit_count >= MIN_SOFT_BITS) {
+    float soft_error = soft_error_sum / soft_bit_count;
+    if (soft_error < MIN_SOFT_ERROR) {
+      soft_error = MIN_SOFT_ERROR;
+    }
+    if (Modulate_IsDifferential(cfg) == true) {
+      snr = 1.0f / (4.0f * soft_error);
+    }
+    else {
+      snr = 1.0f / soft_error - 2.0f;
+    }
+  }
+  else {
+    snr = Sync_LastSnr();
+    if (snr <= 0.0f) {
+      return false;
+    }
+  }
+  if (snr < MIN_SNR_LINEAR) {
+    snr = MIN_SNR_LINEAR;
+  }
+  *snr_db = 10.0f * log10f(snr);
+  return true;
+}
+
+// Noncoherent BFSK for the energy detectors and DBPSK for the differential
+// and OFDM phase detectors
+float channelBitErrorRate(float snr_db, const DspConfig_t* cfg)
+{
+  float snr = powf(10.0f, snr_db / 10.0f);
+  bool phase_detector = (Modulate_IsDifferential(cfg) == true) ||
+                        (cfg->mod_demod_method == MOD_DEMOD_OFDM);
+  float p = 0.5f * expf(phase_detector ? -snr : -0.5f * snr);
+  return p;
+}
+
+// Probability of more than t errors in n independent trials
+float binomialTail(uint16_t n, uint16_t t, float p)
+{
+  if (t >= n || p <= 0.0f) {
+    return 0.0f;
+  }
+  if (p >= 1.0f) {
+    return 1.0f;
+  }
+  // Log domain since (1 - p)^n underflows for long codewords
+  float log_term = n * log1pf(-p);
+  float log_odds = logf(p) - log1pf(-p);
+  float cdf = 0.0f;
+  for (uint16_t k = 0; k <= t; k++) {
+    cdf += expf(log_term);
+    log_term += logf((float) (n - k) / (float) (k + 1)) + log_odds;
+  }
+  return (cdf < 1.0f) ? 1.0f - cdf : 0.0f;
+}
+
+float packetErrorRate(ErrorCorrectionMethod_t method, uint16_t raw_bits,
+                      uint16_t coded_bits, float p)
+{
+  switch (method) {
+    case NO_ECC:
+      return binomialTail(raw_bits, 0, p);
+    case HAMMING_CODE:
+      // A single code over the whole section corrects one error
+      return binomialTail(coded_bits, 1, p);
+    case JANUS_CONVOLUTIONAL: {
+      // Union bound on the first error event with hard decisions. Ties at
+      // half the free distance are broken at random
+      float pairwise = 0.5f * (binomialTail(CONV_FREE_DISTANCE, CONV_FREE_DISTANCE / 2 - 1, p) +
+                               binomialTail(CONV_FREE_DISTANCE, CONV_FREE_DISTANCE / 2, p));
+      float event = CONV_FREE_DISTANCE_EVENTS * pairwise;
+      if (event >= 1.0f) {
+        return 1.0f;
+      }
+      return 1.0f - expf(raw_bits * log1pf(-event));
+    }
+    case REED_SOLOMON: {
+      uint8_t block_length;
+      uint8_t parity_symbols;
+      if (Param_GetUint8(PARAM_RS_BLOCK_LENGTH, &block_length) == false ||
+          Param_GetUint8(PARAM_RS_PARITY_SYMBOLS, &parity_symbols) == false ||
+          block_length <= parity_symbols) {
+        return 1.0f;
+      }
+      float symbol_error = binomialTail(8, 0, p);
+      float block_error = binomialTail(block_length, parity_symbols / 2, symbol_error);
+      uint16_t data_symbols = block_length - parity_symbols;
+      uint16_t num_blocks = ((raw_bits + 7) / 8 + data_symbols - 1) / data_symbols;
+      return 1.0f - powf(1.0f - block_error, num_blocks);
+    }
+    case QC_LDPC: {
+      uint8_t rate;
+      if (Param_GetUint8(PARAM_LDPC_RATE, &rate) == false || rate >= NUM_LDPC_RATES) {
+        return 1.0f;
+      }
+      uint16_t num_codewords = (coded_bits + LDPC_MAX_CODEWORD_BITS - 1) / LDPC_MAX_CODEWORD_BITS;
+      uint16_t codeword_bits = coded_bits / num_codewords;
+      uint16_t correctable = (uint16_t) (ldpc_correctable_fraction[rate] * codeword_bits);
+      float codeword_error = binomialTail(codeword_bits, correctable, p);
+      return 1.0f - powf(1.0f - codeword_error, num_codewords);
+    }
+    default:
+      return 1.0f;
+  }
+}
+
+// Goodput is the delivered fraction of the cargo per waveform step so the
+// preamble and synchronization overhead favour the shorter codes
+uint8_t selectProfile(uint16_t raw_bits, const DspConfig_t* cfg)
+{
+  float snr_db;
+  if (weakestPeer(&snr_db) == false) {
+    return RATE_PROFILE_CONFIGURED;
+  }
+  float p = channelBitErrorRate(snr_db, cfg);
+  float target = per_target_percent / 100.0f;
+
+  uint16_t detection_bits;
+  if (ErrorDetection_CheckLength(&detection_bits, cfg->preamble_validation) == false) {
+    return RATE_PROFILE_CONFIGURED;
+  }
+  uint16_t preamble_bits = ErrorCorrection_CodedLength(
+      PACKET_PREAMBLE_LENGTH_BITS + PACKET_RATE_PROFILE_BITS + detection_bits,
+      cfg->preamble_ecc_method);
+  uint16_t overhead_steps = Sync_NumSteps(cfg);
+
+  uint8_t best_profile = RATE_PROFILE_CONFIGURED;
+  float best_goodput = -1.0f;
+  uint8_t safest_profile = RATE_PROFILE_CONFIGURED;
+  float lowest_per = 2.0f;
+  for (uint8_t i = RATE_PROFILE_CONFIGURED + 1; i < NUM_RATE_PROFILES; i++) {
+    ErrorCorrectionMethod_t method = rate_profiles[i].cargo_ecc_method;
+    uint16_t coded_bits = ErrorCorrection_CodedLength(raw_bits, method);
+    if (coded_bits == 0) {
+      continue; // Invalid code parameters
+    }
+    float per = packetErrorRate(method, raw_bits, coded_bits, p);
+    uint16_t steps = overhead_steps + Modulate_NumDataSteps(preamble_bits + coded_bits, cfg);
+    float goodput = (1.0f - per) * raw_bits / steps;
+    if (per <= target && goodput > best_goodput) {
+      best_goodput = goodput;
+      best_profile = i;
+    }
+    if (per < lowest_per) {
+      lowest_per = per;
+      safest_profile = i;
+    }
+  }
+  return (best_goodput >= 0.0f) ? best_profile : safest_profile;
+}
+
+// Messages are broadcast so the rate has to suit every peer heard recently
+bool weakestPeer(float* snr_db)
+{
+  uint32_t now = osKernelGetTickCount();
+  bool found = false;
+  for (uint8_t i = 0; i < LINK_ADAPT_MAX_PEERS; i++) {
+    if (peers[i].valid == false || now - peers[i].last_tick > PEER_STALE_MS) {
+      continue;
+    }
+    float effective_db = peers[i].snr_db - peers[i].offset_db;
+    if (found == false || effective_db < *snr_db) {
+      *snr_db = effective_db;
+      found = true;
+    }
+  }
+  return found;
+}
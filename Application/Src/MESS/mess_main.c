@@ -22,12 +22,22 @@
 #include "mess_calibration.h"
 #include "mess_dsp_config.h"
 #include "mess_feedback_tests.h"
+#include "mess_snr_sweep.h"
+#include "mess_golden_vectors.h"
+#include "mess_arq.h"
+#include "mess_fragment.h"
+#include "mess_link_adapt.h"
 #include "mess_interleaver.h"
 #include "mess_cargo.h"
 #include "mess_background_noise.h"
 #include "mess_sync.h"
+#include "mess_ofdm.h"
+#include "mess_error_correction.h"
 
 #include "sys_error.h"
+#include "sys_cpu_load.h"
+#include "sys_power.h"
+#include "sys_trace.h"
 
 #include "cfg_main.h"
 #include "cfg_parameters.h"
@@ -88,6 +98,8 @@ static DspConfig_t custom_config = {
     .fhbfsk_freq_spacing = DEFAULT_FHBFSK_FREQ_SPACING,
     .fhbfsk_num_tones = DEFAULT_FHBFSK_NUM_TONES,
     .fhbfsk_dwell_time = DEFAULT_FHBFSK_DWELL_TIME,
+    .mfsk_bits_per_symbol = DEFAULT_MFSK_BITS_PER_SYMBOL,
+    .ofdm_num_subcarriers = DEFAULT_OFDM_NUM_SUBCARRIERS,
     .preamble_validation = DEFAULT_PREAMBLE_ERROR_DETECTION,
     .cargo_validation = DEFAULT_CARGO_ERROR_DETECTION,
     .preamble_ecc_method = DEFAULT_ECC_PREAMBLE,
@@ -99,7 +111,8 @@ static DspConfig_t custom_config = {
     .wakeup_tone1 = DEFAULT_WAKEUP_TONE_FREQ1,
     .wakeup_tone2 = DEFAULT_WAKEUP_TONE_FREQ2,
     .wakeup_tone3 = DEFAULT_WAKEUP_TONE_FREQ3,
-    .protocol = PROTOCOL_CUSTOM
+    .protocol = PROTOCOL_CUSTOM,
+    .link_adaptation = DEFAULT_LINK_ADAPT_STATE
 };
 static DspConfig_t janus_config = {
     .baud_rate = JANUS_BAUD,
@@ -117,7 +130,11 @@ static DspConfig_t janus_config = {
     .sync_method = JANUS_SYNC_METHOD,
     .protocol = PROTOCOL_JANUS
 };
-static DspConfig_t* cfg = &custom_config;
+// Parameter writes land in custom_config while the task only works on its
+// snapshot so a packet never sees a half applied configuration change
+static DspConfig_t custom_config_snapshot;
+static uint32_t custom_config_version = 0;
+static DspConfig_t* cfg = &custom_config_snapshot;
 static BitMessage_t bit_msg;
 static uint16_t message_length = 0;
 
@@ -127,12 +144,14 @@ Message_t rx_msg;
 /* Private function prototypes -----------------------------------------------*/
 
 static void switchState(ProcessingState_t newState);
+static void setTaskState(ProcessingState_t state);
 static void switchTrTransmit();
 static void switchTrReceive();
 static bool handleFlags();
 static bool registerMessParams();
 static bool registerMessMainParams();
 static void getConfig();
+static void refreshConfigSnapshot();
 
 /* Exported function definitions ---------------------------------------------*/
 
@@ -165,6 +184,9 @@ void MESS_StartTask(void* argument)
   Feedback_Init();
   FeedbackTests_Init();
   Demodulate_Init();
+  if (Ofdm_Init() == false) {
+    Error_Routine(ERROR_MESS_INIT);
+  }
   switchState(LISTENING);
 
   osDelay(10);
@@ -196,17 +218,23 @@ void MESS_StartTask(void* argument)
         }
 
         FeedbackTests_GetNext();
+        SnrSweep_GetNext();
         getConfig();
+        Fragment_Process(cfg);
+        Arq_Process(cfg);
 
-        if (MESS_GetMessageFromTxQ(&tx_msg) == pdPASS) {
+        // Messages wait in the queue while parameters are written to flash
+        if (CFG_IsFlashBusy() == false && MESS_GetMessageFromTxQ(&tx_msg) == pdPASS) {
           getConfig();
+          // Only the cargo coding changes so the waveform still uses cfg
+          const DspConfig_t* tx_cfg = LinkAdapt_PrepareTx(&tx_msg, cfg);
 
-          if (Packet_PrepareTx(&tx_msg, &bit_msg, cfg) == false) {
+          if (Packet_PrepareTx(&tx_msg, &bit_msg, tx_cfg) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
             break;
           }
           // Add ECC
-          if (ErrorCorrection_AddCorrection(&bit_msg, cfg) == false) {
+          if (ErrorCorrection_AddCorrection(&bit_msg, tx_cfg) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
           }
           // Add feedback network test false bits
@@ -214,13 +242,14 @@ void MESS_StartTask(void* argument)
             Error_Routine(ERROR_MESS_PROCESSING);
             break;
           }
-          if (Interleaver_Apply(&bit_msg, cfg) == false) {
+          if (Interleaver_Apply(&bit_msg, tx_cfg) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
           }
-          message_length = bit_msg.bit_count;
+          message_length = Modulate_NumDataSteps(bit_msg.bit_count, cfg);
           // convert to frequencies in message_sequence
           switch (tx_msg.type) {
             case MSG_TRANSMIT_TRANSDUCER:
+              Power_AddPacket(POWER_PACKET_TX, tx_msg.length_bits, true);
               switchState(DRIVING_TRANSDUCER);
               break;
             case MSG_TRANSMIT_FEEDBACK:
@@ -232,7 +261,13 @@ void MESS_StartTask(void* argument)
           }
         }
 
-        if (Sync_Synchronize(cfg) == true) {
+        // A flash erase stalls the ADC interrupt for many DMA half buffers so
+        // the input is discarded instead of searched until the save is done
+        if (CFG_IsFlashBusy() == true) {
+          ADC_InputSetTail(ADC_InputGetHead());
+          Sync_Reset();
+        }
+        else if (Sync_Synchronize(cfg) == true) {
           switchState(PROCESSING);
           break;
         }
@@ -270,38 +305,51 @@ void MESS_StartTask(void* argument)
           rx_msg.timestamp = osKernelGetTickCount();
           rx_msg.length_bits = input_bit_msg.data_len_bits;
           rx_msg.protocol = cfg->protocol;
+          // Cargo coding picked by the sender's link adaptation
+          const DspConfig_t* cargo_cfg = LinkAdapt_CargoConfig(cfg, &rx_msg.preamble);
 
-          if (Interleaver_Undo(&input_bit_msg, cfg, false) == false) {
+          if (Interleaver_Undo(&input_bit_msg, cargo_cfg, false) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
           }
 
           // TODO: change to also require message to be custom
           if (rx_msg.preamble.message_type.value == EVAL && (rx_msg.preamble.message_type.valid == true)) {
-            if (Evaluate_UncodedBer(&rx_msg.eval_info, &input_bit_msg, cfg) == false) {
+            if (Evaluate_UncodedBer(&rx_msg.eval_info, &input_bit_msg, cargo_cfg) == false) {
               Error_Routine(ERROR_MESS_PROCESSING);
             }
           }
 
           // undo fec
-          if (ErrorCorrection_CheckCorrection(&input_bit_msg, cfg, false,
+          if (ErrorCorrection_CheckCorrection(&input_bit_msg, cargo_cfg, false,
               &input_bit_msg.error_message,
               &input_bit_msg.corrected_error_message) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
           }
           // decode message
-          if (Cargo_Decode(&input_bit_msg, &rx_msg, cfg) == false) {
+          if (Cargo_Decode(&input_bit_msg, &rx_msg, cargo_cfg) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
             break;
           }
 
           if (ErrorDetection_CheckDetection(&input_bit_msg,
-              &rx_msg.error_detected, cfg, false) == false) {
+              &rx_msg.error_detected, cargo_cfg, false) == false) {
             Error_Routine(ERROR_MESS_PROCESSING);
             break;
           }
+          LinkAdapt_Observe(&rx_msg, &input_bit_msg, cfg);
           rx_msg.error_detected |= input_bit_msg.error_preamble;
+          if (rx_msg.error_detected == true) {
+            Trace_Fault(TRACE_EVENT_PACKET_FAILED, rx_msg.length_bits);
+          }
+          else {
+            Trace_Record(TRACE_EVENT_PACKET_RECEIVED, rx_msg.length_bits);
+          }
+          Power_AddPacket(POWER_PACKET_RX, rx_msg.length_bits, rx_msg.error_detected == false);
           // send it via queue
-          if (FeedbackTests_Check(&rx_msg, &input_bit_msg) == false) {
+          if (FeedbackTests_Check(&rx_msg, &input_bit_msg) == false &&
+              SnrSweep_Check(&rx_msg, &input_bit_msg) == false &&
+              Arq_Check(&rx_msg) == false &&
+              Fragment_Check(&rx_msg) == false) {
             MESS_AddMessageToRxQ(&rx_msg);
           }
           input_bit_msg.added_to_queue = true;
@@ -324,12 +372,21 @@ void MESS_StartTask(void* argument)
 
 void MESS_InitializeQueues(void)
 {
-  tx_queue = xQueueCreate(MSG_QUEUE_SIZE, sizeof(Message_t));
-  rx_queue = xQueueCreate(MSG_QUEUE_SIZE, sizeof(Message_t));
+  static StaticQueue_t tx_queue_control_block;
+  static StaticQueue_t rx_queue_control_block;
+  static uint8_t tx_queue_storage[MSG_QUEUE_SIZE * sizeof(Message_t)];
+  static uint8_t rx_queue_storage[MSG_QUEUE_SIZE * sizeof(Message_t)];
+
+  tx_queue = xQueueCreateStatic(MSG_QUEUE_SIZE, sizeof(Message_t),
+                                tx_queue_storage, &tx_queue_control_block);
+  rx_queue = xQueueCreateStatic(MSG_QUEUE_SIZE, sizeof(Message_t),
+                                rx_queue_storage, &rx_queue_control_block);
 
   if (tx_queue == NULL || rx_queue == NULL) {
     // TODO: Handle error
   }
+
+  Arq_InitializeQueue();
 }
 
 BaseType_t MESS_GetMessageFromTxQ(Message_t* msg)
@@ -416,6 +473,41 @@ bool MESS_GetBandwidth(uint32_t* bandwidth, uint32_t* lower_freq, uint32_t* uppe
     *bandwidth = *upper_freq - *lower_freq;
     return true;
   }
+  else if (custom_config.mod_demod_method == MOD_DEMOD_MFSK) {
+    // Outermost tones. Gray coding means these are not the extreme symbols
+    uint16_t num_tones = 1 << custom_config.mfsk_bits_per_symbol;
+    *lower_freq = UINT32_MAX;
+    *upper_freq = 0;
+    for (uint16_t symbol = 0; symbol < num_tones; symbol++) {
+      uint32_t freq = Modulate_GetMfskFrequency(symbol, &custom_config);
+      if (freq < *lower_freq) {
+        *lower_freq = freq;
+      }
+      if (freq > *upper_freq) {
+        *upper_freq = freq;
+      }
+    }
+
+    *bandwidth = *upper_freq - *lower_freq;
+    return true;
+  }
+  else if (custom_config.mod_demod_method == MOD_DEMOD_OFDM) {
+    if (Ofdm_GetBand(&custom_config, lower_freq, upper_freq) == false) {
+      return false;
+    }
+    *bandwidth = *upper_freq - *lower_freq;
+    return true;
+  }
+  else if (Modulate_IsDifferential(&custom_config) == true) {
+    // Main lobe of the phase modulated carrier
+    if (custom_config.fc <= custom_config.baud_rate) {
+      return false;
+    }
+    *lower_freq = (uint32_t) (custom_config.fc - custom_config.baud_rate);
+    *upper_freq = (uint32_t) (custom_config.fc + custom_config.baud_rate);
+    *bandwidth = *upper_freq - *lower_freq;
+    return true;
+  }
   return false;
 }
 
@@ -435,7 +527,7 @@ ProcessingState_t MESS_GetState()
 static void switchState(ProcessingState_t newState)
 {
   // First deactivate and clear all adcs, dacs, and all buffers except for the input buffer when transitioning from listening to processing
-  task_state = CHANGING;
+  setTaskState(CHANGING);
   switch (newState) {
     case DRIVING_TRANSDUCER:
       ADC_StopAll();
@@ -449,10 +541,11 @@ static void switchState(ProcessingState_t newState)
       switchTrTransmit();
       osDelay(10);
       Modulate_StartTransducerOutput(message_length, cfg, &bit_msg);
-      task_state = DRIVING_TRANSDUCER;
+      setTaskState(DRIVING_TRANSDUCER);
       break;
     case LISTENING:
-      cfg = &custom_config;
+      refreshConfigSnapshot();
+      cfg = &custom_config_snapshot;
       CFG_IncrementVersionNumber();
       Waveform_StopWaveformOutput();
       HAL_TIM_Base_Stop(&htim6);
@@ -465,17 +558,25 @@ static void switchState(ProcessingState_t newState)
       osDelay(5);
       ADC_StartInput();
       Sync_Reset();
-      task_state = LISTENING;
+      setTaskState(LISTENING);
       break;
     case PROCESSING:
       Packet_PrepareRx(&input_bit_msg, cfg);
-      task_state = PROCESSING;
+      LinkAdapt_StartPacket();
+      setTaskState(PROCESSING);
       break;
     default:
       break;
   }
 }
 
+static void setTaskState(ProcessingState_t state)
+{
+  task_state = state;
+  CpuLoad_SetMessState(state);
+  Trace_Record(TRACE_EVENT_MESS_STATE, state);
+}
+
 static void switchTrTransmit()
 {
   HAL_GPIO_WritePin(GPIOD, TR_CTRL_Pin, GPIO_PIN_RESET);
@@ -488,7 +589,7 @@ static void switchTrReceive()
 
 static bool handleFlags()
 {
-  uint32_t flags = osEventFlagsWait(print_event_handle, 0x7F, osFlagsWaitAny, 0);
+  uint32_t flags = osEventFlagsWait(print_event_handle, 0x3FF, osFlagsWaitAny, 0);
 
   if (flags == osFlagsErrorResource) {
     return true;
@@ -504,6 +605,11 @@ static bool handleFlags()
     osEventFlagsSet(print_event_handle, MESS_PRINT_COMPLETE);
   }
   else if (flags & MESS_FREQ_RESP) {
+    // Driving the transducer waits for the parameter save to finish
+    if (CFG_IsFlashBusy() == true) {
+      osEventFlagsSet(print_event_handle, MESS_FREQ_RESP);
+      return true;
+    }
     osEventFlagsClear(print_event_handle, MESS_FREQ_RESP);
     Modulate_TestFrequencyResponse();
     in_feedback = true;
@@ -522,6 +628,19 @@ static bool handleFlags()
     Input_NoiseFft();
     osEventFlagsSet(print_event_handle, MESS_PRINT_COMPLETE);
   }
+  else if (flags & MESS_SNR_SWEEP) {
+    osEventFlagsClear(print_event_handle, MESS_SNR_SWEEP);
+    SnrSweep_Start();
+  }
+  else if (flags & MESS_GOLDEN_VECTORS) {
+    osEventFlagsClear(print_event_handle, MESS_GOLDEN_VECTORS);
+    GoldenVectors_Run();
+    osEventFlagsSet(print_event_handle, MESS_PRINT_COMPLETE);
+  }
+  else if (flags & MESS_ARQ_TEST) {
+    osEventFlagsClear(print_event_handle, MESS_ARQ_TEST);
+    Arq_StartLoopbackTest();
+  }
   return true;
 }
 
@@ -548,6 +667,10 @@ static bool registerMessParams()
     return false;
   }
 
+  if (ErrorCorrection_RegisterParams() == false) {
+    return false;
+  }
+
   if (Demodulate_RegisterParams() == false) {
     return false;
   } 
@@ -559,6 +682,17 @@ static bool registerMessParams()
   if (Evaluate_RegisterParams() == false) {
     return false;
   }
+
+  if (Arq_RegisterParams() == false) {
+    return false;
+  }
+
+  if (Fragment_RegisterParams() == false) {
+    return false;
+  }
+  if (LinkAdapt_RegisterParams() == false) {
+    return false;
+  }
   return true;
 }
 
@@ -625,6 +759,22 @@ static bool registerMessMainParams()
     return false;
   }
 
+  min_u32 = MIN_MFSK_BITS_PER_SYMBOL;
+  max_u32 = MAX_MFSK_BITS_PER_SYMBOL;
+  if (Param_Register(PARAM_MFSK_BITS_PER_SYMBOL, "MFSK bits per symbol", PARAM_TYPE_UINT8,
+                     &custom_config.mfsk_bits_per_symbol, sizeof(uint8_t),
+                     &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
+  min_u32 = MIN_OFDM_NUM_SUBCARRIERS;
+  max_u32 = MAX_OFDM_NUM_SUBCARRIERS;
+  if (Param_Register(PARAM_OFDM_NUM_SUBCARRIERS, "OFDM subcarriers", PARAM_TYPE_UINT8,
+                     &custom_config.ofdm_num_subcarriers, sizeof(uint8_t),
+                     &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
   min_u32 = MIN_ERROR_DETECTION;
   max_u32 = MAX_ERROR_DETECTION;
   if (Param_Register(PARAM_PREAMBLE_ERROR_DETECTION, "preamble error detection method", PARAM_TYPE_UINT8,
@@ -662,6 +812,14 @@ static bool registerMessMainParams()
     return false;
   }
 
+  min_u32 = MIN_LINK_ADAPT_STATE;
+  max_u32 = MAX_LINK_ADAPT_STATE;
+  if (Param_Register(PARAM_LINK_ADAPT, "link adaptation", PARAM_TYPE_UINT8,
+                     &custom_config.link_adaptation, sizeof(bool),
+                     &min_u32, &max_u32, NULL) == false) {
+    return false;
+  }
+
   min_u32 = MIN_FHBFSK_HOPPER;
   max_u32 = MAX_FHBFSK_HOPPER;
   if (Param_Register(PARAM_FHBFSK_HOPPER, "hopper method", PARAM_TYPE_UINT8,
@@ -781,11 +939,14 @@ static bool registerMessMainParams()
 
 void getConfig()
 {
+  refreshConfigSnapshot();
+
   if (FeedbackTests_GetConfig(&cfg) == true) return;
+  if (SnrSweep_GetConfig(&cfg) == true) return;
 
   switch (messaging_protocol) {
     case PROTOCOL_CUSTOM:
-      cfg = &custom_config;
+      cfg = &custom_config_snapshot;
       break;
     case PROTOCOL_JANUS:
       cfg = &janus_config;
@@ -795,7 +956,17 @@ void getConfig()
   }
 }
 
+static void refreshConfigSnapshot()
+{
+  if (Param_RefreshSnapshot(&custom_config_snapshot, &custom_config,
+      sizeof(DspConfig_t), &custom_config_version) == true) {
+    // Tables derived from the configuration in sync and input are rebuilt
+    // when the CFG version changes
+    CFG_IncrementVersionNumber();
+  }
+}
+
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
-  (void)(GPIO_Pin);
+  Trace_Record(TRACE_EVENT_GPIO_EXTI, GPIO_Pin);
 }
@@ -14,6 +14,7 @@
 #include "mess_feedback.h"
 #include "mess_dsp_config.h"
 #include "mess_dac_resources.h"
+#include "mess_ofdm.h"
 #include "cfg_parameters.h"
 #include "cfg_defaults.h"
 #include "stm32h7xx_hal.h"
@@ -115,6 +116,8 @@ static const uint16_t num_primes = sizeof(primes) / sizeof(primes[0]);
 
 /* Private function prototypes -----------------------------------------------*/
 
+bool packSymbol(BitMessage_t* bit_msg, uint16_t symbol_index, uint8_t bits_per_symbol, uint8_t* symbol);
+bool dpskPhaseShift(const DspConfig_t* cfg, BitMessage_t* bit_msg, uint16_t data_step, uint32_t* phase_shift);
 uint32_t getFhbfskSequenceNumber(uint32_t normalized_bit_index, const DspConfig_t* cfg);
 uint32_t incrementSequenceNumber(uint32_t normalized_bit_index, uint16_t num_sequences);
 uint32_t galoisSequenceNumber(uint32_t normalized_bit_index, uint16_t num_sequences);
@@ -160,6 +163,11 @@ bool Modulate_StartFeedbackOutput(uint16_t num_steps,
   osDelay(1);
   MessDacResource_RegisterMessageConfiguration(new_cfg, new_bit_msg);
   Waveform_SetWaveformSequence(num_steps, true);
+  // The input ADC keeps receiving the loopback while the feedback ADC
+  // monitors the transmit path
+  if (ADC_StartFeedback() == false) {
+    return false;
+  }
   if (Waveform_StartWaveformOutput(DAC_CHANNEL_FEEDBACK) == false) {
     return false;
   }
@@ -210,8 +218,81 @@ uint32_t Modulate_GetFskFrequency(bool bit, const DspConfig_t* cfg)
   return (bit) ? cfg->fsk_f1 : cfg->fsk_f0;
 }
 
+uint32_t Modulate_GetMfskFrequency(uint8_t symbol, const DspConfig_t* cfg)
+{
+  uint32_t frequency_separation = (uint32_t) (cfg->fhbfsk_freq_spacing * cfg->baud_rate);
+  uint16_t num_tones = 1 << cfg->mfsk_bits_per_symbol;
+
+  uint32_t start_freq = cfg->fc - frequency_separation * (num_tones - 1) / 2;
+  start_freq = (start_freq / frequency_separation) * frequency_separation;
+
+  // Gray coded so that mistaking a tone for its neighbour is a single bit error
+  uint8_t tone_index = symbol ^ (symbol >> 1);
+  return start_freq + frequency_separation * tone_index;
+}
+
+uint8_t Modulate_BitsPerSymbol(const DspConfig_t* cfg)
+{
+  switch (cfg->mod_demod_method) {
+    case MOD_DEMOD_MFSK:
+      return cfg->mfsk_bits_per_symbol;
+    case MOD_DEMOD_DQPSK:
+      return 2;
+    case MOD_DEMOD_OFDM:
+      return Ofdm_BitsPerSymbol(cfg);
+    default:
+      return 1;
+  }
+}
+
+uint16_t Modulate_NumDataSteps(uint16_t num_bits, const DspConfig_t* cfg)
+{
+  uint8_t bits_per_symbol = Modulate_BitsPerSymbol(cfg);
+  uint16_t num_symbols = (num_bits + bits_per_symbol - 1) / bits_per_symbol;
+  if (Modulate_IsDifferential(cfg) == true) {
+    // Phase reference for the first data symbol
+    num_symbols += DPSK_REFERENCE_SYMBOLS;
+  }
+  return num_symbols;
+}
+
+bool Modulate_IsDifferential(const DspConfig_t* cfg)
+{
+  return (cfg->mod_demod_method == MOD_DEMOD_DBPSK) ||
+         (cfg->mod_demod_method == MOD_DEMOD_DQPSK);
+}
+
 bool Modulate_DataStep(const DspConfig_t* cfg, BitMessage_t* bit_msg, WaveformStep_t* waveform_step, uint16_t bit_index, uint16_t symbol_index)
 {
+  if (cfg->mod_demod_method == MOD_DEMOD_MFSK) {
+    uint8_t symbol;
+    if (packSymbol(bit_msg, bit_index, cfg->mfsk_bits_per_symbol, &symbol) == false) {
+      return false;
+    }
+    waveform_step->freq_hz = Modulate_GetMfskFrequency(symbol, cfg);
+    waveform_step->duration_us = (uint32_t) roundf(1000000.0f / cfg->baud_rate);
+    waveform_step->relative_amplitude = Modulate_GetAmplitude(waveform_step->freq_hz);
+    return true;
+  }
+  if (cfg->mod_demod_method == MOD_DEMOD_OFDM) {
+    if (Ofdm_ModulateSymbol(cfg, bit_msg, bit_index, &waveform_step->samples) == false) {
+      return false;
+    }
+    waveform_step->freq_hz = cfg->fc;
+    waveform_step->duration_us = (uint32_t) (((uint64_t) OFDM_SYMBOL_SAMPLES * 1000000) / OFDM_SAMPLE_RATE);
+    waveform_step->relative_amplitude = Modulate_GetAmplitude(waveform_step->freq_hz);
+    return true;
+  }
+  if (Modulate_IsDifferential(cfg) == true) {
+    if (dpskPhaseShift(cfg, bit_msg, bit_index, &waveform_step->phase_shift) == false) {
+      return false;
+    }
+    waveform_step->freq_hz = cfg->fc;
+    waveform_step->duration_us = (uint32_t) roundf(1000000.0f / cfg->baud_rate);
+    waveform_step->relative_amplitude = Modulate_GetAmplitude(waveform_step->freq_hz);
+    return true;
+  }
+
   bool bit;
   if (Packet_GetBit(bit_msg, bit_index, &bit) == false) {
     return false;
@@ -295,6 +376,53 @@ bool Modulate_RegisterParams()
 
 /* Private function definitions ----------------------------------------------*/
 
+// Groups bits MSB first into a symbol. The final symbol is zero padded when
+// the message length is not a multiple of the bits per symbol
+bool packSymbol(BitMessage_t* bit_msg, uint16_t symbol_index, uint8_t bits_per_symbol, uint8_t* symbol)
+{
+  if ((bits_per_symbol == 0) || (bits_per_symbol > MFSK_MAX_BITS_PER_SYMBOL)) {
+    return false;
+  }
+
+  uint16_t start_bit = symbol_index * bits_per_symbol;
+  if (start_bit >= bit_msg->bit_count) {
+    return false;
+  }
+
+  *symbol = 0;
+  for (uint8_t i = 0; i < bits_per_symbol; i++) {
+    bool bit = false;
+    if (start_bit + i < bit_msg->bit_count) {
+      if (Packet_GetBit(bit_msg, start_bit + i, &bit) == false) {
+        return false;
+      }
+    }
+    *symbol = (*symbol << 1) | bit;
+  }
+  return true;
+}
+
+// Phase change relative to the previous symbol. DQPSK is Gray coded with
+// 00 -> 0, 01 -> pi/2, 11 -> pi and 10 -> 3pi/2 so that a quarter turn error
+// is a single bit error. DBPSK uses 0 -> 0 and 1 -> pi
+bool dpskPhaseShift(const DspConfig_t* cfg, BitMessage_t* bit_msg, uint16_t data_step, uint32_t* phase_shift)
+{
+  if (data_step < DPSK_REFERENCE_SYMBOLS) {
+    *phase_shift = 0;
+    return true;
+  }
+
+  uint8_t bits_per_symbol = Modulate_BitsPerSymbol(cfg);
+  uint8_t symbol;
+  if (packSymbol(bit_msg, data_step - DPSK_REFERENCE_SYMBOLS, bits_per_symbol, &symbol) == false) {
+    return false;
+  }
+
+  uint32_t phase_index = symbol ^ (symbol >> 1);
+  *phase_shift = phase_index << (32 - bits_per_symbol);
+  return true;
+}
+
 uint32_t getFhbfskSequenceNumber(uint32_t normalized_bit_index, const DspConfig_t* cfg)
 {
   switch (cfg->fhbfsk_hopper) {
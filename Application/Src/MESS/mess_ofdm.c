@@ -0,0 +1,288 @@
+/*
+ * mess_ofdm.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_ofdm.h"
+#include "mess_adc.h"
+
+#include "uam_math.h"
+#include "arm_math.h"
+
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+
+
+/* Private define ------------------------------------------------------------*/
+
+// FFT window starts this far into the cyclic prefix
+#define OFDM_WINDOW_ADVANCE         (OFDM_CP_SAMPLES / 2)
+
+#define QPSK_AMPLITUDE              (0.70710678f)
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+static arm_rfft_fast_instance_f32 fft_handle;
+
+// Transmit and receive run concurrently for the feedback network so they each
+// get their own buffers
+static float tx_freq_buffer[OFDM_FFT_SIZE];
+static float tx_symbol[OFDM_SYMBOL_SAMPLES];
+
+static float rx_time_buffer[OFDM_FFT_SIZE];
+static float rx_freq_buffer[OFDM_FFT_SIZE];
+
+static float subcarrier_real[OFDM_MAX_SUBCARRIERS];
+static float subcarrier_imag[OFDM_MAX_SUBCARRIERS];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool firstBin(const DspConfig_t* cfg, uint16_t* first_bin);
+static bool isPilot(uint16_t subcarrier, uint8_t num_subcarriers);
+static float pilotValue(uint16_t subcarrier);
+static bool getPaddedBit(BitMessage_t* bit_msg, uint16_t position);
+static void removeTimingSlope(uint8_t num_subcarriers);
+
+/* Exported function definitions ---------------------------------------------*/
+
+bool Ofdm_Init()
+{
+  return arm_rfft_512_fast_init_f32(&fft_handle) == ARM_MATH_SUCCESS;
+}
+
+uint8_t Ofdm_BitsPerSymbol(const DspConfig_t* cfg)
+{
+  uint8_t num_data_subcarriers = 0;
+  for (uint16_t j = 0; j < cfg->ofdm_num_subcarriers; j++) {
+    if (isPilot(j, cfg->ofdm_num_subcarriers) == false) {
+      num_data_subcarriers++;
+    }
+  }
+  return 2 * num_data_subcarriers;
+}
+
+bool Ofdm_GetBand(const DspConfig_t* cfg, uint32_t* lower_freq, uint32_t* upper_freq)
+{
+  uint16_t first_bin;
+  if (firstBin(cfg, &first_bin) == false) {
+    return false;
+  }
+  uint16_t last_bin = first_bin + cfg->ofdm_num_subcarriers - 1;
+
+  *lower_freq = (uint32_t) first_bin * OFDM_SAMPLE_RATE / OFDM_FFT_SIZE;
+  *upper_freq = (uint32_t) last_bin * OFDM_SAMPLE_RATE / OFDM_FFT_SIZE;
+  return true;
+}
+
+bool Ofdm_ModulateSymbol(const DspConfig_t* cfg, BitMessage_t* bit_msg,
+                         uint16_t symbol_index, const float** samples)
+{
+  uint16_t first_bin;
+  if (firstBin(cfg, &first_bin) == false) {
+    return false;
+  }
+
+  uint16_t bit_position = symbol_index * Ofdm_BitsPerSymbol(cfg);
+  if (bit_position >= bit_msg->bit_count) {
+    return false;
+  }
+
+  memset(tx_freq_buffer, 0, sizeof(tx_freq_buffer));
+  for (uint16_t j = 0; j < cfg->ofdm_num_subcarriers; j++) {
+    uint16_t bin = first_bin + j;
+    if (isPilot(j, cfg->ofdm_num_subcarriers) == true) {
+      tx_freq_buffer[2 * bin] = pilotValue(j);
+      continue;
+    }
+    // Gray coded QPSK: the first bit picks the sign of the real part and the
+    // second the sign of the imaginary part
+    bool first_bit = getPaddedBit(bit_msg, bit_position++);
+    bool second_bit = getPaddedBit(bit_msg, bit_position++);
+    tx_freq_buffer[2 * bin] = (first_bit == true) ? -QPSK_AMPLITUDE : QPSK_AMPLITUDE;
+    tx_freq_buffer[2 * bin + 1] = (second_bit == true) ? -QPSK_AMPLITUDE : QPSK_AMPLITUDE;
+  }
+
+  arm_rfft_fast_f32(&fft_handle, tx_freq_buffer, &tx_symbol[OFDM_CP_SAMPLES], 1);
+
+  // Cyclic prefix is a copy of the end of the symbol
+  memcpy(tx_symbol, &tx_symbol[OFDM_FFT_SIZE],
+         OFDM_CP_SAMPLES * sizeof(float));
+
+  float peak = 0.0f;
+  for (uint16_t i = OFDM_CP_SAMPLES; i < OFDM_SYMBOL_SAMPLES; i++) {
+    float magnitude = fabsf(tx_symbol[i]);
+    if (magnitude > peak) {
+      peak = magnitude;
+    }
+  }
+  if (peak <= 0.0f) {
+    return false;
+  }
+  // Pilots absorb the per symbol gain so normalizing each symbol is harmless
+  arm_scale_f32(tx_symbol, 1.0f / peak, tx_symbol, OFDM_SYMBOL_SAMPLES);
+
+  *samples = tx_symbol;
+  return true;
+}
+
+bool Ofdm_DemodulateSymbol(DemodulationInfo_t* data, const DspConfig_t* cfg)
+{
+  uint16_t first_bin;
+  if (firstBin(cfg, &first_bin) == false) {
+    return false;
+  }
+  uint8_t num_subcarriers = cfg->ofdm_num_subcarriers;
+
+  // Early window rotated back by the advance. The wrapped samples come from
+  // the cyclic prefix so this matches the nominal window
+  uint16_t mask = data->buf_len - 1;
+  uint16_t window_start = data->data_start_index + OFDM_CP_SAMPLES - OFDM_WINDOW_ADVANCE;
+  for (uint16_t n = 0; n < OFDM_FFT_SIZE; n++) {
+    uint16_t offset = (n + OFDM_WINDOW_ADVANCE) & (OFDM_FFT_SIZE - 1);
+    rx_time_buffer[n] = ADC_InputGetDataAbsolute((window_start + offset) & mask);
+  }
+
+  arm_rfft_fast_f32(&fft_handle, rx_time_buffer, rx_freq_buffer, 0);
+
+  for (uint16_t j = 0; j < num_subcarriers; j++) {
+    uint16_t bin = first_bin + j;
+    subcarrier_real[j] = rx_freq_buffer[2 * bin];
+    subcarrier_imag[j] = rx_freq_buffer[2 * bin + 1];
+  }
+
+  removeTimingSlope(num_subcarriers);
+
+  // Pilots are +-1 so the channel estimate is the pilot itself with the sign
+  // removed
+  uint16_t bit_position = 0;
+  memset(data->symbol_bits, 0, sizeof(data->symbol_bits));
+  for (uint16_t j = 0; j < num_subcarriers; j++) {
+    if (isPilot(j, num_subcarriers) == true) {
+      continue;
+    }
+    uint16_t pilot0 = (j / OFDM_PILOT_SPACING) * OFDM_PILOT_SPACING;
+    uint16_t pilot1 = pilot0 + OFDM_PILOT_SPACING;
+    if (pilot1 > num_subcarriers - 1) {
+      pilot1 = num_subcarriers - 1;
+    }
+
+    float h0_real = subcarrier_real[pilot0] * pilotValue(pilot0);
+    float h0_imag = subcarrier_imag[pilot0] * pilotValue(pilot0);
+    float h1_real = subcarrier_real[pilot1] * pilotValue(pilot1);
+    float h1_imag = subcarrier_imag[pilot1] * pilotValue(pilot1);
+
+    float t = (float) (j - pilot0) / (float) (pilot1 - pilot0);
+    float h_real = h0_real + t * (h1_real - h0_real);
+    float h_imag = h0_imag + t * (h1_imag - h0_imag);
+
+    // Y * conj(H). Dividing by |H|^2 does not change the quadrant
+    float z_real = subcarrier_real[j] * h_real + subcarrier_imag[j] * h_imag;
+    float z_imag = subcarrier_imag[j] * h_real - subcarrier_real[j] * h_imag;
+
+    if (z_real < 0.0f) {
+      data->symbol_bits[bit_position / 8] |= 1 << (7 - bit_position % 8);
+    }
+    bit_position++;
+    if (z_imag < 0.0f) {
+      data->symbol_bits[bit_position / 8] |= 1 << (7 - bit_position % 8);
+    }
+    bit_position++;
+  }
+
+  data->analysis_done = true;
+  data->num_bits = bit_position;
+  data->decoded_bit = (data->symbol_bits[0] & 0x80) != 0;
+  return true;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+// Subcarriers are centered on fc
+bool firstBin(const DspConfig_t* cfg, uint16_t* first_bin)
+{
+  if ((cfg->ofdm_num_subcarriers < 2) ||
+      (cfg->ofdm_num_subcarriers > OFDM_MAX_SUBCARRIERS)) {
+    return false;
+  }
+
+  int32_t center_bin = (int32_t) ((cfg->fc * OFDM_FFT_SIZE + OFDM_SAMPLE_RATE / 2) / OFDM_SAMPLE_RATE);
+  int32_t bin = center_bin - cfg->ofdm_num_subcarriers / 2;
+
+  // Keep clear of DC and Nyquist
+  if (bin < 1 || bin + cfg->ofdm_num_subcarriers > OFDM_FFT_SIZE / 2) {
+    return false;
+  }
+  *first_bin = (uint16_t) bin;
+  return true;
+}
+
+bool isPilot(uint16_t subcarrier, uint8_t num_subcarriers)
+{
+  return (subcarrier % OFDM_PILOT_SPACING == 0) || (subcarrier == num_subcarriers - 1);
+}
+
+// Alternating pilot signs avoid a large peak at the start of every symbol
+float pilotValue(uint16_t subcarrier)
+{
+  return ((subcarrier / OFDM_PILOT_SPACING) & 1) ? -1.0f : 1.0f;
+}
+
+// Bits past the end of the message pad the final symbol with zeros
+bool getPaddedBit(BitMessage_t* bit_msg, uint16_t position)
+{
+  bool bit = false;
+  if (position < bit_msg->bit_count) {
+    Packet_GetBit(bit_msg, position, &bit);
+  }
+  return bit;
+}
+
+// A timing offset shows up as a phase that grows linearly across the
+// subcarriers. The average rotation between equally spaced pilots gives the
+// slope which is removed before interpolating the channel
+void removeTimingSlope(uint8_t num_subcarriers)
+{
+  float sum_real = 0.0f;
+  float sum_imag = 0.0f;
+  for (uint16_t j = 0; j + OFDM_PILOT_SPACING < num_subcarriers; j += OFDM_PILOT_SPACING) {
+    uint16_t k = j + OFDM_PILOT_SPACING;
+    float sign = pilotValue(j) * pilotValue(k);
+    // H[k] * conj(H[j])
+    sum_real += sign * (subcarrier_real[k] * subcarrier_real[j] + subcarrier_imag[k] * subcarrier_imag[j]);
+    sum_imag += sign * (subcarrier_imag[k] * subcarrier_real[j] - subcarrier_real[k] * subcarrier_imag[j]);
+  }
+  if (sum_real == 0.0f && sum_imag == 0.0f) {
+    return;
+  }
+
+  // Per subcarrier slope pre-scaled by pi, always within +-1/OFDM_PILOT_SPACING
+  float slope = atan2f(sum_imag, sum_real) / (M_PI * OFDM_PILOT_SPACING);
+  float step_real = uam_cosf(slope);
+  float step_imag = -uam_sinf(slope);
+
+  float rotation_real = 1.0f;
+  float rotation_imag = 0.0f;
+  for (uint16_t j = 0; j < num_subcarriers; j++) {
+    float real = subcarrier_real[j] * rotation_real - subcarrier_imag[j] * rotation_imag;
+    float imag = subcarrier_real[j] * rotation_imag + subcarrier_imag[j] * rotation_real;
+    subcarrier_real[j] = real;
+    subcarrier_imag[j] = imag;
+
+    float next_real = rotation_real * step_real - rotation_imag * step_imag;
+    float next_imag = rotation_real * step_imag + rotation_imag * step_real;
+    rotation_real = next_real;
+    rotation_imag = next_imag;
+  }
+}
@@ -16,13 +16,20 @@
 #include "cfg_parameters.h"
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
 
 /* Private typedef -----------------------------------------------------------*/
 
+typedef struct {
+  uint16_t start_index;
+  uint16_t length;
+  uint16_t depth;
+} ConfidenceMap_t;
 
 
 /* Private define ------------------------------------------------------------*/
 
+#define MAX_CONFIDENCE_MAPS     2 // Preamble and cargo
 
 
 /* Private macro -------------------------------------------------------------*/
@@ -31,6 +38,12 @@
 
 /* Private variables ---------------------------------------------------------*/
 
+// 4 bits per received bit in received order. Too large to keep in every
+// BitMessage_t so only the message being received has them
+static const BitMessage_t* confidence_msg = NULL;
+static uint8_t confidence[(PACKET_MAX_LENGTH_BYTES * 8 + 1) / 2];
+static ConfidenceMap_t confidence_maps[MAX_CONFIDENCE_MAPS];
+static uint8_t num_confidence_maps = 0;
 
 
 /* Private function prototypes -----------------------------------------------*/
@@ -70,6 +83,10 @@ bool Packet_PrepareRx(BitMessage_t* bit_msg, const DspConfig_t* cfg)
     return false;
   }
 
+  confidence_msg = bit_msg;
+  memset(confidence, 0, sizeof(confidence));
+  num_confidence_maps = 0;
+
   return true;
 }
 
@@ -297,6 +314,56 @@ bool Packet_Copy(const BitMessage_t* src_msg, BitMessage_t* dest_msg, const uint
   return true;
 }
 
+void Packet_SetConfidence(const BitMessage_t* bit_msg, uint16_t position, float soft_bit)
+{
+  if (bit_msg != confidence_msg || position >= PACKET_MAX_LENGTH_BYTES * 8) {
+    return;
+  }
+
+  // Level 0 is reserved for bits without a soft decision
+  uint8_t level = (uint8_t) ceilf(fabsf(soft_bit) * PACKET_MAX_CONFIDENCE);
+  if (level < 1) {
+    level = 1;
+  }
+  else if (level > PACKET_MAX_CONFIDENCE) {
+    level = PACKET_MAX_CONFIDENCE;
+  }
+
+  uint8_t shift = (position & 1) * 4;
+  confidence[position / 2] = (confidence[position / 2] & ~(0x0F << shift)) | (level << shift);
+}
+
+uint8_t Packet_GetConfidence(const BitMessage_t* bit_msg, uint16_t position)
+{
+  if (bit_msg != confidence_msg || position >= PACKET_MAX_LENGTH_BYTES * 8) {
+    return 0;
+  }
+
+  // Same mapping as the deinterleaver uses for the bits
+  for (uint8_t i = 0; i < num_confidence_maps; i++) {
+    const ConfidenceMap_t* map = &confidence_maps[i];
+    if (position >= map->start_index && position - map->start_index < map->length) {
+      uint32_t offset = position - map->start_index;
+      position = (uint16_t) ((offset * map->depth) % map->length + map->start_index);
+      break;
+    }
+  }
+
+  return (confidence[position / 2] >> ((position & 1) * 4)) & 0x0F;
+}
+
+void Packet_DeinterleaveConfidence(const BitMessage_t* bit_msg, uint16_t start_index,
+                                   uint16_t length, uint16_t depth)
+{
+  if (bit_msg != confidence_msg || num_confidence_maps >= MAX_CONFIDENCE_MAPS) {
+    return;
+  }
+  confidence_maps[num_confidence_maps].start_index = start_index;
+  confidence_maps[num_confidence_maps].length = length;
+  confidence_maps[num_confidence_maps].depth = depth;
+  num_confidence_maps++;
+}
+
 bool Packet_RegisterParams()
 {
   return true;
@@ -13,6 +13,7 @@
 #include "mess_error_detection.h"
 #include "mess_error_correction.h"
 #include "mess_cargo.h"
+#include "mess_link_adapt.h"
 #include "cfg_parameters.h"
 #include <stdbool.h>
 #include <string.h>
@@ -72,6 +73,16 @@ static const PreambleFieldConfig_t custom_fields[] = {
   FIELDS_END
 };
 
+// Custom preamble with the cargo rate profile chosen by the link adaptation
+static const PreambleFieldConfig_t custom_adaptive_fields[] = {
+  FIELD_ENTRY(0, 4, modem_id),
+  FIELD_ENTRY(4, 4, message_type),
+  FIELD_ENTRY(8, 7, cargo_length),
+  FIELD_ENTRY(15, 1, is_mobile),
+  FIELD_ENTRY(16, 3, rate_profile),
+  FIELDS_END
+};
+
 // JANUS preambles
 
 static const PreambleFieldConfig_t janus_011_01_sms_fields[] = {
@@ -148,6 +159,9 @@ bool Preamble_UpdateNumBits(BitMessage_t* bit_msg, const DspConfig_t* cfg)
 {
   bit_msg->preamble.raw_len = (cfg->protocol == PROTOCOL_CUSTOM) ? 
                               PACKET_PREAMBLE_LENGTH_BITS : JANUS_PREAMBLE_LEN;
+  if (cfg->protocol == PROTOCOL_CUSTOM && cfg->link_adaptation == true) {
+    bit_msg->preamble.raw_len += PACKET_RATE_PROFILE_BITS;
+  }
 
   uint16_t detection_bits;
   if (ErrorDetection_CheckLength(&detection_bits, cfg->preamble_validation) == false) {
@@ -374,7 +388,7 @@ bool getFields(const PreambleFieldConfig_t** fields, const Message_t* msg, const
 {
   switch (cfg->protocol) {
     case PROTOCOL_CUSTOM:
-      *fields = custom_fields;
+      *fields = (cfg->link_adaptation == true) ? custom_adaptive_fields : custom_fields;
       return true;
     case PROTOCOL_JANUS:
       return janusFields(fields, msg->janus_data_type);
@@ -509,6 +523,9 @@ bool addCustomPreamble(BitMessage_t* bit_msg, Message_t* msg, const DspConfig_t*
     case FLOAT:
     case BITS:
     case UNKNOWN:
+    case ARQ_DATA:
+    case ARQ_ACK:
+    case FRAGMENT:
       if (calculateJanusCargoBits(msg, bit_msg, msg->length_bits + detection_bits) == false) {
         return false;
       }
@@ -613,6 +630,8 @@ bool decodeCustomPreamble(BitMessage_t* bit_msg, Message_t* msg, const DspConfig
   if (extractPreambleFields(fields, bit_msg, msg) == false) {
     return false;
   }
+  // The cargo length depends on the rate profile the sender picked
+  cfg = LinkAdapt_CargoConfig(cfg, &msg->preamble);
   if (msg->preamble.message_type.valid == false) {
     return false;
   }
@@ -624,6 +643,9 @@ bool decodeCustomPreamble(BitMessage_t* bit_msg, Message_t* msg, const DspConfig
     case BITS:
     case UNKNOWN:
     case EVAL:
+    case ARQ_DATA:
+    case ARQ_ACK:
+    case FRAGMENT:
       if (decodeJanusCargoBits(msg, bit_msg, cfg) == false) {
         return false;
       }
@@ -0,0 +1,191 @@
+/*
+ * mess_replay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_replay.h"
+#include "mess_adc.h"
+
+#include "usb_comm.h"
+
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+
+
+/* Private define ------------------------------------------------------------*/
+
+#define REPLAY_FIFO_SIZE          (1 << 14) // bytes, 68 ms of samples
+#define REPLAY_FIFO_MASK          (REPLAY_FIFO_SIZE - 1)
+
+// Host is considered gone if no data arrives for this long
+#define REPLAY_TIMEOUT_MS         2000
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint8_t replay_fifo[REPLAY_FIFO_SIZE];
+
+// Written by the USB interrupt
+static volatile uint32_t fifo_head = 0;
+static volatile uint32_t bytes_received = 0;
+static volatile uint32_t last_data_timestamp = 0;
+
+// Written by the ADC interrupt
+static volatile uint32_t fifo_tail = 0;
+static volatile bool streaming = false;
+
+static volatile bool replay_active = false;
+static ReplayStats_t stats;
+
+/* Private function prototypes -----------------------------------------------*/
+
+
+
+/* Exported function definitions ---------------------------------------------*/
+
+void Replay_Start(uint32_t num_samples)
+{
+  replay_active = false;
+
+  fifo_head = 0;
+  fifo_tail = 0;
+  bytes_received = 0;
+  streaming = false;
+  last_data_timestamp = osKernelGetTickCount();
+
+  memset(&stats, 0, sizeof(stats));
+  stats.samples_requested = num_samples;
+
+  replay_active = true;
+}
+
+void Replay_Stop(bool timed_out)
+{
+  replay_active = false;
+  streaming = false;
+  stats.timed_out = timed_out;
+
+  // Reception may have been paused waiting for the buffer to drain
+  USB_ResumeRx();
+}
+
+bool Replay_IsActive()
+{
+  return replay_active;
+}
+
+bool Replay_Service()
+{
+  if (replay_active == false) {
+    USB_ResumeRx();
+    return false;
+  }
+
+  if ((osKernelGetTickCount() - last_data_timestamp) > REPLAY_TIMEOUT_MS &&
+      fifo_head == fifo_tail) {
+    Replay_Stop(true);
+    return false;
+  }
+
+  USB_ResumeRx();
+  return true;
+}
+
+void Replay_AddData(const uint8_t* data, uint32_t len)
+{
+  if (replay_active == false) {
+    return;
+  }
+
+  // Discard anything past the end of the capture
+  uint32_t bytes_expected = stats.samples_requested * sizeof(uint16_t);
+  if (bytes_received + len > bytes_expected) {
+    len = bytes_expected - bytes_received;
+  }
+  // USB reception is paused before the buffer can overflow
+  if (len > Replay_FreeSpace()) {
+    len = Replay_FreeSpace();
+  }
+
+  uint32_t head = fifo_head;
+  for (uint32_t i = 0; i < len; i++) {
+    replay_fifo[head & REPLAY_FIFO_MASK] = data[i];
+    head++;
+  }
+  fifo_head = head;
+  bytes_received += len;
+  last_data_timestamp = osKernelGetTickCount();
+}
+
+uint32_t Replay_FreeSpace()
+{
+  return REPLAY_FIFO_SIZE - (fifo_head - fifo_tail);
+}
+
+bool Replay_GetBlock(uint16_t* block, uint16_t num_samples, uint16_t unprocessed_samples)
+{
+  if (replay_active == false) {
+    return false;
+  }
+
+  uint32_t available_bytes = fifo_head - fifo_tail;
+  uint32_t remaining_samples = stats.samples_requested - stats.samples_replayed;
+  uint32_t block_samples = (num_samples < remaining_samples) ? num_samples : remaining_samples;
+
+  if (available_bytes < block_samples * sizeof(uint16_t)) {
+    // Live ADC samples are used until the host starts streaming
+    if (streaming == true) {
+      stats.underruns++;
+    }
+    return false;
+  }
+  streaming = true;
+
+  // Margin is measured against the ring deadline the real ADC would have
+  if (unprocessed_samples > stats.max_unprocessed) {
+    stats.max_unprocessed = unprocessed_samples;
+  }
+  if (unprocessed_samples + num_samples > PROCESSING_BUFFER_SIZE) {
+    stats.overruns++;
+  }
+
+  uint32_t tail = fifo_tail;
+  for (uint16_t i = 0; i < block_samples; i++) {
+    uint16_t low = replay_fifo[tail & REPLAY_FIFO_MASK];
+    uint16_t high = replay_fifo[(tail + 1) & REPLAY_FIFO_MASK];
+    block[i] = low | (high << 8);
+    tail += sizeof(uint16_t);
+  }
+  fifo_tail = tail;
+
+  // Pad the final partial block with the last sample
+  for (uint16_t i = block_samples; i < num_samples; i++) {
+    block[i] = (block_samples > 0) ? block[block_samples - 1] : 0;
+  }
+
+  stats.samples_replayed += block_samples;
+  if (stats.samples_replayed >= stats.samples_requested) {
+    replay_active = false;
+    streaming = false;
+  }
+  return true;
+}
+
+void Replay_GetStats(ReplayStats_t* replay_stats)
+{
+  *replay_stats = stats;
+}
+
+/* Private function definitions ----------------------------------------------*/
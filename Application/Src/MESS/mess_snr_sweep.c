@@ -0,0 +1,452 @@
+/*
+ * mess_snr_sweep.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "mess_snr_sweep.h"
+#include "mess_dsp_config.h"
+#include "mess_packet.h"
+#include "mess_main.h"
+#include "mess_adc.h"
+
+#include "comm_main.h"
+
+#include "cfg_main.h"
+#include "cfg_parameters.h"
+
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+  uint16_t packets;
+  uint16_t packet_errors;
+  uint16_t lost_packets;
+  uint32_t info_bits;
+  uint32_t info_bit_errors;
+  uint32_t channel_bits;
+  uint32_t channel_bit_errors;
+} SweepPoint_t;
+
+typedef struct {
+  DspConfig_t cfg;
+  // Filled in by the clean calibration packet
+  float reference_power;
+  uint16_t info_bits_per_packet;
+  uint16_t channel_bits_per_packet;
+  uint16_t packet_length_bits;
+} SweepConfig_t;
+
+typedef enum {
+  SENT_MESSAGE,
+  DECODED_MESSAGE
+} LastAction_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Stopping rule for a single SNR point
+#define SWEEP_TARGET_BIT_ERRORS   100
+#define SWEEP_MIN_PACKETS         10
+#define SWEEP_MAX_PACKETS         200
+
+// Time allowed for a packet to be decoded before it is counted as lost
+#define SWEEP_CALIBRATION_TIMEOUT_MS  30000
+#define SWEEP_TIMEOUT_MARGIN_MS       1000
+
+#define SWEEP_NOISE_SEED          0x2545F491u
+
+/* Private macro -------------------------------------------------------------*/
+
+#define SWEEP_CFG(mod, baud, ecc, interleave, hopper) \
+  { \
+    .cfg = { \
+      .baud_rate = (baud), \
+      .mod_demod_method = (mod), \
+      .fsk_f0 = 30000, \
+      .fsk_f1 = 33000, \
+      .fc = 31000, \
+      .fhbfsk_freq_spacing = 1, \
+      .fhbfsk_num_tones = 10, \
+      .fhbfsk_dwell_time = 1, \
+      .preamble_validation = CRC_8, \
+      .cargo_validation = CRC_16, \
+      .preamble_ecc_method = (ecc), \
+      .cargo_ecc_method = (ecc), \
+      .use_interleaver = (interleave), \
+      .fhbfsk_hopper = (hopper), \
+      .sync_method = NO_SYNC, \
+      .wakeup_tones = false, \
+      .wakeup_tone1 = 27000, \
+      .wakeup_tone2 = 30000, \
+      .wakeup_tone3 = 33000, \
+      .protocol = PROTOCOL_CUSTOM \
+    } \
+  }
+
+/* Private variables ---------------------------------------------------------*/
+
+static SweepConfig_t sweep_configs[] = {
+  SWEEP_CFG(MOD_DEMOD_FSK,    100.0f, NO_ECC,              false, HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FSK,    100.0f, HAMMING_CODE,        false, HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FSK,    100.0f, JANUS_CONVOLUTIONAL, false, HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FSK,    100.0f, JANUS_CONVOLUTIONAL, true,  HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FHBFSK, 100.0f, NO_ECC,              false, HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FHBFSK, 100.0f, JANUS_CONVOLUTIONAL, true,  HOPPER_GALOIS),
+  SWEEP_CFG(MOD_DEMOD_FSK,    500.0f, JANUS_CONVOLUTIONAL, true,  HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FHBFSK, 500.0f, JANUS_CONVOLUTIONAL, true,  HOPPER_GALOIS),
+  SWEEP_CFG(MOD_DEMOD_FSK,    100.0f, REED_SOLOMON,        false, HOPPER_INCREMENT),
+  SWEEP_CFG(MOD_DEMOD_FSK,    100.0f, QC_LDPC,             false, HOPPER_INCREMENT)
+};
+
+static const uint16_t num_configs = sizeof(sweep_configs) / sizeof(sweep_configs[0]);
+
+// Ec/N0 per channel bit in dB
+static const float snr_points_db[] = {
+  0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f, 14.0f
+};
+
+static const uint16_t num_snr_points = sizeof(snr_points_db) / sizeof(snr_points_db[0]);
+
+static Message_t sweep_msg = {
+  .type = MSG_TRANSMIT_FEEDBACK,
+  .data_type = EVAL,
+  .preamble = {
+    .is_mobile = {
+      0, true
+    },
+    .message_type = {
+      EVAL, true
+    },
+    .modem_id = {
+      0, true
+    }
+  }
+};
+
+static SweepPoint_t current_point;
+
+static bool performing_sweep = false;
+static bool calibrating = false;
+static uint16_t current_config = 0;
+static uint16_t current_snr = 0;
+static int16_t last_returned_config = -1;
+static LastAction_t last_action = DECODED_MESSAGE;
+static uint32_t sent_timestamp = 0;
+
+// Shared with the ADC DMA callbacks
+static volatile float noise_sigma = 0.0f;
+static volatile float peak_block_power = 0.0f;
+static uint32_t noise_state = SWEEP_NOISE_SEED;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void resetPoint(void);
+static void advanceSweep(bool skip_config);
+static void recordLostPacket(void);
+static void finishPoint(void);
+static uint32_t packetTimeout(void);
+static float gaussianSample(void);
+static void printConfigTable(void);
+
+/* Exported function definitions ---------------------------------------------*/
+
+void SnrSweep_Start()
+{
+  current_config = 0;
+  current_snr = 0;
+  calibrating = true;
+  last_returned_config = -1;
+  last_action = DECODED_MESSAGE;
+  noise_sigma = 0.0f;
+  noise_state = SWEEP_NOISE_SEED;
+  resetPoint();
+
+  for (uint16_t i = 0; i < num_configs; i++) {
+    sweep_configs[i].reference_power = 0.0f;
+    sweep_configs[i].info_bits_per_packet = 0;
+    sweep_configs[i].channel_bits_per_packet = 0;
+    sweep_configs[i].packet_length_bits = 0;
+  }
+
+  printConfigTable();
+
+  performing_sweep = true;
+}
+
+void SnrSweep_GetNext()
+{
+  if (performing_sweep == false) {
+    return;
+  }
+
+  if (last_action == SENT_MESSAGE) {
+    if ((osKernelGetTickCount() - sent_timestamp) < packetTimeout()) {
+      return;
+    }
+    // Never decoded, most likely a missed detection
+    if (calibrating == true) {
+      char output_buffer[64];
+      snprintf(output_buffer, 64, "SWEEP_ERR,%u,calibration timeout\r\n",
+          current_config);
+      COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+      advanceSweep(true);
+    }
+    else {
+      recordLostPacket();
+    }
+    last_action = DECODED_MESSAGE;
+    if (performing_sweep == false) {
+      return;
+    }
+  }
+
+  if (calibrating == true) {
+    noise_sigma = 0.0f;
+  }
+  else {
+    SweepConfig_t* sweep_cfg = &sweep_configs[current_config];
+    float snr_linear = powf(10.0f, snr_points_db[current_snr] / 10.0f);
+    // Noise is white over the full ADC bandwidth so scale the variance by the
+    // number of samples per channel bit (fs / (2 * baud) for real sampling)
+    float variance = sweep_cfg->reference_power * ADC_SAMPLING_RATE /
+        (2.0f * sweep_cfg->cfg.baud_rate * snr_linear);
+    noise_sigma = sqrtf(variance);
+  }
+  peak_block_power = 0.0f;
+
+  sweep_msg.timestamp = osKernelGetTickCount();
+  if (Param_GetUint8(PARAM_ID, (uint8_t*) &sweep_msg.preamble.modem_id.value) == false) {
+    return;
+  }
+  if (Param_GetUint16(PARAM_EVAL_MESSAGE_LEN, &sweep_msg.length_bits) == false) {
+    return;
+  }
+  sweep_msg.length_bits *= 8;
+
+  if (MESS_AddMessageToTxQ(&sweep_msg) != pdPASS) {
+    return;
+  }
+  sent_timestamp = osKernelGetTickCount();
+  last_action = SENT_MESSAGE;
+}
+
+bool SnrSweep_GetConfig(DspConfig_t** cfg)
+{
+  if (performing_sweep == false) {
+    return false;
+  }
+
+  // Only force the DSP modules to reload when the configuration changes
+  if (last_returned_config != (int16_t) current_config) {
+    last_returned_config = (int16_t) current_config;
+    CFG_IncrementVersionNumber();
+  }
+  *cfg = &sweep_configs[current_config].cfg;
+  return true;
+}
+
+bool SnrSweep_Check(Message_t* received_msg, BitMessage_t* received_bit_msg)
+{
+  if (performing_sweep == false) {
+    return false;
+  }
+
+  // A timed out packet may still arrive late. It has already been accounted for
+  if (last_action != SENT_MESSAGE) {
+    return true;
+  }
+  last_action = DECODED_MESSAGE;
+
+  bool valid_header = received_msg->preamble.message_type.valid == true &&
+      received_msg->preamble.message_type.value == EVAL;
+
+  SweepConfig_t* sweep_cfg = &sweep_configs[current_config];
+
+  if (calibrating == true) {
+    if (valid_header == false || received_msg->error_detected == true) {
+      // Retry calibration with the next packet
+      return true;
+    }
+    sweep_cfg->reference_power = peak_block_power;
+    sweep_cfg->info_bits_per_packet = received_msg->eval_info.coded_bits;
+    sweep_cfg->channel_bits_per_packet = received_msg->eval_info.uncoded_bits;
+    sweep_cfg->packet_length_bits = received_bit_msg->final_length;
+    calibrating = false;
+    return true;
+  }
+
+  if (valid_header == false) {
+    recordLostPacket();
+    return true;
+  }
+
+  EvalMessageInfo_t* eval_info = &received_msg->eval_info;
+  current_point.packets++;
+  current_point.info_bits += eval_info->coded_bits;
+  current_point.info_bit_errors += eval_info->coded_errors;
+  current_point.channel_bits += eval_info->uncoded_bits;
+  current_point.channel_bit_errors += eval_info->uncoded_errors;
+  if (eval_info->coded_errors != 0 || received_msg->error_detected == true) {
+    current_point.packet_errors++;
+  }
+
+  finishPoint();
+  return true;
+}
+
+void SnrSweep_AddNoise(float* buffer, uint16_t start_index, uint16_t num_samples, uint16_t mask)
+{
+  if (performing_sweep == false || num_samples == 0) {
+    return;
+  }
+
+  float sigma = noise_sigma;
+  float power = 0.0f;
+
+  for (uint16_t i = 0; i < num_samples; i++) {
+    uint16_t index = (start_index + i) & mask;
+    float sample = buffer[index];
+    power += sample * sample;
+    if (sigma > 0.0f) {
+      buffer[index] = sample + sigma * gaussianSample();
+    }
+  }
+
+  // Peak block power of the clean signal approximates the received signal
+  // power since the packet occupies the entire block
+  power /= (float) num_samples;
+  if (power > peak_block_power) {
+    peak_block_power = power;
+  }
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+void resetPoint()
+{
+  current_point.packets = 0;
+  current_point.packet_errors = 0;
+  current_point.lost_packets = 0;
+  current_point.info_bits = 0;
+  current_point.info_bit_errors = 0;
+  current_point.channel_bits = 0;
+  current_point.channel_bit_errors = 0;
+}
+
+void advanceSweep(bool skip_config)
+{
+  resetPoint();
+  current_snr++;
+  if (skip_config == true || current_snr >= num_snr_points) {
+    current_snr = 0;
+    current_config++;
+    calibrating = true;
+  }
+
+  if (current_config >= num_configs) {
+    performing_sweep = false;
+    noise_sigma = 0.0f;
+    COMM_TransmitData("SWEEP_END\r\n", CALC_LEN, COMM_USB);
+  }
+}
+
+void recordLostPacket()
+{
+  SweepConfig_t* sweep_cfg = &sweep_configs[current_config];
+
+  // A lost packet carries no information so half of its bits are in error
+  current_point.packets++;
+  current_point.packet_errors++;
+  current_point.lost_packets++;
+  current_point.info_bits += sweep_cfg->info_bits_per_packet;
+  current_point.info_bit_errors += sweep_cfg->info_bits_per_packet / 2;
+  current_point.channel_bits += sweep_cfg->channel_bits_per_packet;
+  current_point.channel_bit_errors += sweep_cfg->channel_bits_per_packet / 2;
+
+  finishPoint();
+}
+
+void finishPoint()
+{
+  if (current_point.packets < SWEEP_MIN_PACKETS) {
+    return;
+  }
+  if (current_point.info_bit_errors < SWEEP_TARGET_BIT_ERRORS &&
+      current_point.packets < SWEEP_MAX_PACKETS) {
+    return;
+  }
+
+  SweepConfig_t* sweep_cfg = &sweep_configs[current_config];
+
+  // Information throughput ignoring the fixed wakeup/synchronization overhead
+  float goodput = 0.0f;
+  if (sweep_cfg->packet_length_bits != 0) {
+    float per = (float) current_point.packet_errors /
+        (float) current_point.packets;
+    goodput = (1.0f - per) * sweep_cfg->info_bits_per_packet *
+        sweep_cfg->cfg.baud_rate / sweep_cfg->packet_length_bits;
+  }
+
+  char output_buffer[160];
+  snprintf(output_buffer, 160, "SWEEP,%u,%.1f,%u,%u,%u,%lu,%lu,%lu,%lu,%.2f\r\n",
+      current_config, snr_points_db[current_snr], current_point.packets,
+      current_point.packet_errors, current_point.lost_packets,
+      current_point.info_bits, current_point.info_bit_errors,
+      current_point.channel_bits, current_point.channel_bit_errors, goodput);
+  COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+
+  // Higher SNR points will also be error free so there is no point waiting
+  advanceSweep(current_point.packet_errors == 0);
+}
+
+uint32_t packetTimeout()
+{
+  SweepConfig_t* sweep_cfg = &sweep_configs[current_config];
+  if (calibrating == true || sweep_cfg->packet_length_bits == 0) {
+    return SWEEP_CALIBRATION_TIMEOUT_MS;
+  }
+  uint32_t airtime_ms = (uint32_t) (1000.0f * sweep_cfg->packet_length_bits /
+      sweep_cfg->cfg.baud_rate);
+  return 2 * airtime_ms + SWEEP_TIMEOUT_MARGIN_MS;
+}
+
+// Sum of 4 uniform samples (xorshift32) scaled to unit variance
+float gaussianSample()
+{
+  float sum = 0.0f;
+  for (uint8_t i = 0; i < 4; i++) {
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    sum += (float) ((int32_t) noise_state) * 2.3283064e-10f;
+  }
+  return sum * 1.7320508f;
+}
+
+void printConfigTable()
+{
+  char output_buffer[128];
+
+  COMM_TransmitData("\r\nSWEEP_CFG,index,modulation,baud,ecc,interleaver,"
+      "hopper\r\n", CALC_LEN, COMM_USB);
+
+  for (uint16_t i = 0; i < num_configs; i++) {
+    DspConfig_t* cfg = &sweep_configs[i].cfg;
+    snprintf(output_buffer, 128, "SWEEP_CFG,%u,%u,%.0f,%u,%u,%u\r\n", i,
+        cfg->mod_demod_method, cfg->baud_rate, cfg->cargo_ecc_method,
+        cfg->use_interleaver, cfg->fhbfsk_hopper);
+    COMM_TransmitData(output_buffer, CALC_LEN, COMM_USB);
+  }
+
+  COMM_TransmitData("SWEEP,config,snr_db,packets,packet_errors,lost,"
+      "info_bits,info_bit_errors,channel_bits,channel_bit_errors,goodput\r\n",
+      CALC_LEN, COMM_USB);
+}
@@ -88,6 +88,8 @@ static uint8_t stage2_frequency_index = 0;
 static Stage2Results_t stage2_results[SYNC_STAGE_234_SUBDIVIDE];
 
 static volatile bool sync_error = false;
+// Synchronization SNR of the last message. 0 if it was not measured
+static float last_sync_snr = 0.0f;
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -113,11 +115,18 @@ bool Sync_GetStep(const DspConfig_t* cfg, WaveformStep_t* waveform_step, uint16_
   switch (cfg->sync_method) {
     case NO_SYNC:
       return false;
-    case SYNC_PN_32_JANUS:
-      waveform_step->freq_hz = janus_frequencies[step];
+    case SYNC_PN_32_JANUS: {
+      // Computed directly rather than from janus_frequencies since that cache
+      // is only refreshed for the configuration last used for reception
+      bool bit;
+      if (janusPnStep(&bit, step) == false) {
+        return false;
+      }
+      waveform_step->freq_hz = Modulate_GetFhbfskFrequency(bit, step, cfg);
       waveform_step->duration_us = (uint32_t) roundf(1000000.0f / cfg->baud_rate);
       waveform_step->relative_amplitude = Modulate_GetAmplitude(waveform_step->freq_hz);
       return true;
+    }
     default:
       return false;
   }
@@ -141,6 +150,7 @@ bool Sync_Synchronize(const DspConfig_t* cfg)
   updateParameters(cfg);
   switch (cfg->sync_method) {
     case NO_SYNC:
+      last_sync_snr = 0.0f;
       return Input_DetectMessageStart(cfg);
     case SYNC_PN_32_JANUS:
       return janusPnSynchronize(cfg);
@@ -149,6 +159,11 @@ bool Sync_Synchronize(const DspConfig_t* cfg)
   }
 }
 
+float Sync_LastSnr()
+{
+  return last_sync_snr;
+}
+
 void Sync_Reset()
 {
   memset(stage1_results, 0, sizeof(stage1_results));
@@ -506,6 +521,8 @@ bool evaluateStage2Results()
     return false;
   }
 
+  last_sync_snr = best_snr;
+
   uint32_t samples_to_wait = 24 * samples_per_symbol;
 
   uint64_t current_samples = stage2_results[best_index].rollover_count * PROCESSING_BUFFER_SIZE;
@@ -11,6 +11,7 @@
 #include "sleep/sleep_config.h"
 #include "sleep/sleep_deep.h"
 #include "sys_main.h"
+#include "cfg_main.h"
 #include "cmsis_os.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -44,6 +45,8 @@ void SleepManager_Enter()
     case SLEEP_LIGHT:
       return;
     case SLEEP_DEEP:
+      // Changes still waiting for the save delay would be lost
+      CFG_FlushParameters(CFG_FLUSH_TIMEOUT_MS);
       SleepDeep_Enter();
     default:
       return;
@@ -0,0 +1,316 @@
+/*
+ * sys_cpu_load.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "sys_cpu_load.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+
+
+/* Private define ------------------------------------------------------------*/
+
+#define CPU_LOAD_SAMPLE_PERIOD_MS   1000
+// Longest window in samples
+#define CPU_LOAD_HISTORY            60
+
+// TIM17 interrupt incrementing the run time counter
+#define CPU_LOAD_COUNTER_HZ         10000
+
+// Tasks beyond the tracked ones still have to fit in the status array
+#define CPU_LOAD_STATUS_SLOTS       (CPU_LOAD_MAX_TASKS + 2)
+
+#define CPU_LOAD_NO_SLOT            0xFF
+
+// Name the kernel gives the idle task
+#define CPU_LOAD_IDLE_TASK_NAME     "IDLE"
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint8_t window_seconds[NUM_CPU_LOAD_WINDOWS] = {1, 10, 60};
+
+// Run time counter increments spent in each sample period. Rings indexed by
+// history_index which points at the oldest sample
+static uint16_t elapsed_history[CPU_LOAD_HISTORY];
+static uint16_t task_history[CPU_LOAD_MAX_TASKS][CPU_LOAD_HISTORY];
+static uint16_t mess_history[CPU_LOAD_NUM_MESS_STATES][CPU_LOAD_HISTORY];
+static uint8_t history_index = 0;
+static uint8_t history_count = 0;
+
+static char task_names[CPU_LOAD_MAX_TASKS][configMAX_TASK_NAME_LEN];
+static UBaseType_t task_numbers[CPU_LOAD_MAX_TASKS];
+static uint32_t task_last_counter[CPU_LOAD_MAX_TASKS];
+static uint8_t num_tasks = 0;
+static uint8_t idle_slot = CPU_LOAD_NO_SLOT;
+
+static TaskStatus_t status_array[CPU_LOAD_STATUS_SLOTS];
+static uint32_t last_total_counter = 0;
+static uint32_t last_sample_tick = 0;
+static bool sampling_started = false;
+
+// MESS task state attribution. Shared between the MESS and SYS tasks and only
+// accessed in critical sections
+static TaskHandle_t mess_task = NULL;
+static ProcessingState_t mess_state = CHANGING;
+static uint32_t mess_mark = 0;
+static uint32_t mess_accumulated[CPU_LOAD_NUM_MESS_STATES];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t findTaskSlot(const TaskStatus_t* status);
+static void attributeMessTime(uint32_t counter);
+static uint16_t saturate16(uint32_t value);
+static uint16_t windowPermille(const uint16_t* history, CpuLoadWindow_t window);
+static uint32_t windowSum(const uint16_t* history, uint8_t length);
+static uint16_t putU16(uint8_t* buffer, uint16_t index, uint16_t value);
+static uint16_t putU32(uint8_t* buffer, uint16_t index, uint32_t value);
+
+/* Exported function definitions ---------------------------------------------*/
+
+void CpuLoad_Process(void)
+{
+  uint32_t now = osKernelGetTickCount();
+  if (sampling_started == true && now - last_sample_tick < CPU_LOAD_SAMPLE_PERIOD_MS) {
+    return;
+  }
+
+  uint32_t total_counter;
+  UBaseType_t count = uxTaskGetSystemState(status_array, CPU_LOAD_STATUS_SLOTS, &total_counter);
+  if (count == 0) {
+    return;
+  }
+  last_sample_tick = now;
+
+  uint8_t sample = (history_index + history_count) % CPU_LOAD_HISTORY;
+  if (history_count == CPU_LOAD_HISTORY) {
+    history_index = (history_index + 1) % CPU_LOAD_HISTORY;
+  }
+  for (uint8_t i = 0; i < CPU_LOAD_MAX_TASKS; i++) {
+    task_history[i][sample] = 0;
+  }
+
+  for (UBaseType_t i = 0; i < count; i++) {
+    const TaskStatus_t* status = &status_array[i];
+    uint8_t slot = findTaskSlot(status);
+    if (slot == CPU_LOAD_NO_SLOT) {
+      continue;
+    }
+    task_history[slot][sample] = saturate16(status->ulRunTimeCounter - task_last_counter[slot]);
+    task_last_counter[slot] = status->ulRunTimeCounter;
+
+    if (status->xHandle == mess_task) {
+      taskENTER_CRITICAL();
+      attributeMessTime(status->ulRunTimeCounter);
+      taskEXIT_CRITICAL();
+    }
+  }
+
+  taskENTER_CRITICAL();
+  for (uint8_t i = 0; i < CPU_LOAD_NUM_MESS_STATES; i++) {
+    mess_history[i][sample] = saturate16(mess_accumulated[i]);
+    mess_accumulated[i] = 0;
+  }
+  taskEXIT_CRITICAL();
+
+  elapsed_history[sample] = saturate16(total_counter - last_total_counter);
+  last_total_counter = total_counter;
+
+  // The first sample only sets the baselines
+  if (sampling_started == false) {
+    sampling_started = true;
+    return;
+  }
+  if (history_count < CPU_LOAD_HISTORY) {
+    history_count++;
+  }
+}
+
+void CpuLoad_SetMessState(ProcessingState_t state)
+{
+  if (mess_task == NULL) {
+    mess_task = xTaskGetCurrentTaskHandle();
+  }
+  TaskStatus_t status;
+  vTaskGetInfo(mess_task, &status, pdFALSE, eInvalid);
+
+  taskENTER_CRITICAL();
+  attributeMessTime(status.ulRunTimeCounter);
+  mess_state = state;
+  taskEXIT_CRITICAL();
+}
+
+uint8_t CpuLoad_NumTasks(void)
+{
+  return num_tasks;
+}
+
+const char* CpuLoad_TaskName(uint8_t task)
+{
+  if (task >= num_tasks) {
+    return "";
+  }
+  return task_names[task];
+}
+
+uint16_t CpuLoad_TaskPermille(uint8_t task, CpuLoadWindow_t window)
+{
+  if (task >= num_tasks) {
+    return 0;
+  }
+  return windowPermille(task_history[task], window);
+}
+
+uint16_t CpuLoad_MessStatePermille(ProcessingState_t state, CpuLoadWindow_t window)
+{
+  if (state >= CPU_LOAD_NUM_MESS_STATES) {
+    return 0;
+  }
+  return windowPermille(mess_history[state], window);
+}
+
+uint16_t CpuLoad_BusyPermille(CpuLoadWindow_t window)
+{
+  if (idle_slot == CPU_LOAD_NO_SLOT) {
+    return 0;
+  }
+  uint16_t idle = windowPermille(task_history[idle_slot], window);
+  return (idle < 1000) ? 1000 - idle : 0;
+}
+
+uint8_t CpuLoad_WindowSeconds(CpuLoadWindow_t window)
+{
+  if (window >= NUM_CPU_LOAD_WINDOWS) {
+    return 0;
+  }
+  return window_seconds[window];
+}
+
+uint16_t CpuLoad_PackRecord(uint8_t* buffer, uint16_t max_len)
+{
+  uint16_t length = 10 + NUM_CPU_LOAD_WINDOWS * 2 * (1 + num_tasks + CPU_LOAD_NUM_MESS_STATES);
+  for (uint8_t i = 0; i < num_tasks; i++) {
+    length += 1 + strlen(task_names[i]);
+  }
+  if (length > max_len) {
+    return 0;
+  }
+
+  uint16_t index = 0;
+  buffer[index++] = CPU_LOAD_RECORD_VERSION;
+  buffer[index++] = num_tasks;
+  index = putU32(buffer, index, CPU_LOAD_COUNTER_HZ);
+  index = putU32(buffer, index, osKernelGetTickCount() / 1000);
+  for (CpuLoadWindow_t window = 0; window < NUM_CPU_LOAD_WINDOWS; window++) {
+    index = putU16(buffer, index, CpuLoad_BusyPermille(window));
+    for (uint8_t i = 0; i < num_tasks; i++) {
+      index = putU16(buffer, index, CpuLoad_TaskPermille(i, window));
+    }
+    for (uint8_t i = 0; i < CPU_LOAD_NUM_MESS_STATES; i++) {
+      index = putU16(buffer, index, CpuLoad_MessStatePermille(i, window));
+    }
+  }
+  for (uint8_t i = 0; i < num_tasks; i++) {
+    uint8_t name_length = strlen(task_names[i]);
+    buffer[index++] = name_length;
+    memcpy(&buffer[index], task_names[i], name_length);
+    index += name_length;
+  }
+  return index;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+static uint8_t findTaskSlot(const TaskStatus_t* status)
+{
+  for (uint8_t i = 0; i < num_tasks; i++) {
+    if (task_numbers[i] == status->xTaskNumber) {
+      return i;
+    }
+  }
+  if (num_tasks >= CPU_LOAD_MAX_TASKS) {
+    return CPU_LOAD_NO_SLOT;
+  }
+
+  // New task. Its time before now is not part of any sample
+  uint8_t slot = num_tasks++;
+  task_numbers[slot] = status->xTaskNumber;
+  task_last_counter[slot] = status->ulRunTimeCounter;
+  strncpy(task_names[slot], status->pcTaskName, configMAX_TASK_NAME_LEN - 1);
+  task_names[slot][configMAX_TASK_NAME_LEN - 1] = '\0';
+  if (strcmp(task_names[slot], CPU_LOAD_IDLE_TASK_NAME) == 0) {
+    idle_slot = slot;
+  }
+  return slot;
+}
+
+static void attributeMessTime(uint32_t counter)
+{
+  // The SYS task may have read an older counter than the MESS task's last mark
+  int32_t delta = (int32_t) (counter - mess_mark);
+  if (delta <= 0) {
+    return;
+  }
+  if (mess_mark != 0 && mess_state < CPU_LOAD_NUM_MESS_STATES) {
+    mess_accumulated[mess_state] += delta;
+  }
+  mess_mark = counter;
+}
+
+static uint16_t saturate16(uint32_t value)
+{
+  return (value > UINT16_MAX) ? UINT16_MAX : value;
+}
+
+static uint16_t windowPermille(const uint16_t* history, CpuLoadWindow_t window)
+{
+  if (window >= NUM_CPU_LOAD_WINDOWS) {
+    return 0;
+  }
+  uint32_t elapsed = windowSum(elapsed_history, window_seconds[window]);
+  if (elapsed == 0) {
+    return 0;
+  }
+  uint64_t permille = (uint64_t) windowSum(history, window_seconds[window]) * 1000 / elapsed;
+  return (permille > 1000) ? 1000 : permille;
+}
+
+static uint32_t windowSum(const uint16_t* history, uint8_t length)
+{
+  if (length > history_count) {
+    length = history_count;
+  }
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    sum += history[(history_index + history_count - 1 - i) % CPU_LOAD_HISTORY];
+  }
+  return sum;
+}
+
+static uint16_t putU16(uint8_t* buffer, uint16_t index, uint16_t value)
+{
+  buffer[index++] = value & 0xFF;
+  buffer[index++] = value >> 8;
+  return index;
+}
+
+static uint16_t putU32(uint8_t* buffer, uint16_t index, uint32_t value)
+{
+  index = putU16(buffer, index, value & 0xFFFF);
+  return putU16(buffer, index, value >> 16);
+}
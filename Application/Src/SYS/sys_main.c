@@ -12,6 +12,8 @@
 #include "sys_error.h"
 #include "sys_sensor_timer.h"
 #include "sys_temperature.h"
+#include "sys_power.h"
+#include "sys_cpu_load.h"
 #include "sys_led.h"
 #include "sleep/sleep_manager.h"
 #include "cfg_main.h"
@@ -69,6 +71,10 @@ void SYS_StartTask(void* argument)
     Error_Routine(ERROR_SYS_INIT);
   }
 
+  if (Power_Init() == false) {
+    Error_Routine(ERROR_SYS_INIT);
+  }
+
   if (createSleepEvents() == false) {
     Error_Routine(ERROR_SYS_INIT);
   }
@@ -76,6 +82,8 @@ void SYS_StartTask(void* argument)
   for (;;) {
     LED_Update();
     Temperature_Process();
+    Power_Process();
+    CpuLoad_Process();
     SleepManager_Enter();
     osDelay(100);
   }
@@ -93,7 +101,15 @@ bool registerSysParam()
 
 bool createSleepEvents()
 {
-  sleep_events = osEventFlagsNew(NULL);
+  static StaticEventGroup_t event_control_block;
+  static const osEventFlagsAttr_t event_attr = {
+      .name = "SleepEvents",
+      .attr_bits = 0,
+      .cb_mem = &event_control_block,
+      .cb_size = sizeof(event_control_block)
+  };
+
+  sleep_events = osEventFlagsNew(&event_attr);
 
   return sleep_events != NULL;
 }
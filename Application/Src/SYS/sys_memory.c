@@ -0,0 +1,125 @@
+/*
+ * sys_memory.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "sys_memory.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+  const char* name;
+  uint32_t stack_bytes;
+} TaskStack_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Region sizes from STM32H723VETX_FLASH.ld
+#define DTCM_SIZE_BYTES     (128 * 1024)
+#define RAM_D1_SIZE_BYTES   (320 * 1024)
+#define DMA_BUF_SIZE_BYTES  (16 * 1024)   // Part of RAM_D2 protected by the MPU
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+// Task attributes from main.c
+extern const osThreadAttr_t defaultTask_attributes;
+extern const osThreadAttr_t messageTask_attributes;
+extern const osThreadAttr_t sysTask_attributes;
+extern const osThreadAttr_t commTask_attributes;
+extern const osThreadAttr_t configTask_attributes;
+extern const osThreadAttr_t dacTask_attributes;
+
+static const osThreadAttr_t* const task_attributes[] = {
+  &defaultTask_attributes, &messageTask_attributes, &sysTask_attributes,
+  &commTask_attributes, &configTask_attributes, &dacTask_attributes
+};
+
+// Kernel tasks get their stacks from cmsis_os2.c
+static const TaskStack_t kernel_stacks[] = {
+  {"IDLE", configMINIMAL_STACK_SIZE * sizeof(StackType_t)},
+  {"Tmr Svc", configTIMER_TASK_STACK_DEPTH * sizeof(StackType_t)}
+};
+
+static TaskStatus_t status_array[MEMORY_MAX_TASKS];
+
+// Section boundaries from the linker script
+extern uint8_t _sdata;
+extern uint8_t _ebss;
+extern uint8_t _sdtcm;
+extern uint8_t _edtcm;
+extern uint8_t _sdma_buf;
+extern uint8_t _edma_buf;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t findStackSize(const char* name);
+
+/* Exported function definitions ---------------------------------------------*/
+
+uint8_t Memory_GetTaskUsage(MemoryTaskUsage_t* usage, uint8_t max_tasks)
+{
+  UBaseType_t count = uxTaskGetSystemState(status_array, MEMORY_MAX_TASKS, NULL);
+  if (count > max_tasks) {
+    count = max_tasks;
+  }
+  for (UBaseType_t i = 0; i < count; i++) {
+    usage[i].name = status_array[i].pcTaskName;
+    usage[i].stack_bytes = findStackSize(status_array[i].pcTaskName);
+    usage[i].min_free_bytes = status_array[i].usStackHighWaterMark * sizeof(StackType_t);
+  }
+  return count;
+}
+
+uint8_t Memory_GetRegionUsage(MemoryRegionUsage_t* usage, uint8_t max_regions)
+{
+  const MemoryRegionUsage_t regions[] = {
+    {"RAM_D1 data+bss", &_ebss - &_sdata, RAM_D1_SIZE_BYTES},
+    {"DTCM", &_edtcm - &_sdtcm, DTCM_SIZE_BYTES},
+    {"RAM_D2 DMA", &_edma_buf - &_sdma_buf, DMA_BUF_SIZE_BYTES}
+  };
+  uint8_t count = sizeof(regions) / sizeof(regions[0]);
+  if (count > max_regions) {
+    count = max_regions;
+  }
+  memcpy(usage, regions, count * sizeof(MemoryRegionUsage_t));
+  return count;
+}
+
+void Memory_GetHeapUsage(MemoryHeapUsage_t* usage)
+{
+  usage->size_bytes = configTOTAL_HEAP_SIZE;
+  usage->free_bytes = xPortGetFreeHeapSize();
+  usage->min_free_bytes = xPortGetMinimumEverFreeHeapSize();
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+static uint32_t findStackSize(const char* name)
+{
+  for (uint8_t i = 0; i < sizeof(task_attributes) / sizeof(task_attributes[0]); i++) {
+    if (strcmp(task_attributes[i]->name, name) == 0) {
+      return task_attributes[i]->stack_size;
+    }
+  }
+  for (uint8_t i = 0; i < sizeof(kernel_stacks) / sizeof(kernel_stacks[0]); i++) {
+    if (strcmp(kernel_stacks[i].name, name) == 0) {
+      return kernel_stacks[i].stack_bytes;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * sys_power.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "stm32h7xx_hal.h"
+
+#include "sys_power.h"
+#include "sys_sensor_timer.h"
+
+#include "INA219-driver.h"
+
+#include <math.h>
+#include <stdbool.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+  int16_t shunt_raw;
+  uint16_t bus_raw;
+  uint32_t tick_ms;
+  uint8_t state;        // ProcessingState_t when the reading arrived
+} PowerSample_t;
+
+/* Private define ------------------------------------------------------------*/
+
+// Current sense resistor in series with the supply input
+#define POWER_SHUNT_OHMS          (0.1f)
+
+// Must be a power of 2
+#define POWER_BUFFER_SIZE         128
+
+// Longest gap between readings that is integrated. Longer gaps happen when
+// the I2C bus is shut down in deep sleep
+#define POWER_MAX_GAP_MS          (4 * POWER_SENSOR_PERIOD_MS)
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+static bool power_initialized = false;
+
+static PowerSample_t power_buffer[POWER_BUFFER_SIZE];
+
+static volatile uint16_t buf_index = 0; // Where new data should go
+static uint16_t processing_index = 0; // Where to start processing data from
+
+static volatile uint32_t dropped_count = 0;
+
+// Running statistics. Updated by the SYS task and published as floats at the
+// end of Power_Process so readers never see a torn double
+static uint32_t sample_count = 0;
+static double mean_power_w = 0.0;
+static double m2_power = 0.0;       // Welford sum of squared differences
+static double energy_j = 0.0;
+static double state_energy_j[POWER_NUM_MESS_STATES];
+static uint32_t state_time_ms[POWER_NUM_MESS_STATES];
+
+static uint32_t last_tick_ms = 0;
+static uint8_t run_state = CHANGING;
+static double run_energy_j = 0.0;
+
+static float current_power_w = 0.0f;
+static float current_voltage_v = 0.0f;
+static float current_current_a = 0.0f;
+static float peak_power_w = 0.0f;
+static float published_mean_w = 0.0f;
+static float published_std_w = 0.0f;
+static float published_energy_j = 0.0f;
+static float published_state_energy_j[POWER_NUM_MESS_STATES];
+static float last_packet_energy_j[NUM_POWER_PACKET_TYPES];
+
+// Written by the MESS task
+static PowerPacketStats_t packet_stats[NUM_POWER_PACKET_TYPES];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void processSample(const PowerSample_t* sample);
+static void finishRun(void);
+
+/* Exported function definitions ---------------------------------------------*/
+
+bool Power_Init()
+{
+  if (INA219_Init() == false) {
+    return false;
+  }
+
+  last_tick_ms = HAL_GetTick();
+  power_initialized = true;
+  return true;
+}
+
+bool Power_TriggerConversion()
+{
+  if (power_initialized == false) {
+    return false;
+  }
+
+  if (INA219_StartRead() == false) {
+    dropped_count++;
+    return false;
+  }
+  return true;
+}
+
+void Power_AddValue(int16_t shunt_raw, uint16_t bus_raw)
+{
+  power_buffer[buf_index].shunt_raw = shunt_raw;
+  power_buffer[buf_index].bus_raw = bus_raw;
+  power_buffer[buf_index].tick_ms = HAL_GetTick();
+  power_buffer[buf_index].state = MESS_GetState();
+  buf_index = (buf_index + 1) % POWER_BUFFER_SIZE;
+}
+
+bool Power_Process()
+{
+  uint16_t end_index = buf_index;
+  if (processing_index == end_index) {
+    return true;
+  }
+
+  while (processing_index != end_index) {
+    processSample(&power_buffer[processing_index]);
+    processing_index = (processing_index + 1) % POWER_BUFFER_SIZE;
+  }
+
+  published_mean_w = mean_power_w;
+  published_std_w = (sample_count > 1) ? sqrt(m2_power / (sample_count - 1)) : 0.0f;
+  published_energy_j = energy_j;
+  for (uint8_t i = 0; i < POWER_NUM_MESS_STATES; i++) {
+    published_state_energy_j[i] = state_energy_j[i];
+  }
+  return true;
+}
+
+void Power_AddPacket(PowerPacket_t type, uint16_t bits, bool delivered)
+{
+  if (type >= NUM_POWER_PACKET_TYPES) {
+    return;
+  }
+
+  packet_stats[type].packets++;
+  packet_stats[type].bits += bits;
+  if (delivered == true) {
+    packet_stats[type].delivered_bits += bits;
+  }
+}
+
+float Power_GetCurrent()
+{
+  return current_power_w;
+}
+
+float Power_GetPeak()
+{
+  return peak_power_w;
+}
+
+float Power_GetAverage()
+{
+  return published_mean_w;
+}
+
+float Power_GetStdDev()
+{
+  return published_std_w;
+}
+
+float Power_GetEnergy()
+{
+  return published_energy_j;
+}
+
+void Power_GetLatestReading(float* voltage_v, float* current_a)
+{
+  *voltage_v = current_voltage_v;
+  *current_a = current_current_a;
+}
+
+float Power_GetStateEnergy(ProcessingState_t state, float* time_s)
+{
+  if (state >= POWER_NUM_MESS_STATES) {
+    *time_s = 0.0f;
+    return 0.0f;
+  }
+
+  *time_s = state_time_ms[state] / 1000.0f;
+  return published_state_energy_j[state];
+}
+
+void Power_GetPacketStats(PowerPacket_t type, PowerPacketStats_t* stats)
+{
+  if (type >= NUM_POWER_PACKET_TYPES) {
+    return;
+  }
+
+  *stats = packet_stats[type];
+  ProcessingState_t state = (type == POWER_PACKET_TX) ? DRIVING_TRANSDUCER : PROCESSING;
+  stats->energy_j = published_state_energy_j[state];
+  stats->last_packet_energy_j = last_packet_energy_j[type];
+}
+
+uint32_t Power_GetSampleCount(uint32_t* dropped)
+{
+  *dropped = dropped_count + INA219_GetErrorCount();
+  return sample_count;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+static void processSample(const PowerSample_t* sample)
+{
+  float current_a = (sample->shunt_raw * INA219_SHUNT_LSB_UV * 1e-6f) / POWER_SHUNT_OHMS;
+  float voltage_v = (sample->bus_raw >> 3) * INA219_BUS_LSB_MV * 1e-3f;
+  float power_w = voltage_v * current_a;
+
+  current_voltage_v = voltage_v;
+  current_current_a = current_a;
+  current_power_w = power_w;
+  if (power_w > peak_power_w) {
+    peak_power_w = power_w;
+  }
+
+  sample_count++;
+  double delta = power_w - mean_power_w;
+  mean_power_w += delta / sample_count;
+  m2_power += delta * (power_w - mean_power_w);
+
+  // The reading stands for the interval since the previous one
+  uint32_t dt_ms = sample->tick_ms - last_tick_ms;
+  last_tick_ms = sample->tick_ms;
+  if (dt_ms > POWER_MAX_GAP_MS) {
+    dt_ms = POWER_SENSOR_PERIOD_MS;
+  }
+  double sample_energy_j = power_w * (dt_ms / 1000.0);
+
+  if (sample->state != run_state) {
+    finishRun();
+    run_state = sample->state;
+  }
+  run_energy_j += sample_energy_j;
+
+  energy_j += sample_energy_j;
+  if (sample->state < POWER_NUM_MESS_STATES) {
+    state_energy_j[sample->state] += sample_energy_j;
+    state_time_ms[sample->state] += dt_ms;
+  }
+}
+
+static void finishRun()
+{
+  // Each transmission and each received packet is one contiguous run of its
+  // state so the run energy is the energy of that packet
+  if (run_state == DRIVING_TRANSDUCER) {
+    last_packet_energy_j[POWER_PACKET_TX] = run_energy_j;
+  }
+  else if (run_state == PROCESSING) {
+    last_packet_energy_j[POWER_PACKET_RX] = run_energy_j;
+  }
+  run_energy_j = 0.0;
+}
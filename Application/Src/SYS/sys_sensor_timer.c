@@ -11,6 +11,7 @@
 
 #include "sys_sensor_timer.h"
 #include "sys_temperature.h"
+#include "sys_power.h"
 
 #include <stdbool.h>
 
@@ -23,6 +24,9 @@
 #define TICKS_FOR_TEMPERATURE ((TEMPERATURE_SENSOR_PERIOD_MS * \
                                 SENSOR_TIMER_TICK_RATE_HZ) / \
                                 1000)
+#define TICKS_FOR_POWER       ((POWER_SENSOR_PERIOD_MS * \
+                                SENSOR_TIMER_TICK_RATE_HZ) / \
+                                1000)
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -54,6 +58,10 @@ void SensorTimer_Tick()
   if ((sensor_ticks % TICKS_FOR_TEMPERATURE) == 0) {
     Temperature_TriggerConversion();
   }
+
+  if ((sensor_ticks % TICKS_FOR_POWER) == 0) {
+    Power_TriggerConversion();
+  }
 }
 
 /* Private function definitions ----------------------------------------------*/
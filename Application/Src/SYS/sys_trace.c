@@ -0,0 +1,198 @@
+/*
+ * sys_trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "stm32h7xx_hal.h"
+
+#include "sys_trace.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef enum {
+  TRACE_STOPPED,          // Before Trace_Init and while restarting
+  TRACE_RUNNING,
+  TRACE_ARMING,           // A limit is being set, records are still kept
+  TRACE_LIMITED           // Records at or past trace_limit are dropped
+} TraceState_t;
+
+/* Private define ------------------------------------------------------------*/
+
+#define TRACE_BUFFER_MASK       (TRACE_BUFFER_SIZE - 1)
+
+// Unlocks the DWT registers on the Cortex-M7
+#define DWT_LAR_UNLOCK          0xC5ACCE55
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+static TraceRecord_t trace_buffer[TRACE_BUFFER_SIZE];
+
+static volatile TraceState_t trace_state = TRACE_STOPPED;
+// Slots handed out to writers since the trace was started. Wraps after a few
+// days of uptime so it is only compared with wrap safe arithmetic
+static volatile uint32_t trace_head = 0;
+// Only valid in TRACE_LIMITED
+static volatile uint32_t trace_limit = 0;
+// Set once the head has gone around the buffer
+static volatile bool trace_full = false;
+static volatile bool trace_faulted = false;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool addRecord(TraceEvent_t event, uint32_t arg, uint32_t* index);
+static bool isPastEnd(uint32_t index);
+static bool armLimit(uint32_t limit);
+static uint32_t heldRecords(uint32_t* end);
+
+/* Exported function definitions ---------------------------------------------*/
+
+void Trace_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = DWT_LAR_UNLOCK;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  Trace_Restart();
+}
+
+void Trace_Record(TraceEvent_t event, uint32_t arg)
+{
+  uint32_t index;
+  (void) addRecord(event, arg, &index);
+}
+
+void Trace_Fault(TraceEvent_t event, uint32_t arg)
+{
+  uint32_t index;
+  if (addRecord(event, arg, &index) == false) {
+    return;
+  }
+  if (armLimit(index + 1 + TRACE_POST_FAULT) == true) {
+    trace_faulted = true;
+  }
+}
+
+uint32_t Trace_Freeze(void)
+{
+  uint32_t head = trace_head;
+  // A fault limit further ahead is pulled back to the current head
+  if (armLimit(head) == false && trace_state == TRACE_LIMITED) {
+    uint32_t limit = trace_limit;
+    while ((int32_t) (head - limit) < 0) {
+      if (__atomic_compare_exchange_n(&trace_limit, &limit, head, false,
+          __ATOMIC_RELAXED, __ATOMIC_RELAXED) == true) {
+        break;
+      }
+    }
+  }
+  uint32_t end;
+  return heldRecords(&end);
+}
+
+void Trace_Restart(void)
+{
+  trace_state = TRACE_STOPPED;
+  __DMB();
+  trace_head = 0;
+  trace_full = false;
+  trace_faulted = false;
+  __DMB();
+  trace_state = TRACE_RUNNING;
+}
+
+bool Trace_IsFaulted(void)
+{
+  return trace_faulted;
+}
+
+uint32_t Trace_CopyRecords(uint32_t first, TraceRecord_t* dest, uint32_t max_records)
+{
+  uint32_t end;
+  uint32_t held = heldRecords(&end);
+  if (first >= held) {
+    return 0;
+  }
+  uint32_t count = held - first;
+  if (count > max_records) {
+    count = max_records;
+  }
+  uint32_t start = end - held + first;
+  for (uint32_t i = 0; i < count; i++) {
+    dest[i] = trace_buffer[(start + i) & TRACE_BUFFER_MASK];
+  }
+  return count;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+static bool addRecord(TraceEvent_t event, uint32_t arg, uint32_t* index)
+{
+  // Cheap check first so a stopped trace does not keep advancing the head
+  if (isPastEnd(trace_head) == true) {
+    return false;
+  }
+  *index = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+  if (isPastEnd(*index) == true) {
+    return false;
+  }
+  if (*index == TRACE_BUFFER_MASK) {
+    trace_full = true;
+  }
+
+  // A writer interrupted here is overtaken by the interrupting one, so
+  // timestamps of neighbouring records can be slightly out of order
+  TraceRecord_t* record = &trace_buffer[*index & TRACE_BUFFER_MASK];
+  record->timestamp = DWT->CYCCNT;
+  record->arg = arg;
+  record->event = event;
+  record->source = __get_IPSR();
+  return true;
+}
+
+static bool isPastEnd(uint32_t index)
+{
+  TraceState_t state = trace_state;
+  if (state == TRACE_STOPPED) {
+    return true;
+  }
+  return state == TRACE_LIMITED && (int32_t) (index - trace_limit) >= 0;
+}
+
+// Only the first caller since the trace was started sets the limit. The
+// limit is written before the state so writers never see a stale one
+static bool armLimit(uint32_t limit)
+{
+  TraceState_t expected = TRACE_RUNNING;
+  if (__atomic_compare_exchange_n(&trace_state, &expected, TRACE_ARMING, false,
+      __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false) {
+    return false;
+  }
+  trace_limit = limit;
+  __DMB();
+  trace_state = TRACE_LIMITED;
+  return true;
+}
+
+static uint32_t heldRecords(uint32_t* end)
+{
+  *end = trace_head;
+  if (trace_state == TRACE_LIMITED && (int32_t) (*end - trace_limit) >= 0) {
+    *end = trace_limit;
+  }
+  if (trace_full == true || *end >= TRACE_BUFFER_SIZE) {
+    return TRACE_BUFFER_SIZE;
+  }
+  return *end;
+}
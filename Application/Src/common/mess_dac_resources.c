@@ -14,6 +14,7 @@
 #include "dac_waveform.h"
 #include "sys_error.h"
 #include "sleep/wakeup_tones.h"
+#include "seqlock.h"
 #include "cmsis_os.h"
 #include <string.h>
 
@@ -32,7 +33,6 @@ typedef struct {
 
 /* Private define ------------------------------------------------------------*/
 
-#define MUTEX_TIMEOUT   0 // No timeout since it must be instant
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -40,7 +40,10 @@ typedef struct {
 
 /* Private variables ---------------------------------------------------------*/
 
-static osMutexId_t mess_dac_resource_mutex;
+// Written by MESS before a waveform starts and read by the DAC for every step.
+// A read overlapping a write means a new message was registered while the
+// previous one was still playing
+static Seqlock_t mess_dac_resource_lock;
 
 static DspConfig_t cfg;
 static BitMessage_t bit_msg;
@@ -55,30 +58,28 @@ TransmissionPhase_t getPhase(uint16_t current_step, uint16_t* transmission_step,
 
 void MessDacResource_Init()
 {
-  mess_dac_resource_mutex = osMutexNew(NULL);
+  mess_dac_resource_lock.sequence = 0;
 }
 
 void MessDacResource_RegisterMessageConfiguration(const DspConfig_t* new_cfg,
     BitMessage_t* new_bit_msg)
 {
-  if (osMutexAcquire(mess_dac_resource_mutex, MUTEX_TIMEOUT) != osOK) {
-    Error_Routine(ERROR_MESS_DAC_RESOURCE);
-    return;
-  }
+  Seqlock_WriteBegin(&mess_dac_resource_lock);
   memcpy(&cfg, new_cfg, sizeof(DspConfig_t));
   memcpy(&bit_msg, new_bit_msg, sizeof(BitMessage_t));
 
   transmission_layout.wakeup_steps = WakeupTones_NumSteps(new_cfg);
   transmission_layout.sync_steps = Sync_NumSteps(new_cfg);
 
-  osMutexRelease(mess_dac_resource_mutex);
+  Seqlock_WriteEnd(&mess_dac_resource_lock);
 }
 
 WaveformStep_t MessDacResource_GetStep(uint16_t current_step)
 {
   WaveformStep_t waveform_step = {0};
 
-  if (osMutexAcquire(mess_dac_resource_mutex, MUTEX_TIMEOUT) != osOK) {
+  uint32_t sequence;
+  if (Seqlock_ReadBegin(&mess_dac_resource_lock, &sequence) == false) {
     Error_Routine(ERROR_MESS_DAC_RESOURCE);
     return waveform_step;
   }
@@ -102,7 +103,10 @@ WaveformStep_t MessDacResource_GetStep(uint16_t current_step)
       success = false;
       break;
   }
-  osMutexRelease(mess_dac_resource_mutex);
+  if (Seqlock_ReadValid(&mess_dac_resource_lock, sequence) == false) {
+    Error_Routine(ERROR_MESS_DAC_RESOURCE);
+    return waveform_step;
+  }
   if (success == false) {
     Error_Routine(ERROR_DAC_PROCESSING);
     return waveform_step;
@@ -0,0 +1,59 @@
+/*
+ * crc32.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "crc32.h"
+#include <stdint.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+
+
+/* Private define ------------------------------------------------------------*/
+
+
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+
+
+/* Private function prototypes -----------------------------------------------*/
+
+
+
+/* Exported function definitions ---------------------------------------------*/
+
+// Nibble-wise with the reflected polynomial 0xEDB88320 to keep the table small
+uint32_t Crc32_Update(uint32_t crc, const void* data, uint32_t len)
+{
+  static const uint32_t nibble_table[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+    0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+    0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
+  };
+
+  const uint8_t* bytes = (const uint8_t*) data;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= bytes[i];
+    crc = (crc >> 4) ^ nibble_table[crc & 0x0F];
+    crc = (crc >> 4) ^ nibble_table[crc & 0x0F];
+  }
+  return crc;
+}
+
+uint32_t Crc32_Final(uint32_t crc)
+{
+  return crc ^ 0xFFFFFFFFu;
+}
+
+/* Private function definitions ----------------------------------------------*/
@@ -0,0 +1,59 @@
+/*
+ * hw_random.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "hw_random.h"
+
+#include "stm32h7xx_hal.h"
+#include "cmsis_os.h"
+
+#include <stdint.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+
+
+/* Private define ------------------------------------------------------------*/
+
+// Time allowed for HSI48 and the random number generator to start
+#define RNG_TIMEOUT_MS              5
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+
+
+/* Private function prototypes -----------------------------------------------*/
+
+
+
+/* Exported function definitions ---------------------------------------------*/
+
+// The HAL RNG driver is not part of the project so the registers are used
+// directly. The RNG kernel clock defaults to HSI48 which is otherwise unused
+uint8_t Random_Byte(void)
+{
+  __HAL_RCC_HSI48_ENABLE();
+  __HAL_RCC_RNG_CLK_ENABLE();
+  RNG->CR |= RNG_CR_RNGEN;
+
+  uint32_t start = osKernelGetTickCount();
+  while ((RNG->SR & RNG_SR_DRDY) == 0) {
+    if ((RNG->SR & (RNG_SR_CECS | RNG_SR_SECS)) != 0 ||
+        osKernelGetTickCount() - start > RNG_TIMEOUT_MS) {
+      uint32_t uid = HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2();
+      return (uint8_t) (uid ^ (uid >> 8) ^ (uid >> 16) ^ (uid >> 24) ^ start);
+    }
+  }
+  return (uint8_t) RNG->DR;
+}
+
+/* Private function definitions ----------------------------------------------*/
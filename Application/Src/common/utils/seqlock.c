@@ -0,0 +1,85 @@
+/*
+ * seqlock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ericv
+ */
+
+/* Private includes ----------------------------------------------------------*/
+
+#include "seqlock.h"
+#include "stm32h7xx.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+
+
+/* Private define ------------------------------------------------------------*/
+
+
+
+/* Private macro -------------------------------------------------------------*/
+
+
+
+/* Private variables ---------------------------------------------------------*/
+
+
+
+/* Private function prototypes -----------------------------------------------*/
+
+
+
+/* Exported function definitions ---------------------------------------------*/
+
+void Seqlock_WriteBegin(Seqlock_t* lock)
+{
+  lock->sequence++;
+  __DMB();
+}
+
+void Seqlock_WriteEnd(Seqlock_t* lock)
+{
+  __DMB();
+  lock->sequence++;
+}
+
+bool Seqlock_ReadBegin(const Seqlock_t* lock, uint32_t* sequence)
+{
+  *sequence = lock->sequence;
+  __DMB();
+  return (*sequence & 1) == 0;
+}
+
+bool Seqlock_ReadValid(const Seqlock_t* lock, uint32_t sequence)
+{
+  __DMB();
+  return lock->sequence == sequence;
+}
+
+uint32_t Seqlock_Copy(const Seqlock_t* lock, void* dest, const volatile void* src, size_t size)
+{
+  uint32_t sequence;
+  uint8_t* out = (uint8_t*) dest;
+  const volatile uint8_t* in = (const volatile uint8_t*) src;
+
+  do {
+    while (Seqlock_ReadBegin(lock, &sequence) == false) {
+      // Only reachable from an interrupt that preempted the writer
+    }
+    for (size_t i = 0; i < size; i++) {
+      out[i] = in[i];
+    }
+  } while (Seqlock_ReadValid(lock, sequence) == false);
+
+  return sequence;
+}
+
+uint32_t Seqlock_GetSequence(const Seqlock_t* lock)
+{
+  return lock->sequence;
+}
+
+/* Private function definitions ----------------------------------------------*/
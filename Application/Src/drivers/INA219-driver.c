@@ -8,14 +8,27 @@
 /* Private includes ----------------------------------------------------------*/
 
 #include "INA219-driver.h"
+#include "sys_power.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
-
+typedef enum {
+  READ_IDLE,
+  READ_SHUNT,
+  READ_BUS
+} ReadStep_t;
 
 /* Private define ------------------------------------------------------------*/
 
 #define CONFIGURATION_ADDRESS			0x00
+#define SHUNT_VOLTAGE_ADDRESS			0x01
+#define BUS_VOLTAGE_ADDRESS				0x02
+
+// BRNG = 32 V, PGA = /8 (320 mV), 12 bit bus and shunt ADCs,
+// shunt and bus continuous
+#define CONFIGURATION_VALUE       0x399F
+
+#define MAX_TIMEOUT_MS    5
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -23,6 +36,83 @@
 
 /* Private variables ---------------------------------------------------------*/
 
+extern I2C_HandleTypeDef hi2c1;
 
+static volatile ReadStep_t read_step = READ_IDLE;
+static volatile uint32_t error_count = 0;
+
+// Registers are big endian
+static uint8_t shunt_buffer[2];
+static uint8_t bus_buffer[2];
 
 /* Private function prototypes -----------------------------------------------*/
+
+static uint16_t toRegister(const uint8_t* buffer);
+
+/* Exported function definitions ---------------------------------------------*/
+
+bool INA219_Init()
+{
+  uint8_t config[2] = {CONFIGURATION_VALUE >> 8, CONFIGURATION_VALUE & 0xFF};
+
+  read_step = READ_IDLE;
+  return HAL_I2C_Mem_Write(&hi2c1, INA219_I2C_ADDRESS << 1, CONFIGURATION_ADDRESS,
+      I2C_MEMADD_SIZE_8BIT, config, sizeof(config), MAX_TIMEOUT_MS) == HAL_OK;
+}
+
+bool INA219_StartRead()
+{
+  if (read_step != READ_IDLE || HAL_I2C_GetState(&hi2c1) != HAL_I2C_STATE_READY) {
+    return false;
+  }
+
+  read_step = READ_SHUNT;
+  if (HAL_I2C_Mem_Read_IT(&hi2c1, INA219_I2C_ADDRESS << 1, SHUNT_VOLTAGE_ADDRESS,
+      I2C_MEMADD_SIZE_8BIT, shunt_buffer, sizeof(shunt_buffer)) != HAL_OK) {
+    read_step = READ_IDLE;
+    return false;
+  }
+  return true;
+}
+
+uint32_t INA219_GetErrorCount()
+{
+  return error_count;
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c != &hi2c1) {
+    return;
+  }
+
+  if (read_step == READ_SHUNT) {
+    read_step = READ_BUS;
+    if (HAL_I2C_Mem_Read_IT(&hi2c1, INA219_I2C_ADDRESS << 1, BUS_VOLTAGE_ADDRESS,
+        I2C_MEMADD_SIZE_8BIT, bus_buffer, sizeof(bus_buffer)) != HAL_OK) {
+      read_step = READ_IDLE;
+      error_count++;
+    }
+  }
+  else if (read_step == READ_BUS) {
+    read_step = READ_IDLE;
+    Power_AddValue((int16_t) toRegister(shunt_buffer), toRegister(bus_buffer));
+  }
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c != &hi2c1) {
+    return;
+  }
+
+  read_step = READ_IDLE;
+  error_count++;
+}
+
+/* Private function definitions ----------------------------------------------*/
+
+static uint16_t toRegister(const uint8_t* buffer)
+{
+  return ((uint16_t) buffer[0] << 8) | buffer[1];
+}
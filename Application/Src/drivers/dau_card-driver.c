@@ -8,6 +8,8 @@
 /* Private includes ----------------------------------------------------------*/
 
 #include "stm32h7xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include "cmsis_os.h"
 #include "dau_card-driver.h"
 #include "comm_main.h"
@@ -20,9 +22,16 @@
 
 /* Private define ------------------------------------------------------------*/
 
+// Must be a power of 2
 #define DAU_RX_BUFFER_SIZE  2048
+// Must be a power of 2
 #define DAU_TX_BUFFER_SIZE  2048
 
+// Longest a write waits for space in the ring before it is dropped
+#define DAU_TX_TIMEOUT_MS   50
+
+#define DAU_TX_SPACE_FLAG   0x00000001
+
 /* Private macro -------------------------------------------------------------*/
 
 
@@ -32,17 +41,34 @@
 static CommBuffer_t dau_buffer;
 extern osMutexId_t dau_uart_mutexHandle;
 
+// Circular DMA target. The counters are free running like the transmit ring.
+// The UART callbacks only move rx_write and the COMM task only moves rx_read
 static uint8_t rx_buffer[DAU_RX_BUFFER_SIZE] __attribute__((section(".dma_buf")));
-static volatile uint32_t rx_head;
-static volatile uint32_t rx_tail;
-
+static volatile uint32_t rx_write = 0;
+static volatile uint32_t rx_flush = 0;      // Bytes before this are discarded
+static uint32_t rx_read = 0;
+static uint32_t rx_dma_position = 0;
+static DauRxStats_t rx_stats;
+
+// Ring of bytes waiting to be sent. The head and tail are free running so
+// head - tail is the number of bytes waiting
 static uint8_t tx_buffer[DAU_TX_BUFFER_SIZE] __attribute__((section(".dma_buf")));
-static volatile uint8_t tx_busy = 0;
+static volatile uint32_t tx_head = 0;       // Only moved by writers
+static volatile uint32_t tx_tail = 0;       // Only moved by the callbacks
+static volatile uint16_t tx_in_flight = 0;  // Bytes in the DMA transfer, 0 when idle
+static osEventFlagsId_t tx_events = NULL;
+static DauTxStats_t tx_stats;
 
 extern UART_HandleTypeDef huart5;
 
 /* Private function prototypes -----------------------------------------------*/
 
+static void startTransfer(void);
+static void finishTransfer(bool sent);
+static void countDropped(uint16_t len);
+static void startReception(void);
+static uint32_t findControl(const uint8_t* data, uint32_t len);
+static void appendText(const uint8_t* data, uint32_t len);
 
 
 /* Exported function definitions ---------------------------------------------*/
@@ -55,96 +81,157 @@ void DAU_Init(void)
   dau_buffer.contents_changed = false;
   dau_buffer.source = COMM_UART;
 
-  __HAL_UART_ENABLE_IT(&huart5, UART_IT_IDLE);
+  static StaticEventGroup_t event_control_block;
+  static const osEventFlagsAttr_t event_attr = {
+      .name = "DauTxEvents",
+      .attr_bits = 0,
+      .cb_mem = &event_control_block,
+      .cb_size = sizeof(event_control_block)
+  };
+  tx_events = osEventFlagsNew(&event_attr);
 
-  HAL_UART_Receive_DMA(&huart5, rx_buffer, DAU_RX_BUFFER_SIZE);
+  startReception();
 }
 
 void DAU_TransmitData(uint8_t* data, uint16_t len)
 {
-  if (osMutexAcquire(dau_uart_mutexHandle, osWaitForever) == osOK) {
-    while (tx_busy == 1) {
-      // TODO: Replace busy-wait with proper timeout or notification mechanism
-      osDelay(1);
-    }
-    if (len > DAU_TX_BUFFER_SIZE) {
-      osMutexRelease(dau_uart_mutexHandle);
-      return;
-    }
+  if (len == 0) {
+    return;
+  }
+  if (len > DAU_TX_BUFFER_SIZE || tx_events == NULL) {
+    countDropped(len);
+    return;
+  }
 
-    memcpy(tx_buffer, data, len);
+  if (osMutexAcquire(dau_uart_mutexHandle, osWaitForever) != osOK) {
+    return;
+  }
 
-    tx_busy = 1;
+  // Only waits when the host falls behind by a whole ring
+  if (DAU_TX_BUFFER_SIZE - (tx_head - tx_tail) < len) {
+    tx_stats.back_pressure++;
+    uint32_t start = osKernelGetTickCount();
+    while (DAU_TX_BUFFER_SIZE - (tx_head - tx_tail) < len) {
+      uint32_t elapsed = osKernelGetTickCount() - start;
+      if (elapsed >= DAU_TX_TIMEOUT_MS) {
+        countDropped(len);
+        osMutexRelease(dau_uart_mutexHandle);
+        return;
+      }
+      osEventFlagsWait(tx_events, DAU_TX_SPACE_FLAG, osFlagsWaitAny,
+                       DAU_TX_TIMEOUT_MS - elapsed);
+    }
+  }
 
-    HAL_UART_Transmit_DMA(&huart5, tx_buffer, len);
-    osMutexRelease(dau_uart_mutexHandle);
+  uint32_t index = tx_head & (DAU_TX_BUFFER_SIZE - 1);
+  uint32_t first = DAU_TX_BUFFER_SIZE - index;
+  if (first > len) {
+    first = len;
   }
+  memcpy(&tx_buffer[index], data, first);
+  memcpy(tx_buffer, &data[first], len - first);
+
+  // The completion callback chains the next transfer so one only has to be
+  // started here when the UART is idle
+  taskENTER_CRITICAL();
+  tx_head += len;
+  if (tx_in_flight == 0) {
+    startTransfer();
+  }
+  uint32_t used = tx_head - tx_tail;
+  taskEXIT_CRITICAL();
+
+  tx_stats.queued_bytes += len;
+  if (used > tx_stats.max_used) {
+    tx_stats.max_used = used;
+  }
+  osMutexRelease(dau_uart_mutexHandle);
 }
 
-void DAU_GetNewData()
+void DAU_GetTxStats(DauTxStats_t* stats)
+{
+  *stats = tx_stats;
+}
+
+void DAU_GetRxStats(DauRxStats_t* stats)
 {
-  // Calculate current DMA position
-  uint32_t dma_position = (DAU_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart5.hdmarx)) % DAU_RX_BUFFER_SIZE;
-  rx_tail = dma_position; // Update tail to current DMA position
+  *stats = rx_stats;
+}
 
-  // Process all data between head and tail
-  while (rx_head != rx_tail) {
-    uint8_t byte = rx_buffer[rx_head];
+void DAU_GetNewData()
+{
+  uint32_t flush = rx_flush;
+  if ((int32_t) (flush - rx_read) > 0) {
+    rx_read = flush;
+  }
 
-    DAU_ProcessRxData(&byte, 1);
+  uint32_t write = rx_write;
+  if (write - rx_read > DAU_RX_BUFFER_SIZE) {
+    // The DMA lapped the reader so the unread bytes are mixed with new ones
+    rx_stats.overruns++;
+    rx_read = write;
+    return;
+  }
 
-    rx_head = (rx_head + 1) % DAU_RX_BUFFER_SIZE;
+  // Stops at the end of a line until the COMM task takes the message so
+  // input typed ahead stays in the ring
+  while (rx_read != write && dau_buffer.data_ready == false) {
+    uint32_t index = rx_read & (DAU_RX_BUFFER_SIZE - 1);
+    uint32_t available = DAU_RX_BUFFER_SIZE - index;
+    if (available > write - rx_read) {
+      available = write - rx_read;
+    }
+    rx_read += DAU_ProcessRxData(&rx_buffer[index], available);
   }
 }
 
-void DAU_ProcessRxData(uint8_t* data, uint32_t len)
+uint32_t DAU_ProcessRxData(uint8_t* data, uint32_t len)
 {
-  // if a message is ready, do not process any more user input
-  if (*data == '\0') return; // TODO: Review null character handling
-  if (dau_buffer.data_ready == true) return;
-  if (len == 0) return;
-  dau_buffer.contents_changed = true;
+  uint32_t i = 0;
+  while (i < len && dau_buffer.data_ready == false) {
+    // Printable runs are copied in one go
+    uint32_t run = findControl(&data[i], len - i);
+    if (run > 0) {
+      appendText(&data[i], run);
+      i += run;
+      continue;
+    }
 
-  for (uint16_t i = 0; i < len; i++) {
-    if (dau_buffer.index < sizeof(dau_buffer.buffer) - 1) {
-      if (data[i] == '\e') {
+    switch (data[i]) {
+      case '\0':
+        break;
+      case '\e':
         dau_buffer.buffer[0] = '\e';
         dau_buffer.buffer[1] = '\0';
         dau_buffer.index = 1;
         dau_buffer.data_ready = true;
-
-        continue;
-      }
-
-      if (data[i] == '\b') {
-        if (dau_buffer.index == 0) {
-          continue;
-        }
-        else {
+        break;
+      case '\b':
+        if (dau_buffer.index > 0) {
           dau_buffer.index--;
         }
-        continue;
-      }
-      if (data[i] == '\r' || data[i] == '\n') {
-
+        break;
+      case '\r':
+      case '\n':
         if (dau_buffer.index > 0) {
           // End string
           dau_buffer.buffer[dau_buffer.index] = '\0';
-
           dau_buffer.data_ready = true;
         }
-      }
-      else {
-        dau_buffer.buffer[dau_buffer.index++] = data[i];
-      }
-    } else {
-      dau_buffer.index = 0;
+        break;
+      default:
+        appendText(&data[i], 1);
+        break;
     }
+    dau_buffer.contents_changed = true;
+    i++;
   }
+  return i;
 }
 
 RxState_t DAU_GetMessage(uint8_t* buffer, uint16_t* len)
 {
+  DAU_GetNewData();
   if (dau_buffer.contents_changed == false) return NO_CHANGE;
   RxState_t state = (dau_buffer.data_ready == true) ? DATA_READY : NEW_CONTENT;
   *len = dau_buffer.index;
@@ -160,6 +247,140 @@ RxState_t DAU_GetMessage(uint8_t* buffer, uint16_t* len)
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
   if (huart == &huart5) {
-    tx_busy = 0;
+    finishTransfer(true);
   }
 }
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  if (huart != &huart5) {
+    return;
+  }
+
+  // Called at half transfer, transfer complete and when the line goes idle
+  // with the DMA position. The transfer complete position is the buffer size
+  uint32_t received = (Size - rx_dma_position) & (DAU_RX_BUFFER_SIZE - 1);
+  rx_dma_position = Size & (DAU_RX_BUFFER_SIZE - 1);
+  if (received == 0) {
+    return;
+  }
+  rx_write += received;
+  rx_stats.received_bytes += received;
+  COMM_SignalInput();
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  if (huart != &huart5) {
+    return;
+  }
+
+  // A DMA error aborts the transfer and returns the UART to ready. Errors on
+  // the receive side leave the transmit transfer running
+  if (tx_in_flight != 0 && huart->gState == HAL_UART_STATE_READY) {
+    finishTransfer(false);
+  }
+
+  // With DMA reception the HAL aborts the reception on any receive error
+  // (parity, noise, framing or overrun) as well as on DMA errors
+  if (huart->RxState == HAL_UART_STATE_READY) {
+    rx_stats.errors++;
+    // The DMA restarts from the start of the buffer so the reader skips the
+    // rest of the current lap
+    rx_write += (DAU_RX_BUFFER_SIZE - rx_dma_position) & (DAU_RX_BUFFER_SIZE - 1);
+    rx_flush = rx_write;
+    rx_dma_position = 0;
+    startReception();
+  }
+}
+
+// Interrupts must be masked or the caller must be the UART callback
+static void startTransfer()
+{
+  uint32_t used = tx_head - tx_tail;
+  if (used == 0) {
+    tx_in_flight = 0;
+    return;
+  }
+
+  // DMA needs contiguous memory so a wrapped ring is sent in 2 transfers
+  uint32_t index = tx_tail & (DAU_TX_BUFFER_SIZE - 1);
+  uint32_t chunk = DAU_TX_BUFFER_SIZE - index;
+  if (chunk > used) {
+    chunk = used;
+  }
+  tx_in_flight = chunk;
+  if (HAL_UART_Transmit_DMA(&huart5, &tx_buffer[index], chunk) != HAL_OK) {
+    // Dropped so the ring cannot stall
+    tx_tail += chunk;
+    tx_in_flight = 0;
+    tx_stats.errors++;
+    tx_stats.dropped_bytes += chunk;
+  }
+}
+
+static void finishTransfer(bool sent)
+{
+  if (sent == true) {
+    tx_stats.sent_bytes += tx_in_flight;
+  }
+  else {
+    tx_stats.errors++;
+    tx_stats.dropped_bytes += tx_in_flight;
+  }
+  tx_tail += tx_in_flight;
+  startTransfer();
+  osEventFlagsSet(tx_events, DAU_TX_SPACE_FLAG);
+}
+
+// The callbacks also count dropped bytes
+static void countDropped(uint16_t len)
+{
+  taskENTER_CRITICAL();
+  tx_stats.dropped_messages++;
+  tx_stats.dropped_bytes += len;
+  taskEXIT_CRITICAL();
+}
+
+static void startReception()
+{
+  // The line going idle ends a reception event so commands are handled as
+  // soon as they are sent instead of when the buffer fills
+  if (HAL_UARTEx_ReceiveToIdle_DMA(&huart5, rx_buffer, DAU_RX_BUFFER_SIZE) != HAL_OK) {
+    rx_stats.errors++;
+  }
+}
+
+// Returns the length of the run before the first control character
+static uint32_t findControl(const uint8_t* data, uint32_t len)
+{
+  uint32_t i = 0;
+  while (i < len && data[i] >= ' ') {
+    i++;
+  }
+  return i;
+}
+
+static void appendText(const uint8_t* data, uint32_t len)
+{
+  const uint16_t capacity = sizeof(dau_buffer.buffer) - 1;
+
+  while (len > 0) {
+    if (dau_buffer.index >= capacity) {
+      // Overflowed line. The character is dropped and the line starts over
+      dau_buffer.index = 0;
+      data++;
+      len--;
+      continue;
+    }
+    uint32_t count = capacity - dau_buffer.index;
+    if (count > len) {
+      count = len;
+    }
+    memcpy(&dau_buffer.buffer[dau_buffer.index], data, count);
+    dau_buffer.index += count;
+    data += count;
+    len -= count;
+  }
+  dau_buffer.contents_changed = true;
+}
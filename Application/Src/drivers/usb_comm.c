@@ -12,6 +12,7 @@
 #include "cmsis_os.h"
 #include "comm_main.h"
 #include "cmsis_os.h"
+#include "mess_replay.h"
 #include <string.h>
 #include <stdbool.h>
 
@@ -36,6 +37,9 @@ static uint16_t usb_overflow_mess_len;
 static CommBuffer_t usb_buffer __attribute__((section(".dma_buf")));
 static osMutexId_t usb_mutex;
 static osEventFlagsId_t transfer_events;
+static volatile bool rx_paused = false;
+
+extern USBD_HandleTypeDef hUsbDeviceHS;
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -52,8 +56,23 @@ void USB_Init(void)
   usb_buffer.data_ready = false;
   usb_buffer.source = COMM_USB;
 
-  usb_mutex = osMutexNew(NULL);
-  transfer_events = osEventFlagsNew(NULL);
+  static StaticSemaphore_t mutex_control_block;
+  static const osMutexAttr_t mutex_attr = {
+      .name = "UsbMutex",
+      .attr_bits = 0,
+      .cb_mem = &mutex_control_block,
+      .cb_size = sizeof(mutex_control_block)
+  };
+  static StaticEventGroup_t event_control_block;
+  static const osEventFlagsAttr_t event_attr = {
+      .name = "UsbEvents",
+      .attr_bits = 0,
+      .cb_mem = &event_control_block,
+      .cb_size = sizeof(event_control_block)
+  };
+
+  usb_mutex = osMutexNew(&mutex_attr);
+  transfer_events = osEventFlagsNew(&event_attr);
 }
 
 void USB_TransmitData(uint8_t* data, uint16_t len)
@@ -71,6 +90,11 @@ void USB_TransmitData(uint8_t* data, uint16_t len)
 
 void USB_ProcessRxData(uint8_t* data, uint32_t len)
 {
+  // Replayed captures are raw binary samples and bypass the text handling
+  if (Replay_IsActive() == true) {
+    Replay_AddData(data, len);
+    return;
+  }
   // if a message is ready, do not process any more user input
   if (usb_buffer.data_ready == true) return;
   if (len == 0) return;
@@ -122,6 +146,7 @@ void USB_ProcessRxData(uint8_t* data, uint32_t len)
       usb_buffer.contents_changed = true;
     }
   }
+  COMM_SignalInput();
 }
 
 RxState_t USB_GetMessage(uint8_t* buffer, uint16_t* len)
@@ -141,5 +166,29 @@ void USB_TransferComplete(void)
   osEventFlagsSet(transfer_events, TRANSFER_COMPLETE_FLAG);
 }
 
+bool USB_ContinueRx(void)
+{
+  // NAK further packets until the replay buffer has room for a full packet.
+  // This paces the host to the ADC rate
+  if (Replay_IsActive() == true &&
+      Replay_FreeSpace() < CDC_DATA_HS_OUT_PACKET_SIZE) {
+    rx_paused = true;
+    return false;
+  }
+  return true;
+}
+
+void USB_ResumeRx(void)
+{
+  if (rx_paused == false) return;
+  if (Replay_IsActive() == true &&
+      Replay_FreeSpace() < CDC_DATA_HS_OUT_PACKET_SIZE) return;
+
+  HAL_NVIC_DisableIRQ(OTG_HS_IRQn);
+  rx_paused = false;
+  USBD_CDC_ReceivePacket(&hUsbDeviceHS);
+  HAL_NVIC_EnableIRQ(OTG_HS_IRQn);
+}
+
 
 /* Private function definitions ----------------------------------------------*/
@@ -72,7 +72,7 @@
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 56 )
 #define configMINIMAL_STACK_SIZE                 ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE                    ((size_t)48000)
+#define configTOTAL_HEAP_SIZE                    ((size_t)1024)
 #define configMAX_TASK_NAME_LEN                  ( 16 )
 #define configGENERATE_RUN_TIME_STATS            1
 #define configUSE_TRACE_FACILITY                 1
@@ -181,6 +181,26 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* Kernel events recorded in the event trace (sys_trace.h). The macros are
+expanded inside tasks.c and queue.c which gives them access to the TCB and
+queue being operated on */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+#include "sys_trace.h"
+#define traceTASK_SWITCHED_IN()                   Trace_Record(TRACE_EVENT_TASK_SWITCHED_IN, pxCurrentTCB->uxTCBNumber)
+#define traceTASK_SWITCHED_OUT()                  Trace_Record(TRACE_EVENT_TASK_SWITCHED_OUT, pxCurrentTCB->uxTCBNumber)
+#define traceQUEUE_SEND(pxQueue)                  Trace_Record(TRACE_EVENT_QUEUE_SEND, (uint32_t) (pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)         Trace_Record(TRACE_EVENT_QUEUE_SEND, (uint32_t) (pxQueue))
+#define traceQUEUE_SEND_FAILED(pxQueue)           Trace_Record(TRACE_EVENT_QUEUE_SEND_FAILED, (uint32_t) (pxQueue))
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue)  Trace_Record(TRACE_EVENT_QUEUE_SEND_FAILED, (uint32_t) (pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue)               Trace_Record(TRACE_EVENT_QUEUE_RECEIVE, (uint32_t) (pxQueue))
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)      Trace_Record(TRACE_EVENT_QUEUE_RECEIVE, (uint32_t) (pxQueue))
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)        Trace_Record(TRACE_EVENT_QUEUE_RECEIVE_FAILED, (uint32_t) (pxQueue))
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) Trace_Record(TRACE_EVENT_QUEUE_RECEIVE_FAILED, (uint32_t) (pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)      Trace_Record(TRACE_EVENT_QUEUE_BLOCK_SEND, (uint32_t) (pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)   Trace_Record(TRACE_EVENT_QUEUE_BLOCK_RECEIVE, (uint32_t) (pxQueue))
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+  Trace_Record(TRACE_EVENT_PRIORITY_INHERIT, ((pxTCBOfMutexHolder)->uxTCBNumber << 16) | (uxInheritedPriority))
+#endif /* defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__) */
 /* USER CODE END Defines */
 
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
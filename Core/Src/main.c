@@ -30,13 +30,16 @@
 #include "mess_main.h"
 #include "cfg_main.h"
 #include "sys_main.h"
+#include "sys_trace.h"
 #include "dac_main.h"
 #include "cfg_parameters.h"
+#include "cfg_profiles.h"
 #include "stm32h7xx_ll_cordic.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 typedef StaticTask_t osStaticThreadDef_t;
+typedef StaticSemaphore_t osStaticMutexDef_t;
 /* USER CODE BEGIN PTD */
 
 /* USER CODE END PTD */
@@ -159,11 +162,20 @@ const osThreadAttr_t dacTask_attributes = {
 };
 /* Definitions for dau_uart_mutex */
 osMutexId_t dau_uart_mutexHandle;
+osStaticMutexDef_t dau_uart_mutexControlBlock;
 const osMutexAttr_t dau_uart_mutex_attributes = {
-  .name = "dau_uart_mutex"
+  .name = "dau_uart_mutex",
+  .cb_mem = &dau_uart_mutexControlBlock,
+  .cb_size = sizeof(dau_uart_mutexControlBlock),
 };
 /* USER CODE BEGIN PV */
 osEventFlagsId_t print_event_handle = NULL;
+StaticEventGroup_t print_event_control_block;
+const osEventFlagsAttr_t print_event_attributes = {
+  .name = "print_events",
+  .cb_mem = &print_event_control_block,
+  .cb_size = sizeof(print_event_control_block)
+};
 extern PCD_HandleTypeDef hpcd_USB_OTG_HS;
 /* USER CODE END PV */
 
@@ -262,6 +274,7 @@ int main(void)
   MX_TIM16_Init();
   MX_CORDIC_Init();
   /* USER CODE BEGIN 2 */
+  Trace_Init();
   Ws2812b_Init();
 
   if (CFG_CreateFlags() == false) {
@@ -272,6 +285,10 @@ int main(void)
     Error_Handler();
   }
 
+  if (Profile_Init() == false) {
+    Error_Handler();
+  }
+
   /* USER CODE END 2 */
 
   /* Init scheduler */
@@ -322,7 +339,7 @@ int main(void)
 
   /* USER CODE BEGIN RTOS_EVENTS */
   /* add events, ... */
-  print_event_handle = osEventFlagsNew(NULL);
+  print_event_handle = osEventFlagsNew(&print_event_attributes);
   /* USER CODE END RTOS_EVENTS */
 
   /* Start scheduler */
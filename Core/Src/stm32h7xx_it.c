@@ -22,7 +22,6 @@
 #include "stm32h7xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include "dau_card-driver.h"
 #include "sys_sensor_timer.h"
 #include "ws2812b-driver.h"
 /* USER CODE END Includes */
@@ -357,12 +356,7 @@ void DMA1_Stream7_IRQHandler(void)
 void UART5_IRQHandler(void)
 {
   /* USER CODE BEGIN UART5_IRQn 0 */
-  if (__HAL_UART_GET_FLAG(&huart5, UART_FLAG_IDLE)) {
-      __HAL_UART_CLEAR_IDLEFLAG(&huart5);
 
-      // Process any received data when line goes idle
-      DAU_GetNewData();
-  }
   /* USER CODE END UART5_IRQn 0 */
   HAL_UART_IRQHandler(&huart5);
   /* USER CODE BEGIN UART5_IRQn 1 */
@@ -270,7 +270,9 @@ static int8_t CDC_Receive_HS(uint8_t* Buf, uint32_t *Len)
   /* USER CODE BEGIN 11 */
   USB_ProcessRxData(Buf, *Len);
   USBD_CDC_SetRxBuffer(&hUsbDeviceHS, &Buf[0]);
-  USBD_CDC_ReceivePacket(&hUsbDeviceHS);
+  if (USB_ContinueRx() == true) {
+    USBD_CDC_ReceivePacket(&hUsbDeviceHS);
+  }
   return (USBD_OK);
   /* USER CODE END 11 */
 }
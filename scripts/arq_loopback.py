@@ -0,0 +1,117 @@
+import argparse
+import sys
+
+# Collects the output of the ARQ loopback test (Evaluation Menu). The modem
+# sends the test messages through the feedback network while erasing a fixed
+# fraction of the frames. Exits with 1 if a message was lost, duplicated, or
+# delivered out of order so it can be used as a hardware-in-the-loop gate.
+
+DEFAULT_PORT = 'COM6'
+DEFAULT_BAUD = 3686400
+
+CFG_FIELDS = ["window", "messages", "payload_bytes", "loss_percent"]
+RESULT_FIELDS = ["sent", "delivered", "out_of_order", "duplicates", "corrupt",
+                 "frames", "retransmissions", "timeouts", "fast_retransmits",
+                 "given_up", "acks", "suppressed", "erased", "srtt_ms",
+                 "rto_ms", "elapsed_ms", "result"]
+
+
+def read_serial(port, baud):
+    """Reads lines from the modem until the end of the test"""
+    import serial
+
+    ser = serial.Serial(port, baud, timeout=1)
+    print("Waiting for test. Start it from the Evaluation Menu")
+    lines = []
+    buffer = bytearray()
+    try:
+        while True:
+            buffer += ser.read(ser.in_waiting or 1)
+            while b'\n' in buffer:
+                line, _, buffer = buffer.partition(b'\n')
+                text = line.decode('ascii', errors='replace').strip('\r\n ')
+                if not text.startswith("ARQ"):
+                    continue
+                print(text)
+                lines.append(text)
+                if text == "ARQ_END":
+                    return lines
+    finally:
+        ser.close()
+
+
+def parse_lines(lines):
+    cfg = None
+    result = None
+    deliveries = []
+    for line in lines:
+        fields = line.split(',')
+        if fields[0] == "ARQ_CFG" and fields[1] != "window":
+            cfg = {key: int(value) for key, value in zip(CFG_FIELDS, fields[1:])}
+        elif fields[0] == "ARQ_RX":
+            deliveries.append((int(fields[1]), int(fields[2])))
+        elif fields[0] == "ARQ_RESULT" and fields[1] != "sent":
+            result = dict(zip(RESULT_FIELDS, fields[1:]))
+            for key in RESULT_FIELDS[:-1]:
+                result[key] = int(result[key])
+    return cfg, result, deliveries
+
+
+def check(cfg, result, deliveries):
+    """Returns a list of human readable failures"""
+    failures = []
+    indices = [index for index, _ in deliveries]
+    if indices != list(range(cfg["messages"])):
+        missing = sorted(set(range(cfg["messages"])) - set(indices))
+        if missing:
+            failures.append(f"missing messages {missing}")
+        if len(indices) != len(set(indices)):
+            failures.append("duplicate deliveries")
+        if sorted(indices) != indices:
+            failures.append("out of order deliveries")
+    if result["result"] != "PASS":
+        failures.append("modem reported FAIL")
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description="ARQ loopback test with frame erasures")
+    parser.add_argument("--port", default=DEFAULT_PORT)
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--input", help="Parse a saved log instead of reading the serial port")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input) as f:
+            lines = [line.strip() for line in f if line.startswith("ARQ")]
+    else:
+        lines = read_serial(args.port, args.baud)
+
+    cfg, result, deliveries = parse_lines(lines)
+    if cfg is None or result is None:
+        print("No complete test found")
+        return 1
+
+    efficiency = result["sent"] / max(result["frames"], 1)
+    goodput = (cfg["payload_bytes"] * 8 * result["delivered"] /
+               max(result["elapsed_ms"] / 1000, 1e-3))
+    print(f"Window {cfg['window']}, {cfg['loss_percent']}% erasures: "
+          f"{result['delivered']}/{result['sent']} delivered with "
+          f"{result['frames']} frames ({efficiency:.2f} messages/frame), "
+          f"{result['timeouts']} timeouts, {result['fast_retransmits']} fast "
+          f"retransmits, {result['suppressed']} duplicates suppressed")
+    print(f"Goodput {goodput:.1f} bit/s, SRTT {result['srtt_ms']} ms, "
+          f"RTO {result['rto_ms']} ms")
+
+    failures = check(cfg, result, deliveries)
+    for failure in failures:
+        print("FAILURE: " + failure)
+    if failures:
+        return 1
+
+    print("All messages delivered once and in order")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,252 @@
+import argparse
+import csv
+import json
+import math
+import os
+import sys
+from datetime import datetime
+
+# Collects the output of the BER/PER versus SNR sweep (Evaluation Menu) and
+# compares it against a stored baseline. Exits with 1 on a regression, on a
+# point of the baseline missing from the run or when there is no baseline so
+# it can be used as a hardware-in-the-loop gate. The baseline is recorded on
+# the reference setup with --update-baseline. The comparison itself is checked
+# with --self-test.
+
+DEFAULT_PORT = 'COM6'
+DEFAULT_BAUD = 3686400
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "ber_sweep_baseline.json")
+OUTPUT_DIR = "sweep_data"
+
+POINT_FIELDS = ["config", "snr_db", "packets", "packet_errors", "lost",
+                "info_bits", "info_bit_errors", "channel_bits",
+                "channel_bit_errors", "goodput"]
+Z_95 = 1.96
+
+
+def wilson_interval(errors, trials, z=Z_95):
+    """95% Wilson score interval for an error rate"""
+    if trials == 0:
+        return 0.0, 1.0
+    p = errors / trials
+    denom = 1 + z * z / trials
+    centre = (p + z * z / (2 * trials)) / denom
+    half = z * math.sqrt(p * (1 - p) / trials + z * z / (4 * trials * trials)) / denom
+    return max(0.0, centre - half), min(1.0, centre + half)
+
+
+def read_serial(port, baud):
+    """Reads lines from the modem until the end of the sweep"""
+    import serial
+
+    ser = serial.Serial(port, baud, timeout=1)
+    print("Waiting for sweep. Start it from the Evaluation Menu")
+    lines = []
+    buffer = bytearray()
+    try:
+        while True:
+            buffer += ser.read(ser.in_waiting or 1)
+            while b'\n' in buffer:
+                line, _, buffer = buffer.partition(b'\n')
+                text = line.decode('ascii', errors='replace').strip('\r\n ')
+                if not text.startswith("SWEEP"):
+                    continue
+                print(text)
+                lines.append(text)
+                if text == "SWEEP_END":
+                    return lines
+    finally:
+        ser.close()
+
+
+def parse_lines(lines):
+    configs = {}
+    points = []
+    errors = []
+    for line in lines:
+        fields = line.split(',')
+        if fields[0] == "SWEEP_ERR":
+            errors.append(f"config {fields[1]}: {','.join(fields[2:])}")
+        elif fields[0] == "SWEEP_CFG" and fields[1] != "index":
+            configs[fields[1]] = {
+                "modulation": int(fields[2]),
+                "baud": float(fields[3]),
+                "ecc": int(fields[4]),
+                "interleaver": int(fields[5]),
+                "hopper": int(fields[6]),
+            }
+        elif fields[0] == "SWEEP" and fields[1] != "config":
+            point = dict(zip(POINT_FIELDS, fields[1:]))
+            for key in POINT_FIELDS:
+                point[key] = float(point[key]) if key in ("snr_db", "goodput") else int(point[key])
+            point["config"] = str(point["config"])
+            ber_lo, ber_hi = wilson_interval(point["info_bit_errors"], point["info_bits"])
+            per_lo, per_hi = wilson_interval(point["packet_errors"], point["packets"])
+            point["ber"] = point["info_bit_errors"] / max(point["info_bits"], 1)
+            point["ber_low"], point["ber_high"] = ber_lo, ber_hi
+            point["per"] = point["packet_errors"] / max(point["packets"], 1)
+            point["per_low"], point["per_high"] = per_lo, per_hi
+            point["channel_ber"] = point["channel_bit_errors"] / max(point["channel_bits"], 1)
+            points.append(point)
+    return configs, points, errors
+
+
+def point_key(point):
+    return f"{point['config']}@{point['snr_db']:.1f}"
+
+
+def compare(points, baseline, tolerance):
+    """Returns a list of human readable regressions"""
+    regressions = []
+    measured = {point_key(p) for p in points}
+    swept_configs = {p["config"] for p in points}
+    for key in sorted(set(baseline.get("configs", {})) - swept_configs):
+        regressions.append(f"config {key} missing from the sweep")
+
+    # The modem skips the remaining higher SNR points of a config once a point
+    # has no packet errors, so those points are not missing
+    error_free_snr = {}
+    for point in points:
+        if point["packet_errors"] == 0:
+            config = point["config"]
+            error_free_snr[config] = min(point["snr_db"],
+                                         error_free_snr.get(config, math.inf))
+    for ref in baseline.get("points", []):
+        if ref["config"] not in swept_configs or point_key(ref) in measured:
+            continue
+        if ref["snr_db"] > error_free_snr.get(ref["config"], math.inf):
+            continue
+        regressions.append(f"{point_key(ref)} missing from the sweep")
+
+    reference = {point_key(p): p for p in baseline.get("points", [])}
+    for point in points:
+        ref = reference.get(point_key(point))
+        if ref is None:
+            continue
+        # Only flag when the measured rate is significantly worse
+        for rate in ("ber", "per"):
+            limit = ref[rate] * (1 + tolerance)
+            if point[rate + "_low"] > limit:
+                regressions.append(f"{point_key(point)} {rate.upper()} "
+                                   f"{point[rate]:.3e} (low {point[rate + '_low']:.3e}) "
+                                   f"> baseline {ref[rate]:.3e}")
+        if point["goodput"] < ref["goodput"] * (1 - tolerance):
+            regressions.append(f"{point_key(point)} goodput {point['goodput']:.2f} "
+                               f"< baseline {ref['goodput']:.2f}")
+    return regressions
+
+
+def self_test():
+    """Checks compare() on synthetic sweeps. Returns the number of failures"""
+    def point(config, snr_db, packet_errors, packets=100):
+        return {"config": config, "snr_db": snr_db, "packets": packets,
+                "packet_errors": packet_errors, "per": packet_errors / packets,
+                "per_low": wilson_interval(packet_errors, packets)[0],
+                "ber": 0.0, "ber_low": 0.0, "goodput": 100.0}
+
+    baseline = {"configs": {"0": {}, "1": {}},
+                "points": [point("0", 0.0, 50), point("0", 3.0, 5),
+                           point("0", 6.0, 0), point("1", 0.0, 0)]}
+    cases = [
+        ("identical run passes", baseline["points"], []),
+        ("error free earlier skips the higher points",
+         [point("0", 0.0, 40), point("0", 3.0, 0), point("1", 0.0, 0)], []),
+        ("point missing below the first error free point",
+         [point("0", 0.0, 50), point("0", 6.0, 0), point("1", 0.0, 0)],
+         ["0@3.0 missing from the sweep"]),
+        ("point missing without an error free point",
+         [point("0", 0.0, 50), point("0", 3.0, 5), point("1", 0.0, 0)],
+         ["0@6.0 missing from the sweep"]),
+        ("whole config missing",
+         [point("0", 0.0, 50), point("0", 3.0, 5), point("0", 6.0, 0)],
+         ["config 1 missing from the sweep"]),
+    ]
+    failures = 0
+    for name, points, expected in cases:
+        result = compare(points, baseline, 0.25)
+        if result != expected:
+            print(f"FAIL {name}: {result} != {expected}")
+            failures += 1
+        else:
+            print(f"PASS {name}")
+    return failures
+
+
+def save_results(configs, points, out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
+    csv_name = os.path.join(out_dir, f"ber_sweep_{timestamp}.csv")
+    json_name = os.path.join(out_dir, f"ber_sweep_{timestamp}.json")
+
+    with open(csv_name, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=list(points[0].keys()) if points else POINT_FIELDS)
+        writer.writeheader()
+        writer.writerows(points)
+
+    with open(json_name, 'w') as f:
+        json.dump({"configs": configs, "points": points}, f, indent=2)
+
+    print(f"Saved results to {csv_name} and {json_name}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="BER/PER/goodput versus SNR sweep")
+    parser.add_argument("--port", default=DEFAULT_PORT)
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--input", help="Parse a saved log instead of reading the serial port")
+    parser.add_argument("--out-dir", default=OUTPUT_DIR)
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE)
+    parser.add_argument("--tolerance", type=float, default=0.25,
+                        help="Relative tolerance before a point is flagged")
+    parser.add_argument("--update-baseline", action="store_true")
+    parser.add_argument("--self-test", action="store_true",
+                        help="Check the baseline comparison and exit")
+    args = parser.parse_args()
+
+    if args.self_test:
+        return 1 if self_test() else 0
+
+    if args.input:
+        with open(args.input) as f:
+            lines = [line.strip() for line in f if line.startswith("SWEEP")]
+    else:
+        lines = read_serial(args.port, args.baud)
+
+    configs, points, errors = parse_lines(lines)
+    for error in errors:
+        print("SWEEP ERROR: " + error)
+    if not points:
+        print("No sweep points found")
+        return 1
+
+    save_results(configs, points, args.out_dir)
+
+    if args.update_baseline:
+        if errors:
+            print("Not updating the baseline from a sweep with errors")
+            return 1
+        with open(args.baseline, 'w') as f:
+            json.dump({"configs": configs, "points": points}, f, indent=2)
+        print(f"Baseline updated: {args.baseline}")
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print(f"No baseline at {args.baseline}. Run with --update-baseline to create one")
+        return 1
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    regressions = compare(points, baseline, args.tolerance)
+    for regression in regressions:
+        print("REGRESSION: " + regression)
+    if regressions or errors:
+        return 1
+
+    print("No regressions against baseline")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
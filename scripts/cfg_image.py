@@ -0,0 +1,103 @@
+import argparse
+import json
+import struct
+import sys
+import zlib
+
+# Decodes and builds the binary configuration images exchanged through the
+# Configuration Image export and import menus. An image is a header (magic,
+# version, entry count, entry bytes), tag-type-length-value entries and a
+# CRC-32 over everything before it, sent as one line of hex. Decoding prints
+# the entries as JSON in the form accepted when building, so a snapshot of
+# one modem can be edited and provisioned to others:
+# {"profile": 0, "entries": [{"id": 0, "type": "uint16", "value": 100}, ...]}
+# The optional profile starts from a stored profile (slot from 0) that the
+# entries then override.
+
+MAGIC = 0x55434647
+VERSION = 1
+TAG_PROFILE = 0xF0
+HEADER_FORMAT = "<IBBH"
+ENTRY_FORMAT = "<BBB"
+
+# Must match ParamType_t in cfg_parameters.h
+TYPES = [("uint8", "<B"), ("int8", "<b"), ("uint16", "<H"), ("int16", "<h"),
+         ("uint32", "<I"), ("int32", "<i"), ("float", "<f")]
+TYPE_NAMES = [name for name, _ in TYPES]
+
+
+def decode(line):
+    """Returns the JSON description of a hex encoded image"""
+    image = bytes.fromhex(line.strip())
+    header_size = struct.calcsize(HEADER_FORMAT)
+    if len(image) < header_size + 4:
+        raise ValueError("image is too short")
+    magic, version, count, length = struct.unpack_from(HEADER_FORMAT, image)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a version %d configuration image" % VERSION)
+    if header_size + length + 4 != len(image):
+        raise ValueError("length does not match the header")
+    crc, = struct.unpack_from("<I", image, len(image) - 4)
+    if zlib.crc32(image[:-4]) != crc:
+        raise ValueError("CRC mismatch")
+
+    description = {"entries": []}
+    index = header_size
+    for _ in range(count):
+        tag, type_index, size = struct.unpack_from(ENTRY_FORMAT, image, index)
+        index += struct.calcsize(ENTRY_FORMAT)
+        value = image[index:index + size]
+        index += size
+        if tag == TAG_PROFILE:
+            description["profile"] = value[0]
+            continue
+        name, fmt = TYPES[type_index]
+        description["entries"].append({"id": tag, "type": name,
+                                       "value": struct.unpack(fmt, value)[0]})
+    return description
+
+
+def encode(description):
+    """Returns the hex encoded image of a JSON description"""
+    entries = bytearray()
+    count = 0
+    if "profile" in description:
+        entries += struct.pack(ENTRY_FORMAT, TAG_PROFILE, 0, 1)
+        entries += struct.pack("<B", description["profile"])
+        count += 1
+    for entry in description.get("entries", []):
+        type_index = TYPE_NAMES.index(entry["type"])
+        value = struct.pack(TYPES[type_index][1], entry["value"])
+        entries += struct.pack(ENTRY_FORMAT, entry["id"], type_index, len(value))
+        entries += value
+        count += 1
+
+    image = struct.pack(HEADER_FORMAT, MAGIC, VERSION, count, len(entries)) + entries
+    image += struct.pack("<I", zlib.crc32(image))
+    return image.hex().upper()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode or build configuration images")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+    decode_parser = subparsers.add_parser("decode", help="Hex image to JSON")
+    decode_parser.add_argument("image", help="File holding the exported line, - for stdin")
+    encode_parser = subparsers.add_parser("encode", help="JSON to hex image")
+    encode_parser.add_argument("description", help="JSON file, - for stdin")
+    args = parser.parse_args()
+
+    if args.command == "decode":
+        f = sys.stdin if args.image == "-" else open(args.image, 'r')
+        try:
+            print(json.dumps(decode(f.read()), indent=2))
+        except ValueError as e:
+            print(f"Invalid image: {e}")
+            return 1
+    else:
+        f = sys.stdin if args.description == "-" else open(args.description, 'r')
+        print(encode(json.load(f)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,112 @@
+import argparse
+import struct
+import sys
+import time
+
+# Polls the CPU load record (Debug Menu) and prints the busy, per task, and
+# per MESS state load for the 1 s, 10 s, and 60 s windows. With --csv every
+# record is also appended to a file for long captures.
+
+DEFAULT_PORT = 'COM6'
+DEFAULT_BAUD = 3686400
+
+RECORD_VERSION = 1
+WINDOWS = ["1s", "10s", "60s"]
+MESS_STATES = ["MESS driving", "MESS listening", "MESS processing",
+               "MESS changing"]
+
+
+def decode_record(data):
+    """Decodes a binary CPU load record into a dictionary"""
+    version, num_tasks, counter_hz, uptime = struct.unpack_from("<BBII", data, 0)
+    if version != RECORD_VERSION:
+        raise ValueError(f"Unsupported record version {version}")
+    index = 10
+    windows = []
+    for _ in WINDOWS:
+        values = struct.unpack_from(f"<{1 + num_tasks + len(MESS_STATES)}H", data, index)
+        index += 2 * len(values)
+        windows.append({"busy": values[0],
+                        "tasks": list(values[1:1 + num_tasks]),
+                        "states": list(values[1 + num_tasks:])})
+    names = []
+    for _ in range(num_tasks):
+        length = data[index]
+        names.append(data[index + 1:index + 1 + length].decode('ascii', errors='replace'))
+        index += 1 + length
+    return {"counter_hz": counter_hz, "uptime_s": uptime, "names": names,
+            "windows": windows}
+
+
+def print_record(record):
+    print(f"\nUptime {record['uptime_s']} s, run time counter {record['counter_hz']} Hz")
+    print(f"{'CPU load (%)':16}" + "".join(f"{w:>8}" for w in WINDOWS))
+    print(f"{'Busy':16}" + "".join(f"{w['busy'] / 10:8.1f}" for w in record["windows"]))
+    for i, name in enumerate(record["names"]):
+        print(f"{name:16}" + "".join(f"{w['tasks'][i] / 10:8.1f}" for w in record["windows"]))
+    for i, name in enumerate(MESS_STATES):
+        print(f"{name:16}" + "".join(f"{w['states'][i] / 10:8.1f}" for w in record["windows"]))
+
+
+def read_record(ser, timeout_s=2.0):
+    """Reads the text header and the binary record that follows it"""
+    deadline = time.time() + timeout_s
+    buffer = bytearray()
+    while time.time() < deadline:
+        buffer += ser.read(ser.in_waiting or 1)
+        start = buffer.find(b"CPU_RECORD,")
+        if start < 0 or b'\n' not in buffer[start:]:
+            continue
+        header, _, rest = buffer[start:].partition(b'\n')
+        length = int(header.decode('ascii').strip().split(',')[1])
+        if length == 0:
+            return None
+        while len(rest) < length and time.time() < deadline:
+            rest += ser.read(length - len(rest))
+        if len(rest) < length:
+            break
+        return decode_record(bytes(rest[:length]))
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Read the modem CPU load statistics")
+    parser.add_argument("--port", default=DEFAULT_PORT)
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--command", default=None,
+                        help="Menu selection sending the CPU load record, "
+                             "e.g. '3,16' (omit to trigger it by hand)")
+    parser.add_argument("--period", type=float, default=0,
+                        help="Seconds between polls (0 reads one record)")
+    parser.add_argument("--csv", default=None, help="Appends the records to this file")
+    args = parser.parse_args()
+
+    import serial
+    ser = serial.Serial(args.port, args.baud, timeout=0.1)
+    try:
+        while True:
+            if args.command is not None:
+                for selection in args.command.split(','):
+                    ser.write(selection.encode('ascii') + b'\r')
+                    time.sleep(0.05)
+            else:
+                print("Waiting for a record. Send it from the Debug Menu")
+            record = read_record(ser, 2.0 if args.command is not None else 60.0)
+            if record is None:
+                print("No record received")
+                return 1
+            print_record(record)
+            if args.csv is not None:
+                with open(args.csv, 'a') as f:
+                    for window, values in zip(WINDOWS, record["windows"]):
+                        loads = [values["busy"]] + values["tasks"] + values["states"]
+                        f.write(",".join(str(v) for v in [record["uptime_s"], window] + loads) + "\n")
+            if args.period <= 0:
+                return 0
+            time.sleep(args.period)
+    finally:
+        ser.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
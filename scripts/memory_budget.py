@@ -0,0 +1,158 @@
+import argparse
+import json
+import re
+import sys
+from collections import defaultdict
+
+# Memory budget per subsystem from the GNU ld map file of a firmware build
+# (Debug/UAM.map). Every input section is attributed to the subsystem of the
+# object file it comes from and to the memory region its address falls in.
+# Initialized data is counted in RAM and again in FLASH for its load image.
+# With --budget the totals are checked against a JSON file of the form
+# {"MESS": {"DTCMRAM": 40000, "RAM_D1": 120000}, ...} and the script exits
+# with 1 if a subsystem is over budget.
+
+SKIPPED_SECTIONS = (".debug", ".comment", ".ARM.attributes", ".stab", ".note")
+
+SUBSYSTEMS = [
+    (r"Application/Src/([^/]+)/", None),
+    (r"Core/", "Core"),
+    (r"Drivers/STM32H7xx_HAL_Driver/", "HAL"),
+    (r"Drivers/CMSIS/", "CMSIS"),
+    (r"Middlewares/Third_Party/FreeRTOS/", "FreeRTOS"),
+    (r"Middlewares/ST/|USB_DEVICE/", "USB"),
+    (r"([^/\\]+)\.a\(", None),
+]
+
+INPUT_SECTION = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+INPUT_SECTION_NAME = re.compile(r"^ (\S+)$")
+INPUT_SECTION_CONT = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+REGION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+
+
+def subsystem_of(path):
+    normalized = path.replace("\\", "/")
+    for pattern, name in SUBSYSTEMS:
+        match = re.search(pattern, normalized)
+        if match:
+            return name if name is not None else match.group(1)
+    return "other"
+
+
+def parse_map(text):
+    """Returns the memory regions and the list of (section, address, size, object)"""
+    regions = []
+    sections = []
+    lines = text.splitlines()
+    index = 0
+    while index < len(lines) and not lines[index].startswith("Memory Configuration"):
+        index += 1
+    for line in lines[index + 1:]:
+        index += 1
+        if line.startswith("Linker script and memory map"):
+            break
+        match = REGION.match(line)
+        if match and match.group(1) not in ("Name", "*default*"):
+            regions.append((match.group(1), int(match.group(2), 16), int(match.group(3), 16)))
+
+    pending = None
+    for line in lines[index:]:
+        if pending is not None:
+            match = INPUT_SECTION_CONT.match(line)
+            if match:
+                sections.append((pending, int(match.group(1), 16), int(match.group(2), 16),
+                                 match.group(3).strip()))
+            pending = None
+            continue
+        match = INPUT_SECTION.match(line)
+        if match:
+            sections.append((match.group(1), int(match.group(2), 16), int(match.group(3), 16),
+                             match.group(4).strip()))
+            continue
+        match = INPUT_SECTION_NAME.match(line)
+        if match and match.group(1) != "*fill*":
+            pending = match.group(1)
+    return regions, sections
+
+
+def region_of(regions, address):
+    for name, origin, length in regions:
+        if origin <= address < origin + length:
+            return name
+    return None
+
+
+def build_budget(regions, sections):
+    usage = defaultdict(lambda: defaultdict(int))
+    largest = []
+    for name, address, size, obj in sections:
+        if size == 0 or name.startswith(SKIPPED_SECTIONS) or name == "*fill*":
+            continue
+        region = region_of(regions, address)
+        if region is None:
+            continue
+        subsystem = subsystem_of(obj)
+        usage[subsystem][region] += size
+        if name.startswith(".data") and region != "FLASH":
+            usage[subsystem]["FLASH"] += size
+        largest.append((size, region, name, obj))
+    largest.sort(reverse=True)
+    return usage, largest
+
+
+def print_budget(regions, usage, largest, top):
+    names = [name for name, _, _ in regions
+             if any(name in values for values in usage.values())]
+    print(f"{'Subsystem':12}" + "".join(f"{name:>12}" for name in names))
+    totals = defaultdict(int)
+    for subsystem in sorted(usage, key=lambda s: -sum(usage[s].values())):
+        print(f"{subsystem:12}" + "".join(f"{usage[subsystem].get(name, 0):12}" for name in names))
+        for name in names:
+            totals[name] += usage[subsystem].get(name, 0)
+    print(f"{'Total':12}" + "".join(f"{totals[name]:12}" for name in names))
+    lengths = {name: length for name, _, length in regions}
+    print(f"{'Size':12}" + "".join(f"{lengths[name]:12}" for name in names))
+    print(f"{'Used (%)':12}" + "".join(f"{100 * totals[name] / lengths[name]:12.1f}" for name in names))
+
+    if top > 0:
+        print(f"\nLargest {top} input sections")
+        for size, region, name, obj in largest[:top]:
+            print(f"{size:8} {region:10} {name:40} {obj}")
+
+
+def check_budget(usage, budget):
+    over = []
+    for subsystem, limits in budget.items():
+        for region, limit in limits.items():
+            used = usage.get(subsystem, {}).get(region, 0)
+            if used > limit:
+                over.append(f"{subsystem} uses {used} B of {region}, budget is {limit} B")
+    return over
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Memory budget per subsystem from a linker map")
+    parser.add_argument("map", help="Map file written by the linker")
+    parser.add_argument("--top", type=int, default=0, help="Also lists the largest input sections")
+    parser.add_argument("--budget", default=None, help="JSON file with the budget per subsystem")
+    args = parser.parse_args()
+
+    with open(args.map, 'r', errors='replace') as f:
+        regions, sections = parse_map(f.read())
+    if len(regions) == 0:
+        print("No memory configuration found in the map file")
+        return 1
+    usage, largest = build_budget(regions, sections)
+    print_budget(regions, usage, largest, args.top)
+
+    if args.budget is not None:
+        with open(args.budget, 'r') as f:
+            over = check_budget(usage, json.load(f))
+        for line in over:
+            print(line)
+        return 1 if over else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
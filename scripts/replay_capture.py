@@ -0,0 +1,98 @@
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+# Streams a recorded ADC capture (as saved by read_waveform.py or a raw
+# little-endian uint16 file) to the modem's replay mode. The modem consumes
+# the samples at the ADC rate so the host is paced by USB flow control.
+
+DEFAULT_PORT = 'COM6'
+DEFAULT_BAUD = 3686400
+# Main menu -> Debug menu -> Replay
+DEFAULT_MENU_PATH = "2,13"
+CHUNK_SIZE = 4096
+
+
+def load_capture(filename):
+    """Loads samples from a text capture (one value per line) or raw binary"""
+    if filename.endswith(".txt"):
+        samples = []
+        with open(filename) as f:
+            for line in f:
+                line = line.strip()
+                if not line or line.startswith('#'):
+                    continue
+                samples.append(int(line))
+        return struct.pack(f"<{len(samples)}H", *samples), len(samples)
+
+    with open(filename, 'rb') as f:
+        data = f.read()
+    data = data[:len(data) - (len(data) % 2)]
+    return data, len(data) // 2
+
+
+def wait_for(ser, token, timeout):
+    """Reads until the token is seen and returns everything read"""
+    buffer = bytearray()
+    end = time.time() + timeout
+    while time.time() < end:
+        buffer += ser.read(ser.in_waiting or 1)
+        if token in buffer:
+            return buffer.decode('ascii', errors='replace')
+    raise TimeoutError(f"Did not receive {token!r}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay an ADC capture into the modem")
+    parser.add_argument("capture")
+    parser.add_argument("--port", default=DEFAULT_PORT)
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--menu-path", default=DEFAULT_MENU_PATH,
+                        help="Comma separated menu selections from the main menu")
+    args = parser.parse_args()
+
+    data, num_samples = load_capture(args.capture)
+    print(f"Loaded {num_samples} samples ({num_samples / 120000:.2f} s)")
+
+    ser = serial.Serial(args.port, args.baud, timeout=0.1)
+
+    # Return to the main menu then navigate to the replay entry
+    for _ in range(4):
+        ser.write(b'\x1b')
+        time.sleep(0.05)
+    ser.reset_input_buffer()
+    for selection in args.menu_path.split(','):
+        ser.write(selection.strip().encode() + b'\r')
+        time.sleep(0.05)
+
+    wait_for(ser, b"Enter the number of samples", 2)
+    ser.write(f"{num_samples}\r".encode())
+    wait_for(ser, b"REPLAY_READY", 2)
+
+    start = time.time()
+    for i in range(0, len(data), CHUNK_SIZE):
+        ser.write(data[i:i + CHUNK_SIZE])
+    print(f"Streamed in {time.time() - start:.2f} s")
+
+    output = wait_for(ser, b"deadline slack", 10 + num_samples / 120000)
+    print(output)
+    # Messages decoded during the replay are printed once the menu returns
+    time.sleep(1)
+    print(ser.read(ser.in_waiting).decode('ascii', errors='replace'))
+
+    for line in output.splitlines():
+        if line.startswith("REPLAY_DONE"):
+            fields = line.split(',')
+            underruns, overruns, timed_out = int(fields[3]), int(fields[4]), int(fields[8])
+            if overruns or timed_out:
+                return 1
+            if underruns:
+                print("Warning: host could not keep up with the ADC rate")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
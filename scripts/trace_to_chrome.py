@@ -0,0 +1,171 @@
+import argparse
+import json
+import struct
+import sys
+import time
+
+# Converts an event trace dump (Debug Menu) into Chrome trace JSON that can be
+# opened in chrome://tracing or https://ui.perfetto.dev. Tasks get one track
+# each built from the context switch records, interrupts get one track per
+# exception number, and the MESS task states get their own track. The dump can
+# be read from the modem directly or from a raw capture saved with --raw.
+
+DEFAULT_PORT = 'COM6'
+DEFAULT_BAUD = 3686400
+
+RECORD_FORMAT = "<IIHH"
+
+# Must match TraceEvent_t in sys_trace.h
+EVENTS = ["task_switched_in", "task_switched_out", "queue_send",
+          "queue_send_failed", "queue_receive", "queue_receive_failed",
+          "queue_block_send", "queue_block_receive", "priority_inherit",
+          "adc_half", "adc_full", "dac_half", "dac_full", "dac_underrun",
+          "gpio_exti", "mess_state", "param_set", "packet_received",
+          "packet_failed", "mark"]
+FAULT_EVENTS = {"dac_underrun", "packet_failed", "queue_send_failed"}
+ADC_NAMES = ["input", "feedback", "temperature"]
+MESS_STATES = ["driving transducer", "listening", "processing", "changing"]
+
+PID = 1
+MESS_STATE_TID = 900
+ISR_TID_OFFSET = 1000
+
+
+def capture(port, baud, timeout_s):
+    """Reads one dump from the modem and returns the raw bytes"""
+    import serial
+
+    ser = serial.Serial(port, baud, timeout=0.1)
+    print("Waiting for the trace. Start the dump from the Debug Menu")
+    data = bytearray()
+    deadline = time.time() + timeout_s
+    try:
+        while time.time() < deadline:
+            data += ser.read(ser.in_waiting or 1)
+            if b"TRACE_END" in data:
+                return bytes(data)
+    finally:
+        ser.close()
+    raise TimeoutError("No complete trace received")
+
+
+def parse_dump(data):
+    """Splits a dump into the task table, header fields, and records"""
+    tasks = {}
+    start = data.find(b"TRACE_TASK")
+    if start < 0:
+        start = data.find(b"TRACE_DUMP")
+    index = start
+    while True:
+        end = data.index(b"\n", index)
+        line = data[index:end].decode('ascii', errors='replace').strip()
+        index = end + 1
+        fields = line.split(',')
+        if fields[0] == "TRACE_TASK":
+            tasks[int(fields[1])] = fields[2]
+        elif fields[0] == "TRACE_DUMP":
+            num_records, size, core_hz, faulted = (int(v) for v in fields[1:5])
+            break
+    if size != struct.calcsize(RECORD_FORMAT):
+        raise ValueError(f"Unexpected record size {size}")
+    records = [struct.unpack_from(RECORD_FORMAT, data, index + i * size)
+               for i in range(num_records)]
+    return tasks, core_hz, bool(faulted), records
+
+
+def to_chrome(tasks, core_hz, records):
+    """Builds the list of Chrome trace events"""
+    events = []
+    for number, name in tasks.items():
+        events.append({"ph": "M", "pid": PID, "tid": number, "name": "thread_name",
+                       "args": {"name": name}})
+    events.append({"ph": "M", "pid": PID, "tid": MESS_STATE_TID, "name": "thread_name",
+                   "args": {"name": "MESS state"}})
+
+    isr_tracks = set()
+    running_task = None
+    mess_state = None
+    cycles = 0
+    previous = None
+    for timestamp, arg, event_id, source in records:
+        # Cycle counter wraps every few seconds. Neighbouring records can also
+        # be slightly out of order when an interrupt overtakes a writer
+        if previous is not None:
+            cycles += struct.unpack("<i", struct.pack("<I", (timestamp - previous) & 0xFFFFFFFF))[0]
+        previous = timestamp
+        ts = cycles * 1e6 / core_hz
+        name = EVENTS[event_id] if event_id < len(EVENTS) else f"event_{event_id}"
+
+        if name == "task_switched_in":
+            running_task = arg
+            events.append({"ph": "B", "pid": PID, "tid": arg, "ts": ts,
+                           "name": tasks.get(arg, f"task {arg}")})
+            continue
+        if name == "task_switched_out":
+            events.append({"ph": "E", "pid": PID, "tid": arg, "ts": ts})
+            running_task = None
+            continue
+        if name == "mess_state":
+            if mess_state is not None:
+                events.append({"ph": "E", "pid": PID, "tid": MESS_STATE_TID, "ts": ts})
+            mess_state = arg
+            state = MESS_STATES[arg] if arg < len(MESS_STATES) else str(arg)
+            events.append({"ph": "B", "pid": PID, "tid": MESS_STATE_TID, "ts": ts,
+                           "name": state})
+            continue
+
+        args = {"arg": f"0x{arg:08x}" if name.startswith("queue") else arg}
+        if name.startswith("adc") and arg < len(ADC_NAMES):
+            args["adc"] = ADC_NAMES[arg]
+        elif name == "priority_inherit":
+            args = {"holder": tasks.get(arg >> 16, arg >> 16), "priority": arg & 0xFFFF}
+
+        if source != 0:
+            tid = ISR_TID_OFFSET + source
+            if tid not in isr_tracks:
+                isr_tracks.add(tid)
+                events.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                               "args": {"name": f"ISR {source}"}})
+        else:
+            tid = running_task if running_task is not None else 0
+        scope = "g" if name in FAULT_EVENTS else "t"
+        events.append({"ph": "i", "pid": PID, "tid": tid, "ts": ts, "s": scope,
+                       "name": name, "args": args})
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert the modem event trace to Chrome trace JSON")
+    parser.add_argument("--port", default=DEFAULT_PORT)
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--input", default=None, help="Raw dump captured earlier with --raw")
+    parser.add_argument("--raw", default=None, help="Saves the raw dump read from the modem")
+    parser.add_argument("--timeout", type=float, default=60)
+    parser.add_argument("--out", default="trace.json")
+    args = parser.parse_args()
+
+    if args.input is not None:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+    else:
+        data = capture(args.port, args.baud, args.timeout)
+        if args.raw is not None:
+            with open(args.raw, 'wb') as f:
+                f.write(data)
+
+    tasks, core_hz, faulted, records = parse_dump(data)
+    events = to_chrome(tasks, core_hz, records)
+    with open(args.out, 'w') as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+
+    span_ms = 0
+    if len(events) > 0:
+        stamps = [e["ts"] for e in events if "ts" in e]
+        span_ms = (max(stamps) - min(stamps)) / 1000 if stamps else 0
+    print(f"{len(records)} records over {span_ms:.1f} ms written to {args.out}"
+          + (" (stopped by a fault)" if faulted else ""))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())